@@ -0,0 +1,96 @@
+/******************************************************************************/
+/*!
+\file   BenchmarkMain.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+The main function of M5Bench, which runs M5Benchmark without the game.
+*/
+/******************************************************************************/
+#include "Core/M5App.h"
+#include "Core/M5GameData.h"
+#include "Core/M5IniFile.h"
+#include "Core/M5Benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+/******************************************************************************/
+/*!
+Starts the engine without drawing, times every benchmark and saves the
+results.
+
+Use M5Bench file to save the results to file.  Use -baseline file to compare
+against an earlier run and -threshold percent to change how much slower a
+benchmark can get before it is a regression.  It must be run from the
+EngineTest directory so the ArcheTypes and Textures can be found.
+
+\param [in] argc
+The number of arguments.
+
+\param [in] argv
+The arguments.
+
+\return
+The number of regressions, so scripts can fail on a slower engine.
+*/
+/******************************************************************************/
+int main(int argc, char* argv[])
+{
+  std::string resultFile = "Benchmark.json";
+  std::string baselineFile;
+  float threshold = 10.0f;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string option = argv[i];
+    if (option == "-baseline" && i + 1 < argc)
+      baselineFile = argv[++i];
+    else if (option == "-threshold" && i + 1 < argc)
+      threshold = static_cast<float>(std::atof(argv[++i]));
+    else if (option[0] != '-')
+      resultFile = option;
+    else
+    {
+      std::fprintf(stderr, "Usage: M5Bench [file] [-baseline file] [-threshold percent]\n");
+      return -1;
+    }
+  }
+
+  M5InitData initData;
+  M5GameData gameData;
+  M5IniFile iniFile;
+
+  std::FILE* pFile = std::fopen("GameData/InitData.ini", "r");
+  if (!pFile)
+  {
+    std::fprintf(stderr, "M5Bench must be run from the EngineTest directory\n");
+    return -1;
+  }
+  std::fclose(pFile);
+
+  iniFile.ReadFile("GameData/InitData.ini");
+  iniFile.SetToSection("InitData");
+  iniFile.GetValue("width", initData.width);
+  iniFile.GetValue("height", initData.height);
+  iniFile.GetValue("loadThreads", initData.loadThreads);
+  iniFile.GetValue("framesPerSecond", initData.fps);
+
+  gameData.level = 1;
+  gameData.maxLevels = 1;
+  initData.title = "M5Bench";
+  initData.instance = 0;
+  initData.pGData = &gameData;
+  initData.gameDataSize = sizeof(gameData);
+  initData.fullScreen = false;
+  initData.headless = true;
+  initData.software = false;
+
+  M5App::Init(initData);
+  int regressions = M5Benchmark::Run(resultFile.c_str(),
+    baselineFile.empty() ? 0 : baselineFile.c_str(), threshold);
+  M5App::Shutdown();
+  return regressions;
+}
@@ -0,0 +1,55 @@
+/******************************************************************************/
+/*!
+\file   LinuxMain.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+The main function of EngineTest on Linux.  It passes the arguments to WinMain
+in Main.cpp as one command line, like Windows does.
+*/
+/******************************************************************************/
+#include <windows.h>
+
+#include <string>
+
+int WINAPI WinMain(HINSTANCE instance, HINSTANCE prev, LPSTR commandLine, int show);
+
+/******************************************************************************/
+/*!
+Joins the arguments into a command line and runs the game.  There is no
+OpenGL on Linux, so the game is drawn headless unless -software or -golden
+asks for the software backend.  Use -duration seconds to quit a windowless
+run, or -replay file to quit when the replay ends.
+
+\param [in] argc
+The number of arguments.
+
+\param [in] argv
+The arguments.
+
+\return
+The value returned by WinMain.
+*/
+/******************************************************************************/
+int main(int argc, char* argv[])
+{
+  std::string commandLine;
+  bool hasBackend = false;
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string option = argv[i];
+    if (option == "-headless" || option == "-software" || option == "-golden")
+      hasBackend = true;
+
+    if (!commandLine.empty())
+      commandLine += ' ';
+    commandLine += option;
+  }
+
+  if (!hasBackend)
+    commandLine += commandLine.empty() ? "-headless" : " -headless";
+
+  return WinMain(0, 0, &commandLine[0], 0);
+}
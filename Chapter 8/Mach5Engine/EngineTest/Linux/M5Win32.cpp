@@ -0,0 +1,478 @@
+/******************************************************************************/
+/*!
+\file   M5Win32.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+The Win32, OpenGL and GLU functions from Linux/include that can't be inline,
+for building on Linux.
+
+There is only ever one window class and one window, which is all M5App
+makes.
+
+*/
+/******************************************************************************/
+#include "windows.h"
+#include "gl/glew.h"
+#include "gl/glu.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+namespace
+{
+WNDPROC s_pWinProc;     //!< The window procedure of the registered class
+RECT    s_clientRect;   //!< The size of the window
+bool    s_isWindowOpen; //!< If CreateWindow was called without DestroyWindow
+int     s_window;       //!< Its address is the handle of the window
+
+std::atomic<GLuint> s_nextName(1); //!< The next texture or buffer name to give out
+
+/******************************************************************************/
+/*!
+Multiplies a 4x4 column major matrix and a point.
+
+\param [in] pMtx
+The matrix.
+
+\param [in] pIn
+The point.
+
+\param [out] pOut
+The result.
+*/
+/******************************************************************************/
+void Transform(const GLdouble* pMtx, const GLdouble* pIn, GLdouble* pOut)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		pOut[i] = pIn[0] * pMtx[0 * 4 + i] + pIn[1] * pMtx[1 * 4 + i] +
+			pIn[2] * pMtx[2 * 4 + i] + pIn[3] * pMtx[3 * 4 + i];
+	}
+}
+/******************************************************************************/
+/*!
+Multiplies two 4x4 column major matrices.
+
+\param [in] pLeft
+The left matrix.
+
+\param [in] pRight
+The right matrix.
+
+\param [out] pOut
+The result, left times right.
+*/
+/******************************************************************************/
+void Multiply(const GLdouble* pLeft, const GLdouble* pRight, GLdouble* pOut)
+{
+	for (int col = 0; col < 4; ++col)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			pOut[col * 4 + row] = pLeft[0 * 4 + row] * pRight[col * 4 + 0] +
+				pLeft[1 * 4 + row] * pRight[col * 4 + 1] +
+				pLeft[2 * 4 + row] * pRight[col * 4 + 2] +
+				pLeft[3 * 4 + row] * pRight[col * 4 + 3];
+		}
+	}
+}
+/******************************************************************************/
+/*!
+Inverts a 4x4 matrix with Gauss-Jordan elimination.
+
+\param [in] pMtx
+The matrix.
+
+\param [out] pOut
+The inverse.
+
+\return
+False if the matrix can't be inverted.
+*/
+/******************************************************************************/
+bool Invert(const GLdouble* pMtx, GLdouble* pOut)
+{
+	GLdouble work[4][8];
+	for (int row = 0; row < 4; ++row)
+	{
+		for (int col = 0; col < 4; ++col)
+		{
+			work[row][col] = pMtx[col * 4 + row];
+			work[row][col + 4] = (row == col) ? 1.0 : 0.0;
+		}
+	}
+
+	for (int col = 0; col < 4; ++col)
+	{
+		/*Use the biggest pivot to keep the error down*/
+		int pivot = col;
+		for (int row = col + 1; row < 4; ++row)
+		{
+			if (std::abs(work[row][col]) > std::abs(work[pivot][col]))
+				pivot = row;
+		}
+		if (work[pivot][col] == 0.0)
+			return false;
+
+		for (int i = 0; i < 8; ++i)
+			std::swap(work[col][i], work[pivot][i]);
+
+		GLdouble scale = 1.0 / work[col][col];
+		for (int i = 0; i < 8; ++i)
+			work[col][i] *= scale;
+
+		for (int row = 0; row < 4; ++row)
+		{
+			if (row == col)
+				continue;
+			GLdouble factor = work[row][col];
+			for (int i = 0; i < 8; ++i)
+				work[row][i] -= factor * work[col][i];
+		}
+	}
+
+	for (int row = 0; row < 4; ++row)
+	{
+		for (int col = 0; col < 4; ++col)
+			pOut[col * 4 + row] = work[row][col + 4];
+	}
+	return true;
+}
+
+}//end unnamed namespace
+
+/******************************************************************************/
+/*!
+Saves the window procedure of the class.
+
+\param [in] pClass
+The class to register.
+
+\return
+TRUE.
+*/
+/******************************************************************************/
+BOOL RegisterClass(const WNDCLASS* pClass)
+{
+	s_pWinProc = pClass->lpfnWndProc;
+	return TRUE;
+}
+/******************************************************************************/
+/*!
+Forgets the window procedure of the class.
+
+\return
+TRUE.
+*/
+/******************************************************************************/
+BOOL UnregisterClass(LPCSTR /*className*/, HINSTANCE /*instance*/)
+{
+	s_pWinProc = 0;
+	return TRUE;
+}
+/******************************************************************************/
+/*!
+Makes the window and sends it WM_CREATE, the way Windows does before
+CreateWindow returns.
+
+\param [in] width
+The width of the window.
+
+\param [in] height
+The height of the window.
+
+\return
+The window.
+*/
+/******************************************************************************/
+HWND CreateWindow(LPCSTR /*className*/, LPCSTR /*title*/, DWORD /*style*/, int /*x*/, int /*y*/,
+	int width, int height, HWND /*parent*/, HMENU /*menu*/, HINSTANCE /*instance*/, void* /*pParam*/)
+{
+	HWND window = &s_window;
+	s_clientRect.left = 0;
+	s_clientRect.top = 0;
+	s_clientRect.right = width;
+	s_clientRect.bottom = height;
+	s_isWindowOpen = true;
+	if (s_pWinProc)
+		s_pWinProc(window, WM_CREATE, 0, 0);
+	return window;
+}
+/******************************************************************************/
+/*!
+Sends WM_DESTROY and closes the window.
+
+\param [in] window
+The window.
+
+\return
+TRUE if the window was open.
+*/
+/******************************************************************************/
+BOOL DestroyWindow(HWND window)
+{
+	if (!s_isWindowOpen)
+		return FALSE;
+
+	s_isWindowOpen = false;
+	if (s_pWinProc)
+		s_pWinProc(window, WM_DESTROY, 0, 0);
+	return TRUE;
+}
+/******************************************************************************/
+/*!
+Calls the window procedure with a message and waits for it to finish.
+
+\return
+The result of the window procedure, or 0 if the window is closed.
+*/
+/******************************************************************************/
+LRESULT SendMessage(HWND window, UINT msg, WPARAM wp, LPARAM lp)
+{
+	if (!s_isWindowOpen || !s_pWinProc)
+		return 0;
+	return s_pWinProc(window, msg, wp, lp);
+}
+/******************************************************************************/
+/*!
+Gets the size of the window.
+
+\param [out] pRect
+The size, starting at 0, 0.
+
+\return
+TRUE.
+*/
+/******************************************************************************/
+BOOL GetClientRect(HWND /*window*/, RECT* pRect)
+{
+	*pRect = s_clientRect;
+	return TRUE;
+}
+/******************************************************************************/
+/*!
+Changes the size of the window and sends WM_SIZE.
+
+\param [in] window
+The window.
+
+\param [in] width
+The new width.
+
+\param [in] height
+The new height.
+
+\return
+TRUE.
+*/
+/******************************************************************************/
+BOOL MoveWindow(HWND window, int /*x*/, int /*y*/, int width, int height, BOOL /*repaint*/)
+{
+	s_clientRect.right = width;
+	s_clientRect.bottom = height;
+	SendMessage(window, WM_SIZE, 0, 0);
+	return TRUE;
+}
+/******************************************************************************/
+/*!
+Prints a message box to stderr.  There is nobody to ask, so the answer is
+always yes, which makes asserts break.
+
+\return
+IDYES.
+*/
+/******************************************************************************/
+int MessageBox(HWND /*window*/, LPCSTR text, LPCSTR caption, UINT /*type*/)
+{
+	std::fprintf(stderr, "%s\n%s\n", caption, text);
+	std::fflush(stderr);
+	return IDYES;
+}
+/******************************************************************************/
+/*!
+Stops in the debugger.  Without one the process ends.
+*/
+/******************************************************************************/
+void DebugBreak(void)
+{
+	std::raise(SIGTRAP);
+}
+/******************************************************************************/
+/*!
+Exits without running destructors.
+
+\param [in] exitCode
+The exit code.
+*/
+/******************************************************************************/
+void ExitProcess(UINT exitCode)
+{
+	std::_Exit(static_cast<int>(exitCode));
+}
+/******************************************************************************/
+/*!
+Gets the working directory.
+
+\param [in] size
+The size of buffer.
+
+\param [out] buffer
+The place to copy the directory to.
+
+\return
+The length of the directory, or 0 if it didn't fit.
+*/
+/******************************************************************************/
+DWORD GetCurrentDirectory(DWORD size, LPSTR buffer)
+{
+	if (!getcwd(buffer, size))
+		return 0;
+	return static_cast<DWORD>(std::strlen(buffer));
+}
+/******************************************************************************/
+/*!
+Gets the time from a steady clock.
+
+\param [out] pCount
+The time in nanoseconds.
+
+\return
+TRUE.
+*/
+/******************************************************************************/
+BOOL QueryPerformanceCounter(LARGE_INTEGER* pCount)
+{
+	pCount->QuadPart = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+	return TRUE;
+}
+/******************************************************************************/
+/*!
+Gets the ticks per second of QueryPerformanceCounter.
+
+\param [out] pFrequency
+One billion, since the counter is in nanoseconds.
+
+\return
+TRUE.
+*/
+/******************************************************************************/
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* pFrequency)
+{
+	pFrequency->QuadPart = 1000000000;
+	return TRUE;
+}
+/******************************************************************************/
+/*!
+Sleeps the thread.
+
+\param [in] milliseconds
+The time to sleep.
+*/
+/******************************************************************************/
+void Sleep(DWORD milliseconds)
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+/******************************************************************************/
+/*!
+Hands out texture names.  Names are never given out twice.
+
+\param [in] count
+The number of names.
+
+\param [out] pTextures
+The names.
+*/
+/******************************************************************************/
+void glGenTextures(GLsizei count, GLuint* pTextures)
+{
+	for (GLsizei i = 0; i < count; ++i)
+		pTextures[i] = s_nextName++;
+}
+/******************************************************************************/
+/*!
+Hands out buffer names.  Names are never given out twice.
+
+\param [in] count
+The number of names.
+
+\param [out] pBuffers
+The names.
+*/
+/******************************************************************************/
+void glGenBuffers(GLsizei count, GLuint* pBuffers)
+{
+	for (GLsizei i = 0; i < count; ++i)
+		pBuffers[i] = s_nextName++;
+}
+/******************************************************************************/
+/*!
+Maps a point in the world to the window, the same way GLU does.
+
+\return
+GL_TRUE, or GL_FALSE if the point is on the camera plane.
+*/
+/******************************************************************************/
+GLint gluProject(GLdouble objX, GLdouble objY, GLdouble objZ, const GLdouble* pModel,
+	const GLdouble* pProj, const GLint* pView, GLdouble* pWinX, GLdouble* pWinY, GLdouble* pWinZ)
+{
+	GLdouble point[4] = { objX, objY, objZ, 1.0 };
+	GLdouble eye[4];
+	GLdouble clip[4];
+	Transform(pModel, point, eye);
+	Transform(pProj, eye, clip);
+	if (clip[3] == 0.0)
+		return 0;
+
+	/*Clip space to 0 to 1*/
+	for (int i = 0; i < 3; ++i)
+		clip[i] = clip[i] / clip[3] * 0.5 + 0.5;
+
+	*pWinX = clip[0] * pView[2] + pView[0];
+	*pWinY = clip[1] * pView[3] + pView[1];
+	*pWinZ = clip[2];
+	return 1;
+}
+/******************************************************************************/
+/*!
+Maps a point in the window back to the world, the same way GLU does.
+
+\return
+GL_TRUE, or GL_FALSE if the matrices can't be inverted.
+*/
+/******************************************************************************/
+GLint gluUnProject(GLdouble winX, GLdouble winY, GLdouble winZ, const GLdouble* pModel,
+	const GLdouble* pProj, const GLint* pView, GLdouble* pObjX, GLdouble* pObjY, GLdouble* pObjZ)
+{
+	GLdouble both[16];
+	GLdouble inverse[16];
+	Multiply(pProj, pModel, both);
+	if (!Invert(both, inverse))
+		return 0;
+
+	/*Window to -1 to 1*/
+	GLdouble point[4] = {
+		(winX - pView[0]) / pView[2] * 2.0 - 1.0,
+		(winY - pView[1]) / pView[3] * 2.0 - 1.0,
+		winZ * 2.0 - 1.0,
+		1.0 };
+	GLdouble obj[4];
+	Transform(inverse, point, obj);
+	if (obj[3] == 0.0)
+		return 0;
+
+	*pObjX = obj[0] / obj[3];
+	*pObjY = obj[1] / obj[3];
+	*pObjZ = obj[2] / obj[3];
+	return 1;
+}
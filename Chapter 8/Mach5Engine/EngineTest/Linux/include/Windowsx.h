@@ -0,0 +1,22 @@
+/******************************************************************************/
+/*!
+\file   Windowsx.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+The message cracking macros the engine uses, for building on Linux.
+
+*/
+/******************************************************************************/
+#ifndef M5_LINUX_WINDOWSX_H
+#define M5_LINUX_WINDOWSX_H
+
+#include "windows.h"
+
+#define GET_X_LPARAM(lp) ((int)(short)((lp) & 0xffff))
+#define GET_Y_LPARAM(lp) ((int)(short)(((lp) >> 16) & 0xffff))
+#define GET_WHEEL_DELTA_WPARAM(wp) ((short)(((wp) >> 16) & 0xffff))
+
+#endif //M5_LINUX_WINDOWSX_H
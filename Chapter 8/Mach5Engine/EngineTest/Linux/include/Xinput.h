@@ -0,0 +1,59 @@
+/******************************************************************************/
+/*!
+\file   Xinput.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+The XInput game pad API, for building on Linux.  No game pad is ever
+connected.
+
+*/
+/******************************************************************************/
+#ifndef M5_LINUX_XINPUT_H
+#define M5_LINUX_XINPUT_H
+
+#include "windows.h"
+
+#define XINPUT_GAMEPAD_DPAD_UP          0x0001
+#define XINPUT_GAMEPAD_DPAD_DOWN        0x0002
+#define XINPUT_GAMEPAD_DPAD_LEFT        0x0004
+#define XINPUT_GAMEPAD_DPAD_RIGHT       0x0008
+#define XINPUT_GAMEPAD_START            0x0010
+#define XINPUT_GAMEPAD_BACK             0x0020
+#define XINPUT_GAMEPAD_LEFT_THUMB       0x0040
+#define XINPUT_GAMEPAD_RIGHT_THUMB      0x0080
+#define XINPUT_GAMEPAD_LEFT_SHOULDER    0x0100
+#define XINPUT_GAMEPAD_RIGHT_SHOULDER   0x0200
+#define XINPUT_GAMEPAD_A                0x1000
+#define XINPUT_GAMEPAD_B                0x2000
+#define XINPUT_GAMEPAD_X                0x4000
+#define XINPUT_GAMEPAD_Y                0x8000
+
+#define XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE  7849
+#define XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE 8689
+#define XINPUT_GAMEPAD_TRIGGER_THRESHOLD    30
+
+#define ERROR_DEVICE_NOT_CONNECTED 1167
+
+struct XINPUT_GAMEPAD
+{
+	WORD  wButtons;
+	BYTE  bLeftTrigger;
+	BYTE  bRightTrigger;
+	short sThumbLX;
+	short sThumbLY;
+	short sThumbRX;
+	short sThumbRY;
+};
+
+struct XINPUT_STATE
+{
+	DWORD          dwPacketNumber;
+	XINPUT_GAMEPAD Gamepad;
+};
+
+inline DWORD XInputGetState(DWORD, XINPUT_STATE*) { return ERROR_DEVICE_NOT_CONNECTED; }
+
+#endif //M5_LINUX_XINPUT_H
@@ -0,0 +1,28 @@
+/******************************************************************************/
+/*!
+\file   crtdbg.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+The debug heap functions the engine uses, for building on Linux.  They do
+nothing.  M5Memory still reports leaks of tagged allocations, and
+-fsanitize=address finds the rest.
+
+*/
+/******************************************************************************/
+#ifndef M5_LINUX_CRTDBG_H
+#define M5_LINUX_CRTDBG_H
+
+#define _CRTDBG_ALLOC_MEM_DF  0x01
+#define _CRTDBG_LEAK_CHECK_DF 0x20
+#define _CRTDBG_MODE_DEBUG    0x2
+#define _CRT_WARN             0
+#define _CRT_ERROR            1
+
+inline int _CrtSetDbgFlag(int flag) { return flag; }
+inline int _CrtSetReportMode(int, int mode) { return mode; }
+inline long _CrtSetBreakAlloc(long alloc) { return alloc; }
+
+#endif //M5_LINUX_CRTDBG_H
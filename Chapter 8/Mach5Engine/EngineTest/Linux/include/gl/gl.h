@@ -0,0 +1,91 @@
+/******************************************************************************/
+/*!
+\file   gl.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+The part of OpenGL 1.1 the engine uses, for building on Linux.  Every call
+does nothing, except that names are still handed out so the engine can tell
+textures and buffers apart.
+
+*/
+/******************************************************************************/
+#ifndef M5_LINUX_GL_H
+#define M5_LINUX_GL_H
+
+typedef unsigned int   GLenum;
+typedef unsigned int   GLbitfield;
+typedef unsigned int   GLuint;
+typedef int            GLint;
+typedef int            GLsizei;
+typedef unsigned char  GLubyte;
+typedef unsigned char  GLboolean;
+typedef float          GLfloat;
+typedef double         GLdouble;
+typedef double         GLclampd;
+typedef float          GLclampf;
+typedef void           GLvoid;
+
+#define GL_TRIANGLES              0x0004
+#define GL_LEQUAL                 0x0203
+#define GL_SRC_ALPHA              0x0302
+#define GL_ONE_MINUS_SRC_ALPHA    0x0303
+#define GL_FRONT                  0x0404
+#define GL_DEPTH_TEST             0x0B71
+#define GL_BLEND                  0x0BE2
+#define GL_TEXTURE_2D             0x0DE1
+#define GL_UNSIGNED_BYTE          0x1401
+#define GL_FLOAT                  0x1406
+#define GL_MODELVIEW              0x1700
+#define GL_PROJECTION             0x1701
+#define GL_TEXTURE                0x1702
+#define GL_RGB                    0x1907
+#define GL_RGBA                   0x1908
+#define GL_FILL                   0x1B02
+#define GL_LINEAR                 0x2601
+#define GL_TEXTURE_MAG_FILTER     0x2800
+#define GL_TEXTURE_MIN_FILTER     0x2801
+#define GL_TEXTURE_WRAP_S         0x2802
+#define GL_TEXTURE_WRAP_T         0x2803
+#define GL_CLAMP                  0x2900
+#define GL_VERTEX_ARRAY           0x8074
+#define GL_COLOR_ARRAY            0x8076
+#define GL_TEXTURE_COORD_ARRAY    0x8078
+#define GL_DEPTH_BUFFER_BIT       0x00000100
+#define GL_COLOR_BUFFER_BIT       0x00004000
+
+//Hands out texture names that were never used
+void glGenTextures(GLsizei count, GLuint* pTextures);
+
+inline void glDeleteTextures(GLsizei, const GLuint*) {}
+inline void glBindTexture(GLenum, GLuint) {}
+inline void glTexParameteri(GLenum, GLenum, GLint) {}
+inline void glTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*) {}
+inline void glEnable(GLenum) {}
+inline void glDisable(GLenum) {}
+inline void glBlendFunc(GLenum, GLenum) {}
+inline void glDepthFunc(GLenum) {}
+inline void glPolygonMode(GLenum, GLenum) {}
+inline void glClear(GLbitfield) {}
+inline void glClearColor(GLclampf, GLclampf, GLclampf, GLclampf) {}
+inline void glClearDepth(GLclampd) {}
+inline void glViewport(GLint, GLint, GLsizei, GLsizei) {}
+inline void glMatrixMode(GLenum) {}
+inline void glLoadIdentity(void) {}
+inline void glLoadMatrixf(const GLfloat*) {}
+inline void glLoadMatrixd(const GLdouble*) {}
+inline void glMultMatrixf(const GLfloat*) {}
+inline void glPushMatrix(void) {}
+inline void glPopMatrix(void) {}
+inline void glEnableClientState(GLenum) {}
+inline void glDisableClientState(GLenum) {}
+inline void glVertexPointer(GLint, GLenum, GLsizei, const GLvoid*) {}
+inline void glTexCoordPointer(GLint, GLenum, GLsizei, const GLvoid*) {}
+inline void glColorPointer(GLint, GLenum, GLsizei, const GLvoid*) {}
+inline void glColor4ubv(const GLubyte*) {}
+inline void glDrawArrays(GLenum, GLint, GLsizei) {}
+inline void glFinish(void) {}
+
+#endif //M5_LINUX_GL_H
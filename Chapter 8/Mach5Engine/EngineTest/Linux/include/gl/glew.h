@@ -0,0 +1,34 @@
+/******************************************************************************/
+/*!
+\file   glew.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+The buffer object functions the engine gets from GLEW, for building on Linux.
+Like gl.h, every call does nothing but hand out names.
+
+*/
+/******************************************************************************/
+#ifndef M5_LINUX_GLEW_H
+#define M5_LINUX_GLEW_H
+
+#include "gl.h"
+#include <cstddef>
+
+typedef std::ptrdiff_t GLsizeiptr;
+
+#define GLEW_OK         0
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_STATIC_DRAW  0x88E4
+
+//Hands out buffer names that were never used
+void glGenBuffers(GLsizei count, GLuint* pBuffers);
+
+inline GLenum glewInit(void) { return GLEW_OK; }
+inline void glDeleteBuffers(GLsizei, const GLuint*) {}
+inline void glBindBuffer(GLenum, GLuint) {}
+inline void glBufferData(GLenum, GLsizeiptr, const GLvoid*, GLenum) {}
+
+#endif //M5_LINUX_GLEW_H
@@ -0,0 +1,32 @@
+/******************************************************************************/
+/*!
+\file   glu.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+The GLU functions the engine uses, for building on Linux.  gluProject and
+gluUnProject do the real math, since M5Gfx uses them to find the world
+extents for culling and OutsideViewKillComponent.  The rest do nothing.
+
+*/
+/******************************************************************************/
+#ifndef M5_LINUX_GLU_H
+#define M5_LINUX_GLU_H
+
+#include "gl.h"
+
+//Maps a point in the world to the window
+GLint gluProject(GLdouble objX, GLdouble objY, GLdouble objZ, const GLdouble* pModel,
+	const GLdouble* pProj, const GLint* pView, GLdouble* pWinX, GLdouble* pWinY, GLdouble* pWinZ);
+//Maps a point in the window back to the world
+GLint gluUnProject(GLdouble winX, GLdouble winY, GLdouble winZ, const GLdouble* pModel,
+	const GLdouble* pProj, const GLint* pView, GLdouble* pObjX, GLdouble* pObjY, GLdouble* pObjZ);
+
+inline void gluOrtho2D(GLdouble, GLdouble, GLdouble, GLdouble) {}
+inline void gluPerspective(GLdouble, GLdouble, GLdouble, GLdouble) {}
+inline void gluLookAt(GLdouble, GLdouble, GLdouble, GLdouble, GLdouble, GLdouble,
+	GLdouble, GLdouble, GLdouble) {}
+
+#endif //M5_LINUX_GLU_H
@@ -0,0 +1,377 @@
+/******************************************************************************/
+/*!
+\file   windows.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+The part of the Win32 API the engine uses, for building on Linux.  There is
+no real window.  CreateWindow calls the window procedure with WM_CREATE and
+DestroyWindow with WM_DESTROY, so M5App starts and stops graphics the same
+way it does on Windows, but no input messages ever arrive.  Drawing only
+works with the null and software backends, OpenGL calls do nothing.
+
+*/
+/******************************************************************************/
+#ifndef M5_LINUX_WINDOWS_H
+#define M5_LINUX_WINDOWS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+/*Types************************************************************************/
+typedef int            BOOL;
+typedef unsigned char  BYTE;
+typedef unsigned short WORD;
+typedef unsigned int   DWORD;
+typedef unsigned int   UINT;
+typedef int            LONG;
+typedef char           CHAR;
+typedef char*          LPSTR;
+typedef const char*    LPCSTR;
+typedef uintptr_t      WPARAM;
+typedef intptr_t       LPARAM;
+typedef intptr_t       LRESULT;
+typedef void*          HANDLE;
+typedef void*          HWND;
+typedef void*          HDC;
+typedef void*          HGLRC;
+typedef void*          HINSTANCE;
+typedef void*          HFONT;
+typedef void*          HBRUSH;
+typedef void*          HICON;
+typedef void*          HCURSOR;
+typedef void*          HMENU;
+typedef void*          HGDIOBJ;
+
+#define WINAPI
+#define CALLBACK
+#define FALSE 0
+#define TRUE  1
+#define MAKEWORD(low, high) ((WORD)(((BYTE)(low)) | (((WORD)((BYTE)(high))) << 8)))
+#define ZeroMemory(pDest, size) std::memset((pDest), 0, (size))
+
+typedef LRESULT(CALLBACK* WNDPROC)(HWND, UINT, WPARAM, LPARAM);
+
+union LARGE_INTEGER
+{
+	struct
+	{
+		DWORD LowPart;
+		LONG  HighPart;
+	};
+	long long QuadPart;
+};
+
+struct RECT
+{
+	LONG left;
+	LONG top;
+	LONG right;
+	LONG bottom;
+};
+
+struct POINT
+{
+	LONG x;
+	LONG y;
+};
+
+struct MSG
+{
+	HWND   hwnd;
+	UINT   message;
+	WPARAM wParam;
+	LPARAM lParam;
+	DWORD  time;
+	POINT  pt;
+};
+
+struct WNDCLASS
+{
+	UINT      style;
+	WNDPROC   lpfnWndProc;
+	int       cbClsExtra;
+	int       cbWndExtra;
+	HINSTANCE hInstance;
+	HICON     hIcon;
+	HCURSOR   hCursor;
+	HBRUSH    hbrBackground;
+	LPCSTR    lpszMenuName;
+	LPCSTR    lpszClassName;
+};
+
+struct DEVMODE
+{
+	WORD  dmSize;
+	DWORD dmFields;
+	DWORD dmBitsPerPel;
+	DWORD dmPelsWidth;
+	DWORD dmPelsHeight;
+};
+
+struct PIXELFORMATDESCRIPTOR
+{
+	WORD  nSize;
+	WORD  nVersion;
+	DWORD dwFlags;
+	BYTE  iPixelType;
+	BYTE  cColorBits;
+	BYTE  cDepthBits;
+	BYTE  cStencilBits;
+	BYTE  iLayerType;
+};
+
+struct BITMAPINFOHEADER
+{
+	DWORD biSize;
+	LONG  biWidth;
+	LONG  biHeight;
+	WORD  biPlanes;
+	WORD  biBitCount;
+	DWORD biCompression;
+	DWORD biSizeImage;
+	LONG  biXPelsPerMeter;
+	LONG  biYPelsPerMeter;
+	DWORD biClrUsed;
+	DWORD biClrImportant;
+};
+
+struct BITMAPINFO
+{
+	BITMAPINFOHEADER bmiHeader;
+	DWORD            bmiColors[1];
+};
+
+struct COORD
+{
+	short X;
+	short Y;
+};
+
+struct CONSOLE_SCREEN_BUFFER_INFO
+{
+	COORD dwSize;
+	COORD dwCursorPosition;
+	WORD  wAttributes;
+};
+
+/*Constants********************************************************************/
+#define WM_CREATE        0x0001
+#define WM_DESTROY       0x0002
+#define WM_SIZE          0x0005
+#define WM_CLOSE         0x0010
+#define WM_QUIT          0x0012
+#define WM_KEYFIRST      0x0100
+#define WM_KEYDOWN       0x0100
+#define WM_KEYUP         0x0101
+#define WM_KEYLAST       0x0109
+#define WM_MOUSEFIRST    0x0200
+#define WM_MOUSEMOVE     0x0200
+#define WM_LBUTTONDOWN   0x0201
+#define WM_LBUTTONUP     0x0202
+#define WM_RBUTTONDOWN   0x0204
+#define WM_RBUTTONUP     0x0205
+#define WM_MBUTTONDOWN   0x0207
+#define WM_MBUTTONUP     0x0208
+#define WM_MOUSEWHEEL    0x020A
+#define WM_MOUSELAST     0x020E
+
+#define VK_BACK     0x08
+#define VK_TAB      0x09
+#define VK_RETURN   0x0D
+#define VK_SHIFT    0x10
+#define VK_CONTROL  0x11
+#define VK_ESCAPE   0x1B
+#define VK_SPACE    0x20
+#define VK_LEFT     0x25
+#define VK_UP       0x26
+#define VK_RIGHT    0x27
+#define VK_DOWN     0x28
+#define VK_F1       0x70
+#define VK_F2       0x71
+#define VK_F3       0x72
+#define VK_F4       0x73
+#define VK_F5       0x74
+#define VK_F6       0x75
+#define VK_F7       0x76
+#define VK_F8       0x77
+#define VK_F9       0x78
+#define VK_F10      0x79
+#define VK_F11      0x7A
+#define VK_F12      0x7B
+#define VK_LSHIFT   0xA0
+#define VK_RSHIFT   0xA1
+#define VK_LCONTROL 0xA2
+#define VK_RCONTROL 0xA3
+
+#define WS_POPUP   0x80000000u
+#define WS_VISIBLE 0x10000000u
+#define WS_CAPTION 0x00C00000u
+
+#define CS_VREDRAW 0x0001
+#define CS_HREDRAW 0x0002
+#define CS_OWNDC   0x0020
+
+#define SW_SHOWNORMAL 1
+#define GWL_STYLE     (-16)
+#define PM_REMOVE     0x0001
+
+#define IDI_APPLICATION ((LPCSTR)32512)
+#define IDC_ARROW       ((LPCSTR)32512)
+#define WHITE_BRUSH     0
+
+#define ENUM_CURRENT_SETTINGS  ((DWORD)-1)
+#define DM_BITSPERPEL          0x00040000
+#define DM_PELSWIDTH           0x00080000
+#define DM_PELSHEIGHT          0x00100000
+#define CDS_FULLSCREEN         0x00000004
+#define DISP_CHANGE_SUCCESSFUL 0
+#define DISP_CHANGE_FAILED     (-1)
+
+#define MB_YESNO                0x00000004
+#define MB_ICONERROR            0x00000010
+#define MB_SYSTEMMODAL          0x00001000
+#define MB_TASKMODAL            0x00002000
+#define MB_SETFOREGROUND        0x00010000
+#define MB_DEFAULT_DESKTOP_ONLY 0x00020000
+#define IDYES 6
+#define IDNO  7
+
+#define PFD_DOUBLEBUFFER   0x00000001
+#define PFD_DRAW_TO_WINDOW 0x00000004
+#define PFD_SUPPORT_OPENGL 0x00000020
+#define PFD_TYPE_RGBA      0
+
+#define FW_NORMAL           400
+#define FW_BOLD             700
+#define ANSI_CHARSET        0
+#define DEFAULT_CHARSET     1
+#define OUT_TT_PRECIS       4
+#define CLIP_DEFAULT_PRECIS 0
+#define ANTIALIASED_QUALITY 4
+#define DEFAULT_PITCH       0
+#define FF_DONTCARE         0
+
+#define BI_RGB         0
+#define DIB_RGB_COLORS 0
+
+#define STD_OUTPUT_HANDLE ((DWORD)-11)
+#define ERROR_SUCCESS     0
+
+/*Windows**********************************************************************/
+//Saves the window procedure of a class
+BOOL RegisterClass(const WNDCLASS* pClass);
+//Forgets a class
+BOOL UnregisterClass(LPCSTR className, HINSTANCE instance);
+//Makes a window of a registered class and sends it WM_CREATE
+HWND CreateWindow(LPCSTR className, LPCSTR title, DWORD style, int x, int y,
+	int width, int height, HWND parent, HMENU menu, HINSTANCE instance, void* pParam);
+//Sends WM_DESTROY and forgets the window
+BOOL DestroyWindow(HWND window);
+//Calls the window procedure right away
+LRESULT SendMessage(HWND window, UINT msg, WPARAM wp, LPARAM lp);
+//Gets the size of the window
+BOOL GetClientRect(HWND window, RECT* pRect);
+//Resizes the window and sends WM_SIZE
+BOOL MoveWindow(HWND window, int x, int y, int width, int height, BOOL repaint);
+
+inline LRESULT DefWindowProc(HWND, UINT, WPARAM, LPARAM) { return 0; }
+inline BOOL PeekMessage(MSG*, HWND, UINT, UINT, UINT) { return FALSE; }
+inline BOOL TranslateMessage(const MSG*) { return FALSE; }
+inline LRESULT DispatchMessage(const MSG*) { return 0; }
+inline void PostQuitMessage(int) {}
+inline BOOL ShowWindow(HWND, int) { return TRUE; }
+inline BOOL UpdateWindow(HWND) { return TRUE; }
+inline BOOL SetForegroundWindow(HWND) { return TRUE; }
+inline LONG SetWindowLong(HWND, int, LONG) { return 0; }
+inline int ShowCursor(BOOL show) { return show ? 0 : -1; }
+inline HWND FindWindow(LPCSTR, LPCSTR) { return 0; }
+inline HICON LoadIcon(HINSTANCE, LPCSTR) { return 0; }
+inline HCURSOR LoadCursor(HINSTANCE, LPCSTR) { return 0; }
+inline HGDIOBJ GetStockObject(int) { return 0; }
+inline BOOL AdjustWindowRect(RECT*, DWORD, BOOL) { return TRUE; }
+//There is no display to change, so full screen always fails
+inline LONG ChangeDisplaySettings(DEVMODE*, DWORD) { return DISP_CHANGE_FAILED; }
+//Reports a 1920x1080 display
+inline BOOL EnumDisplaySettings(LPCSTR, DWORD, DEVMODE* pMode)
+{
+	pMode->dmBitsPerPel = 32;
+	pMode->dmPelsWidth = 1920;
+	pMode->dmPelsHeight = 1080;
+	return TRUE;
+}
+
+/*GDI and WGL******************************************************************/
+inline HDC GetDC(HWND window) { return window; }
+inline int ReleaseDC(HWND, HDC) { return 1; }
+inline int ChoosePixelFormat(HDC, const PIXELFORMATDESCRIPTOR*) { return 1; }
+inline BOOL SetPixelFormat(HDC, int, const PIXELFORMATDESCRIPTOR*) { return TRUE; }
+inline BOOL SwapBuffers(HDC) { return TRUE; }
+inline HFONT CreateFont(int, int, int, int, int, DWORD, DWORD, DWORD, DWORD, DWORD,
+	DWORD, DWORD, DWORD, LPCSTR) { return 0; }
+inline HGDIOBJ SelectObject(HDC, HGDIOBJ) { return 0; }
+inline BOOL DeleteObject(HGDIOBJ) { return TRUE; }
+inline int SetDIBitsToDevice(HDC, int, int, DWORD, DWORD, int, int, UINT, UINT,
+	const void*, const BITMAPINFO*, UINT) { return 0; }
+inline HGLRC wglCreateContext(HDC dc) { return dc; }
+inline BOOL wglDeleteContext(HGLRC) { return TRUE; }
+inline BOOL wglMakeCurrent(HDC, HGLRC) { return TRUE; }
+inline BOOL wglShareLists(HGLRC, HGLRC) { return TRUE; }
+inline BOOL wglUseFontBitmaps(HDC, DWORD, DWORD, DWORD) { return TRUE; }
+
+/*Console and debugging********************************************************/
+//Prints the message to stderr and answers yes, so asserts break
+int MessageBox(HWND window, LPCSTR text, LPCSTR caption, UINT type);
+#define MessageBoxA MessageBox
+//Stops in the debugger with SIGTRAP
+void DebugBreak(void);
+//Exits without running destructors
+void ExitProcess(UINT exitCode);
+//Gets the working directory
+DWORD GetCurrentDirectory(DWORD size, LPSTR buffer);
+
+inline BOOL AllocConsole(void) { return TRUE; }
+inline BOOL FreeConsole(void) { return TRUE; }
+inline BOOL SetConsoleTitle(LPCSTR) { return TRUE; }
+inline HANDLE GetStdHandle(DWORD) { return 0; }
+inline BOOL GetConsoleScreenBufferInfo(HANDLE, CONSOLE_SCREEN_BUFFER_INFO* pInfo)
+{
+	std::memset(pInfo, 0, sizeof(*pInfo));
+	return FALSE;
+}
+inline BOOL FillConsoleOutputCharacter(HANDLE, CHAR, DWORD, COORD, DWORD*) { return FALSE; }
+inline BOOL FillConsoleOutputAttribute(HANDLE, WORD, DWORD, COORD, DWORD*) { return FALSE; }
+inline BOOL SetConsoleCursorPosition(HANDLE, COORD) { return FALSE; }
+inline BOOL SetConsoleTextAttribute(HANDLE, WORD) { return FALSE; }
+
+/*Timing***********************************************************************/
+//Gets a monotonic time in nanoseconds
+BOOL QueryPerformanceCounter(LARGE_INTEGER* pCount);
+//The counter is in nanoseconds
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* pFrequency);
+//Sleeps the thread
+void Sleep(DWORD milliseconds);
+
+/*C runtime********************************************************************/
+inline int fopen_s(FILE** ppFile, const char* fileName, const char* mode)
+{
+	*ppFile = std::fopen(fileName, mode);
+	return *ppFile ? 0 : 1;
+}
+inline int freopen_s(FILE** ppFile, const char* fileName, const char* mode, FILE* pStream)
+{
+	/*There is no console to open, stdout already goes to the terminal*/
+	if (std::strcmp(fileName, "CONOUT$") == 0)
+	{
+		*ppFile = pStream;
+		return 0;
+	}
+	*ppFile = std::freopen(fileName, mode, pStream);
+	return *ppFile ? 0 : 1;
+}
+
+#endif //M5_LINUX_WINDOWS_H
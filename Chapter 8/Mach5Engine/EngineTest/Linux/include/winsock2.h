@@ -0,0 +1,71 @@
+/******************************************************************************/
+/*!
+\file   winsock2.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+The part of Winsock the engine uses, for building on Linux.  These are real
+sockets.  Each Winsock call is mapped to the BSD socket call it came from.
+
+*/
+/******************************************************************************/
+#ifndef M5_LINUX_WINSOCK2_H
+#define M5_LINUX_WINSOCK2_H
+
+#include "windows.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef int           SOCKET;
+typedef unsigned long u_long;
+
+#define INVALID_SOCKET  (-1)
+#define SOCKET_ERROR    (-1)
+#define WSAECONNRESET   ECONNRESET
+#define WSAEMSGSIZE     EMSGSIZE
+#define WSAEWOULDBLOCK  EWOULDBLOCK
+
+struct WSADATA
+{
+	WORD wVersion;
+	WORD wHighVersion;
+};
+
+inline int WSAStartup(WORD version, WSADATA* pData)
+{
+	pData->wVersion = version;
+	pData->wHighVersion = version;
+	return 0;
+}
+inline int WSACleanup(void) { return 0; }
+inline int WSAGetLastError(void) { return errno; }
+inline int closesocket(SOCKET handle) { return close(handle); }
+inline int ioctlsocket(SOCKET handle, long command, u_long* pArg)
+{
+	int arg = static_cast<int>(*pArg);
+	return ioctl(handle, command, &arg);
+}
+/*Winsock uses int for address sizes where BSD uses socklen_t*/
+inline int getsockname(SOCKET handle, sockaddr* pAddress, int* pSize)
+{
+	socklen_t size = static_cast<socklen_t>(*pSize);
+	int result = getsockname(handle, pAddress, &size);
+	*pSize = static_cast<int>(size);
+	return result;
+}
+inline int recvfrom(SOCKET handle, char* pData, int size, int flags, sockaddr* pFrom, int* pFromSize)
+{
+	socklen_t fromSize = static_cast<socklen_t>(*pFromSize);
+	int result = static_cast<int>(recvfrom(handle, pData, static_cast<size_t>(size), flags, pFrom, &fromSize));
+	*pFromSize = static_cast<int>(fromSize);
+	return result;
+}
+
+#endif //M5_LINUX_WINSOCK2_H
@@ -0,0 +1,19 @@
+/******************************************************************************/
+/*!
+\file   ws2tcpip.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/03
+
+inet_pton, for building on Linux.  It comes from arpa/inet.h through
+winsock2.h.
+
+*/
+/******************************************************************************/
+#ifndef M5_LINUX_WS2TCPIP_H
+#define M5_LINUX_WS2TCPIP_H
+
+#include "winsock2.h"
+
+#endif //M5_LINUX_WS2TCPIP_H
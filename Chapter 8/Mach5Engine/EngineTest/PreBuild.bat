@@ -80,9 +80,9 @@ echo */ >> %SOURCE%
 echo /******************************************************************************/ >> %SOURCE%
 ::Add includes
 echo #include "RegisterStages.h" >> %SOURCE%
-echo #include "Core\M5StageManager.h" >> %SOURCE%
-echo #include "Core\M5StageTypes.h" >> %SOURCE%
-echo #include "Core\M5StageBuilder.h" >> %SOURCE%
+echo #include "Core/M5StageManager.h" >> %SOURCE%
+echo #include "Core/M5StageTypes.h" >> %SOURCE%
+echo #include "Core/M5StageBuilder.h" >> %SOURCE%
 
 ::Include all Stage header files
 for %%f in ( *Stage.h ) do (
@@ -99,8 +99,8 @@ for %%f in ( *Stage.h ) do (
 echo } >> %SOURCE%
 goto:eof
 ::******************************************************************************
-::Auto generates the RegisterComponents.h files which registers all user 
-::created components with the ObjectManager
+::Auto generates the RegisterComponents.h files which make a table of builders
+::for all user created components, indexed by M5ComponentTypes
 ::******************************************************************************
 :CreateRegisterComponent
 ::Create output file
@@ -116,14 +116,15 @@ echo \par    Mach5 Game Engine >> %HEADER%
 echo. >> %HEADER%
 echo This file gets auto generated based on the names of the Components in the >> %HEADER%
 echo Include folder and current project.  PreBuild.bat looks for files named *Component.h >> %HEADER%
-echo and registers those with the ObjectManager. >> %HEADER%
+echo and makes a table of their builders for the ObjectManager. >> %HEADER%
 echo */ >> %HEADER%
 echo /******************************************************************************/ >> %HEADER%
 ::Add Code Guards
 echo #ifndef REGISTER_COMPONENTS_H >> %HEADER%
 echo #define REGISTER_COMPONENTS_H >> %HEADER%
 echo. >> %HEADER%
-echo void RegisterComponents(void); >> %HEADER%
+echo struct M5ComponentBuilder; >> %HEADER%
+echo const M5ComponentBuilder* GetComponentBuilders^(void^); >> %HEADER%
 echo #endif //REGISTER_COMPONENTS_H >> %HEADER%
 
 
@@ -137,16 +138,16 @@ echo \par    Mach5 Game Engine >> %SOURCE%
 echo. >> %SOURCE%
 echo This file gets auto generated based on the names of the Components in the >> %SOURCE%
 echo Include folder and current project.  UserPreBuild.bat looks for files named *Component.h >> %SOURCE%
-echo and registers those with the ObjectManager. >> %SOURCE%
+echo and makes a table of their builders for the ObjectManager. >> %SOURCE%
 echo */ >> %SOURCE%
 echo /******************************************************************************/ >> %SOURCE%
 ::Add includes
-echo #include "Core\M5ObjectManager.h" >> %SOURCE%
-echo #include "Core\M5ComponentTypes.h" >> %SOURCE%
-echo #include "Core\M5ComponentBuilder.h" >> %SOURCE%
+echo #include "RegisterComponents.h" >> %SOURCE%
+echo #include "Core/M5ComponentTypes.h" >> %SOURCE%
+echo #include "Core/M5ComponentBuilder.h" >> %SOURCE%
 ::All Component header files from the Include folder
 for %%f in ( Core\*???Component.h ) do (
-  echo #include "Core\%%~nxf" >> %SOURCE%
+  echo #include "Core/%%~nxf" >> %SOURCE%
 )
 ::All Component header files from the current project
 for %%f in ( *Component.h ) do (
@@ -154,15 +155,23 @@ for %%f in ( *Component.h ) do (
 )
 echo. >> %SOURCE%
 echo. >> %SOURCE%
-echo void RegisterComponents(void) {  >> %SOURCE%
+echo namespace { >> %SOURCE%
+echo //! AutoGenerated builders in the same order as M5ComponentTypes >> %SOURCE%
+echo constexpr M5ComponentBuilder s_builders[] = { >> %SOURCE%
 ::All Component header files from the Include folder
 for %%f in ( Core\*???Component.h ) do (
-  echo  M5ObjectManager::AddComponent^(CT_%%~nf, new M5ComponentTBuilder^< %%~nf ^>^(^) ^); >> %SOURCE%
+  echo  M5MakeComponentBuilder^< %%~nf ^>^(^), >> %SOURCE%
 )
 ::All Component header files from the current project
 for %%f in ( *Component.h ) do (
-  echo  M5ObjectManager::AddComponent^(CT_%%~nf, new M5ComponentTBuilder^< %%~nf ^>^(^) ^); >> %SOURCE%
+  echo  M5MakeComponentBuilder^< %%~nf ^>^(^), >> %SOURCE%
 )
+echo }; >> %SOURCE%
+echo static_assert^(sizeof^(s_builders^) / sizeof^(s_builders[0]^) ^=^= CT_INVALID, "Run PreBuild.bat, the builders don't match M5ComponentTypes"^); >> %SOURCE%
+echo } >> %SOURCE%
+echo. >> %SOURCE%
+echo const M5ComponentBuilder* GetComponentBuilders^(void^) { >> %SOURCE%
+echo  return s_builders; >> %SOURCE%
 echo } >> %SOURCE%
 goto:eof
 ::******************************************************************************
@@ -209,8 +218,8 @@ echo and registers those with the ObjectManager. >> %SOURCE%
 echo */ >> %SOURCE%
 echo /******************************************************************************/ >> %SOURCE%
 ::Add includes
-echo #include "Core\M5ArcheTypes.h" >> %SOURCE%
-echo #include "Core\M5ObjectManager.h" >> %SOURCE%
+echo #include "Core/M5ArcheTypes.h" >> %SOURCE%
+echo #include "Core/M5ObjectManager.h" >> %SOURCE%
 echo. >> %SOURCE%
 echo. >> %SOURCE%
 
@@ -218,7 +227,7 @@ echo void RegisterArcheTypes(void) {  >> %SOURCE%
 
 ::Get all files with the name *Stage in it and output just the file name
 for %%f in ( ..\ArcheTypes\*.ini ) do (
-  echo M5ObjectManager::AddArcheType^(AT_%%~nf, "ArcheTypes\\%%~nf.ini"^); >> %SOURCE%
+  echo M5ObjectManager::AddArcheType^(AT_%%~nf, "ArcheTypes/%%~nf.ini"^); >> %SOURCE%
 )
 echo } >> %SOURCE%
 
@@ -297,6 +306,7 @@ echo /**************************************************************************
 echo #ifndef M5COMPONENT_TYPE_H >> %ENUMFILE%
 echo #define M5COMPONENT_TYPE_H >> %ENUMFILE%
 echo #include ^<string^> >> %ENUMFILE%
+echo #include "M5Hash.h" >> %ENUMFILE%
 echo. >> %ENUMFILE%
 echo. >> %ENUMFILE%
 echo //! AutoGenerated enum based on component file names  >> %ENUMFILE%
@@ -321,12 +331,14 @@ echo. >> %ENUMFILE%
 echo //! AutoGenerated function to convert strings to our M5ComponentTypes type >> %ENUMFILE%
 echo inline M5ComponentTypes StringToComponent^(const std::string^& string^) { >> %ENUMFILE%
 
+echo switch ^(M5Hash^(string.c_str^(^)^)^) { >> %ENUMFILE%
 for %%f in ( Core\*???Component.h ) do (
-  echo if^(string ^=^= "%%~nf"^) return CT_%%~nf; >> %ENUMFILE%
+  echo case M5HashLiteral^("%%~nf"^): return ^(string ^=^= "%%~nf"^) ? CT_%%~nf : CT_INVALID; >> %ENUMFILE%
 )
 for %%f in ( *Component.h ) do (
-  echo if^(string ^=^= "%%~nf"^) return CT_%%~nf; >> %ENUMFILE%
+  echo case M5HashLiteral^("%%~nf"^): return ^(string ^=^= "%%~nf"^) ? CT_%%~nf : CT_INVALID; >> %ENUMFILE%
 )
+echo } >> %ENUMFILE%
 echo return CT_INVALID; >> %ENUMFILE%
 echo } >> %ENUMFILE%
 echo #endif //M5COMPONENT_TYPE_H >> %ENUMFILE%
@@ -355,6 +367,7 @@ echo /**************************************************************************
 echo #ifndef M5ARCHE_TYPES_H >> %ENUMFILE%
 echo #define M5ARCHE_TYPES_H >> %ENUMFILE%
 echo #include ^<string^> >> %ENUMFILE%
+echo #include "M5Hash.h" >> %ENUMFILE%
 echo. >> %ENUMFILE%
 echo. >> %ENUMFILE%
 echo //! AutoGenerated enum based on archetype ini file names  >> %ENUMFILE%
@@ -375,11 +388,21 @@ echo. >> %ENUMFILE%
 echo //! AutoGenerated function to convert strings to our M5ArcheTypes type >> %ENUMFILE%
 echo inline M5ArcheTypes StringToArcheType^(const std::string^& string^) { >> %ENUMFILE%
 
+echo switch ^(M5Hash^(string.c_str^(^)^)^) { >> %ENUMFILE%
 for %%f in ( ..\ArcheTypes\*.ini ) do (
-  echo if^(string ^=^= "%%~nf"^) return AT_%%~nf; >> %ENUMFILE%
+  echo case M5HashLiteral^("%%~nf"^): return ^(string ^=^= "%%~nf"^) ? AT_%%~nf : AT_INVALID; >> %ENUMFILE%
 )
+echo } >> %ENUMFILE%
 echo return AT_INVALID; >> %ENUMFILE%
 echo } >> %ENUMFILE%
+echo. >> %ENUMFILE%
+echo //! AutoGenerated names of each M5ArcheTypes, in the same order as the enum >> %ENUMFILE%
+echo const char* const ARCHETYPE_NAMES[] = { >> %ENUMFILE%
+for %%f in ( ..\ArcheTypes\*.ini ) do (
+  echo "%%~nf", >> %ENUMFILE%
+)
+echo "INVALID" >> %ENUMFILE%
+echo }; >> %ENUMFILE%
 
 echo #endif //M5ARCHE_TYPES_H >> %ENUMFILE%
 
@@ -407,6 +430,7 @@ echo /**************************************************************************
 echo #ifndef M5COMMAND_TYPE_H >> %ENUMFILE%
 echo #define M5COMMAND_TYPE_H >> %ENUMFILE%
 echo #include ^<string^> >> %ENUMFILE%
+echo #include "M5Hash.h" >> %ENUMFILE%
 echo. >> %ENUMFILE%
 echo. >> %ENUMFILE%
 echo //! AutoGenerated enum based on command file names  >> %ENUMFILE%
@@ -431,20 +455,22 @@ echo. >> %ENUMFILE%
 echo //! AutoGenerated function to convert strings to our M5CommandTypes type >> %ENUMFILE%
 echo inline M5CommandTypes StringToCommand^(const std::string^& string^) { >> %ENUMFILE%
 
+echo switch ^(M5Hash^(string.c_str^(^)^)^) { >> %ENUMFILE%
 for %%f in ( Core\*???Command.h ) do (
-  echo if^(string ^=^= "%%~nf"^) return CMD_%%~nf; >> %ENUMFILE%
+  echo case M5HashLiteral^("%%~nf"^): return ^(string ^=^= "%%~nf"^) ? CMD_%%~nf : CMD_INVALID; >> %ENUMFILE%
 )
 for %%f in ( *Command.h ) do (
-  echo if^(string ^=^= "%%~nf"^) return CMD_%%~nf; >> %ENUMFILE%
+  echo case M5HashLiteral^("%%~nf"^): return ^(string ^=^= "%%~nf"^) ? CMD_%%~nf : CMD_INVALID; >> %ENUMFILE%
 )
+echo } >> %ENUMFILE%
 echo return CMD_INVALID; >> %ENUMFILE%
 echo } >> %ENUMFILE%
 echo #endif //M5COMMAND_TYPE_H >> %ENUMFILE%
 
 goto:eof
 ::******************************************************************************
-::Auto generates the RegisterCommands.h files which registers all user 
-::created commands with the ObjectManager
+::Auto generates the RegisterCommands.h files which make a table of builders
+::for all user created commands, indexed by M5CommandTypes
 ::******************************************************************************
 :CreateRegisterCommand
 ::Create output file
@@ -460,14 +486,15 @@ echo \par    Mach5 Game Engine >> %HEADER%
 echo. >> %HEADER%
 echo This file gets auto generated based on the names of the Commands in the >> %HEADER%
 echo Include folder and current project.  PreBuild.bat looks for files named *Command.h >> %HEADER%
-echo and registers those with the ObjectManager. >> %HEADER%
+echo and makes a table of their builders for the ObjectManager. >> %HEADER%
 echo */ >> %HEADER%
 echo /******************************************************************************/ >> %HEADER%
 ::Add Code Guards
 echo #ifndef REGISTER_COMMANDS_H >> %HEADER%
 echo #define REGISTER_COMMANDS_H >> %HEADER%
 echo. >> %HEADER%
-echo void RegisterCommands(void); >> %HEADER%
+echo #include "Core/M5Command.h" >> %HEADER%
+echo const M5CommandBuilder* GetCommandBuilders^(void^); >> %HEADER%
 echo #endif //REGISTER_COMMANDS_H >> %HEADER%
 
 
@@ -481,16 +508,15 @@ echo \par    Mach5 Game Engine >> %SOURCE%
 echo. >> %SOURCE%
 echo This file gets auto generated based on the names of the Commands in the >> %SOURCE%
 echo Include folder and current project.  PreBuild.bat looks for files named *Command.h >> %SOURCE%
-echo and registers those with the ObjectManager. >> %SOURCE%
+echo and makes a table of their builders for the ObjectManager. >> %SOURCE%
 echo */ >> %SOURCE%
 echo /******************************************************************************/ >> %SOURCE%
 ::Add includes
-echo #include "Core\M5ObjectManager.h" >> %SOURCE%
-echo #include "Core\M5CommandTypes.h" >> %SOURCE%
-echo #include "Core\M5TBuilder.h" >> %SOURCE%
+echo #include "RegisterCommands.h" >> %SOURCE%
+echo #include "Core/M5CommandTypes.h" >> %SOURCE%
 ::All Component header files from the Include folder
 for %%f in ( Core\*Command.h ) do (
-  echo #include "Core\%%~nxf" >> %SOURCE%
+  echo #include "Core/%%~nxf" >> %SOURCE%
 )
 ::All Component header files from the current project
 for %%f in ( *Command.h ) do (
@@ -498,15 +524,23 @@ for %%f in ( *Command.h ) do (
 )
 echo. >> %SOURCE%
 echo. >> %SOURCE%
-echo void RegisterCommands(void) {  >> %SOURCE%
+echo namespace { >> %SOURCE%
+echo //! AutoGenerated builders in the same order as M5CommandTypes >> %SOURCE%
+echo constexpr M5CommandBuilder s_builders[] = { >> %SOURCE%
 ::All Component header files from the Include folder
 for %%f in ( Core\*???Command.h ) do (
-  echo  M5ObjectManager::AddCommand^(CMD_%%~nf, new %%~nf^(^) ^); >> %SOURCE%
+  echo  M5BuildCommand^< %%~nf ^>, >> %SOURCE%
 )
 ::All Component header files from the current project
 for %%f in ( *???Command.h ) do (
-  echo  M5ObjectManager::AddCommand^(CMD_%%~nf, new %%~nf^(^) ^); >> %SOURCE%
+  echo  M5BuildCommand^< %%~nf ^>, >> %SOURCE%
 )
+echo }; >> %SOURCE%
+echo static_assert^(sizeof^(s_builders^) / sizeof^(s_builders[0]^) ^=^= CMD_INVALID, "Run PreBuild.bat, the builders don't match M5CommandTypes"^); >> %SOURCE%
+echo } >> %SOURCE%
+echo. >> %SOURCE%
+echo const M5CommandBuilder* GetCommandBuilders^(void^) { >> %SOURCE%
+echo  return s_builders; >> %SOURCE%
 echo } >> %SOURCE%
 goto:eof
 
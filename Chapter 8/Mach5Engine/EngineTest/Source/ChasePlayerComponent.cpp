@@ -11,12 +11,21 @@ Simple AI to Chase the Player
 /******************************************************************************/
 #include "ChasePlayerComponent.h"
 
-#include "Core\M5ObjectManager.h"
-#include "Core\M5IniFile.h"
-#include "Core\M5Object.h"
+#include "Core/M5ObjectManager.h"
+#include "Core/M5IniFile.h"
+#include "Core/M5Object.h"
+#include "Core/M5Snapshot.h"
+#include "Core/M5Vec2Batch.h"
+#include "Core/M5Math.h"
 #include <vector>
 #include <cmath>
 
+namespace
+{
+M5Vec2Buffer       s_pos;   //!< Reused so UpdateBatch doesn't allocate each frame
+M5Vec2Buffer       s_vel;   //!< Reused so UpdateBatch doesn't allocate each frame
+std::vector<float> s_speed; //!< Reused so UpdateBatch doesn't allocate each frame
+}
 
 /******************************************************************************/
 /*!
@@ -40,19 +49,61 @@ void ChasePlayerComponent::Update(float)
 	M5ObjectManager::GetAllObjectsByType(AT_Player, players);
 	M5Vec2 dir;
 	M5Vec2::Sub(dir, players[0]->pos, m_pObj->pos);
-	m_pObj->rotation = std::atan2f(dir.y, dir.x);
+	m_pObj->rotation = M5Math::Atan2(dir.y, dir.x);
 	dir.Normalize();
 	dir *= m_speed;
 	m_pObj->vel = dir;
 }
 /******************************************************************************/
 /*!
+Steers every chaser towards the player at once.  The player is only looked up
+one time, and the velocities are found four at a time.
+
+\param [in] comps
+The list of components, all of them from start on must be
+ChasePlayerComponents.
+
+\param [in] start
+The index of the first ChasePlayerComponent.
+*/
+/******************************************************************************/
+void ChasePlayerComponent::UpdateBatch(std::vector<M5Component*>& comps, size_t start, float)
+{
+	std::vector<M5Object*> players;
+	M5ObjectManager::GetAllObjectsByType(AT_Player, players);
+	M5Vec2 target = players[0]->pos;
+
+	size_t size = comps.size() - start;
+	M5Vec2Span pos = s_pos.Resize(size);
+	M5Vec2Span vel = s_vel.Resize(size);
+	s_speed.resize(size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		ChasePlayerComponent* pChase = static_cast<ChasePlayerComponent*>(comps[start + i]);
+		pos.x[i] = pChase->m_pObj->pos.x;
+		pos.y[i] = pChase->m_pObj->pos.y;
+		s_speed[i] = pChase->m_speed;
+	}
+
+	if (size)
+		M5Vec2Batch::Seek(vel, pos, target, &s_speed[0]);
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		M5Object* pObj = static_cast<ChasePlayerComponent*>(comps[start + i])->m_pObj;
+		pObj->rotation = M5Math::Atan2(target.y - pos.y[i], target.x - pos.x[i]);
+		pObj->vel.x = vel.x[i];
+		pObj->vel.y = vel.y[i];
+	}
+}
+/******************************************************************************/
+/*!
 Sets component type and starting values for player
 */
 /******************************************************************************/
 ChasePlayerComponent* ChasePlayerComponent::Clone(void) const
 {
-	ChasePlayerComponent* pNew = new ChasePlayerComponent;
+	ChasePlayerComponent* pNew = new (CT_ChasePlayerComponent) ChasePlayerComponent;
 	pNew->m_speed = m_speed;
 	return pNew;
 }
@@ -61,4 +112,27 @@ void ChasePlayerComponent::FromFile(M5IniFile& iniFile)
 	iniFile.SetToSection("ChasePlayerComponent");
 	iniFile.GetValue("speed", m_speed);
 }
+/******************************************************************************/
+/*!
+Saves the data of this component into a snapshot.
+
+\param [in] snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+void ChasePlayerComponent::Save(M5Snapshot& snapshot) const
+{
+	snapshot.Write(m_speed);
+}
+/******************************************************************************/
+/*!
+Restores the data of this component from a snapshot.
 
+\param [in] snapshot
+The snapshot to read from.
+*/
+/******************************************************************************/
+void ChasePlayerComponent::Load(M5Snapshot& snapshot)
+{
+	snapshot.Read(m_speed);
+}
@@ -13,6 +13,8 @@ Simple AI to Chase the Player
 #define CHASE_PLAYER_COMPONENT_H
 
 #include "Core/M5Component.h"
+#include "Core/M5ComponentBuilder.h"
+#include <vector>
 
 //!< Simple AI to Chase the Player
 class ChasePlayerComponent : public M5Component
@@ -20,11 +22,28 @@ class ChasePlayerComponent : public M5Component
 public:
 	ChasePlayerComponent(void);
 	virtual void Update(float dt);
+	static void UpdateBatch(std::vector<M5Component*>& comps, size_t start, float dt);
 	virtual void FromFile(M5IniFile& iniFile);
 	virtual ChasePlayerComponent* Clone(void) const;
+	virtual void Save(M5Snapshot& snapshot) const;
+	virtual void Load(M5Snapshot& snapshot);
 private:
 	float m_speed;
 
 };
 
+//! Every chaser steers at once with the M5Vec2Batch functions
+template <>
+struct M5HasBatchUpdate<ChasePlayerComponent>
+{
+	static const bool value = true; //!< ChasePlayerComponent::UpdateBatch is used
+};
+
+//! Chasers keep their velocity between turns, so they don't need to steer every frame
+template <>
+struct M5UpdateRate<ChasePlayerComponent>
+{
+	static constexpr float value = 10.0f; //!< Steer ten times a second
+};
+
 #endif //CHASE_PLAYER_COMPONENT_H
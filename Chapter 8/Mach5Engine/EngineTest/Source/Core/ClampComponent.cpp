@@ -13,6 +13,12 @@ Component to clamp an object in the screen
 #include "M5Gfx.h"
 #include "M5Math.h"
 #include "M5Object.h"
+#include "M5Vec2Batch.h"
+
+namespace
+{
+M5Vec2Buffer s_pos; //!< Reused so UpdateBatch doesn't allocate each frame
+}
 
 /******************************************************************************/
 /*!
@@ -37,8 +43,57 @@ void ClampComponent::Update(float /*dt*/)
 	M5Vec2 topRight;
 	M5Gfx::GetWorldBotLeft(botLeft);
 	M5Gfx::GetWorldTopRight(topRight);
-	m_pObj->pos.x = M5Math::Clamp(m_pObj->pos.x, botLeft.x, topRight.x);
-	m_pObj->pos.y = M5Math::Clamp(m_pObj->pos.y, botLeft.y, topRight.y);
+	M5Vec2 pos(M5Math::Clamp(m_pObj->pos.x, botLeft.x, topRight.x),
+		M5Math::Clamp(m_pObj->pos.y, botLeft.y, topRight.y));
+	if (pos.x != m_pObj->pos.x || pos.y != m_pObj->pos.y)
+	{
+		m_pObj->pos = pos;
+		M5Gfx::MarkMoved(m_pObj);
+	}
+}
+/******************************************************************************/
+/*!
+Clamps every ClampComponent's object at once.  The positions are copied into
+arrays so four of them can be clamped at a time.
+
+\param [in] comps
+The list of components, all of them from start on must be ClampComponents.
+
+\param [in] start
+The index of the first ClampComponent.
+
+\param [in] dt
+The time in seconds since the last frame
+*/
+/******************************************************************************/
+void ClampComponent::UpdateBatch(std::vector<M5Component*>& comps, size_t start, float /*dt*/)
+{
+	M5Vec2 botLeft;
+	M5Vec2 topRight;
+	M5Gfx::GetWorldBotLeft(botLeft);
+	M5Gfx::GetWorldTopRight(topRight);
+
+	size_t size = comps.size() - start;
+	M5Vec2Span pos = s_pos.Resize(size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		M5Object* pObj = static_cast<ClampComponent*>(comps[start + i])->m_pObj;
+		pos.x[i] = pObj->pos.x;
+		pos.y[i] = pObj->pos.y;
+	}
+
+	M5Vec2Batch::Clamp(pos, pos, botLeft, topRight);
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		M5Object* pObj = static_cast<ClampComponent*>(comps[start + i])->m_pObj;
+		if (pObj->pos.x != pos.x[i] || pObj->pos.y != pos.y[i])
+		{
+			pObj->pos.x = pos.x[i];
+			pObj->pos.y = pos.y[i];
+			M5Gfx::MarkMoved(pObj);
+		}
+	}
 }
 /******************************************************************************/
 /*!
@@ -51,7 +106,7 @@ A new clamp component that is a copy of this one.
 /******************************************************************************/
 ClampComponent* ClampComponent::Clone(void) const
 {
-	ClampComponent* pNew = new ClampComponent;
+	ClampComponent* pNew = new (CT_ClampComponent) ClampComponent;
 	pNew->m_pObj = m_pObj;
 	return pNew;
 }
\ No newline at end of file
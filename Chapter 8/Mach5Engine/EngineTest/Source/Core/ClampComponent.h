@@ -12,6 +12,8 @@ Component to Clamp an object in the screen
 #ifndef CLAMP_COMPONENT_H
 #define CLAMP_COMPONENT_H
 #include "M5Component.h"
+#include "M5ComponentBuilder.h"
+#include <vector>
 
 //! Component to Clamp an object in the screen
 class ClampComponent : public M5Component
@@ -19,8 +21,16 @@ class ClampComponent : public M5Component
 public:
 	ClampComponent();
 	virtual void Update(float dt);
+	static void UpdateBatch(std::vector<M5Component*>& comps, size_t start, float dt);
 	virtual ClampComponent* Clone(void) const;
 };
 
+//! Clamps every object at once with the M5Vec2Batch functions
+template <>
+struct M5HasBatchUpdate<ClampComponent>
+{
+	static const bool value = true; //!< ClampComponent::UpdateBatch is used
+};
+
 #endif //CLAMP_COMPONENT_H
 
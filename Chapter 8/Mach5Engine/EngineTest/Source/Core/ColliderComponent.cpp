@@ -17,10 +17,12 @@ about it's game object.  For now, it only containts a radius.
 #include "M5Object.h"
 #include "M5Intersect.h"
 #include "M5ComponentTypes.h"
+#include "M5Snapshot.h"
 
 ColliderComponent::ColliderComponent(void) :
 	M5Component(CT_ColliderComponent),
-	m_radius(0)
+	m_radius(0),
+	m_colliderIndex(-1)
 {
 }
 ColliderComponent::~ColliderComponent(void)
@@ -37,7 +39,7 @@ void ColliderComponent::FromFile(M5IniFile& iniFile)
 }
 ColliderComponent* ColliderComponent::Clone(void) const
 {
-	ColliderComponent* pNew = new ColliderComponent;
+	ColliderComponent* pNew = new (CT_ColliderComponent) ColliderComponent;
 	pNew->m_radius = m_radius;
 	pNew->m_pObj = m_pObj;
 
@@ -53,4 +55,16 @@ void ColliderComponent::TestCollision(const ColliderComponent* pOther)
 	{
 		M5Phy::AddCollisionPair(m_pObj->GetID(), pOther->m_pObj->GetID());
 	}
-}
\ No newline at end of file
+}
+void ColliderComponent::Save(M5Snapshot& snapshot) const
+{
+	snapshot.Write(m_radius);
+}
+void ColliderComponent::Load(M5Snapshot& snapshot)
+{
+	snapshot.Read(m_radius);
+}
+void ColliderComponent::Unregister(void)
+{
+	M5Phy::UnregisterCollider(this);
+}
@@ -14,18 +14,32 @@ about it's game object.  For now, it only containts a radius.
 #define COLLIDER_COMPONENT_H
 
 #include "M5Component.h"
+#include "M5ComponentBuilder.h"
 
 class ColliderComponent : public M5Component
 {
 public:
+	friend class M5Phy;
+
 	ColliderComponent(void);
 	~ColliderComponent(void);
 	virtual void Update(float dt);
 	virtual void FromFile(M5IniFile& iniFile);
 	virtual ColliderComponent* Clone(void) const;
+	virtual void Save(M5Snapshot& snapshot) const;
+	virtual void Load(M5Snapshot& snapshot);
+	virtual void Unregister(void);
 	void TestCollision(const ColliderComponent* pOther);
 private:
 	float m_radius;
+	int   m_colliderIndex; //!< Index in the M5Phy collider list, -1 if not registered
+};
+
+//! Colliders are tested by M5Phy, so the type based update can skip them
+template <>
+struct M5HasUpdate<ColliderComponent>
+{
+	static const bool value = false; //!< ColliderComponent::Update is empty
 };
 
 #endif //COLLIDER_COMPONENT_H
\ No newline at end of file
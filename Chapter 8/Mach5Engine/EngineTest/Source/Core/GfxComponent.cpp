@@ -14,6 +14,7 @@ Base graphics component.  For now it just contains a texture.
 #include "M5Mtx44.h"
 #include "M5Object.h"
 #include "M5IniFile.h"
+#include "M5Snapshot.h"
 #include <string>
 #include <algorithm>
 
@@ -25,11 +26,17 @@ Construtor for GFX component.  Sets default values
 GfxComponent::GfxComponent(void):
 	M5Component(CT_GfxComponent),
 	m_textureID(0),
-	m_texScaleX(1),
-	m_texScaleY(1),
-	m_texTransX(0),
-	m_texTransY(0),
-	m_drawSpace(DrawSpace::DS_WORLD)
+	m_data(),
+	m_worldRot(0),
+	m_isWorldValid(false),
+	m_cell(0),
+	m_cellIndex(-1),
+	m_movedIndex(-1),
+	m_layer(0),
+	m_drawIndex(-1),
+	m_visibleFrame(0),
+	m_isInHud(false),
+	m_isLarge(false)
 {
 }
 /******************************************************************************/
@@ -44,20 +51,34 @@ GfxComponent::~GfxComponent(void)
 }
 /******************************************************************************/
 /*!
-This component know how to draw itself.
+This component know how to draw itself.  The world matrix is only rebuilt when
+the position, scale or rotation of the object changed since the last draw.
+Objects write these directly, so the values are compared instead of relying
+on a flag.
 */
 /******************************************************************************/
 void GfxComponent::Draw(void) const
 {
-	M5Mtx44 world;
-	world.MakeTransform(m_pObj->scale, 
-		m_pObj->rotation, 
-		m_pObj->pos, 
-		0);
-	M5Gfx::SetTextureCoords(m_texScaleX, m_texScaleY, 0, m_texTransX, m_texTransY);
+	//Exact compares, so slow movement is never lost to an epsilon
+	if (!m_isWorldValid ||
+		m_worldPos.x != m_pObj->pos.x || m_worldPos.y != m_pObj->pos.y ||
+		m_worldScale.x != m_pObj->scale.x || m_worldScale.y != m_pObj->scale.y ||
+		m_worldRot != m_pObj->rotation)
+	{
+		m_world.MakeTransform(m_pObj->scale,
+			m_pObj->rotation,
+			m_pObj->pos,
+			0);
+		m_worldPos     = m_pObj->pos;
+		m_worldScale   = m_pObj->scale;
+		m_worldRot     = m_pObj->rotation;
+		m_isWorldValid = true;
+		M5Gfx::CountMatrixBuild();
+	}
+	M5Gfx::SetTextureCoords(m_data->texScaleX, m_data->texScaleY, 0, m_data->texTransX, m_data->texTransY);
 	M5Gfx::SetTexture(m_textureID);
 	//M5Gfx::setT
-	M5Gfx::Draw(world);
+	M5Gfx::Draw(m_world);
 }
 /******************************************************************************/
 /*!
@@ -73,7 +94,8 @@ void GfxComponent::Update(float /*dt*/)
 }
 /******************************************************************************/
 /*!
-Clones the current GfxComponent and registers it with the GfxEngine.
+Clones the current GfxComponent and registers it with the GfxEngine.  The
+clone shares the settings of this component instead of copying them.
 
 \return
 A new GfxComponent that is a clone of this one
@@ -82,16 +104,12 @@ A new GfxComponent that is a clone of this one
 GfxComponent* GfxComponent::Clone(void) const
 {
 	//Allocates new object and copies data
-	GfxComponent* pNew = new GfxComponent;
+	GfxComponent* pNew = new (CT_GfxComponent) GfxComponent;
 	pNew->m_pObj = m_pObj;
 	pNew->SetTextureID(m_textureID);
-	pNew->m_drawSpace = m_drawSpace;
-	pNew->m_texScaleX = m_texScaleX;
-	pNew->m_texScaleY = m_texScaleY;
-	pNew->m_texTransX = m_texTransX;
-	pNew->m_texTransY = m_texTransY;
+	pNew->m_data = m_data;
 
-	if (m_drawSpace == DrawSpace::DS_WORLD)
+	if (m_data->drawSpace == DrawSpace::DS_WORLD)
 		M5Gfx::RegisterWorldComponent(pNew);
 	else
 		M5Gfx::RegisterHudComponent(pNew);
@@ -144,6 +162,7 @@ The new drawSpace to draw in
 /******************************************************************************/
 void GfxComponent::SetDrawSpace(DrawSpace drawSpace)
 {
+	m_data.Edit().drawSpace = drawSpace;
 	M5Gfx::UnregisterComponent(this);
 	if (drawSpace == DrawSpace::DS_WORLD)
 		M5Gfx::RegisterWorldComponent(this);
@@ -161,14 +180,15 @@ The preloaded inifile to read from.
 void GfxComponent::FromFile(M5IniFile& iniFile)
 {
 	//Get texture
-	std::string path("Textures\\");
+	std::string path("Textures/");
 	std::string fileName;
+	GfxComponentData& data = m_data.Edit();
 	iniFile.SetToSection("GfxComponent");
 	iniFile.GetValue("texture", fileName);
-	iniFile.GetValue("texScaleX", m_texScaleX);
-	iniFile.GetValue("texScaleY", m_texScaleY);
-	iniFile.GetValue("texTransX", m_texTransX);
-	iniFile.GetValue("texTransY", m_texTransY);
+	iniFile.GetValue("texScaleX", data.texScaleX);
+	iniFile.GetValue("texScaleY", data.texScaleY);
+	iniFile.GetValue("texTransX", data.texTransX);
+	iniFile.GetValue("texTransY", data.texTransY);
 
 
 	path += fileName;
@@ -182,9 +202,18 @@ void GfxComponent::FromFile(M5IniFile& iniFile)
 
 	//Note, should be lowercase, otherwise it will be part of hud
 	if (drawSpace == "world")
-		m_drawSpace = DrawSpace::DS_WORLD;
+		data.drawSpace = DrawSpace::DS_WORLD;
 	else
-		m_drawSpace = DrawSpace::DS_HUD;
+		data.drawSpace = DrawSpace::DS_HUD;
+}
+/******************************************************************************/
+/*!
+Stops drawing this component.  The texture is released by the destructor.
+*/
+/******************************************************************************/
+void GfxComponent::Unregister(void)
+{
+	M5Gfx::UnregisterComponent(this);
 }
 /******************************************************************************/
 /*!
@@ -194,4 +223,52 @@ Returns the textureId used by the Gfx Component
 int GfxComponent::GetTextureID(void) const
 {
 	return m_textureID;
-}
\ No newline at end of file
+}
+/******************************************************************************/
+/*!
+Saves the data of this component into a snapshot.
+
+\param [in] snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+void GfxComponent::Save(M5Snapshot& snapshot) const
+{
+	snapshot.Write(m_textureID);
+	m_data.Save(snapshot);
+}
+/******************************************************************************/
+/*!
+Restores the data of this component from a snapshot.
+
+\param [in] snapshot
+The snapshot to read from.
+*/
+/******************************************************************************/
+void GfxComponent::Load(M5Snapshot& snapshot)
+{
+	//The texture count must follow the id, so this can't be copied directly
+	int textureID;
+	snapshot.Read(textureID);
+	if (textureID != m_textureID)
+		SetTextureID(textureID);
+
+	DrawSpace drawSpace = m_data->drawSpace;
+	m_data.Load(snapshot);
+	if (m_data->drawSpace != drawSpace)
+		SetDrawSpace(m_data->drawSpace);
+}
+/******************************************************************************/
+/*!
+Saves the draw space for replication clients.  Texture ids only mean something
+on the server, so clients pick textures from the ArcheType.
+
+\param [in] snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+void GfxComponent::Replicate(M5Snapshot& snapshot) const
+{
+	unsigned char drawSpace = static_cast<unsigned char>(m_data->drawSpace);
+	snapshot.Write(drawSpace);
+}
@@ -13,6 +13,10 @@ Base graphics component.  For now it just contains a texture.
 #define GFX_COMPONENT
 
 #include "M5Component.h"
+#include "M5ComponentBuilder.h"
+#include "M5ArcheData.h"
+#include "M5Mtx44.h"
+#include "M5Vec2.h"
 
 enum class DrawSpace
 {
@@ -20,27 +24,62 @@ enum class DrawSpace
 	DS_HUD
 };
 
+//! Settings shared by every GfxComponent cloned from the same ArcheType
+struct GfxComponentData
+{
+	float     texScaleX = 1;                   //!< Texture coordinate scale in x
+	float     texScaleY = 1;                   //!< Texture coordinate scale in y
+	float     texTransX = 0;                   //!< Texture coordinate offset in x
+	float     texTransY = 0;                   //!< Texture coordinate offset in y
+	DrawSpace drawSpace = DrawSpace::DS_WORLD; //!< The space to draw in
+};
+
 //!< Base graphics component.  For now it just contains a texture.
 class GfxComponent : public M5Component
 {
 public:
+	friend class M5Gfx;
+
 	GfxComponent(void);
 	~GfxComponent(void);
 	void Draw(void) const;
 	virtual void Update(float dt);
 	virtual GfxComponent* Clone(void) const;
 	virtual void FromFile(M5IniFile& iniFile);
+	virtual void Save(M5Snapshot& snapshot) const;
+	virtual void Load(M5Snapshot& snapshot);
+	virtual void Replicate(M5Snapshot& snapshot) const;
+	virtual void Unregister(void);
 	void SetTextureID(int id);
 	int  GetTextureID(void) const;
 	void SetTexture(const char* fileName);
 	void SetDrawSpace(DrawSpace drawSpace);
 private:
 	int       m_textureID;  //!< Texture id loaded from graphics.
-	float     m_texScaleX;
-	float     m_texScaleY;
-	float     m_texTransX;
-	float     m_texTransY;
-	DrawSpace m_drawSpace;  //!The space to draw in
+
+	M5ArcheData<GfxComponentData> m_data; //!< Settings shared with the rest of the ArcheType
+
+	mutable M5Mtx44 m_world;        //!< World matrix from the last Draw
+	mutable M5Vec2  m_worldPos;     //!< The position m_world was built from
+	mutable M5Vec2  m_worldScale;   //!< The scale m_world was built from
+	mutable float   m_worldRot;     //!< The rotation m_world was built from
+	mutable bool    m_isWorldValid; //!< False until m_world is built the first time
+
+	unsigned long long m_cell;         //!< The culling grid cell this is in
+	int                m_cellIndex;    //!< Index in the grid cell, -1 if not in the grid
+	int                m_movedIndex;   //!< Index in the M5Gfx moved list, -1 if not in it
+	int                m_layer;        //!< Pause depth when registered, paused layers aren't drawn
+	int                m_drawIndex;    //!< Index in the M5Gfx draw list, -1 if not registered
+	unsigned           m_visibleFrame; //!< The last M5Gfx culling frame this was visible in
+	bool               m_isInHud;      //!< True if m_drawIndex is in the HUD list
+	bool               m_isLarge;      //!< True if this is in the large list instead of a grid cell
+};
+
+//! M5Gfx keeps the culling grid up to date, so the type based update can skip these
+template <>
+struct M5HasUpdate<GfxComponent>
+{
+	static const bool value = false; //!< GfxComponent::Update is empty
 };
 
 #endif // !GFX_COMPONENT
@@ -16,8 +16,14 @@ the Mach 5 Engine.
 #include "M5StageManager.h"
 #include "M5ObjectManager.h"
 #include "M5Input.h"
+#include "M5Replay.h"
 #include "M5Timer.h"
 #include "M5Gfx.h"
+#include "M5Memory.h"
+#include "M5Log.h"
+#include "M5Telemetry.h"
+#include "M5Replication.h"
+#include "M5StreamManager.h"
 #include "Windowsx.h" /*For GET_X_LPARAM, GET_Y_LPARAM*/
 
 
@@ -25,6 +31,8 @@ namespace
 {
 /*The name of the Windows class. It is used to register and create the window*/
 const char* CLASS_NAME = "Mach5Class";
+/*The file M5Log writes messages to*/
+const char* LOG_FILE = "M5Log.txt";
 /*My Window style if the user chooses full screen*/
 const DWORD FULLSCREEN_STYLE = WS_POPUP | WS_VISIBLE;
 /*My Window style if the user chooses windowed mode.*/
@@ -38,6 +46,8 @@ HWND        s_window;      /*!< The window after creating it*/
 DWORD       s_style;       /*!< The windows style */
 bool        s_isQuitting;  /*!< The quit stage of the game*/
 bool        s_isFullScreen;/*!< If the window is in full screen or not*/
+bool        s_isHeadless;  /*!< If graphics uses the null backend instead of OpenGL*/
+bool        s_isSoftware;  /*!< If graphics draws on the CPU instead of OpenGL*/
 int         s_height;      /*!< The height of the client area of the window */
 int         s_width;       /*!< The width of the client area of the window */
 
@@ -262,6 +272,10 @@ void M5App::Init(const M5InitData& initData)
   //Make sure this function is called only 1 time.
   M5DEBUG_CALL_CHECK(1);
 
+  /*Start logging first so everything else can use it*/
+  M5Log::Init(LOG_FILE);
+  M5Telemetry::Init();
+
   /*Set up s_appData*/
   s_isQuitting = false;
   s_height = initData.height;
@@ -271,6 +285,8 @@ void M5App::Init(const M5InitData& initData)
   s_title = initData.title;
   s_instance = initData.instance;
   s_isFullScreen = initData.fullScreen;
+  s_isHeadless = initData.headless;
+  s_isSoftware = initData.software;
   s_style = WINDOWED_STYLE;
 
   /*Use default for my WNDCLASS*/
@@ -322,6 +338,7 @@ void M5App::Init(const M5InitData& initData)
 
   
   M5StageManager::Init(*initData.pGData, initData.fps);
+  M5ObjectManager::SetLoadThreads(initData.loadThreads);
   M5ObjectManager::Init();
   M5Input::Init();
 }
@@ -366,9 +383,26 @@ void M5App::Shutdown(void)
   if (s_isFullScreen)
     ChangeDisplaySettings(NULL, 0);
 
+  /*Clients are told how much was sent while the log is still running*/
+  M5Replication::Shutdown();
+  M5StreamManager::Shutdown();
   M5ObjectManager::Shutdown();
+  M5Replay::Shutdown();
   /*Shut down StageMgr*/
   M5StageManager::Shutdown();
+  /*Benchmark and test runs quit without closing the window, so the render
+  thread is still running*/
+  if (s_window != 0)
+  {
+    M5Gfx::Shutdown();
+    DestroyWindow(s_window);
+  }
+  /*Everything the engine owns is deleted, so anything left is a leak*/
+  M5Memory::ReportLeaks();
+  /*Summarize the session while the log is still running*/
+  M5Telemetry::Shutdown();
+  /*Write any messages that are left*/
+  M5Log::Shutdown();
   /*Clean up windows*/
   UnregisterClass(CLASS_NAME, s_instance);
 
@@ -465,12 +499,18 @@ The result of the default windows procedure or 0.
 /******************************************************************************/
 LRESULT CALLBACK M5App::M5WinProc(HWND win, UINT msg, WPARAM wp, LPARAM lp)
 {
+  /*While replaying, input only comes from the recorded file*/
+  if (M5Replay::IsReplaying() &&
+    ((msg >= WM_KEYFIRST && msg <= WM_KEYLAST) ||
+    (msg >= WM_MOUSEFIRST && msg <= WM_MOUSELAST)))
+    return DefWindowProc(win, msg, wp, lp);
+
   switch (msg)
   {
   case WM_CREATE:
   {
     /*Once the window is create M5 can start graphics*/
-    M5Gfx::Init(win, s_width, s_height);
+    M5Gfx::Init(win, s_width, s_height, s_isHeadless, s_isSoftware);
     break;
   }
   case WM_DESTROY:
@@ -33,6 +33,9 @@ struct M5InitData
   int         width;       /*!< The width of the client area of the screen*/
   int         fps;         /*!<*The target frames per second for the game, usually 30 or 60*/
   bool        fullScreen;  /*!< If the game should begin in fullscreen or not*/
+  bool        headless;    /*!< If frames should be read by the null backend instead of drawn*/
+  bool        software;    /*!< If frames should be drawn on the CPU instead of with OpenGL*/
+  int         loadThreads; /*!< Threads that read archetype files at startup, 0 for one per core*/
 };
 
 //! Singleton class to Control the Window
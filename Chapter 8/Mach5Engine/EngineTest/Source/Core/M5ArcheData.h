@@ -0,0 +1,246 @@
+/******************************************************************************/
+/*!
+\file   M5ArcheData.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Template class for component settings that are shared by every clone of an
+ArcheType instead of being copied into each one.
+
+*/
+/******************************************************************************/
+#ifndef M5_ARCHE_DATA_H
+#define M5_ARCHE_DATA_H
+
+#include "M5Memory.h"
+#include "M5Snapshot.h"
+
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+/*! Read only settings shared by every clone of a prototype component.  The
+prototype in the M5ObjectManager gets its own copy when it reads its ini file,
+and each clone just points at it, so clones are smaller and copying them is a
+pointer copy.  T must be plain data with defaults for every member.
+
+Editing the settings of one component gives it its own copy, so the other
+clones are never changed.  The copies are counted, so a clone can outlive its
+prototype.  Only the main thread should clone or delete components that share
+settings.*/
+template <typename T>
+class M5ArcheData
+{
+public:
+	static_assert(std::is_trivially_copyable<T>::value, "Shared settings must be plain data");
+
+	M5ArcheData(void);
+	M5ArcheData(const M5ArcheData& rhs);
+	~M5ArcheData(void);
+	M5ArcheData& operator=(const M5ArcheData& rhs);
+	//Gets the shared settings
+	const T* operator->(void) const;
+	//Gets the shared settings
+	const T& Get(void) const;
+	//Gets settings that only this component uses, so they can be changed
+	T& Edit(void);
+	//Saves the settings into a snapshot
+	void Save(M5Snapshot& snapshot) const;
+	//Restores the settings, only copying them if they are different
+	void Load(M5Snapshot& snapshot);
+private:
+	//! The settings and the number of components that use them
+	struct Block
+	{
+		T   data;     //!< The settings
+		int refCount; //!< Components using this block
+	};
+
+	static Block* GetDefault(void);
+	static void   AddRef(Block* pBlock);
+	void Release(void);
+
+	Block* m_pBlock; //!< The settings this uses, never null
+};
+
+/******************************************************************************/
+/*!
+Gets the block that every component starts with.  It has the default values
+of T and is never deleted.
+
+\return
+The default block.
+*/
+/******************************************************************************/
+template <typename T>
+typename M5ArcheData<T>::Block* M5ArcheData<T>::GetDefault(void)
+{
+	static Block s_default = { T(), 0 };
+	return &s_default;
+}
+/******************************************************************************/
+/*!
+Counts one more component using a block.  The default block isn't counted.
+
+\param [in] pBlock
+The block to count.
+*/
+/******************************************************************************/
+template <typename T>
+void M5ArcheData<T>::AddRef(Block* pBlock)
+{
+	if (pBlock != GetDefault())
+		++pBlock->refCount;
+}
+/******************************************************************************/
+/*!
+Starts with the default values of T without allocating.
+*/
+/******************************************************************************/
+template <typename T>
+M5ArcheData<T>::M5ArcheData(void) :
+	m_pBlock(GetDefault())
+{
+}
+/******************************************************************************/
+/*!
+Shares the settings of another component.
+
+\param [in] rhs
+The settings to share.
+*/
+/******************************************************************************/
+template <typename T>
+M5ArcheData<T>::M5ArcheData(const M5ArcheData& rhs) :
+	m_pBlock(rhs.m_pBlock)
+{
+	AddRef(m_pBlock);
+}
+/******************************************************************************/
+/*!
+Deletes the settings if this is the last component using them.
+*/
+/******************************************************************************/
+template <typename T>
+M5ArcheData<T>::~M5ArcheData(void)
+{
+	Release();
+}
+/******************************************************************************/
+/*!
+Stops using the current settings and shares the settings of another
+component.  This is how a clone gets the settings of its prototype.
+
+\param [in] rhs
+The settings to share.
+
+\return
+This object.
+*/
+/******************************************************************************/
+template <typename T>
+M5ArcheData<T>& M5ArcheData<T>::operator=(const M5ArcheData& rhs)
+{
+	AddRef(rhs.m_pBlock);
+	Release();
+	m_pBlock = rhs.m_pBlock;
+	return *this;
+}
+/******************************************************************************/
+/*!
+Gets the shared settings.
+
+\return
+A pointer to the settings.
+*/
+/******************************************************************************/
+template <typename T>
+const T* M5ArcheData<T>::operator->(void) const
+{
+	return &m_pBlock->data;
+}
+/******************************************************************************/
+/*!
+Gets the shared settings.
+
+\return
+The settings.
+*/
+/******************************************************************************/
+template <typename T>
+const T& M5ArcheData<T>::Get(void) const
+{
+	return m_pBlock->data;
+}
+/******************************************************************************/
+/*!
+Gets settings that only this component uses.  If the settings are shared, they
+are copied first.  Prototypes call this in FromFile so their clones share the
+values read from the ini file.
+
+\return
+Settings that can be changed.
+*/
+/******************************************************************************/
+template <typename T>
+T& M5ArcheData<T>::Edit(void)
+{
+	if (m_pBlock == GetDefault() || m_pBlock->refCount > 1)
+	{
+		void* pMemory = M5Memory::Allocate(sizeof(Block), MT_COMPONENTS);
+		Block* pBlock = new (pMemory) Block(*m_pBlock);
+		pBlock->refCount = 1;
+		Release();
+		m_pBlock = pBlock;
+	}
+	return m_pBlock->data;
+}
+/******************************************************************************/
+/*!
+Saves the settings into a snapshot.
+
+\param [in] snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+template <typename T>
+void M5ArcheData<T>::Save(M5Snapshot& snapshot) const
+{
+	snapshot.Write(m_pBlock->data);
+}
+/******************************************************************************/
+/*!
+Restores the settings from a snapshot.  Usually they haven't changed since the
+save, so the shared settings are kept and nothing is copied.
+
+\param [in] snapshot
+The snapshot to read from.
+*/
+/******************************************************************************/
+template <typename T>
+void M5ArcheData<T>::Load(M5Snapshot& snapshot)
+{
+	T data;
+	snapshot.Read(data);
+	if (std::memcmp(&data, &m_pBlock->data, sizeof(T)) != 0)
+		Edit() = data;
+}
+/******************************************************************************/
+/*!
+Stops using the current settings, deleting them if nothing else uses them.
+*/
+/******************************************************************************/
+template <typename T>
+void M5ArcheData<T>::Release(void)
+{
+	if (m_pBlock != GetDefault() && --m_pBlock->refCount == 0)
+	{
+		m_pBlock->~Block();
+		M5Memory::Free(m_pBlock);
+	}
+}
+
+
+#endif //M5_ARCHE_DATA_H
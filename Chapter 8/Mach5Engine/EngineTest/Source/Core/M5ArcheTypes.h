@@ -13,6 +13,7 @@ and creates an enumeration value of AT_*.
 #ifndef M5ARCHE_TYPES_H 
 #define M5ARCHE_TYPES_H 
 #include <string> 
+#include "M5Hash.h" 
  
  
 //! AutoGenerated enum based on archetype ini file names  
@@ -44,27 +45,55 @@ AT_INVALID
  
 //! AutoGenerated function to convert strings to our M5ArcheTypes type 
 inline M5ArcheTypes StringToArcheType(const std::string& string) { 
-if(string == "1024x768Button") return AT_1024x768Button; 
-if(string == "1280x768Button") return AT_1280x768Button; 
-if(string == "800x600Button") return AT_800x600Button; 
-if(string == "BackButton") return AT_BackButton; 
-if(string == "Bullet") return AT_Bullet; 
-if(string == "FullscreenButton") return AT_FullscreenButton; 
-if(string == "GameOverTitle") return AT_GameOverTitle; 
-if(string == "MenuAsteroid") return AT_MenuAsteroid; 
-if(string == "MenuButton") return AT_MenuButton; 
-if(string == "MenuSpawner") return AT_MenuSpawner; 
-if(string == "MenuTitle") return AT_MenuTitle; 
-if(string == "OptionsButton") return AT_OptionsButton; 
-if(string == "OptionsTitle") return AT_OptionsTitle; 
-if(string == "PauseTitle") return AT_PauseTitle; 
-if(string == "PlayButton") return AT_PlayButton; 
-if(string == "Player") return AT_Player; 
-if(string == "QuitButton") return AT_QuitButton; 
-if(string == "Raider") return AT_Raider; 
-if(string == "Splash") return AT_Splash; 
-if(string == "Ufo") return AT_Ufo; 
-if(string == "WindowedButton") return AT_WindowedButton; 
+switch (M5Hash(string.c_str())) { 
+case M5HashLiteral("1024x768Button"): return (string == "1024x768Button") ? AT_1024x768Button : AT_INVALID; 
+case M5HashLiteral("1280x768Button"): return (string == "1280x768Button") ? AT_1280x768Button : AT_INVALID; 
+case M5HashLiteral("800x600Button"): return (string == "800x600Button") ? AT_800x600Button : AT_INVALID; 
+case M5HashLiteral("BackButton"): return (string == "BackButton") ? AT_BackButton : AT_INVALID; 
+case M5HashLiteral("Bullet"): return (string == "Bullet") ? AT_Bullet : AT_INVALID; 
+case M5HashLiteral("FullscreenButton"): return (string == "FullscreenButton") ? AT_FullscreenButton : AT_INVALID; 
+case M5HashLiteral("GameOverTitle"): return (string == "GameOverTitle") ? AT_GameOverTitle : AT_INVALID; 
+case M5HashLiteral("MenuAsteroid"): return (string == "MenuAsteroid") ? AT_MenuAsteroid : AT_INVALID; 
+case M5HashLiteral("MenuButton"): return (string == "MenuButton") ? AT_MenuButton : AT_INVALID; 
+case M5HashLiteral("MenuSpawner"): return (string == "MenuSpawner") ? AT_MenuSpawner : AT_INVALID; 
+case M5HashLiteral("MenuTitle"): return (string == "MenuTitle") ? AT_MenuTitle : AT_INVALID; 
+case M5HashLiteral("OptionsButton"): return (string == "OptionsButton") ? AT_OptionsButton : AT_INVALID; 
+case M5HashLiteral("OptionsTitle"): return (string == "OptionsTitle") ? AT_OptionsTitle : AT_INVALID; 
+case M5HashLiteral("PauseTitle"): return (string == "PauseTitle") ? AT_PauseTitle : AT_INVALID; 
+case M5HashLiteral("PlayButton"): return (string == "PlayButton") ? AT_PlayButton : AT_INVALID; 
+case M5HashLiteral("Player"): return (string == "Player") ? AT_Player : AT_INVALID; 
+case M5HashLiteral("QuitButton"): return (string == "QuitButton") ? AT_QuitButton : AT_INVALID; 
+case M5HashLiteral("Raider"): return (string == "Raider") ? AT_Raider : AT_INVALID; 
+case M5HashLiteral("Splash"): return (string == "Splash") ? AT_Splash : AT_INVALID; 
+case M5HashLiteral("Ufo"): return (string == "Ufo") ? AT_Ufo : AT_INVALID; 
+case M5HashLiteral("WindowedButton"): return (string == "WindowedButton") ? AT_WindowedButton : AT_INVALID; 
+} 
 return AT_INVALID; 
 } 
+ 
+//! AutoGenerated names of each M5ArcheTypes, in the same order as the enum 
+const char* const ARCHETYPE_NAMES[] = { 
+"1024x768Button", 
+"1280x768Button", 
+"800x600Button", 
+"BackButton", 
+"Bullet", 
+"FullscreenButton", 
+"GameOverTitle", 
+"MenuAsteroid", 
+"MenuButton", 
+"MenuSpawner", 
+"MenuTitle", 
+"OptionsButton", 
+"OptionsTitle", 
+"PauseTitle", 
+"PlayButton", 
+"Player", 
+"QuitButton", 
+"Raider", 
+"Splash", 
+"Ufo", 
+"WindowedButton", 
+"INVALID" 
+}; 
 #endif //M5ARCHE_TYPES_H 
@@ -0,0 +1,1711 @@
+/******************************************************************************/
+/*!
+\file   M5Benchmark.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/26
+
+Singleton class to time the core engine functions and compare the times to a
+saved baseline.
+
+Each benchmark is run once to warm up the caches, then a few more times, and
+the fastest run is kept since it has the least noise from the rest of the
+system.  Results are saved as JSON so they can be kept as a baseline and
+compared against after an engine change.
+
+*/
+/******************************************************************************/
+#include "M5Benchmark.h"
+#include "M5Debug.h"
+#include "M5Vec2.h"
+#include "M5Vec2Batch.h"
+#include "M5FastMath.h"
+#include "M5Math.h"
+#include "M5Mtx44.h"
+#include "M5Intersect.h"
+#include "M5IniFile.h"
+#include "M5Random.h"
+#include "M5Object.h"
+#include "M5Component.h"
+#include "M5ObjectManager.h"
+#include "M5Factory.h"
+#include "M5TBuilder.h"
+#include "M5ComponentPool.h"
+#include "ClampComponent.h"
+#include "ColliderComponent.h"
+#include "GfxComponent.h"
+#include "OutsideViewKillComponent.h"
+#include "RepositionComponent.h"
+#include "UIButtonComponent.h"
+#include "WrapComponent.h"
+#include "M5Memory.h"
+#include "M5Phy.h"
+#include "M5Nav.h"
+#include "M5Gfx.h"
+#include "M5TextBatch.h"
+#include "M5Histogram.h"
+#include "M5SoftRenderBackend.h"
+#include "M5ReplicaWorld.h"
+#include "M5ReplicaClient.h"
+#include "M5Replication.h"
+#include "M5StreamManager.h"
+#include "M5Snapshot.h"
+#include "M5ArcheTypes.h"
+#include "M5ComponentTypes.h"
+#include "M5Log.h"
+#include "M5ResourceManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gl/gl.h"
+
+namespace
+{
+typedef std::chrono::high_resolution_clock BenchClock;
+
+const int   REPEATS = 5;              //!< Timed runs of each benchmark, the fastest is kept
+const int   SEED = 1;                 //!< So every run uses the same data
+const float DT = 1.0f / 60.0f;        //!< Frame time passed to updates
+const float WORLD_SIZE = 500.0f;      //!< Objects are spread over this much of the world
+const char* INI_FILE = "ArcheTypes/Raider.ini"; //!< Used to time reading ini files
+const char* ARCHETYPE_FILE = "ArcheTypes/Ufo.ini"; //!< Copied to time loading archetypes
+const char* TEXTURE_FILE = "Textures/ufo.tga";     //!< Copied to time loading archetypes
+
+/*! A benchmark function.  It should do its setup, time only the work it is
+measuring and return the time in seconds.  ops is set to the number of
+operations that were timed.*/
+typedef double(*M5BenchFunc)(int size, int& ops);
+
+//! A benchmark to run
+struct M5BenchTest
+{
+	const char* name;  //!< Name in the results
+	int         size;  //!< Number of items to work on
+	M5BenchFunc pFunc; //!< The function to time
+};
+
+//! The result of one benchmark
+struct M5BenchResult
+{
+	std::string name;    //!< Name of the benchmark
+	int         size;    //!< Number of items it worked on
+	int         ops;        //!< Number of operations timed in one run
+	double      nsPerOp;    //!< Fastest time for a single operation
+	double      bytesPerOp; //!< Memory kept or bytes sent for each operation, 0 if not measured
+};
+
+/*! A virtual builder like the ones M5Factory held for components.  Components
+are made in the M5ComponentPool of their type, so M5TBuilder can't make them.*/
+template <typename T, M5ComponentTypes Type>
+class PoolTBuilder : public M5BaseTBuilder<M5Component>
+{
+public:
+	//! Creates a new component of type T
+	virtual M5Component* Build(void) { return new (Type) T(); }
+};
+
+//! Written to by benchmarks so the compiler can't remove the work
+volatile float s_sink;
+//! Set by benchmarks that measure the memory each operation keeps or the bytes it sends
+double s_bytesPerOp;
+
+/******************************************************************************/
+/*!
+Gets the seconds since a time point.
+
+\param [in] start
+The time to measure from.
+
+\return
+The seconds since start.
+*/
+/******************************************************************************/
+double SecondsSince(const BenchClock::time_point& start)
+{
+	std::chrono::duration<double> time = BenchClock::now() - start;
+	return time.count();
+}
+/******************************************************************************/
+/*!
+Fills a vector with random points in the world.
+
+\param [out] points
+The vector to fill.
+
+\param [in] size
+The number of points.
+*/
+/******************************************************************************/
+void MakePoints(std::vector<M5Vec2>& points, int size)
+{
+	points.resize(size);
+	for (int i = 0; i < size; ++i)
+	{
+		points[i].x = M5Random::GetFloat(-WORLD_SIZE, WORLD_SIZE);
+		points[i].y = M5Random::GetFloat(-WORLD_SIZE, WORLD_SIZE);
+	}
+}
+/******************************************************************************/
+/*!
+Gets the bytes used by objects and components.  The M5ComponentPool blocks
+are kept after their components are deleted, so only the slots in use are
+counted for them.
+
+\return
+The live bytes of MT_OBJECTS and MT_COMPONENTS.
+*/
+/******************************************************************************/
+long long GetObjectBytes(void)
+{
+	M5MemoryStats objects;
+	M5MemoryStats components;
+	M5Memory::GetStats(MT_OBJECTS, objects);
+	M5Memory::GetStats(MT_COMPONENTS, components);
+
+	long long bytes = objects.liveBytes + components.liveBytes;
+	for (int i = 0; i < CT_INVALID; ++i)
+	{
+		M5ComponentPoolStats pool;
+		M5ComponentPool::GetStats(static_cast<M5ComponentTypes>(i), pool);
+		bytes += pool.usedBytes - pool.totalBytes;
+	}
+	return bytes;
+}
+/******************************************************************************/
+/*!
+Makes objects of the given type at random places in the world.
+
+\param [in] type
+The ArcheType to make.
+
+\param [in] size
+The number of objects to make.
+*/
+/******************************************************************************/
+void MakeObjects(M5ArcheTypes type, int size)
+{
+	for (int i = 0; i < size; ++i)
+	{
+		M5Object* pObj = M5ObjectManager::CreateObject(type);
+		pObj->pos.x = M5Random::GetFloat(-WORLD_SIZE, WORLD_SIZE);
+		pObj->pos.y = M5Random::GetFloat(-WORLD_SIZE, WORLD_SIZE);
+	}
+}
+/******************************************************************************/
+/*!
+Makes objects of the given type at random places inside the view, so objects
+with an OutsideViewKillComponent stay alive.
+
+\param [in] type
+The ArcheType to make.
+
+\param [in] size
+The number of objects to make.
+*/
+/******************************************************************************/
+void MakeObjectsInView(M5ArcheTypes type, int size)
+{
+	M5Vec2 botLeft;
+	M5Vec2 topRight;
+	M5Gfx::GetWorldBotLeft(botLeft);
+	M5Gfx::GetWorldTopRight(topRight);
+
+	/*Keep away from the edges so objects don't leave during the benchmark*/
+	M5Vec2 margin = (topRight - botLeft) * .25f;
+	botLeft += margin;
+	topRight -= margin;
+	for (int i = 0; i < size; ++i)
+	{
+		M5Object* pObj = M5ObjectManager::CreateObject(type);
+		pObj->pos.x = M5Random::GetFloat(botLeft.x, topRight.x);
+		pObj->pos.y = M5Random::GetFloat(botLeft.y, topRight.y);
+	}
+}
+/******************************************************************************/
+/*!
+Times normalizing vectors.
+*/
+/******************************************************************************/
+double Vec2Normalize(int size, int& ops)
+{
+	std::vector<M5Vec2> points;
+	std::vector<M5Vec2> results(size);
+	MakePoints(points, size);
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		M5Vec2::Normalize(results[i], points[i]);
+	double time = SecondsSince(start);
+
+	s_sink = results[size / 2].x;
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times moving points by a velocity, the way M5Object::Update does.
+*/
+/******************************************************************************/
+double Vec2Integrate(int size, int& ops)
+{
+	std::vector<M5Vec2> points;
+	std::vector<M5Vec2> vels;
+	MakePoints(points, size);
+	MakePoints(vels, size);
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+	{
+		M5Vec2 move;
+		M5Vec2::Scale(move, vels[i], DT);
+		M5Vec2::Add(points[i], points[i], move);
+	}
+	double time = SecondsSince(start);
+
+	s_sink = points[size / 2].x;
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times moving points by velocities four at a time, to compare with
+Vec2Integrate.
+*/
+/******************************************************************************/
+double Vec2BatchIntegrate(int size, int& ops)
+{
+	std::vector<M5Vec2> points;
+	std::vector<M5Vec2> vels;
+	MakePoints(points, size);
+	MakePoints(vels, size);
+
+	M5Vec2Buffer pointBuffer;
+	M5Vec2Buffer velBuffer;
+	M5Vec2Span pointSpan = pointBuffer.Resize(size);
+	M5Vec2Span velSpan = velBuffer.Resize(size);
+	for (int i = 0; i < size; ++i)
+	{
+		pointSpan.x[i] = points[i].x;
+		pointSpan.y[i] = points[i].y;
+		velSpan.x[i] = vels[i].x;
+		velSpan.y[i] = vels[i].y;
+	}
+
+	BenchClock::time_point start = BenchClock::now();
+	M5Vec2Batch::AddScaled(pointSpan, pointSpan, velSpan, DT);
+	double time = SecondsSince(start);
+
+	s_sink = pointSpan.x[size / 2];
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Fills a vector with random angles.
+
+\param [out] angles
+The vector to fill.
+
+\param [in] size
+The number of angles.
+*/
+/******************************************************************************/
+void MakeAngles(std::vector<float>& angles, int size)
+{
+	angles.resize(size);
+	for (int i = 0; i < size; ++i)
+		angles[i] = M5Random::GetFloat(-M5Math::TWO_PI, M5Math::TWO_PI);
+}
+/******************************************************************************/
+/*!
+Times the standard library sine and cosine, to compare with FastSinCos.
+*/
+/******************************************************************************/
+double StdSinCos(int size, int& ops)
+{
+	std::vector<float> angles;
+	std::vector<float> sins(size);
+	std::vector<float> coss(size);
+	MakeAngles(angles, size);
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+	{
+		sins[i] = std::sin(angles[i]);
+		coss[i] = std::cos(angles[i]);
+	}
+	double time = SecondsSince(start);
+
+	s_sink = sins[size / 2] + coss[size / 2];
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times the polynomial sine and cosine on an array of angles.
+*/
+/******************************************************************************/
+double FastSinCos(int size, int& ops)
+{
+	std::vector<float> angles;
+	std::vector<float> sins(size);
+	std::vector<float> coss(size);
+	MakeAngles(angles, size);
+
+	BenchClock::time_point start = BenchClock::now();
+	M5FastMath::SinCos(&sins[0], &coss[0], &angles[0], size);
+	double time = SecondsSince(start);
+
+	s_sink = sins[size / 2] + coss[size / 2];
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times the standard library atan2 the way ChasePlayerComponent uses it, to
+compare with FastAtan2.
+*/
+/******************************************************************************/
+double StdAtan2(int size, int& ops)
+{
+	std::vector<M5Vec2> points;
+	std::vector<float> results(size);
+	MakePoints(points, size);
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		results[i] = std::atan2(points[i].y, points[i].x);
+	double time = SecondsSince(start);
+
+	s_sink = results[size / 2];
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times the polynomial atan2 on arrays of x and y.
+*/
+/******************************************************************************/
+double FastAtan2(int size, int& ops)
+{
+	std::vector<M5Vec2> points;
+	std::vector<float> x(size);
+	std::vector<float> y(size);
+	std::vector<float> results(size);
+	MakePoints(points, size);
+	for (int i = 0; i < size; ++i)
+	{
+		x[i] = points[i].x;
+		y[i] = points[i].y;
+	}
+
+	BenchClock::time_point start = BenchClock::now();
+	M5FastMath::Atan2(&results[0], &y[0], &x[0], size);
+	double time = SecondsSince(start);
+
+	s_sink = results[size / 2];
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times making world matrices.
+*/
+/******************************************************************************/
+double Mtx44Transform(int size, int& ops)
+{
+	std::vector<M5Vec2> points;
+	std::vector<M5Mtx44> results(size);
+	MakePoints(points, size);
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+	{
+		M5Mtx44::MakeTransform(results[i], 10.0f, 10.0f, points[i].y,
+			points[i].x, points[i].y, 0.0f);
+	}
+	double time = SecondsSince(start);
+
+	s_sink = results[size / 2].m[0][0];
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times multiplying matrices.
+*/
+/******************************************************************************/
+double Mtx44Multiply(int size, int& ops)
+{
+	std::vector<M5Vec2> points;
+	std::vector<M5Mtx44> worlds(size);
+	std::vector<M5Mtx44> results(size);
+	M5Mtx44 camera;
+	MakePoints(points, size);
+	M5Mtx44::MakeTranslate(camera, 100.0f, 100.0f, 0.0f);
+	for (int i = 0; i < size; ++i)
+		M5Mtx44::MakeTranslate(worlds[i], points[i].x, points[i].y, 0.0f);
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		M5Mtx44::Multiply(results[i], camera, worlds[i]);
+	double time = SecondsSince(start);
+
+	s_sink = results[size / 2].m[0][3];
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times circle tests between neighboring circles.
+*/
+/******************************************************************************/
+double IntersectCircleCircle(int size, int& ops)
+{
+	std::vector<M5Vec2> points;
+	MakePoints(points, size + 1);
+
+	int hits = 0;
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		hits += M5Intersect::CircleCircle(points[i], 50.0f, points[i + 1], 50.0f);
+	double time = SecondsSince(start);
+
+	s_sink = static_cast<float>(hits);
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times rectangle tests between neighboring rectangles.
+*/
+/******************************************************************************/
+double IntersectRectRect(int size, int& ops)
+{
+	std::vector<M5Vec2> points;
+	MakePoints(points, size + 1);
+
+	int hits = 0;
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		hits += M5Intersect::RectRect(points[i], 100.0f, 50.0f, points[i + 1], 100.0f, 50.0f);
+	double time = SecondsSince(start);
+
+	s_sink = static_cast<float>(hits);
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times reading an ArcheType file and getting its values.
+*/
+/******************************************************************************/
+double IniFileRead(int size, int& ops)
+{
+	M5IniFile iniFile;
+	float total = 0;
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+	{
+		float value = 0;
+		iniFile.ReadFile(INI_FILE);
+		iniFile.GetValue("scaleX", value);
+		total += value;
+		iniFile.SetToSection("ColliderComponent");
+		iniFile.GetValue("radius", value);
+		total += value;
+	}
+	double time = SecondsSince(start);
+
+	s_sink = total;
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times building components the way the M5ObjectManager did before the builders
+were a generated table, with a hash table of virtual builders.
+*/
+/******************************************************************************/
+double FactoryBuild(int size, int& ops)
+{
+	typedef M5BaseTBuilder<M5Component> Builder;
+	M5Factory<M5ComponentTypes, Builder, M5Component> factory;
+	factory.AddBuilder(CT_ClampComponent, new PoolTBuilder<ClampComponent, CT_ClampComponent>());
+	factory.AddBuilder(CT_ColliderComponent, new PoolTBuilder<ColliderComponent, CT_ColliderComponent>());
+	factory.AddBuilder(CT_GfxComponent, new PoolTBuilder<GfxComponent, CT_GfxComponent>());
+	factory.AddBuilder(CT_OutsideViewKillComponent, new PoolTBuilder<OutsideViewKillComponent, CT_OutsideViewKillComponent>());
+	factory.AddBuilder(CT_RepositionComponent, new PoolTBuilder<RepositionComponent, CT_RepositionComponent>());
+	factory.AddBuilder(CT_UIButtonComponent, new PoolTBuilder<UIButtonComponent, CT_UIButtonComponent>());
+	factory.AddBuilder(CT_WrapComponent, new PoolTBuilder<WrapComponent, CT_WrapComponent>());
+	std::vector<M5Component*> components(size);
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		components[i] = factory.Build(CT_ColliderComponent);
+	double time = SecondsSince(start);
+
+	for (int i = 0; i < size; ++i)
+		delete components[i];
+
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times building components from the generated table of builders.
+*/
+/******************************************************************************/
+double CreateComponent(int size, int& ops)
+{
+	std::vector<M5Component*> components(size);
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		components[i] = M5ObjectManager::CreateComponent(CT_ColliderComponent);
+	double time = SecondsSince(start);
+
+	for (int i = 0; i < size; ++i)
+		delete components[i];
+
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+The old generated StringToArcheType, which compared the string to every
+archetype name in order until one matched.
+
+\param [in] string
+The name to convert.
+
+\return
+The matching M5ArcheTypes or AT_INVALID.
+*/
+/******************************************************************************/
+M5ArcheTypes StringToArcheTypeChain(const std::string& string)
+{
+	for (int i = 0; i < AT_INVALID; ++i)
+	{
+		if (string == ARCHETYPE_NAMES[i])
+			return static_cast<M5ArcheTypes>(i);
+	}
+	return AT_INVALID;
+}
+/******************************************************************************/
+/*!
+Times converting random archetype names to M5ArcheTypes.
+
+\param [in] pConvert
+The function that converts a name.
+
+\param [in] size
+The number of names to convert.
+
+\param [out] ops
+The number of names converted.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+double TimeStringToArcheType(M5ArcheTypes(*pConvert)(const std::string&), int size, int& ops)
+{
+	std::vector<std::string> names(size);
+	for (int i = 0; i < size; ++i)
+		names[i] = ARCHETYPE_NAMES[M5Random::GetInt() % AT_INVALID];
+
+	int total = 0;
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		total += pConvert(names[i]);
+	double time = SecondsSince(start);
+
+	s_sink = static_cast<float>(total);
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times converting names with a string compare for each archetype.
+*/
+/******************************************************************************/
+double ArcheTypeChain(int size, int& ops)
+{
+	return TimeStringToArcheType(StringToArcheTypeChain, size, ops);
+}
+/******************************************************************************/
+/*!
+Times converting names with the generated switch on the name's hash.
+*/
+/******************************************************************************/
+double ArcheTypeSwitch(int size, int& ops)
+{
+	return TimeStringToArcheType(StringToArcheType, size, ops);
+}
+/******************************************************************************/
+/*!
+Times recording frame times in microseconds, which M5Telemetry does several
+times every frame.
+*/
+/******************************************************************************/
+double HistogramRecord(int size, int& ops)
+{
+	M5Histogram histogram;
+	std::vector<unsigned> values(size);
+	for (int i = 0; i < size; ++i)
+		values[i] = static_cast<unsigned>(M5Random::GetFloat(0.0f, 50000.0f));
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		histogram.Record(values[i]);
+	double time = SecondsSince(start);
+
+	s_sink = static_cast<float>(histogram.GetPercentile(99));
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times a frame of text that was also written last frame, like a debug overlay.
+*/
+/******************************************************************************/
+double TextWrite(int size, int& ops)
+{
+	M5TextBatch batch;
+	std::vector<std::string> lines(size);
+	char text[64];
+	for (int i = 0; i < size; ++i)
+	{
+		std::snprintf(text, sizeof(text), "Object %d pos (%.2f, %.2f)", i,
+			M5Random::GetFloat(-WORLD_SIZE, WORLD_SIZE), M5Random::GetFloat(-WORLD_SIZE, WORLD_SIZE));
+		lines[i] = text;
+		batch.Write(text, 0.0f, static_cast<float>(i), 1.5f, 0xffffffff);
+	}
+	batch.EndFrame();
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		batch.Write(lines[i].c_str(), 0.0f, static_cast<float>(i), 1.5f, 0xffffffff);
+	double time = SecondsSince(start);
+
+	s_sink = static_cast<float>(batch.GetVertices().size());
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times drawing frames of rotated, alpha blended 32 pixel sprites at 1280x720
+with the software backend, using this thread and its workers.  An operation
+is one sprite in one frame, so op/s in the output is sprites per second.
+*/
+/******************************************************************************/
+double SoftRender(int size, int& ops)
+{
+	const int   FRAMES = 5;
+	const int   WIDTH = 1280;
+	const int   HEIGHT = 720;
+	const int   TEXTURE_SIZE = 32;
+	const float SPRITE_SIZE = 32.0f;
+
+	M5SoftRenderBackend backend;
+	backend.Init(0);
+
+	std::vector<unsigned char> pixels(TEXTURE_SIZE * TEXTURE_SIZE * 4);
+	for (size_t i = 0; i < pixels.size(); ++i)
+		pixels[i] = static_cast<unsigned char>(M5Random::GetInt() % 256);
+	int textureID = backend.CreateTexture(&pixels[0], TEXTURE_SIZE, TEXTURE_SIZE, GL_RGBA);
+
+	M5RenderFrame frame;
+	frame.width = WIDTH;
+	frame.height = HEIGHT;
+	frame.viewport[0] = 0;
+	frame.viewport[1] = 0;
+	frame.viewport[2] = WIDTH;
+	frame.viewport[3] = HEIGHT;
+	frame.background[0] = frame.background[1] = frame.background[2] = 0.0f;
+	for (int i = 0; i < 16; ++i)
+		frame.persp[i] = frame.camera[i] = (i % 5 == 0) ? 1.0 : 0.0;
+
+	frame.hud.resize(size);
+	for (int i = 0; i < size; ++i)
+	{
+		M5RenderItem& item = frame.hud[i];
+		item.world.MakeTransform(SPRITE_SIZE, SPRITE_SIZE, M5Random::GetFloat(0.0f, M5Math::TWO_PI),
+			M5Random::GetFloat(0.0f, static_cast<float>(WIDTH)),
+			M5Random::GetFloat(0.0f, static_cast<float>(HEIGHT)), 0.0f);
+		item.texCoords.MakeIdentity();
+		item.textureID = textureID;
+		item.color[0] = item.color[1] = item.color[2] = item.color[3] = 255;
+	}
+
+	/*The first frame makes the frame buffer and tile lists*/
+	backend.StartThread();
+	backend.Execute(frame);
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < FRAMES; ++i)
+		backend.Execute(frame);
+	double time = SecondsSince(start);
+
+	backend.EndThread();
+	backend.DeleteTexture(textureID);
+
+	ops = size * FRAMES;
+	return time;
+}
+/******************************************************************************/
+/*!
+Writes the results as JSON.
+
+\param [in] fileName
+The file to write.
+
+\param [in] results
+The results to write.
+*/
+/******************************************************************************/
+void WriteResults(const char* fileName, const std::vector<M5BenchResult>& results)
+{
+	FILE* pFile = std::fopen(fileName, "w");
+	M5DEBUG_ASSERT(pFile != 0, "Benchmark results file could not be opened");
+	if (pFile == 0)
+		return;
+
+	/*One result per line, so ReadBaseline doesn't need a full JSON parser*/
+	std::fprintf(pFile, "{\n  \"benchmarks\": [\n");
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		std::fprintf(pFile, "    { \"name\": \"%s\", \"size\": %d, \"ops\": %d, \"nsPerOp\": %.4f, \"bytesPerOp\": %.1f }%s\n",
+			results[i].name.c_str(), results[i].size, results[i].ops, results[i].nsPerOp,
+			results[i].bytesPerOp, (i + 1 < results.size()) ? "," : "");
+	}
+	std::fprintf(pFile, "  ]\n}\n");
+	std::fclose(pFile);
+}
+/******************************************************************************/
+/*!
+Reads results written by WriteResults.
+
+\param [in] fileName
+The file to read.
+
+\param [out] results
+The results in the file.
+*/
+/******************************************************************************/
+void ReadBaseline(const char* fileName, std::vector<M5BenchResult>& results)
+{
+	const char* NAME_KEY = "\"name\": \"";
+	const char* NS_KEY = "\"nsPerOp\": ";
+	const char* BYTES_KEY = "\"bytesPerOp\": ";
+
+	std::ifstream inFile(fileName);
+	M5DEBUG_ASSERT(inFile.is_open(), "Benchmark baseline file could not be opened");
+
+	std::string line;
+	while (std::getline(inFile, line))
+	{
+		size_t nameStart = line.find(NAME_KEY);
+		size_t nsStart = line.find(NS_KEY);
+		if (nameStart == std::string::npos || nsStart == std::string::npos)
+			continue;
+
+		nameStart += std::strlen(NAME_KEY);
+		size_t nameEnd = line.find('"', nameStart);
+		if (nameEnd == std::string::npos)
+			continue;
+
+		M5BenchResult result;
+		result.name = line.substr(nameStart, nameEnd - nameStart);
+		result.size = 0;
+		result.ops = 0;
+		result.nsPerOp = std::atof(line.c_str() + nsStart + std::strlen(NS_KEY));
+
+		/*Older baselines don't have memory results*/
+		size_t bytesStart = line.find(BYTES_KEY);
+		result.bytesPerOp = 0;
+		if (bytesStart != std::string::npos)
+			result.bytesPerOp = std::atof(line.c_str() + bytesStart + std::strlen(BYTES_KEY));
+		results.push_back(result);
+	}
+}
+/******************************************************************************/
+/*!
+Prints how each result changed from the baseline.
+
+\param [in] baselineFile
+The file with the baseline results.
+
+\param [in] results
+The results of this run.
+
+\param [in] threshold
+How much slower, in percent, a benchmark can get before it is a regression.
+
+\return
+The number of benchmarks that are slower than the threshold allows.
+*/
+/******************************************************************************/
+int Compare(const char* baselineFile, const std::vector<M5BenchResult>& results, float threshold)
+{
+	std::vector<M5BenchResult> baseline;
+	ReadBaseline(baselineFile, baseline);
+
+	int regressions = 0;
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const M5BenchResult* pBase = 0;
+		for (size_t j = 0; j < baseline.size() && pBase == 0; ++j)
+		{
+			if (baseline[j].name == results[i].name)
+				pBase = &baseline[j];
+		}
+
+		if (pBase == 0 || pBase->nsPerOp <= 0)
+		{
+			std::printf("M5Benchmark: %-32s not in baseline\n", results[i].name.c_str());
+			continue;
+		}
+
+		double change = (results[i].nsPerOp - pBase->nsPerOp) * 100.0 / pBase->nsPerOp;
+		bool isRegression = change > threshold;
+		if (isRegression)
+			++regressions;
+
+		std::printf("M5Benchmark: %-32s %12.2f ns -> %12.2f ns %+7.1f%%%s\n",
+			results[i].name.c_str(), pBase->nsPerOp, results[i].nsPerOp, change,
+			isRegression ? "  REGRESSION" : "");
+		if (pBase->bytesPerOp > 0 && results[i].bytesPerOp > 0)
+		{
+			std::printf("M5Benchmark: %-32s %12.1f B  -> %12.1f B\n",
+				results[i].name.c_str(), pBase->bytesPerOp, results[i].bytesPerOp);
+		}
+	}
+
+	std::printf("M5Benchmark: %d regressions over %.1f%%\n", regressions, threshold);
+	return regressions;
+}
+}//end unnamed namespace
+
+
+/******************************************************************************/
+/*!
+Times creating objects from an ArcheType and deleting them again.
+*/
+/******************************************************************************/
+double M5Benchmark::CreateDestroy(int size, int& ops)
+{
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		M5ObjectManager::CreateObject(AT_Raider);
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+	double time = SecondsSince(start);
+
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times the frame where every collider dies at once, like clearing a level.
+Dead objects are taken out of M5Phy and M5Gfx during the update, and deleted
+over the next frames, so deleting them isn't timed.  An operation is one
+object.
+*/
+/******************************************************************************/
+double M5Benchmark::DestroyColliders(int size, int& ops)
+{
+	MakeObjects(AT_Bullet, size);
+
+	std::vector<M5Object*> objects;
+	M5ObjectManager::GetAllObjectsByType(AT_Bullet, objects);
+	for (size_t i = 0; i < objects.size(); ++i)
+		objects[i]->isDead = true;
+
+	BenchClock::time_point start = BenchClock::now();
+	M5ObjectManager::Update(DT);
+	double time = SecondsSince(start);
+
+	M5DEBUG_ASSERT(M5Phy::GetColliderCount() == 0, "Dead colliders are still in M5Phy");
+	M5ObjectManager::FlushDestroyQueue();
+
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times updating every object and component for one frame.
+*/
+/******************************************************************************/
+double M5Benchmark::ObjectUpdate(int size, int& ops)
+{
+	/*Raiders need a player to chase*/
+	MakeObjects(AT_Player, 1);
+	MakeObjects(AT_Raider, size);
+
+	BenchClock::time_point start = BenchClock::now();
+	M5ObjectManager::Update(DT);
+	double time = SecondsSince(start);
+
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+
+	ops = size + 1;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times updating a mix of objects one object at a time.
+*/
+/******************************************************************************/
+double M5Benchmark::UpdateMixedPerObject(int size, int& ops)
+{
+	return UpdateMixed(false, size, ops);
+}
+/******************************************************************************/
+/*!
+Times updating a mix of objects one component type at a time.
+*/
+/******************************************************************************/
+double M5Benchmark::UpdateMixedPerType(int size, int& ops)
+{
+	return UpdateMixed(true, size, ops);
+}
+/******************************************************************************/
+/*!
+Times frames of a level that is a third Ufos, a third Bullets and a third
+MenuAsteroids, so components of many types are mixed together in memory.  Every
+component updates every frame so both modes do the same work.  The time is
+the update time of M5ObjectManager::Update, and an operation is one frame.
+
+\param [in] useSystems
+True to update components by type, false to update each object in turn.
+
+\param [in] size
+The number of objects.
+
+\param [out] ops
+The number of operations that were timed.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+double M5Benchmark::UpdateMixed(bool useSystems, int size, int& ops)
+{
+	const int FRAMES = 10;
+
+	bool oldSystems = M5ObjectManager::GetSystemUpdate();
+	bool oldRates = M5ObjectManager::GetUpdateRates();
+	M5ObjectManager::SetSystemUpdate(useSystems);
+	M5ObjectManager::SetUpdateRates(false);
+
+	MakeObjectsInView(AT_Ufo, size / 3);
+	MakeObjectsInView(AT_Bullet, size / 3);
+	MakeObjectsInView(AT_MenuAsteroid, size - 2 * (size / 3));
+
+	double time = 0;
+	for (int i = 0; i < FRAMES; ++i)
+	{
+		M5ObjectManager::Update(DT);
+		time += M5ObjectManager::GetUpdateTime();
+	}
+
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+	M5ObjectManager::SetUpdateRates(oldRates);
+	M5ObjectManager::SetSystemUpdate(oldSystems);
+
+	ops = FRAMES;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times testing every pair of colliders.  An operation is one pair.
+*/
+/******************************************************************************/
+double M5Benchmark::PhyUpdate(int size, int& ops)
+{
+	MakeObjects(AT_Raider, size);
+
+	BenchClock::time_point start = BenchClock::now();
+	M5Phy::Update();
+	double time = SecondsSince(start);
+
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+
+	ops = size * (size - 1) / 2;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times building frames and handing them to the render thread.  Several frames
+are run so the time includes waiting on the render thread, which makes this a
+measure of throughput.  Use -headless to leave out the GPU.  An operation is
+one object in one frame.
+*/
+/******************************************************************************/
+double M5Benchmark::GfxUpdate(int size, int& ops)
+{
+	const int FRAMES = 10;
+	MakeObjects(AT_Raider, size);
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < FRAMES; ++i)
+		M5Gfx::Update();
+	double time = SecondsSince(start);
+
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+
+	ops = size * FRAMES;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times chasers that each steer straight at the player on their own.  This is
+the cost of chasing without the shared flow field.
+*/
+/******************************************************************************/
+double M5Benchmark::ChaseSeek(int size, int& ops)
+{
+	return ChaseUpdate(CT_ChasePlayerComponent, size, ops);
+}
+/******************************************************************************/
+/*!
+Times chasers that steer around obstacles with the shared flow field.  The
+player moves to a new cell every frame, so the field is rebuilt every frame.
+*/
+/******************************************************************************/
+double M5Benchmark::ChaseFlow(int size, int& ops)
+{
+	const int WALLS = 8;
+	for (int i = 0; i < WALLS; ++i)
+	{
+		M5Vec2 center(M5Random::GetFloat(-WORLD_SIZE, WORLD_SIZE),
+			M5Random::GetFloat(-WORLD_SIZE, WORLD_SIZE));
+		M5Nav::AddObstacle(center, WORLD_SIZE * 0.1f);
+	}
+
+	double time = ChaseUpdate(CT_FlowChaseComponent, size, ops);
+	M5Nav::Reset();
+	return time;
+}
+/******************************************************************************/
+/*!
+Times updating objects that only have one chase component for several frames.
+The player moves every frame.  An operation is one chaser in one frame.
+
+\param [in] type
+The chase component to give each object.
+
+\param [in] size
+The number of chasers.
+
+\param [out] ops
+The number of operations that were timed.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+double M5Benchmark::ChaseUpdate(M5ComponentTypes type, int size, int& ops)
+{
+	const int FRAMES = 10;
+	const float CELL_SIZE = 16.0f;
+	M5Nav::SetBounds(M5Vec2(-WORLD_SIZE, -WORLD_SIZE), M5Vec2(WORLD_SIZE, WORLD_SIZE), CELL_SIZE);
+
+	/*Objects are made by hand so nothing else is updated*/
+	M5Object* pPlayer = new M5Object(AT_Player);
+	M5ObjectManager::AddObject(pPlayer);
+	for (int i = 0; i < size; ++i)
+	{
+		M5Object* pObj = new M5Object(AT_Raider);
+		pObj->pos.x = M5Random::GetFloat(-WORLD_SIZE, WORLD_SIZE);
+		pObj->pos.y = M5Random::GetFloat(-WORLD_SIZE, WORLD_SIZE);
+		pObj->AddComponent(M5ObjectManager::CreateComponent(type));
+		M5ObjectManager::AddObject(pObj);
+	}
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < FRAMES; ++i)
+	{
+		pPlayer->pos.x += CELL_SIZE;
+		M5ObjectManager::Update(DT);
+	}
+	double time = SecondsSince(start);
+
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+	M5Nav::UseWorldBounds();
+
+	ops = size * FRAMES;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times writing the delta of one frame of moving Raiders, the work the server
+does for each client every snapshot.  An operation is one object, and the
+bytes are the size of the delta for each object.
+*/
+/******************************************************************************/
+double M5Benchmark::ReplicaEncode(int size, int& ops)
+{
+	/*Raiders need a player to chase*/
+	MakeObjects(AT_Player, 1);
+	MakeObjects(AT_Raider, size);
+
+	M5ReplicaWorld baseline;
+	M5ReplicaWorld world;
+	M5ReplicaWorld check;
+	std::vector<unsigned char> delta;
+	M5ObjectManager::Update(DT);
+	M5ObjectManager::Replicate(baseline);
+	M5ObjectManager::Update(DT);
+	M5ObjectManager::Replicate(world);
+
+	BenchClock::time_point start = BenchClock::now();
+	world.WriteDelta(baseline, delta);
+	double time = SecondsSince(start);
+
+	bool isRead = check.ReadDelta(baseline, &delta[0], delta.size());
+	M5DEBUG_ASSERT(isRead && check.Matches(world), "A replica delta didn't read back to the same world");
+	static_cast<void>(isRead); //Only the assert reads it
+	s_bytesPerOp = static_cast<double>(delta.size()) / (size + 1);
+
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+
+	ops = size + 1;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times saving every object into a snapshot and restoring them all in place,
+like rewinding a level.  An operation is one object, and the bytes are the
+size of the snapshot for each object.  The snapshot is saved once first, so
+the time doesn't include growing it, like a game that reuses one snapshot.
+Afterwards an object is destroyed and restored again, to check it comes back
+with the ID it was saved with.
+*/
+/******************************************************************************/
+double M5Benchmark::SnapshotRestore(int size, int& ops)
+{
+	MakeObjects(AT_Raider, size);
+
+	M5Snapshot snapshot;
+	M5ObjectManager::Snapshot(snapshot);
+
+	BenchClock::time_point start = BenchClock::now();
+	M5ObjectManager::Snapshot(snapshot);
+	M5ObjectManager::Restore(snapshot);
+	double time = SecondsSince(start);
+
+	M5Log::Write(LL_INFO, LC_STAGE, "M5Benchmark: snapshot and restore of %d objects took %.3f ms",
+		size, time * 1000.0);
+	s_bytesPerOp = static_cast<double>(snapshot.GetSize()) / size;
+
+	M5Object* pObj = 0;
+	M5ObjectManager::GetFirstObjectByType(AT_Raider, pObj);
+	int id = pObj->GetID();
+	M5ObjectManager::DestroyObject(id);
+	M5ObjectManager::Restore(snapshot);
+	pObj = 0;
+	M5ObjectManager::GetObjectByID(id, pObj);
+	M5DEBUG_ASSERT(pObj != 0, "A restored object didn't keep its ID");
+
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times a replication server and a client in this process sending frames of
+moving Raiders over 127.0.0.1, one snapshot a frame.  An operation is one
+snapshot written, sent, read and acked, and the bytes are the size of a
+snapshot after the first one, so bandwidth is bytes times the send rate.
+*/
+/******************************************************************************/
+double M5Benchmark::ReplicaLoopback(int size, int& ops)
+{
+	const int   FRAMES = 30;
+	const float SEND_RATE = 60.0f;
+
+	MakeObjects(AT_Player, 1);
+	MakeObjects(AT_Raider, size);
+
+	M5ReplicaClient client;
+	bool isStarted = M5Replication::StartServer(0, SEND_RATE);
+	M5DEBUG_ASSERT(isStarted, "The replication server could not start");
+	static_cast<void>(isStarted); //Only the assert reads it
+	client.Connect("127.0.0.1", M5Replication::GetPort());
+
+	/*The first frame connects and sends every object in full*/
+	M5Replication::Update(DT);
+	client.Update(DT);
+	M5Replication::Update(DT);
+	client.Update(DT);
+	long long startBytes = client.GetReceivedBytes();
+
+	double time = 0;
+	for (int i = 0; i < FRAMES; ++i)
+	{
+		M5ObjectManager::Update(DT);
+		BenchClock::time_point start = BenchClock::now();
+		M5Replication::Update(DT);
+		client.Update(DT);
+		time += SecondsSince(start);
+	}
+
+	M5ReplicaWorld check;
+	M5ObjectManager::Replicate(check);
+	M5DEBUG_ASSERT(client.GetWorld().Matches(check), "The replica client didn't read the last snapshot");
+	s_bytesPerOp = static_cast<double>(client.GetReceivedBytes() - startBytes) / FRAMES;
+
+	client.Disconnect();
+	M5Replication::StopServer();
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+
+	ops = FRAMES;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times streaming a generated level while the camera flies from one corner to
+the other.  The time is the slowest frame of streaming, which is the load
+hitch a player would see, and the bytes are the most memory that objects,
+components and loaded chunks used at the same time.  Frames here are much
+shorter than in the game, so the loading thread is waited for between frames
+as if it had a whole frame to read.  An operation is the whole flight.
+*/
+/******************************************************************************/
+double M5Benchmark::StreamLevel(int size, int& ops)
+{
+	const int   FRAMES = 1000;
+	const float LEVEL_SIZE = 4000.0f;
+	const float CHUNK_SIZE = 100.0f;
+	const float CAMERA_Z = 60.0f;
+	const char* CHUNK_FILE = "Benchmark.m5c";
+
+	std::vector<M5Placement> placements(size);
+	for (int i = 0; i < size; ++i)
+	{
+		placements[i].pos.x = M5Random::GetFloat(-LEVEL_SIZE * .5f, LEVEL_SIZE * .5f);
+		placements[i].pos.y = M5Random::GetFloat(-LEVEL_SIZE * .5f, LEVEL_SIZE * .5f);
+		placements[i].type = (i % 2 == 0) ? AT_Raider : AT_Ufo;
+	}
+	bool isWritten = M5StreamManager::WriteChunkFile(CHUNK_FILE, placements, CHUNK_SIZE);
+	M5DEBUG_ASSERT(isWritten, "The benchmark chunk file could not be written");
+	static_cast<void>(isWritten); //Only the assert reads it
+	std::vector<M5Placement>().swap(placements);
+
+	bool isOpen = M5StreamManager::Open(CHUNK_FILE);
+	M5DEBUG_ASSERT(isOpen, "The benchmark chunk file could not be opened");
+	static_cast<void>(isOpen); //Only the assert reads it
+
+	double worstFrame = 0;
+	long long peakBytes = 0;
+	long long peakObjectBytes = 0;
+	int peakObjects = 0;
+	for (int i = 0; i < FRAMES; ++i)
+	{
+		float along = (static_cast<float>(i) / (FRAMES - 1) - .5f) * LEVEL_SIZE * .9f;
+		M5Gfx::SetCamera(along, along, CAMERA_Z, 0);
+
+		BenchClock::time_point start = BenchClock::now();
+		M5StreamManager::Update();
+		worstFrame = std::max(worstFrame, SecondsSince(start));
+		M5ObjectManager::UpdateDestroyQueue();
+		M5StreamManager::WaitForLoads();
+
+		M5MemoryStats stream;
+		M5Memory::GetStats(MT_STREAM, stream);
+		long long objectBytes = GetObjectBytes();
+		if (objectBytes + stream.liveBytes > peakBytes)
+			peakBytes = objectBytes + stream.liveBytes;
+		if (objectBytes > peakObjectBytes)
+		{
+			peakObjectBytes = objectBytes;
+			peakObjects = M5ObjectManager::GetObjectCount();
+		}
+	}
+
+	M5StreamStats stats;
+	M5StreamManager::GetStats(stats);
+	M5Log::Write(LL_INFO, LC_STAGE, "M5Benchmark: streamed %d chunks, peak %d objects, %.1f MB peak, %.2f ms worst frame",
+		stats.chunkCount, peakObjects, peakBytes / (1024.0 * 1024.0), worstFrame * 1000.0);
+	if (peakObjects != 0)
+	{
+		M5Log::Write(LL_INFO, LC_STAGE, "M5Benchmark: making all %d objects up front would need about %.1f MB",
+			size, static_cast<double>(peakObjectBytes) / peakObjects * size / (1024.0 * 1024.0));
+	}
+	s_bytesPerOp = static_cast<double>(peakBytes);
+
+	M5StreamManager::Close();
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+	M5Gfx::SetCamera(0, 0, CAMERA_Z, 0);
+	std::remove(CHUNK_FILE);
+
+	ops = 1;
+	return worstFrame;
+}
+/******************************************************************************/
+/*!
+Times loading archetypes with the load threads set to 1.
+*/
+/******************************************************************************/
+double M5Benchmark::LoadArcheTypes1(int size, int& ops)
+{
+	return LoadArcheTypes(1, size, ops);
+}
+/******************************************************************************/
+/*!
+Times loading archetypes with the load threads set to 4.
+*/
+/******************************************************************************/
+double M5Benchmark::LoadArcheTypes4(int size, int& ops)
+{
+	return LoadArcheTypes(4, size, ops);
+}
+/******************************************************************************/
+/*!
+Times loading archetypes with the load threads set to 8.
+*/
+/******************************************************************************/
+double M5Benchmark::LoadArcheTypes8(int size, int& ops)
+{
+	return LoadArcheTypes(8, size, ops);
+}
+/******************************************************************************/
+/*!
+Times loading archetypes the way M5ObjectManager does at startup.  Copies of
+the Ufo archetype are written first, each with its own copy of the texture,
+so every file is read and every texture decoded and made.  The textures are
+evicted afterwards so the next run loads them again.  An operation is one
+archetype read and built.
+
+\param [in] threadCount
+The number of load threads.
+
+\param [in] size
+The number of archetypes to load.
+
+\param [out] ops
+The number of operations that were timed.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+double M5Benchmark::LoadArcheTypes(int threadCount, int size, int& ops)
+{
+	std::ifstream textureIn(TEXTURE_FILE, std::ios::in | std::ios::binary);
+	M5DEBUG_ASSERT(textureIn.is_open(), "The benchmark texture could not be opened");
+	std::string texture((std::istreambuf_iterator<char>(textureIn)), std::istreambuf_iterator<char>());
+
+	M5IniFile archeType;
+	archeType.ReadFile(ARCHETYPE_FILE);
+	archeType.SetToSection("GfxComponent");
+
+	std::vector<M5ArcheTypeFile> files(size);
+	for (int i = 0; i < size; ++i)
+	{
+		std::string name = "BenchmarkArcheType" + std::to_string(i);
+		std::ofstream textureOut(name + ".tga", std::ios::out | std::ios::binary);
+		textureOut.write(texture.data(), texture.size());
+
+		/*Texture names are relative to the Textures folder*/
+		archeType.AddKeyValue("texture", "../" + name + ".tga");
+		archeType.WriteFile(name + ".ini");
+
+		files[i].type = AT_Ufo;
+		files[i].fileName = name + ".ini";
+	}
+
+	int oldThreads = M5ObjectManager::GetLoadThreads();
+	M5ObjectManager::SetLoadThreads(threadCount);
+	std::vector<M5Object*> prototypes(size);
+
+	BenchClock::time_point start = BenchClock::now();
+	M5ObjectManager::ReadArcheTypes(files);
+	for (int i = 0; i < size; ++i)
+		prototypes[i] = M5ObjectManager::BuildArcheType(files[i].type, files[i].file);
+	double time = SecondsSince(start);
+
+	M5ObjectManager::SetLoadThreads(oldThreads);
+	M5Log::Write(LL_INFO, LC_OBJECTS, "M5Benchmark: loaded %d archetypes in %.1f ms on %d threads",
+		size, time * 1000.0, threadCount);
+
+	M5TextureStats textures;
+	M5Gfx::GetTextureStats(textures);
+	M5Gfx::SetTextureBudget(0);
+	for (int i = 0; i < size; ++i)
+	{
+		delete prototypes[i];
+		std::string name = "BenchmarkArcheType" + std::to_string(i);
+		std::remove((name + ".tga").c_str());
+		std::remove((name + ".ini").c_str());
+	}
+	M5Gfx::SetTextureBudget(textures.budget);
+
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times updating a level with every component updated every frame.
+*/
+/******************************************************************************/
+double M5Benchmark::UpdateEveryFrame(int size, int& ops)
+{
+	return UpdateLevel(false, size, ops);
+}
+/******************************************************************************/
+/*!
+Times updating a level with the AI components at their M5UpdateRate.
+*/
+/******************************************************************************/
+double M5Benchmark::UpdateAtRates(int size, int& ops)
+{
+	return UpdateLevel(true, size, ops);
+}
+/******************************************************************************/
+/*!
+Times one second of frames of a level that is half Raiders and half Ufos, so
+half of the objects have a FlowChaseComponent and half a RandomGoComponent.
+The time is the component update time of M5ObjectManager::Update, and an
+operation is one frame.  The average and worst frames are logged, since
+spreading the slower updates out should keep the worst frame close to the
+average.
+
+\param [in] useRates
+True to update the AI components at their M5UpdateRate, false for every frame.
+
+\param [in] size
+The number of objects.
+
+\param [out] ops
+The number of operations that were timed.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+double M5Benchmark::UpdateLevel(bool useRates, int size, int& ops)
+{
+	const int FRAMES = 60;
+
+	/*Raiders need a player to chase*/
+	MakeObjects(AT_Player, 1);
+	MakeObjects(AT_Raider, size / 2);
+	MakeObjects(AT_Ufo, size - size / 2);
+
+	bool oldRates = M5ObjectManager::GetUpdateRates();
+	M5ObjectManager::SetUpdateRates(useRates);
+
+	double time = 0;
+	double worstFrame = 0;
+	for (int i = 0; i < FRAMES; ++i)
+	{
+		M5ObjectManager::Update(DT);
+		double frame = M5ObjectManager::GetUpdateTime();
+		time += frame;
+		worstFrame = std::max(worstFrame, frame);
+	}
+
+	M5ObjectManager::SetUpdateRates(oldRates);
+	M5Log::Write(LL_INFO, LC_OBJECTS, "M5Benchmark: %d objects, %.2f ms average and %.2f ms worst update with rates %s",
+		size, time * 1000.0 / FRAMES, worstFrame * 1000.0, useRates ? "on" : "off");
+
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+
+	ops = FRAMES;
+	return time;
+}
+/******************************************************************************/
+/*!
+Times cloning Raiders from their ArcheType.
+*/
+/******************************************************************************/
+double M5Benchmark::CloneRaider(int size, int& ops)
+{
+	return CloneArcheType(AT_Raider, size, ops);
+}
+/******************************************************************************/
+/*!
+Times cloning Bullets from their ArcheType.
+*/
+/******************************************************************************/
+double M5Benchmark::CloneBullet(int size, int& ops)
+{
+	return CloneArcheType(AT_Bullet, size, ops);
+}
+/******************************************************************************/
+/*!
+Times creating objects from an ArcheType, and measures the object and
+component memory each one uses.  Settings shared with the prototype aren't
+counted, since they are only allocated once.
+
+\param [in] type
+The ArcheType to clone.
+
+\param [in] size
+The number of objects to create.
+
+\param [out] ops
+The number of operations that were timed.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+double M5Benchmark::CloneArcheType(M5ArcheTypes type, int size, int& ops)
+{
+	long long startBytes = GetObjectBytes();
+
+	BenchClock::time_point start = BenchClock::now();
+	for (int i = 0; i < size; ++i)
+		M5ObjectManager::CreateObject(type);
+	double time = SecondsSince(start);
+
+	s_bytesPerOp = static_cast<double>(GetObjectBytes() - startBytes) / size;
+	M5ObjectManager::DestroyAllObjects();
+	M5ObjectManager::FlushDestroyQueue();
+
+	ops = size;
+	return time;
+}
+/******************************************************************************/
+/*!
+Runs every benchmark and writes the results as JSON.  If a baseline file is
+given, each result is compared with the time saved in the baseline and every
+benchmark that got slower by more than the threshold is printed.
+
+\attention
+This must be called after M5App::Init and before the first stage starts,
+since it creates and destroys game objects.
+
+\param [in] resultFile
+The JSON file to write the results to.
+
+\param [in] baselineFile
+JSON results from an earlier run to compare against, or 0 for no comparison.
+
+\param [in] threshold
+How much slower, in percent, a benchmark can get before it is a regression.
+
+\return
+The number of benchmarks that are slower than the baseline.
+*/
+/******************************************************************************/
+int M5Benchmark::Run(const char* resultFile, const char* baselineFile, float threshold)
+{
+	const M5BenchTest tests[] =
+	{
+		{ "M5Vec2::Normalize",               10000, Vec2Normalize },
+		{ "M5Vec2::Integrate",               10000, Vec2Integrate },
+		{ "M5Vec2Batch::AddScaled",          10000, Vec2BatchIntegrate },
+		{ "std::sin/std::cos",               10000, StdSinCos },
+		{ "M5FastMath::SinCos",              10000, FastSinCos },
+		{ "std::atan2",                      10000, StdAtan2 },
+		{ "M5FastMath::Atan2",               10000, FastAtan2 },
+		{ "M5Mtx44::MakeTransform",          10000, Mtx44Transform },
+		{ "M5Mtx44::Multiply",               10000, Mtx44Multiply },
+		{ "M5Intersect::CircleCircle",       10000, IntersectCircleCircle },
+		{ "M5Intersect::RectRect",           10000, IntersectRectRect },
+		{ "M5IniFile::ReadFile",             100,   IniFileRead },
+		{ "M5Factory::Build",                1000,  FactoryBuild },
+		{ "M5ObjectManager::CreateComponent",1000,  CreateComponent },
+		{ "StringToArcheType if chain",      10000, ArcheTypeChain },
+		{ "StringToArcheType",               10000, ArcheTypeSwitch },
+		{ "M5TextBatch::Write",              1000,  TextWrite },
+		{ "M5Histogram::Record",             10000, HistogramRecord },
+		{ "M5ObjectManager::CreateDestroy",  1000,  CreateDestroy },
+		{ "Destroy colliders in one frame",  20000, DestroyColliders },
+		{ "M5ObjectManager::Update",         1000,  ObjectUpdate },
+		{ "Mixed update per object",         50000, UpdateMixedPerObject },
+		{ "Mixed update per type",           50000, UpdateMixedPerType },
+		{ "M5Phy::Update",                   500,   PhyUpdate },
+		{ "M5Gfx::Update",                   1000,  GfxUpdate },
+		{ "M5SoftRenderBackend 1280x720",    10000, SoftRender },
+		{ "ChasePlayerComponent::Update",    10000, ChaseSeek },
+		{ "FlowChaseComponent::Update",      10000, ChaseFlow },
+		{ "M5ReplicaWorld::WriteDelta",      5000,  ReplicaEncode },
+		{ "M5Replication 60Hz loopback",     5000,  ReplicaLoopback },
+		{ "Snapshot and restore",            10000, SnapshotRestore },
+		{ "M5StreamManager worst frame",     500000, StreamLevel },
+		{ "Load ArcheTypes 1 thread",        400,   LoadArcheTypes1 },
+		{ "Load ArcheTypes 4 threads",       400,   LoadArcheTypes4 },
+		{ "Load ArcheTypes 8 threads",       400,   LoadArcheTypes8 },
+		{ "Level update every frame",        20000, UpdateEveryFrame },
+		{ "Level update AI at 10Hz",         20000, UpdateAtRates },
+		{ "M5Object::Clone Raider",          1000,  CloneRaider },
+		{ "M5Object::Clone Bullet",          1000,  CloneBullet }
+	};
+	const int TEST_COUNT = sizeof(tests) / sizeof(tests[0]);
+
+	std::vector<M5BenchResult> results;
+	for (int i = 0; i < TEST_COUNT; ++i)
+	{
+		M5BenchResult result;
+		result.name = tests[i].name;
+		result.size = tests[i].size;
+		result.ops = 0;
+		result.nsPerOp = 0;
+		result.bytesPerOp = 0;
+
+		/*The first run only warms up the caches*/
+		for (int run = 0; run <= REPEATS; ++run)
+		{
+			int ops = 1;
+			M5Random::Seed(SEED);
+			s_bytesPerOp = 0;
+			double time = tests[i].pFunc(tests[i].size, ops);
+			double nsPerOp = time * 1000000000.0 / ops;
+			result.ops = ops;
+			result.bytesPerOp = s_bytesPerOp;
+			if (run == 1 || (run > 1 && nsPerOp < result.nsPerOp))
+				result.nsPerOp = nsPerOp;
+		}
+
+		if (result.bytesPerOp > 0)
+		{
+			std::printf("M5Benchmark: %-32s %8d %12.2f ns %14.0f op/s %10.1f B\n",
+				result.name.c_str(), result.size, result.nsPerOp, 1000000000.0 / result.nsPerOp,
+				result.bytesPerOp);
+		}
+		else
+		{
+			std::printf("M5Benchmark: %-32s %8d %12.2f ns %14.0f op/s\n",
+				result.name.c_str(), result.size, result.nsPerOp, 1000000000.0 / result.nsPerOp);
+		}
+		results.push_back(result);
+	}
+
+	WriteResults(resultFile, results);
+
+	int regressions = 0;
+	if (baselineFile != 0)
+		regressions = Compare(baselineFile, results, threshold);
+
+	std::fflush(stdout);
+	return regressions;
+}
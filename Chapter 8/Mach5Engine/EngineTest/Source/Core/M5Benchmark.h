@@ -0,0 +1,55 @@
+/******************************************************************************/
+/*!
+\file   M5Benchmark.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/26
+
+Singleton class to time the core engine functions and compare the times to a
+saved baseline.
+
+*/
+/******************************************************************************/
+#ifndef M5_BENCHMARK_H
+#define M5_BENCHMARK_H
+
+#include "M5ComponentTypes.h"
+#include "M5ArcheTypes.h"
+
+//! Singleton class to time the core engine functions.
+class M5Benchmark
+{
+public:
+	//Times every benchmark, saves the results and compares them to a baseline
+	static int Run(const char* resultFile, const char* baselineFile, float threshold);
+private:
+	static double CreateDestroy(int size, int& ops);
+	static double DestroyColliders(int size, int& ops);
+	static double ObjectUpdate(int size, int& ops);
+	static double UpdateMixedPerObject(int size, int& ops);
+	static double UpdateMixedPerType(int size, int& ops);
+	static double UpdateMixed(bool useSystems, int size, int& ops);
+	static double PhyUpdate(int size, int& ops);
+	static double GfxUpdate(int size, int& ops);
+	static double ChaseSeek(int size, int& ops);
+	static double ChaseFlow(int size, int& ops);
+	static double ChaseUpdate(M5ComponentTypes type, int size, int& ops);
+	static double ReplicaEncode(int size, int& ops);
+	static double ReplicaLoopback(int size, int& ops);
+	static double SnapshotRestore(int size, int& ops);
+	static double StreamLevel(int size, int& ops);
+	static double LoadArcheTypes1(int size, int& ops);
+	static double LoadArcheTypes4(int size, int& ops);
+	static double LoadArcheTypes8(int size, int& ops);
+	static double LoadArcheTypes(int threadCount, int size, int& ops);
+	static double UpdateEveryFrame(int size, int& ops);
+	static double UpdateAtRates(int size, int& ops);
+	static double UpdateLevel(bool useRates, int size, int& ops);
+	static double CloneRaider(int size, int& ops);
+	static double CloneBullet(int size, int& ops);
+	static double CloneArcheType(M5ArcheTypes type, int size, int& ops);
+};//end M5Benchmark
+
+
+#endif //M5_BENCHMARK_H
@@ -25,5 +25,15 @@ public:
 	virtual M5Command* Clone(void) const = 0;
 };
 
+//! Creates a new command, RegisterCommands.cpp has a table of these by M5CommandTypes
+typedef M5Command* (*M5CommandBuilder)(void);
+
+//! Creates a new command of type T
+template <typename T>
+M5Command* M5BuildCommand(void)
+{
+	return new T();
+}
+
 
 #endif //M5COMMAND_H
\ No newline at end of file
@@ -13,6 +13,7 @@ and creates an enumeration value of CMD_*Command.
 #ifndef M5COMMAND_TYPE_H 
 #define M5COMMAND_TYPE_H 
 #include <string> 
+#include "M5Hash.h" 
  
  
 //! AutoGenerated enum based on command file names  
@@ -29,12 +30,14 @@ CMD_INVALID
  
 //! AutoGenerated function to convert strings to our M5CommandTypes type 
 inline M5CommandTypes StringToCommand(const std::string& string) { 
-if(string == "ChangeResolutionCommand") return CMD_ChangeResolutionCommand; 
-if(string == "ChangeStageCommand") return CMD_ChangeStageCommand; 
-if(string == "PauseStageCommand") return CMD_PauseStageCommand; 
-if(string == "QuitCommand") return CMD_QuitCommand; 
-if(string == "ResumeStageCommand") return CMD_ResumeStageCommand; 
-if(string == "SetFullscreenCommand") return CMD_SetFullscreenCommand; 
+switch (M5Hash(string.c_str())) { 
+case M5HashLiteral("ChangeResolutionCommand"): return (string == "ChangeResolutionCommand") ? CMD_ChangeResolutionCommand : CMD_INVALID; 
+case M5HashLiteral("ChangeStageCommand"): return (string == "ChangeStageCommand") ? CMD_ChangeStageCommand : CMD_INVALID; 
+case M5HashLiteral("PauseStageCommand"): return (string == "PauseStageCommand") ? CMD_PauseStageCommand : CMD_INVALID; 
+case M5HashLiteral("QuitCommand"): return (string == "QuitCommand") ? CMD_QuitCommand : CMD_INVALID; 
+case M5HashLiteral("ResumeStageCommand"): return (string == "ResumeStageCommand") ? CMD_ResumeStageCommand : CMD_INVALID; 
+case M5HashLiteral("SetFullscreenCommand"): return (string == "SetFullscreenCommand") ? CMD_SetFullscreenCommand : CMD_INVALID; 
+} 
 return CMD_INVALID; 
 } 
 #endif //M5COMMAND_TYPE_H 
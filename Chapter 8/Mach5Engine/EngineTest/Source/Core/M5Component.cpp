@@ -11,12 +11,23 @@ Base class component for M5Objects
 */
 /******************************************************************************/
 #include "M5Component.h"
+#include "M5ObjectManager.h"
+#include "M5ComponentPool.h"
+#include <cmath>
+
+namespace
+{
+const unsigned PHASE_STEP = 2654435769u;  //!< Golden ratio fraction of 2^32, so the first updates of new components are spread out
+const float    PHASE_SCALE = 1.0f / 4294967296.0f; //!< Turns a 32 bit phase into a fraction of the interval
+}
 
 int M5Component::s_componentID = 0;
 
 /******************************************************************************/
 /*!
-Constructor to set the type of component as well as defaults.
+Constructor to set the type of component as well as defaults.  Components of
+a type with an M5UpdateRate start their timer part way through the interval,
+so components made in the same frame don't all update in the same frame.
 
 \param [in] type
 The type of this component.
@@ -26,17 +37,78 @@ M5Component::M5Component(M5ComponentTypes type):
 	isDead(false),
 	m_pObj(0), 
 	m_type(type),
-	m_id(++s_componentID)
+	m_id(++s_componentID),
+	m_systemIndex(-1),
+	m_updateInterval(M5ObjectManager::GetUpdateInterval(type)),
+	m_untilUpdate(0),
+	m_sinceUpdate(0)
 {
+	if (m_updateInterval > 0)
+	{
+		//Unsigned math wraps, so the phase stays exact however big the id gets
+		unsigned phase = static_cast<unsigned>(m_id) * PHASE_STEP;
+		m_untilUpdate = phase * PHASE_SCALE * m_updateInterval;
+	}
 }
 /******************************************************************************/
 /*!
-  Virtual destructor because this is used as a base class.
+  Virtual destructor because this is used as a base class.  Removes the
+  component from the type based update if needed.
 */
 /******************************************************************************/
 M5Component::~M5Component(void) 
 {
-	 //Empty Base Class virtual destructor 
+	//Make sure the type based update doesn't use a deleted component
+	if (m_systemIndex >= 0)
+		M5ObjectManager::UnregisterComponent(this);
+}
+/******************************************************************************/
+/*!
+Allocates memory for a component in the M5ComponentPool of its type, so
+components of one type are next to each other.  Derived components use this
+with new (CT_MyComponent) MyComponent.
+
+\param [in] size
+The number of bytes to allocate.
+
+\param [in] type
+The type of the component being made.
+
+\return
+The memory for the component.
+*/
+/******************************************************************************/
+void* M5Component::operator new(size_t size, M5ComponentTypes type)
+{
+	return M5ComponentPool::Allocate(type, size);
+}
+/******************************************************************************/
+/*!
+Frees memory allocated by operator new when a constructor throws.
+
+\param [in] pMemory
+The memory to free.
+
+\param [in] type
+The type the memory was allocated for.
+*/
+/******************************************************************************/
+void M5Component::operator delete(void* pMemory, M5ComponentTypes /*type*/)
+{
+	M5ComponentPool::Free(pMemory);
+}
+/******************************************************************************/
+/*!
+Frees memory allocated by operator new.  The slot remembers its type, so it
+goes back to the right pool.
+
+\param [in] pMemory
+The memory to free.
+*/
+/******************************************************************************/
+void M5Component::operator delete(void* pMemory)
+{
+	M5ComponentPool::Free(pMemory);
 }
 /******************************************************************************/
 /*!
@@ -49,6 +121,59 @@ void M5Component::FromFile(M5IniFile&)
 }
 /******************************************************************************/
 /*!
+Virtual function to save the data of the component into a snapshot.  A
+component without data doesn't need to override this.
+
+\param [in] snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+void M5Component::Save(M5Snapshot&) const
+{
+	//empty for the base class
+}
+/******************************************************************************/
+/*!
+Virtual function to restore the data of the component from a snapshot.  This
+must read exactly what Save wrote.
+
+\param [in] snapshot
+The snapshot to read from.
+*/
+/******************************************************************************/
+void M5Component::Load(M5Snapshot&)
+{
+	//empty for the base class
+}
+/******************************************************************************/
+/*!
+Virtual function to save the data that a replication client needs to show the
+component.  It is sent again whenever the bytes change, so only write what
+clients need and what changes rarely.  Most components don't need to override
+this.
+
+\param [in] snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+void M5Component::Replicate(M5Snapshot&) const
+{
+	//empty for the base class
+}
+/******************************************************************************/
+/*!
+Virtual function to remove the component from any engine lists, so it has no
+effect while it waits to be deleted.  A component that registers with an engine
+must override this.  It will be called again by the destructor, so it must be
+safe to call twice.
+*/
+/******************************************************************************/
+void M5Component::Unregister(void)
+{
+	//empty for the base class
+}
+/******************************************************************************/
+/*!
 Allows the parent pointer to be be set by the user
 
 \param [in] pObject
@@ -73,6 +198,51 @@ M5ComponentTypes M5Component::GetType(void) const
 }
 /******************************************************************************/
 /*!
+Advances the update timer by one frame and checks if this component should be
+updated.  Components without an M5UpdateRate are due every frame.  The rest
+are due when their interval has passed, or on a frame with an event, and are
+given all of the time since their last update.  If a long frame skips past a
+turn, the next turn is still on the same beat so the updates stay spread out.
+
+\param [in] dt
+The time in seconds since the last frame.
+
+\param [out] updateDt
+The time to pass to Update.
+
+\return
+True if Update should be called this frame.
+*/
+/******************************************************************************/
+bool M5Component::IsDue(float dt, float& updateDt)
+{
+	updateDt = dt;
+	if (m_updateInterval == 0 || !M5ObjectManager::GetUpdateRates())
+	{
+		m_sinceUpdate = 0;
+		return true;
+	}
+
+	m_sinceUpdate += dt;
+	if (m_updateInterval < 0)
+	{
+		if (!M5ObjectManager::HasEvent(m_type))
+			return false;
+	}
+	else
+	{
+		m_untilUpdate -= dt;
+		if (m_untilUpdate > 0)
+			return false;
+		m_untilUpdate = m_updateInterval + std::fmod(m_untilUpdate, m_updateInterval);
+	}
+
+	updateDt = m_sinceUpdate;
+	m_sinceUpdate = 0;
+	return true;
+}
+/******************************************************************************/
+/*!
 Returns the unique id of this component.
 
 \return 
@@ -12,25 +12,46 @@ Base class component for M5Objects
 #ifndef M5COMPONENT_H
 #define M5COMPONENT_H
 #include "M5ComponentTypes.h"
+#include <cstddef>
 
 //Forward declarations
 class M5Object;
 class M5IniFile;
+class M5Snapshot;
 
 //! Base class component for M5Objects
 class M5Component
 {
 public:
+	friend class M5ObjectManager;
+	friend class M5Object;
+
 	M5Component(M5ComponentTypes type);
 	virtual ~M5Component(void);
+	//! Components are made in the M5ComponentPool of their type, use new (type) T
+	static void* operator new(size_t size, M5ComponentTypes type);
+	//! Frees memory allocated by operator new if the constructor throws
+	static void  operator delete(void* pMemory, M5ComponentTypes type);
+	//! Frees memory allocated by operator new
+	static void  operator delete(void* pMemory);
 	//! virtual constructor for M5Component, must override
 	virtual M5Component* Clone(void) const = 0;
 	//! the per frame behavoir of component,must override
 	virtual void     Update(float dt)= 0;
 	virtual void     FromFile(M5IniFile&);
+	//! Saves the data needed to restore this component, override if it has data
+	virtual void     Save(M5Snapshot&) const;
+	//! Restores the data written by Save, in the same order
+	virtual void     Load(M5Snapshot&);
+	//! Saves the data clients need to see this component, override if it has any
+	virtual void     Replicate(M5Snapshot&) const;
+	//! Removes the component from any engine lists before it is deleted
+	virtual void     Unregister(void);
 	void             SetParent(M5Object* pParent);
 	M5ComponentTypes GetType(void) const;
 	int              GetID(void) const;
+	//Advances the update timer and checks if Update should be called this frame
+	bool             IsDue(float dt, float& updateDt);
 	//Public data
 	bool                   isDead;        //!< flag to mark for deletion
 protected:
@@ -40,6 +61,10 @@ private:
 	M5Component(const M5Component& rhs) = delete;
 	const int              m_id;          //!< Unique Id for all componnents
 	const M5ComponentTypes m_type;        //!< To of Component used for searching
+	int                    m_systemIndex; //!< Index in the type based update list, -1 if not in it
+	float                  m_updateInterval; //!< Seconds between updates, 0 for every frame, less than 0 for on event
+	float                  m_untilUpdate;    //!< Seconds until the next update
+	float                  m_sinceUpdate;    //!< Seconds since the last update
 	static int             s_componentID; //!< Static id counter shared by all components.
 };
 
@@ -6,42 +6,204 @@
 \par    Mach5 Game Engine
 \date   2016/08/22
 
-Base class Builder for easily instantiating M5Components
+Builders for easily instantiating and updating M5Components
 
 */
 /******************************************************************************/
 #ifndef M5COMPONENT_BUILDER_H
 #define M5COMPONENT_BUILDER_H
 
-//Forward declaration
-class M5Component;
+#include "M5Component.h"
+#include <vector>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
 
-//! Base Builder class to create M5Components via a M5ComonentFactory
-class M5ComponentBuilder
+constexpr float UPDATE_EVERY_FRAME = 0.0f;  //!< M5UpdateRate of components updated every frame
+constexpr float UPDATE_ON_EVENT    = -1.0f; //!< M5UpdateRate of components only updated when T::HasEvent is true
+
+/*! Tells the type based update if components of type T do anything in Update.
+Specialize this for components with an empty Update so they are skipped.*/
+template <typename T>
+struct M5HasUpdate
 {
-public:
-	~M5ComponentBuilder() {} //empty virtual destructor
-	//! Virtual Build call that must be overloaded by all Derived Builders
-	virtual M5Component* Build(void) = 0;
-private:
+	static const bool value = true; //!< False if T::Update does nothing
 };
 
-/*! Templated builder derived class so I don't need to create a Builder for each
-M5Component type*/
+/*! Tells the type based update if T has a static UpdateBatch(comps, start, dt)
+that updates every component of type T at once.  Specialize this for
+components that have one.*/
 template <typename T>
-class M5ComponentTBuilder : public M5ComponentBuilder
+struct M5HasBatchUpdate
+{
+	static const bool value = false; //!< True if T::UpdateBatch should be used
+};
+
+/*! How many times a second components of type T are updated.  Specialize this
+for components that don't need to update every frame.  Their updates are
+spread over the frames so the cost stays level, and each one gets the time
+since its last update.  Components that only react to something can use
+UPDATE_ON_EVENT and a static HasEvent() that is checked once a frame.*/
+template <typename T>
+struct M5UpdateRate
+{
+	static constexpr float value = UPDATE_EVERY_FRAME; //!< Updates per second, or UPDATE_EVERY_FRAME or UPDATE_ON_EVENT
+};
+
+/*! The functions to create and update one type of component.  The generated
+RegisterComponents.cpp fills a constant table of these, one for each
+M5ComponentTypes value, so nothing is registered at run time.*/
+struct M5ComponentBuilder
+{
+	//! Creates a new component in the M5ComponentPool of its type
+	typedef M5Component* (*BuildFunc)(M5ComponentTypes type);
+	//! Updates every component from start on, they must all be the same type
+	typedef void(*UpdateFunc)(std::vector<M5Component*>& comps, size_t start, float dt);
+	//! Checks if components of an UPDATE_ON_EVENT type should update this frame
+	typedef bool(*EventFunc)(void);
+
+	BuildFunc  Build;      //!< Creates a new component of this type
+	UpdateFunc UpdateAll;  //!< Updates every component of this type without virtual calls
+	UpdateFunc UpdateDue;  //!< Updates the components of this type whose turn it is
+	EventFunc  HasEvent;   //!< Calls T::HasEvent for UPDATE_ON_EVENT types, false for the rest
+	bool       hasUpdate;  //!< False if components of this type have nothing to update
+	float      updateRate; //!< Updates per second, or UPDATE_EVERY_FRAME or UPDATE_ON_EVENT
+};
+
+/*! Templated functions so I don't need to write a builder for each M5Component
+type.*/
+template <typename T>
+class M5ComponentTBuilder
 {
 public:
-	virtual M5Component* Build(void);
+	static M5Component* Build(M5ComponentTypes type);
+	static void UpdateAll(std::vector<M5Component*>& comps, size_t start, float dt);
+	static void UpdateDue(std::vector<M5Component*>& comps, size_t start, float dt);
+	static bool HasEvent(void);
 private:
+	static void UpdateEach(std::vector<M5Component*>& comps, size_t start, float dt, std::false_type);
+	static void UpdateEach(std::vector<M5Component*>& comps, size_t start, float dt, std::true_type);
+	static void UpdateDueEach(std::vector<M5Component*>& comps, size_t start, float dt, std::false_type);
+	static void UpdateDueEach(std::vector<M5Component*>& comps, size_t start, float dt, std::true_type);
+	static bool CheckEvent(std::false_type);
+	static bool CheckEvent(std::true_type);
 };
 
 
-//! Creates a new M5Component of type T
+//! Creates a new M5Component of type T in the pool of its M5ComponentTypes
+template <typename T>
+M5Component* M5ComponentTBuilder<T>::Build(M5ComponentTypes type)
+{
+	return new (type) T();
+}
+//! Updates all components of type T, in one batch if T has an UpdateBatch
+template <typename T>
+void M5ComponentTBuilder<T>::UpdateAll(std::vector<M5Component*>& comps, size_t start, float dt)
+{
+	UpdateEach(comps, start, dt, std::integral_constant<bool, M5HasBatchUpdate<T>::value>());
+}
+/*! Updates all components of type T.  The call is not virtual, so the compiler
+can inline T::Update into the loop.*/
+template <typename T>
+void M5ComponentTBuilder<T>::UpdateEach(std::vector<M5Component*>& comps, size_t start, float dt, std::false_type)
+{
+	//Components can be created or destroyed during Update, so check the size each time
+	for (size_t i = start; i < comps.size(); ++i)
+		static_cast<T*>(comps[i])->T::Update(dt);
+}
+/*! Lets T update all of its components at once, so it can use the
+M5Vec2Batch functions.  Empty lists are skipped, so a batch doesn't look for
+objects it has nothing to do with.*/
+template <typename T>
+void M5ComponentTBuilder<T>::UpdateEach(std::vector<M5Component*>& comps, size_t start, float dt, std::true_type)
+{
+	if (start < comps.size())
+		T::UpdateBatch(comps, start, dt);
+}
+//! Updates the components of type T whose turn it is, in batches if T has an UpdateBatch
+template <typename T>
+void M5ComponentTBuilder<T>::UpdateDue(std::vector<M5Component*>& comps, size_t start, float dt)
+{
+	UpdateDueEach(comps, start, dt, std::integral_constant<bool, M5HasBatchUpdate<T>::value>());
+}
+/*! Updates the components of type T whose turn it is, each with the time since
+its last update.  The call is not virtual.*/
+template <typename T>
+void M5ComponentTBuilder<T>::UpdateDueEach(std::vector<M5Component*>& comps, size_t start, float dt, std::false_type)
+{
+	float updateDt;
+	//Components can be created or destroyed during Update, so check the size each time
+	for (size_t i = start; i < comps.size(); ++i)
+	{
+		if (comps[i]->IsDue(dt, updateDt))
+			static_cast<T*>(comps[i])->T::Update(updateDt);
+	}
+}
+/*! Gives the components of type T whose turn it is to T::UpdateBatch.  A batch
+has only one dt, so components that waited different times, like ones made
+since the last turn or woken by an event, are sorted into one batch per dt.*/
+template <typename T>
+void M5ComponentTBuilder<T>::UpdateDueEach(std::vector<M5Component*>& comps, size_t start, float dt, std::true_type)
+{
+	typedef std::pair<float, M5Component*> DuePair;
+	static std::vector<DuePair> s_due;
+	static std::vector<M5Component*> s_batch;
+	s_due.clear();
+
+	bool isSameDt = true;
+	float updateDt;
+	for (size_t i = start; i < comps.size(); ++i)
+	{
+		if (comps[i]->IsDue(dt, updateDt))
+		{
+			isSameDt = isSameDt && (s_due.empty() || s_due[0].first == updateDt);
+			s_due.push_back(DuePair(updateDt, comps[i]));
+		}
+	}
+
+	if (!isSameDt)
+	{
+		std::stable_sort(s_due.begin(), s_due.end(),
+			[](const DuePair& left, const DuePair& right) { return left.first < right.first; });
+	}
+
+	size_t size = s_due.size();
+	for (size_t first = 0; first < size;)
+	{
+		s_batch.clear();
+		size_t last = first;
+		for (; last < size && s_due[last].first == s_due[first].first; ++last)
+			s_batch.push_back(s_due[last].second);
+
+		T::UpdateBatch(s_batch, 0, s_due[first].first);
+		first = last;
+	}
+}
+//! Checks if components of type T should update this frame, only used for UPDATE_ON_EVENT types
+template <typename T>
+bool M5ComponentTBuilder<T>::HasEvent(void)
+{
+	return CheckEvent(std::integral_constant<bool, M5UpdateRate<T>::value == UPDATE_ON_EVENT>());
+}
+//! Types that aren't UPDATE_ON_EVENT don't need a HasEvent
+template <typename T>
+bool M5ComponentTBuilder<T>::CheckEvent(std::false_type)
+{
+	return false;
+}
+//! Asks an UPDATE_ON_EVENT type if something happened this frame
+template <typename T>
+bool M5ComponentTBuilder<T>::CheckEvent(std::true_type)
+{
+	return T::HasEvent();
+}
+//! Makes the builder for type T at compile time, for the table of builders
 template <typename T>
-M5Component* M5ComponentTBuilder<T>::Build(void)
+constexpr M5ComponentBuilder M5MakeComponentBuilder(void)
 {
-	return new T();
+	return M5ComponentBuilder{ &M5ComponentTBuilder<T>::Build,
+		&M5ComponentTBuilder<T>::UpdateAll, &M5ComponentTBuilder<T>::UpdateDue,
+		&M5ComponentTBuilder<T>::HasEvent, M5HasUpdate<T>::value, M5UpdateRate<T>::value };
 }
 
 
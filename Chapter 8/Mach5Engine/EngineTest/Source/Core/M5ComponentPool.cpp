@@ -0,0 +1,181 @@
+/******************************************************************************/
+/*!
+\file   M5ComponentPool.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/04
+
+Singleton class that stores the components of each M5ComponentTypes together.
+
+Each type has its own blocks of equal sized slots.  A slot has a small header
+that remembers the type, so Free doesn't need to be told which pool the memory
+came from.  Free slots are kept in a list that is threaded through the slots
+themselves.  Components are only made on the main thread, so nothing here is
+locked.
+
+*/
+/******************************************************************************/
+#include "M5ComponentPool.h"
+#include "M5Memory.h"
+#include "M5Debug.h"
+
+#include <vector>
+
+namespace
+{
+//! Stored in front of every slot
+struct M5SlotHeader
+{
+	M5ComponentTypes type; //!< The pool the slot belongs to
+};
+
+//! The slots of one component type
+struct M5Pool
+{
+	std::vector<char*> blocks;    //!< Memory for SLOTS_PER_BLOCK slots each
+	char*              pFree;     //!< The first free slot, each free slot points to the next
+	size_t             slotSize;  //!< Bytes in each slot, including the header
+	int                liveCount; //!< Slots holding a component
+};
+
+const size_t HEADER_SIZE = 16;       //!< Size of the header, big enough to keep components aligned
+const size_t ALIGNMENT = 16;         //!< Slot sizes are rounded up to this
+const int    SLOTS_PER_BLOCK = 256;  //!< Slots allocated at a time for a type
+static_assert(sizeof(M5SlotHeader) <= HEADER_SIZE, "M5SlotHeader doesn't fit");
+
+M5Pool s_pools[CT_INVALID]; //!< The pool of each component type
+
+/******************************************************************************/
+/*!
+Gets the next free slot after a free slot.  The pointer is stored where the
+component would be.
+
+\param [in] pSlot
+A free slot.
+
+\return
+A reference to the next free slot pointer inside pSlot.
+*/
+/******************************************************************************/
+char*& NextFree(char* pSlot)
+{
+	return *reinterpret_cast<char**>(pSlot + HEADER_SIZE);
+}
+/******************************************************************************/
+/*!
+Allocates another block for a pool and adds its slots to the free list, in
+address order so components made together end up next to each other.
+
+\param [in] pool
+The pool that is out of free slots.
+*/
+/******************************************************************************/
+void AddBlock(M5Pool& pool)
+{
+	char* pBlock = static_cast<char*>(M5Memory::Allocate(pool.slotSize * SLOTS_PER_BLOCK, MT_COMPONENTS));
+	pool.blocks.push_back(pBlock);
+
+	for (int i = 0; i < SLOTS_PER_BLOCK - 1; ++i)
+		NextFree(pBlock + i * pool.slotSize) = pBlock + (i + 1) * pool.slotSize;
+	NextFree(pBlock + (SLOTS_PER_BLOCK - 1) * pool.slotSize) = pool.pFree;
+	pool.pFree = pBlock;
+}
+}//end unnamed namespace
+
+
+/******************************************************************************/
+/*!
+Gets memory for a component from the pool of its type.  Every component of a
+type must be the same size, since they are all the same class.
+
+\param [in] type
+The type of the component.
+
+\param [in] size
+The size of the component in bytes.
+
+\return
+Memory for the component.  It must be freed with M5ComponentPool::Free.
+*/
+/******************************************************************************/
+void* M5ComponentPool::Allocate(M5ComponentTypes type, size_t size)
+{
+	M5DEBUG_ASSERT(type >= 0 && type < CT_INVALID, "Invalid component type");
+
+	M5Pool& pool = s_pools[type];
+	size_t slotSize = HEADER_SIZE + (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	if (pool.slotSize == 0)
+		pool.slotSize = slotSize;
+	M5DEBUG_ASSERT(pool.slotSize == slotSize, "Every component of a type must be the same size");
+
+	if (pool.pFree == 0)
+		AddBlock(pool);
+
+	char* pSlot = pool.pFree;
+	pool.pFree = NextFree(pSlot);
+	reinterpret_cast<M5SlotHeader*>(pSlot)->type = type;
+	++pool.liveCount;
+	return pSlot + HEADER_SIZE;
+}
+/******************************************************************************/
+/*!
+Returns the memory of a component to the pool it came from.  The slot is
+reused by the next component of that type.
+
+\param [in] pMemory
+The memory to free.  This can be 0.
+*/
+/******************************************************************************/
+void M5ComponentPool::Free(void* pMemory)
+{
+	if (pMemory == 0)
+		return;
+
+	char* pSlot = static_cast<char*>(pMemory) - HEADER_SIZE;
+	M5Pool& pool = s_pools[reinterpret_cast<M5SlotHeader*>(pSlot)->type];
+	NextFree(pSlot) = pool.pFree;
+	pool.pFree = pSlot;
+	--pool.liveCount;
+}
+/******************************************************************************/
+/*!
+Gets the memory use of the pool of one type.
+
+\param [in] type
+The type to get the stats of.
+
+\param [out] stats
+The memory use of the pool.
+*/
+/******************************************************************************/
+void M5ComponentPool::GetStats(M5ComponentTypes type, M5ComponentPoolStats& stats)
+{
+	M5DEBUG_ASSERT(type >= 0 && type < CT_INVALID, "Invalid component type");
+	const M5Pool& pool = s_pools[type];
+	stats.usedBytes  = static_cast<long long>(pool.liveCount) * pool.slotSize;
+	stats.totalBytes = static_cast<long long>(pool.blocks.size()) * SLOTS_PER_BLOCK * pool.slotSize;
+	stats.liveCount  = pool.liveCount;
+	stats.blockCount = static_cast<int>(pool.blocks.size());
+}
+/******************************************************************************/
+/*!
+Frees the blocks of every pool.  This is called by M5ObjectManager::Shutdown
+after every component is deleted.  A pool that still has components keeps its
+blocks, so M5Memory reports them as a leak.
+*/
+/******************************************************************************/
+void M5ComponentPool::Shutdown(void)
+{
+	for (int i = 0; i < CT_INVALID; ++i)
+	{
+		M5Pool& pool = s_pools[i];
+		if (pool.liveCount != 0)
+			continue;
+
+		for (size_t j = 0; j < pool.blocks.size(); ++j)
+			M5Memory::Free(pool.blocks[j]);
+		pool.blocks.clear();
+		pool.pFree = 0;
+	}
+}
@@ -0,0 +1,46 @@
+/******************************************************************************/
+/*!
+\file   M5ComponentPool.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/04
+
+Singleton class that stores the components of each M5ComponentTypes together.
+
+*/
+/******************************************************************************/
+#ifndef M5_COMPONENT_POOL_H
+#define M5_COMPONENT_POOL_H
+
+#include "M5ComponentTypes.h"
+#include <cstddef>
+
+//! Memory use of the pool of one M5ComponentTypes
+struct M5ComponentPoolStats
+{
+	long long usedBytes;  //!< Bytes of slots holding live components
+	long long totalBytes; //!< Bytes of every block, used or not
+	int       liveCount;  //!< Components in the pool
+	int       blockCount; //!< Blocks the pool has allocated
+};
+
+/*! Singleton class that gives every M5ComponentTypes its own blocks of memory,
+so the type based update walks components that sit next to each other.*/
+class M5ComponentPool
+{
+public:
+	friend class M5ObjectManager;
+
+	//Gets memory for a component of the given type
+	static void* Allocate(M5ComponentTypes type, size_t size);
+	//Returns memory from Allocate to the pool of its type
+	static void  Free(void* pMemory);
+	//Gets the memory use of the pool of one type
+	static void  GetStats(M5ComponentTypes type, M5ComponentPoolStats& stats);
+private:
+	static void  Shutdown(void);
+};//end M5ComponentPool
+
+
+#endif //M5_COMPONENT_POOL_H
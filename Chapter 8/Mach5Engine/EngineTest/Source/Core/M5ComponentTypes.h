@@ -13,6 +13,7 @@ and creates an enumeration value of CT_*Component.
 #ifndef M5COMPONENT_TYPE_H 
 #define M5COMPONENT_TYPE_H 
 #include <string> 
+#include "M5Hash.h" 
  
  
 //! AutoGenerated enum based on component file names  
@@ -25,6 +26,7 @@ CT_RepositionComponent,
 CT_UIButtonComponent, 
 CT_WrapComponent, 
 CT_ChasePlayerComponent, 
+CT_FlowChaseComponent, 
 CT_GrowToSizeComponent, 
 CT_MenuSpawnerComponent, 
 CT_PlayerInputComponent, 
@@ -36,19 +38,22 @@ CT_INVALID
  
 //! AutoGenerated function to convert strings to our M5ComponentTypes type 
 inline M5ComponentTypes StringToComponent(const std::string& string) { 
-if(string == "ClampComponent") return CT_ClampComponent; 
-if(string == "ColliderComponent") return CT_ColliderComponent; 
-if(string == "GfxComponent") return CT_GfxComponent; 
-if(string == "OutsideViewKillComponent") return CT_OutsideViewKillComponent; 
-if(string == "RepositionComponent") return CT_RepositionComponent; 
-if(string == "UIButtonComponent") return CT_UIButtonComponent; 
-if(string == "WrapComponent") return CT_WrapComponent; 
-if(string == "ChasePlayerComponent") return CT_ChasePlayerComponent; 
-if(string == "GrowToSizeComponent") return CT_GrowToSizeComponent; 
-if(string == "MenuSpawnerComponent") return CT_MenuSpawnerComponent; 
-if(string == "PlayerInputComponent") return CT_PlayerInputComponent; 
-if(string == "RandomGoComponent") return CT_RandomGoComponent; 
-if(string == "ShrinkComponent") return CT_ShrinkComponent; 
+switch (M5Hash(string.c_str())) { 
+case M5HashLiteral("ClampComponent"): return (string == "ClampComponent") ? CT_ClampComponent : CT_INVALID; 
+case M5HashLiteral("ColliderComponent"): return (string == "ColliderComponent") ? CT_ColliderComponent : CT_INVALID; 
+case M5HashLiteral("GfxComponent"): return (string == "GfxComponent") ? CT_GfxComponent : CT_INVALID; 
+case M5HashLiteral("OutsideViewKillComponent"): return (string == "OutsideViewKillComponent") ? CT_OutsideViewKillComponent : CT_INVALID; 
+case M5HashLiteral("RepositionComponent"): return (string == "RepositionComponent") ? CT_RepositionComponent : CT_INVALID; 
+case M5HashLiteral("UIButtonComponent"): return (string == "UIButtonComponent") ? CT_UIButtonComponent : CT_INVALID; 
+case M5HashLiteral("WrapComponent"): return (string == "WrapComponent") ? CT_WrapComponent : CT_INVALID; 
+case M5HashLiteral("ChasePlayerComponent"): return (string == "ChasePlayerComponent") ? CT_ChasePlayerComponent : CT_INVALID; 
+case M5HashLiteral("FlowChaseComponent"): return (string == "FlowChaseComponent") ? CT_FlowChaseComponent : CT_INVALID; 
+case M5HashLiteral("GrowToSizeComponent"): return (string == "GrowToSizeComponent") ? CT_GrowToSizeComponent : CT_INVALID; 
+case M5HashLiteral("MenuSpawnerComponent"): return (string == "MenuSpawnerComponent") ? CT_MenuSpawnerComponent : CT_INVALID; 
+case M5HashLiteral("PlayerInputComponent"): return (string == "PlayerInputComponent") ? CT_PlayerInputComponent : CT_INVALID; 
+case M5HashLiteral("RandomGoComponent"): return (string == "RandomGoComponent") ? CT_RandomGoComponent : CT_INVALID; 
+case M5HashLiteral("ShrinkComponent"): return (string == "ShrinkComponent") ? CT_ShrinkComponent : CT_INVALID; 
+} 
 return CT_INVALID; 
 } 
 #endif //M5COMPONENT_TYPE_H 
@@ -72,7 +72,7 @@ The Type of the Enum/Builder to remove.
 template<typename EnumType, typename BuilderType, typename ReturnType>
 void M5Factory<EnumType, BuilderType, ReturnType>::RemoveBuilder(EnumType type)
 {
-	BuilderMap::iterator itor = m_builderMap.find(type);
+	typename BuilderMap::iterator itor = m_builderMap.find(type);
 	M5DEBUG_ASSERT(itor != m_builderMap.end(),
 		"Trying to Remove a Builder that doesn't exist");
 
@@ -123,4 +123,4 @@ void M5Factory<EnumType, BuilderType, ReturnType>::ClearBuilders(void)
 	m_builderMap.clear();
 }
 
-#endif M5FACTORY_H
+#endif //M5FACTORY_H
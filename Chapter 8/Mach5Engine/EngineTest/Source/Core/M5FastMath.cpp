@@ -0,0 +1,227 @@
+/******************************************************************************/
+/*!
+\file   M5FastMath.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/29
+
+Polynomial versions of the trig functions that are faster than the standard
+library but a little less accurate.
+
+Sin and Cos move the angle into [-PI/4, PI/4] and pick a polynomial based on
+the quarter turn the angle was in.  Atan2 finds the arctangent of a value in
+[0, 1] and then fixes the angle based on the signs of x and y.  The
+coefficients are minimax fits, so the errors are spread evenly across each
+range.
+
+*/
+/******************************************************************************/
+#include "M5FastMath.h"
+#include "M5Math.h"
+
+#include <cmath>
+
+namespace
+{
+/*!2/PI, to find the quarter turn an angle is in*/
+const float TWO_OVER_PI = 0.636619772367581343f;
+/*!PI/2 split into three parts that are each exact in a float, so an angle can
+be moved near zero without losing bits*/
+const float HALF_PI_1 = 1.5703125f;
+/*!The second part of PI/2*/
+const float HALF_PI_2 = 4.837512969970703125e-4f;
+/*!The rest of PI/2*/
+const float HALF_PI_3 = 7.54978995489188216e-8f;
+
+/******************************************************************************/
+/*!
+Helper function to find the sine and cosine of an angle.  Everything is done
+with plain math and selects instead of branches so loops over it can be
+vectorized.
+
+\param [in] radians
+The angle in radians.
+
+\param [out] sin
+The sine of the angle.
+
+\param [out] cos
+The cosine of the angle.
+*/
+/******************************************************************************/
+inline void SinCosKernel(float radians, float& sin, float& cos)
+{
+  /*Find the closest quarter turn and how far the angle is from it*/
+  float scaled = radians * TWO_OVER_PI;
+  int quarter = static_cast<int>(scaled + (scaled < 0.f ? -.5f : .5f));
+  float turn = static_cast<float>(quarter);
+  float x = radians - turn * HALF_PI_1;
+  x -= turn * HALF_PI_2;
+  x -= turn * HALF_PI_3;
+
+  float x2 = x * x;
+  float s = x + x * x2 * (-1.6666654611e-1f + x2 * (8.3321608736e-3f + x2 * -1.9515295891e-4f));
+  float c = 1.f - .5f * x2 + x2 * x2 * (4.166664568298827e-2f + x2 * (-1.388731625493765e-3f + x2 * 2.443315711809948e-5f));
+
+  /*Odd quarters swap sine and cosine, then the sign comes from the half turn*/
+  bool swap = (quarter & 1) != 0;
+  float sinResult = swap ? c : s;
+  float cosResult = swap ? s : c;
+  sin = (quarter & 2) ? -sinResult : sinResult;
+  cos = ((quarter + 1) & 2) ? -cosResult : cosResult;
+}
+/******************************************************************************/
+/*!
+Helper function to find the angle of a vector.  Like SinCosKernel there are
+no branches.
+
+\param [in] y
+The y value of the vector.
+
+\param [in] x
+The x value of the vector.
+
+\return
+The angle of the vector in the range [-PI, PI].  The zero vector returns 0.
+*/
+/******************************************************************************/
+inline float Atan2Kernel(float y, float x)
+{
+  float absX = std::fabs(x);
+  float absY = std::fabs(y);
+  float high = absX > absY ? absX : absY;
+  float low = absX > absY ? absY : absX;
+
+  /*Arctangent of low/high, which is in [0, 1]*/
+  float a = low / (high > 0.f ? high : 1.f);
+  float a2 = a * a;
+  float angle = a * (0.99997726f + a2 * (-0.33262347f + a2 * (0.19354346f +
+    a2 * (-0.11643287f + a2 * (0.05265332f + a2 * -0.01172120f)))));
+
+  /*Move the angle to the right octant, then the right quadrant*/
+  angle = absY > absX ? M5Math::HALF_PI - angle : angle;
+  angle = x < 0.f ? M5Math::PI - angle : angle;
+  return y < 0.f ? -angle : angle;
+}
+}//end unnamed namespace
+
+namespace M5FastMath
+{
+/******************************************************************************/
+/*!
+Finds the sine of an angle.
+
+\param radians
+The angle in radians.  It should be between -MAX_ANGLE and MAX_ANGLE.
+
+\return
+The sine of the angle, within 2e-7 of std::sin.
+*/
+/******************************************************************************/
+float Sin(float radians)
+{
+  float sin, cos;
+  SinCosKernel(radians, sin, cos);
+  return sin;
+}
+/******************************************************************************/
+/*!
+Finds the cosine of an angle.
+
+\param radians
+The angle in radians.  It should be between -MAX_ANGLE and MAX_ANGLE.
+
+\return
+The cosine of the angle, within 2e-7 of std::cos.
+*/
+/******************************************************************************/
+float Cos(float radians)
+{
+  float sin, cos;
+  SinCosKernel(radians, sin, cos);
+  return cos;
+}
+/******************************************************************************/
+/*!
+Finds the sine and cosine of an angle.  This is cheaper than calling Sin and
+Cos, since most of the work is shared.
+
+\param radians
+The angle in radians.  It should be between -MAX_ANGLE and MAX_ANGLE.
+
+\param sin
+The sine of the angle, within 2e-7 of std::sin.
+
+\param cos
+The cosine of the angle, within 2e-7 of std::cos.
+*/
+/******************************************************************************/
+void SinCos(float radians, float& sin, float& cos)
+{
+  SinCosKernel(radians, sin, cos);
+}
+/******************************************************************************/
+/*!
+Finds the angle of the vector x,y.
+
+\param y
+The y value of the vector.
+
+\param x
+The x value of the vector.
+
+\return
+The angle in radians between -PI and PI, within 1e-5 of std::atan2.  The zero
+vector returns 0.
+*/
+/******************************************************************************/
+float Atan2(float y, float x)
+{
+  return Atan2Kernel(y, x);
+}
+/******************************************************************************/
+/*!
+Finds the sine and cosine of every angle in an array.
+
+\param sin
+An array of size floats to store the sines.
+
+\param cos
+An array of size floats to store the cosines.
+
+\param radians
+An array of size angles in radians.
+
+\param size
+The number of angles.
+*/
+/******************************************************************************/
+void SinCos(float* sin, float* cos, const float* radians, size_t size)
+{
+  for (size_t i = 0; i < size; ++i)
+    SinCosKernel(radians[i], sin[i], cos[i]);
+}
+/******************************************************************************/
+/*!
+Finds the angle of every vector in a pair of arrays.
+
+\param result
+An array of size floats to store the angles.
+
+\param y
+An array of size y values.
+
+\param x
+An array of size x values.
+
+\param size
+The number of vectors.
+*/
+/******************************************************************************/
+void Atan2(float* result, const float* y, const float* x, size_t size)
+{
+  for (size_t i = 0; i < size; ++i)
+    result[i] = Atan2Kernel(y[i], x[i]);
+}
+}//end namespace M5FastMath
@@ -0,0 +1,44 @@
+/******************************************************************************/
+/*!
+\file   M5FastMath.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/29
+
+Polynomial versions of the trig functions that are faster than the standard
+library but a little less accurate.
+
+*/
+/******************************************************************************/
+#ifndef M5_FAST_MATH_H
+#define M5_FAST_MATH_H
+
+#include <cstddef>
+
+/*! Fast trig functions.  Call these directly where speed matters more than the
+last few bits, or call M5Math::SinCos and M5Math::Atan2 to use these only when
+M5_FAST_TRIG is defined.
+
+None of the functions branch on their input, so the array versions can be
+vectorized by the compiler.*/
+namespace M5FastMath
+{
+/*!The largest angle that Sin, Cos and SinCos are accurate for*/
+const float MAX_ANGLE = 8192.f;
+/*Sine of an angle, max error 2e-7 when |radians| < MAX_ANGLE*/
+float Sin(float radians);
+/*Cosine of an angle, max error 2e-7 when |radians| < MAX_ANGLE*/
+float Cos(float radians);
+/*Sine and cosine of an angle at once, max error 2e-7 when |radians| < MAX_ANGLE*/
+void  SinCos(float radians, float& sin, float& cos);
+/*Angle of the vector x,y in radians, max error 1e-5*/
+float Atan2(float y, float x);
+/*SinCos of every angle in an array*/
+void  SinCos(float* sin, float* cos, const float* radians, size_t size);
+/*Atan2 of every vector in a pair of arrays*/
+void  Atan2(float* result, const float* y, const float* x, size_t size);
+}//end namespace M5FastMath
+
+
+#endif //M5_FAST_MATH_H
@@ -0,0 +1,405 @@
+/******************************************************************************/
+/*!
+\file   M5GLRenderBackend.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+A render backend that draws frames to a window with OpenGL.
+
+*/
+/******************************************************************************/
+#include "M5GLRenderBackend.h"
+#include "M5Debug.h"
+
+#include <cstring> /*memset*/
+#include <vector>
+
+#include "gl/glew.h"
+#include "gl/gl.h"
+#include "gl/glu.h"
+
+namespace
+{
+/*! A struct to define my vertex.*/
+struct M5Vertex
+{
+	float x;/*The x position*/
+	float y;/*The y position*/
+	float z;/*The z position*/
+	float tu;/*The u texture coord*/
+	float tv;/*The v texture coord*/
+};
+}//end unnamed namespace
+
+/******************************************************************************/
+/*!
+Sets starting values.  Nothing is created until Init.
+*/
+/******************************************************************************/
+M5GLRenderBackend::M5GLRenderBackend(void) :
+	m_window(0),
+	m_deviceContext(0),
+	m_mainContext(0),
+	m_drawContext(0),
+	m_vboID(0),
+	m_vertexCount(0),
+	m_fontTexture(0)
+{
+}
+/******************************************************************************/
+/*!
+Creates both contexts and everything the frames are drawn with.  The main
+context stays current on the main thread so textures can be made there.
+
+\param [in] window
+The window to draw to.
+*/
+/******************************************************************************/
+void M5GLRenderBackend::Init(HWND window)
+{
+	m_window = window;
+	m_deviceContext = GetDC(m_window);
+
+	/*This will assert if it fails otherwise both contexts are valid*/
+	ContextInit();
+
+	/*Set up glew functions*/
+	glewInit();
+	VertexBufferInit();
+	FontInit();
+
+	/*Make sure everything is done before the draw context uses it*/
+	glFinish();
+
+	/*Give back the resource until we need it again.*/
+	ReleaseDC(m_window, m_deviceContext);
+	m_deviceContext = 0;
+}
+/******************************************************************************/
+/*!
+Frees the quad, the font texture and both contexts.  The render thread must be
+stopped first.
+*/
+/******************************************************************************/
+void M5GLRenderBackend::Shutdown(void)
+{
+	glDeleteBuffers((GLsizei)1, &m_vboID);
+	glDeleteTextures(1, &m_fontTexture);
+	wglMakeCurrent(NULL, NULL);
+	wglDeleteContext(m_drawContext);
+	wglDeleteContext(m_mainContext);
+	m_drawContext = 0;
+	m_mainContext = 0;
+}
+/******************************************************************************/
+/*!
+Makes the draw context current on the render thread and sets the state that
+never changes.
+*/
+/******************************************************************************/
+void M5GLRenderBackend::StartThread(void)
+{
+	m_deviceContext = GetDC(m_window);
+	BOOL result = wglMakeCurrent(m_deviceContext, m_drawContext);
+	M5DEBUG_ASSERT(result != 0, "Unable to Set Render Context on the render thread");
+	static_cast<void>(result); /*Only the assert reads it*/
+
+	/*Set fill mode*/
+	glPolygonMode(GL_FRONT, GL_FILL);
+
+	/*Enable Depth Test*/
+	glEnable(GL_DEPTH_TEST);
+	glClearDepth(1.0f);
+	glDepthFunc(GL_LEQUAL);
+
+	/*Enable textures*/
+	glEnable(GL_TEXTURE_2D);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	/*Set up for position and color*/
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+}
+/******************************************************************************/
+/*!
+Releases the draw context so it can be deleted on the main thread.
+*/
+/******************************************************************************/
+void M5GLRenderBackend::EndThread(void)
+{
+	wglMakeCurrent(NULL, NULL);
+	ReleaseDC(m_window, m_deviceContext);
+	m_deviceContext = 0;
+}
+/******************************************************************************/
+/*!
+Draws the world with the camera, then the HUD and text in screen space, and
+shows the frame.
+
+\param [in] frame
+The frame to draw.
+*/
+/******************************************************************************/
+void M5GLRenderBackend::Execute(const M5RenderFrame& frame)
+{
+	glViewport(frame.viewport[0], frame.viewport[1], frame.viewport[2], frame.viewport[3]);
+	glClearColor(frame.background[0], frame.background[1], frame.background[2], 1.0);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	/*World objects use the perspective and camera*/
+	glMatrixMode(GL_PROJECTION);
+	glLoadMatrixd(frame.persp);
+	glMatrixMode(GL_MODELVIEW);
+	glLoadMatrixd(frame.camera);
+	DrawItems(frame.world);
+
+	/*HUD objects are in screen space*/
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	gluOrtho2D(0, frame.width, 0, frame.height);
+	glMatrixMode(GL_MODELVIEW);
+	glLoadIdentity();
+	DrawItems(frame.hud);
+	DrawTextQuads(frame.text);
+
+	SwapBuffers(m_deviceContext);
+}
+/******************************************************************************/
+/*!
+Uploads pixels to a new texture.  This is called on the main thread with the
+main context, and waits for the upload so the draw context can use it right
+away.
+
+\param [in] pixels
+The pixels of the texture, starting with the bottom row.
+
+\param [in] width
+The width of the texture.
+
+\param [in] height
+The height of the texture.
+
+\param [in] format
+GL_RGB or GL_RGBA.
+
+\return
+The id of the new texture.
+*/
+/******************************************************************************/
+int M5GLRenderBackend::CreateTexture(const unsigned char* pixels, int width, int height, unsigned format)
+{
+	GLuint id = 0;
+	/*Request a texture from openGL*/
+	glGenTextures(1, &id);
+	/*Set up my texture*/
+	glBindTexture(GL_TEXTURE_2D, id);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, format, width, height,
+		0, format, GL_UNSIGNED_BYTE, pixels);
+	glFinish();
+
+	return static_cast<int>(id);
+}
+/******************************************************************************/
+/*!
+Deletes a texture.  This is called on the main thread while the render thread
+is idle.
+
+\param [in] textureID
+The texture to delete.
+*/
+/******************************************************************************/
+void M5GLRenderBackend::DeleteTexture(int textureID)
+{
+	GLuint id = static_cast<GLuint>(textureID);
+	glDeleteTextures(1, &id);
+}
+/******************************************************************************/
+/*!
+This function will initialize both render contexts.  If it fails the program
+will assert in debug or crash in release mode.  The draw context shares
+textures and buffers with the main context.
+*/
+/******************************************************************************/
+void M5GLRenderBackend::ContextInit(void)
+{
+	/*A struct the specifies information about the back buffer*/
+	PIXELFORMATDESCRIPTOR pfd;
+	int pixelFormat; /*The result value after choosing my pixel format*/
+	BOOL result; /*Used to check for errors.*/
+
+	/*Clear my pfd and only set the values I need.*/
+	std::memset(&pfd, 0, sizeof(pfd));
+
+	/*Set up information about pixels for buffer and back buffer*/
+	pfd.nSize = sizeof(PIXELFORMATDESCRIPTOR);
+	pfd.nVersion = 1;
+	/*A set of flags that specify the properties of the pixel buffer*/
+	pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
+	pfd.iPixelType = PFD_TYPE_RGBA;
+	pfd.cColorBits = 32;
+	pfd.cDepthBits = 32;
+
+	/*Choose back buffer information*/
+	pixelFormat = ChoosePixelFormat(m_deviceContext, &pfd);
+	M5DEBUG_ASSERT(pixelFormat != 0, "Unable to chose PixelFormat. Your video card is out of date");
+
+	/*Set back buffer information*/
+	result = SetPixelFormat(m_deviceContext, pixelFormat, &pfd);
+	M5DEBUG_ASSERT(result != 0, "Unable to Set PixelFormat. Your video card is out of date");
+
+	/*Create openGL render contexts*/
+	m_mainContext = wglCreateContext(m_deviceContext);
+	M5DEBUG_ASSERT(m_mainContext != 0, "Unable to Create Render Context. Your video card is out of date");
+	m_drawContext = wglCreateContext(m_deviceContext);
+	M5DEBUG_ASSERT(m_drawContext != 0, "Unable to Create Render Context. Your video card is out of date");
+
+	/*Must be shared before either context makes anything*/
+	result = wglShareLists(m_mainContext, m_drawContext);
+	M5DEBUG_ASSERT(result != 0, "Unable to share Render Contexts. Your video card is out of date");
+
+	/*Set the openGl render context*/
+	result = wglMakeCurrent(m_deviceContext, m_mainContext);
+	M5DEBUG_ASSERT(result != 0, "Unable to Set Render Context. Your video card is out of date");
+	static_cast<void>(result); /*Only the asserts read it*/
+}
+/******************************************************************************/
+/*!
+Creates the single vertex buffer in the game.  Since this is currently only a
+2D game engine it only needs a Quad.
+
+My verts are like this
+
+2--------(1,6)
+|           |
+|           |
+|           |
+|           |
+(3,4)----- 5
+*/
+/******************************************************************************/
+void M5GLRenderBackend::VertexBufferInit(void)
+{
+	const int VERT_COUNT = 6;
+	/*Hard code my verts, because we are only supporting one vbo*/
+	M5Vertex vertArray[6] = {
+	  { .5f, .5f, 0.f, 1.f, 1.f }, /*1*/
+	  { -.5f, .5f, 0.f, 0.f, 1.f }, /*2*/
+	  { -.5f, -.5f, 0.f, 0.f, 0.f }, /*3*/
+
+	  { -.5f, -.5f, 0.f, 0.f, 0.f }, /*4*/
+	  { .5f, -.5f, 0.f, 1.f, 0.f }, /*5*/
+	  { .5f, .5f, 0.f, 1.f, 1.f } }; /*6*/
+	GLsizei dataSize = sizeof(M5Vertex) * VERT_COUNT;
+
+	/*Generate my vbo*/
+	glGenBuffers((GLsizei)1, &m_vboID);
+	m_vertexCount = VERT_COUNT;
+
+	/*Set my buffer to the current*/
+	glBindBuffer(GL_ARRAY_BUFFER, m_vboID);
+	/*Fill in data into my vbo*/
+	glBufferData(GL_ARRAY_BUFFER, dataSize, vertArray, GL_STATIC_DRAW);
+}
+/******************************************************************************/
+/*!
+Helper function to create the glyph atlas texture for drawing text.
+*/
+/******************************************************************************/
+void M5GLRenderBackend::FontInit(void)
+{
+	M5TextBatch text;
+	std::vector<unsigned char> pixels;
+	text.GetAtlas(pixels);
+
+	glGenTextures(1, &m_fontTexture);
+	glBindTexture(GL_TEXTURE_2D, m_fontTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, M5TextBatch::ATLAS_WIDTH, M5TextBatch::ATLAS_HEIGHT,
+		0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+/******************************************************************************/
+/*!
+Draws a list of quads with the current projection and camera.  The texture is
+only bound when it changes.
+
+\param [in] items
+The quads to draw.
+*/
+/******************************************************************************/
+void M5GLRenderBackend::DrawItems(const M5RenderItems& items)
+{
+	/*Text uses client memory, so the quad has to be bound again*/
+	glBindBuffer(GL_ARRAY_BUFFER, m_vboID);
+	/*Set the start of my position data*/
+	glVertexPointer(3, GL_FLOAT, sizeof(M5Vertex), 0);
+	/*Set  my texture positions*/
+	glTexCoordPointer(2, GL_FLOAT, sizeof(M5Vertex),
+		((char*)0 + sizeof(float) * 3));
+
+	int textureID = -1;
+	size_t size = items.size();
+	for (size_t i = 0; i < size; ++i)
+	{
+		const M5RenderItem& item = items[i];
+		if (item.textureID != textureID)
+		{
+			textureID = item.textureID;
+			glBindTexture(GL_TEXTURE_2D, textureID);
+		}
+
+		glMatrixMode(GL_TEXTURE);
+		glLoadMatrixf(&item.texCoords.m[0][0]);
+		glMatrixMode(GL_MODELVIEW);
+		glColor4ubv(item.color);
+
+		/*Add this matrix to the view*/
+		glPushMatrix();
+		/*Right now my matrix is the transpose of open gl*/
+		glMultMatrixf(&item.world.m[0][0]);
+		/*Draw my object*/
+		glDrawArrays(GL_TRIANGLES, 0, m_vertexCount);
+		/*Remove this matrix*/
+		glPopMatrix();
+	}
+}
+/******************************************************************************/
+/*!
+Draws all text in the frame with a single draw call.  The quads are in screen
+space, so this must be called after the HUD.
+
+\param [in] verts
+The text quads to draw.
+*/
+/******************************************************************************/
+void M5GLRenderBackend::DrawTextQuads(const M5TextVertices& verts)
+{
+	if (verts.empty())
+		return;
+
+	/*The glyph coords are already in the atlas*/
+	glMatrixMode(GL_TEXTURE);
+	glLoadIdentity();
+	glMatrixMode(GL_MODELVIEW);
+
+	/*The text is in client memory, not the quad vertex buffer*/
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindTexture(GL_TEXTURE_2D, m_fontTexture);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(M5TextVertex), &verts[0].x);
+	glTexCoordPointer(2, GL_FLOAT, sizeof(M5TextVertex), &verts[0].u);
+	glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(M5TextVertex), verts[0].color);
+
+	glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(verts.size()));
+
+	glDisableClientState(GL_COLOR_ARRAY);
+}
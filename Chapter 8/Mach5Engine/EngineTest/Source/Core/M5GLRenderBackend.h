@@ -0,0 +1,56 @@
+/******************************************************************************/
+/*!
+\file   M5GLRenderBackend.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+A render backend that draws frames to a window with OpenGL.
+
+*/
+/******************************************************************************/
+#ifndef M5_GL_RENDER_BACKEND_H
+#define M5_GL_RENDER_BACKEND_H
+
+#include "M5RenderBackend.h"
+#include "M5RenderList.h"
+
+/*! Used to exclude rarely-used stuff from Windows */
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+/*! A render backend that draws frames to a window with OpenGL.  There are two
+contexts that share textures.  The main thread uses one to make textures, and
+the render thread draws with the other.*/
+class M5GLRenderBackend : public M5RenderBackend
+{
+public:
+	M5GLRenderBackend(void);
+	//Makes the contexts, the quad and the font texture on the main thread
+	void Init(HWND window);
+	//Frees everything made in Init, after the render thread has stopped
+	void Shutdown(void);
+	virtual void StartThread(void);
+	virtual void EndThread(void);
+	virtual void Execute(const M5RenderFrame& frame);
+	virtual int  CreateTexture(const unsigned char* pixels, int width, int height, unsigned format);
+	virtual void DeleteTexture(int textureID);
+private:
+	void ContextInit(void);
+	void VertexBufferInit(void);
+	void FontInit(void);
+	void DrawItems(const M5RenderItems& items);
+	void DrawTextQuads(const M5TextVertices& verts);
+
+	HWND     m_window;        //!< The window to draw to
+	HDC      m_deviceContext; //!< The device context of the window
+	HGLRC    m_mainContext;   //!< Context for making textures on the main thread
+	HGLRC    m_drawContext;   //!< Context for drawing on the render thread
+	unsigned m_vboID;         //!< The quad every item is drawn with
+	unsigned m_vertexCount;   //!< Number of vertices in the quad
+	unsigned m_fontTexture;   //!< The glyph atlas for text
+};
+
+
+#endif //M5_GL_RENDER_BACKEND_H
@@ -14,14 +14,25 @@ Singleton class to draw and modify the view of the screen
 #include "M5Vec2.h"
 #include "M5Mtx44.h"
 #include "M5Debug.h"
+#include "M5Log.h"
 #include "M5ResourceManager.h"
 #include "GfxComponent.h"
+#include "M5Object.h"
+#include "M5Memory.h"
+#include "M5TextBatch.h"
+#include "M5RenderThread.h"
+#include "M5GLRenderBackend.h"
+#include "M5NullRenderBackend.h"
+#include "M5SoftRenderBackend.h"
 
 #include <cmath> /*for tan*/
 #include <cstring> /*memset*/
 #include <string>
 #include <vector>
 #include <stack>
+#include <chrono>
+#include <unordered_map>
+#include <algorithm>
 
 #include "windows.h"
 #include "gl/glew.h"
@@ -40,30 +51,15 @@ const GLdouble CAM_NEAR_CLIP = 1.0;      /*!< Near clip plane in the Z*/
 const GLdouble CAM_FAR_CLIP = 1000.0;    /*!< Far Clip plane in the Z*/
 const GLdouble MIN_CAM_DISTANCE = 2.0f;  /*!< Min camera distance*/
 const GLdouble MAX_CAM_DISTANCE = 999.0f;/*!< Max camera distance*/
-/*Information about my font list*/
-const int NUMBER_OF_CHARACTERS = 96;     /*!< The size*/
-const int STARTING_CHARACTER = 32;       /*!< Start with the space*/
+/*Information about my font*/
+const float FONT_HEIGHT_SCALE = .03f;    /*!< Height of a line of text compared to the screen*/
+/*Information about my culling grid*/
+const float CELL_SIZE = 20.f;            /*!< Width and height of a grid cell in world units*/
 
 /************************************************************************/
 /* Types used by my graphics Engine                                     */
 /************************************************************************/
 
-  //!A struct to hold my Vertex buffer object information
-struct M5Mesh
-{
-	unsigned vertexCount; /*!< The number of vertices's in the list.*/
-	GLuint   vboID;       /*!< The vbo id from openGl.*/
-};
-
-/*! A struct to define my vertex.*/
-struct M5Vertex
-{
-	float x;/*The x position*/
-	float y;/*The y position*/
-	float z;/*The z position*/
-	float tu;/*The u texture coord*/
-	float tv;/*The v texture coord*/
-};
 struct GfxState
 {
 	GLdouble cameraZ; 
@@ -72,6 +68,7 @@ struct GfxState
 	GLdouble cameraRot;
 	int hudStart;
 	int worldStart;
+	int drawLayer;
 	int textureID;
 	int height;
 	float scaleX;
@@ -92,6 +89,7 @@ struct GfxState
 
 //!! A struct to hold and share data important to graphics functions.
 GfxState s_gfxState;
+M5GfxStats s_stats;
 std::stack<GfxState> s_pauseStack;
 
 /*Projection data*/
@@ -103,13 +101,14 @@ GLdouble s_persp[16];     /*!< A copy of the perspective matrix*/
 GLdouble s_camera[16];    /*!< A copy of the camera matrix*/
 
 /*Window drawing data*/
-HGLRC    s_renderContext; /*!< The renderContext for OpenGL*/
-HDC      s_deviceContext; /*!< The device context for windows*/
 HWND     s_window;        /*!< The window for windows and openGL*/
+bool     s_isHeadless;    /*!< True if frames go to the null backend instead of OpenGL*/
+bool     s_isSoftware;    /*!< True if frames are drawn on the CPU instead of OpenGL*/
 
 /*Screen dimensions*/
 int      s_width;         /*!< The width of the client area of the screen*/
 int      s_height;        /*!< The height of the client area of the screen*/
+GLint    s_viewport[4];   /*!< The x, y, width and height of the viewport*/
 
 /*Visible corners points of the world*/
 M5Vec2   s_worldTopLeft;  /*!< The top left point on the screen.*/
@@ -117,23 +116,128 @@ M5Vec2   s_worldTopRight; /*!< The top right point on the screen.*/
 M5Vec2   s_worldBotLeft;  /*!< The bottom Left point on the screen.*/
 M5Vec2   s_worldBotRight; /*!< The bottom right point on the screen.*/
 
-/*Font data*/
-HFONT    s_font;          /*!< The font to create*/
-HFONT    s_oldFont;       /*!< The old font*/
-GLuint   s_fontBase;      /*!< My font list I will create*/
-
-M5Mesh   s_mesh;          /*!< Quad Mesh since it is 2D game engine*/
+M5Mtx44  s_texCoords;     /*!< The texture matrix from SetTextureCoords*/
 
 //! Typedef for my vector of components
-typedef std::vector<GfxComponent*> Components;
+typedef std::vector<GfxComponent*, M5Allocator<GfxComponent*, MT_GFX> > Components;
+
+//! Typedef for the culling grid, cell key to the components in that cell
+typedef std::unordered_map<unsigned long long, Components, std::hash<unsigned long long>,
+	std::equal_to<unsigned long long>, M5Allocator<std::pair<const unsigned long long, Components>, MT_GFX> > Grid;
+
+Components          s_worldComponents;
+Components          s_hudComponents;
+M5GLRenderBackend   s_glBackend;       /*!< Draws frames with OpenGL*/
+M5NullRenderBackend s_nullBackend;     /*!< Reads frames without drawing, for headless runs*/
+M5SoftRenderBackend s_softBackend;     /*!< Draws frames on the CPU, for machines without a GPU*/
+M5RenderBackend*    s_pBackend;        /*!< The backend in use*/
+M5RenderThread      s_renderThread;    /*!< Draws the last frame while the next is simulated*/
+M5RenderFrame*      s_pFrame;          /*!< The frame being filled during Update*/
+M5RenderItems*      s_pList;           /*!< The world or HUD list Draw adds to*/
+M5ResourceManager   s_resourceManager;
+M5TextBatch         s_text;            /*!< Text written this frame*/
+Grid                s_grid;            /*!< World components by the cell they are in*/
+Components          s_largeComponents; /*!< World components too big for the grid*/
+Components          s_moved;           /*!< World components that need their grid cell checked before culling*/
+Components          s_visible;         /*!< World components that passed culling this frame*/
+Components          s_drawOrder;       /*!< s_visible sorted by ID, kept while the visible set is the same*/
+unsigned            s_cullFrame;       /*!< Counts calls to DrawVisibleWorld, to tell what was visible last frame*/
+
+/******************************************************************************/
+/*!
+Helper function to turn a world coordinate into a grid coordinate.
+
+\param [in] value
+The x or y world coordinate.
+
+\return
+The x or y grid coordinate.
+*/
+/******************************************************************************/
+int ToCell(float value)
+{
+	return static_cast<int>(std::floor(value / CELL_SIZE));
+}
+/******************************************************************************/
+/*!
+Helper function to pack grid coordinates into a key for the grid.
+
+\param [in] x
+The x grid coordinate.
+
+\param [in] y
+The y grid coordinate.
+
+\return
+The key of the cell.
+*/
+/******************************************************************************/
+unsigned long long MakeCellKey(int x, int y)
+{
+	return (static_cast<unsigned long long>(static_cast<unsigned>(x)) << 32) | static_cast<unsigned>(y);
+}
+/******************************************************************************/
+/*!
+Helper function to get the radius of a circle that holds an object at any
+rotation.
+
+\param [in] scale
+The scale of the object.
+
+\return
+The radius of the object.
+*/
+/******************************************************************************/
+float CullRadius(const M5Vec2& scale)
+{
+	return .5f * std::sqrt(scale.x * scale.x + scale.y * scale.y);
+}
+/******************************************************************************/
+/*!
+Helper function to get the list a world component goes in, a grid cell or the
+list of large components.
+
+\param [in] isLarge
+True if the component is too big for the grid.
 
-Components        s_worldComponents;
-Components        s_hudComponents;
-M5ResourceManager s_resourceManager;
+\param [in] cell
+The key of the grid cell, if it isn't large.
 
+\return
+The list of components.
+*/
+/******************************************************************************/
+Components& GetCellList(bool isLarge, unsigned long long cell)
+{
+	if (isLarge)
+		return s_largeComponents;
+	return s_grid[cell];
+}
 /******************************************************************************/
 /*!
-Helper function to Set projection matrix is something needs to change.
+Helper function to sort visible components so they always draw in the same
+order.
+
+\param [in] pLeft
+The first component to compare.
+
+\param [in] pRight
+The second component to compare.
+
+\return
+True if pLeft was created before pRight.
+*/
+/******************************************************************************/
+bool DrawOrder(const GfxComponent* pLeft, const GfxComponent* pRight)
+{
+	return pLeft->GetID() < pRight->GetID();
+}
+
+/******************************************************************************/
+/*!
+Helper function to Set projection matrix is something needs to change.  This
+is the same matrix gluPerspective makes, but it is built here so no OpenGL
+context is needed on the simulation thread.
 
 \param [in] fov
 The field of view for the height of the screen, specified in degrees.
@@ -150,16 +254,14 @@ The distance of the far clip plane.
 /******************************************************************************/
 void SetPerspective(GLdouble fov, GLdouble aspectRatio, GLdouble nearClip, GLdouble farClip)
 {
-	//GLdouble modelView[16];
-	/*Set our current view mode*/
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	/*Set up Perspective Matrix*/
-	gluPerspective(fov, aspectRatio, nearClip, farClip);
-	glGetDoublev(GL_PROJECTION_MATRIX, s_persp);
-
-	/*Switch back to Model view*/
-	glMatrixMode(GL_MODELVIEW);
+	GLdouble f = 1.0 / std::tan(fov * .5 * M5Math::PI / 180.0);
+
+	std::memset(s_persp, 0, sizeof(s_persp));
+	s_persp[0] = f / aspectRatio;
+	s_persp[5] = f;
+	s_persp[10] = (farClip + nearClip) / (nearClip - farClip);
+	s_persp[11] = -1.0;
+	s_persp[14] = (2.0 * farClip * nearClip) / (nearClip - farClip);
 }
 }//end unnamed namespace
 
@@ -193,15 +295,15 @@ void M5Gfx::SetCamera(float cameraX, float cameraY,
 	s_gfxState.cameraZ = cameraZ;
 	s_gfxState.cameraRot = cameraRot;
 
-	glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
-	gluLookAt(cameraX, cameraY, cameraZ,/*Camera position*/
-		cameraX, cameraY, 0.0,    /*Target*/
-		0, 1.0, 0.0);           /*UpVector*/
-
+	/*The camera looks straight down, so gluLookAt would only translate.  The
+	rotation goes first, then the translation is the last column*/
 	rotMatrix.MakeRotateZ(cameraRot);
-	glMultMatrixf((GLfloat*)&rotMatrix.m[0][0]);
-	glGetDoublev(GL_MODELVIEW_MATRIX, s_camera);
+	const float* pRot = &rotMatrix.m[0][0];
+	for (int i = 0; i < 16; ++i)
+		s_camera[i] = pRot[i];
+	s_camera[12] = -cameraX;
+	s_camera[13] = -cameraY;
+	s_camera[14] = -cameraZ;
 	/*Re calculate world extents*/
 	CalulateWorldExtents();
 }
@@ -210,7 +312,7 @@ void M5Gfx::SetCamera(float cameraX, float cameraY,
 /******************************************************************************/
 /*!
 Initializes the Graphics Engine for drawing.  This will be called automatically
-when the window is created.
+when the window is created.  The render thread is started last.
 
 \param [in] window
 The window to draw to.
@@ -220,9 +322,18 @@ The width of the client area of the window.
 
 \param [in] height
 The height of the client area of the window
+
+\param [in] headless
+True to read frames with the null backend instead of drawing them with
+OpenGL.  No GPU is needed, so this is used to time the engine.
+
+\param [in] software
+True to draw frames on the CPU instead of with OpenGL.  No GPU is needed, and
+the last frame can be saved with SaveFrame.  If headless is also true, frames
+are drawn but not shown in the window.
 */
 /******************************************************************************/
-void M5Gfx::Init(HWND window, int width, int height)
+void M5Gfx::Init(HWND window, int width, int height, bool headless, bool software)
 {
 	M5DEBUG_CALL_CHECK(1);
 
@@ -230,6 +341,8 @@ void M5Gfx::Init(HWND window, int width, int height)
 	s_window = window;
 	s_width = width;
 	s_height = height;
+	s_isHeadless = headless;
+	s_isSoftware = software;
 
 	/*Set defaults for projection*/
 	s_fov = WIN_FOV;
@@ -237,33 +350,22 @@ void M5Gfx::Init(HWND window, int width, int height)
 	s_farClip = CAM_FAR_CLIP;
 	s_aspectRatio = (GLdouble)width / height;
 
-	/*Get Device context for window*/
-	s_deviceContext = GetDC(s_window);
-
-	/*This will assert if it fails otherwise gfxData.renderContext is valid*/
-	RenderContextInit();
-	FontInit();
-
-	/*Give back the resource until we need it again.*/
-	ReleaseDC(s_window, s_deviceContext);
-	s_deviceContext = 0;
-
-	/*Set fill mode*/
-	glPolygonMode(GL_FRONT, GL_FILL);
-
-	/*Enable Depth Test*/
-	glEnable(GL_DEPTH_TEST);
-	glClearDepth(1.0f);
-	glDepthFunc(GL_LEQUAL);
-
-	/*Enable textures*/
-	glEnable(GL_TEXTURE_2D);
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	/*Set up for position and color*/
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	/*This will assert if it fails otherwise the contexts are valid*/
+	if (s_isSoftware)
+	{
+		s_softBackend.Init(s_isHeadless ? 0 : s_window);
+		s_pBackend = &s_softBackend;
+	}
+	else if (s_isHeadless)
+	{
+		s_pBackend = &s_nullBackend;
+	}
+	else
+	{
+		s_glBackend.Init(s_window);
+		s_pBackend = &s_glBackend;
+	}
+	s_resourceManager.SetBackend(s_pBackend);
 
 	//Set my GfxState
 	/*Set my drawing viewPort*/
@@ -279,10 +381,10 @@ void M5Gfx::Init(HWND window, int width, int height)
 	SetBackgroundColor();
 	s_gfxState.hudStart = 0;
 	s_gfxState.worldStart = 0;
+	s_gfxState.drawLayer = 0;
+	s_gfxState.textureID = 0;
 
-	/*Set up glew functions*/
-	glewInit();
-	VertexBufferInit();
+	s_renderThread.Start(s_pBackend);
 }
 /******************************************************************************/
 /*!
@@ -296,91 +398,62 @@ void M5Gfx::Shutdown(void)
 	M5DEBUG_ASSERT(s_hudComponents.size() == 0 && s_worldComponents.size() == 0,
 		"Some Components were not unloaded.");
 
+	/*The last frame might still use textures*/
+	s_renderThread.Stop();
+
 	s_hudComponents.clear();
 	s_worldComponents.clear();
+	s_grid.clear();
+	s_largeComponents.clear();
+	s_moved.clear();
+	s_visible.clear();
+	s_drawOrder.clear();
+
+	M5TextureStats textures;
+	s_resourceManager.GetStats(textures);
+	M5Log::Write(LL_INFO, LC_GFX, "M5Gfx: %d texture hits, %d misses, %d evictions",
+		textures.hits, textures.misses, textures.evictions);
 	s_resourceManager.Clear();
 
-	glDeleteBuffers((GLsizei)1, &s_mesh.vboID);
-	glDeleteLists(s_fontBase, NUMBER_OF_CHARACTERS);
-	wglMakeCurrent(NULL, NULL);
-	wglDeleteContext(s_renderContext);
-	s_renderContext = 0;
-}
-/******************************************************************************/
-/*!
-Sets the beginning of a draw frame.  This must be called before trying to draw
-anything.
-
-\attention
-This must be called before drawing anything.
-
-*/
-/******************************************************************************/
-void M5Gfx::StartScene(void)
-{
-	s_deviceContext = GetDC(s_window);
-	wglMakeCurrent(s_deviceContext, s_renderContext);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	if (s_isSoftware)
+		s_softBackend.Shutdown();
+	else if (!s_isHeadless)
+		s_glBackend.Shutdown();
 }
 /******************************************************************************/
 /*!
-Specifies when the draw frame is finished.  This must be called after all draw
-calls.
-
-\attention
-This must be called after all draw calls.
-
-*/
-/******************************************************************************/
-void M5Gfx::EndScene(void)
-{
-	SwapBuffers(s_deviceContext);
-	ReleaseDC(s_window, s_deviceContext);
-	s_deviceContext = 0;
-}
-/******************************************************************************/
-/*!
-Writes Text to the screen. Using an internal font.  This is best used for debug
-text. (It is better to use images for the text you want.)
+Writes Text to the screen using the built in font.  The text isn't drawn right
+away, all text for the frame is drawn in one batch on top of the HUD.  The
+current texture color is used for the text.
 
 \attention
 This is best used for debug only.
 
 \param [in] text
-The Text you want to draw to the screen.
+The Text you want to draw to the screen.  Use \\n to start a new line.
 
 \param [in] x
-The x location to start.
+The x location in screen space to start.
 
 \param [in] y
-The y location to start.
+The y location in screen space of the bottom of the first line.
 */
 /******************************************************************************/
 void M5Gfx::WriteText(const char* text, float x, float y)
 {
-	/*Disable textures*/
-	glDisable(GL_TEXTURE_2D);
-	glMatrixMode(GL_MODELVIEW);
-
-	/*Set up Matrix*/
-	glPushMatrix();
-	glRasterPos2f(x, y);
-
-	/*Set up display list*/
-	glPushAttrib(GL_LIST_BIT);
-	glListBase(s_fontBase - STARTING_CHARACTER);
-
-	/*Draw text display list*/
-	glCallLists(static_cast<GLsizei>(std::strlen(text)), GL_UNSIGNED_BYTE, text);
-
-	/*restore display list and matrix*/
-	glPopAttrib();
-	glPopMatrix();
-	glEnable(GL_TEXTURE_2D);
+	unsigned color = s_gfxState.txRed | (s_gfxState.txGreen << 8) |
+		(s_gfxState.txBlue << 16) | (static_cast<unsigned>(s_gfxState.txAlpha) << 24);
+	float scale = s_height * FONT_HEIGHT_SCALE / M5TextBatch::GLYPH_HEIGHT;
+	s_text.Write(text, x, y, scale, color);
 }
 /******************************************************************************/
 /*!
-Draws the currently set texture at this location, scale and rotation.
+Adds the currently set texture at this location, scale and rotation to the
+frame.  It is drawn by the render thread after the frame is submitted.
+
+\attention
+This can only be called while M5Gfx is updating, such as from
+GfxComponent::Draw.
 
 \param [in] worldMatrix
 The world matrix that will define the scale rotation and translation.
@@ -388,24 +461,18 @@ The world matrix that will define the scale rotation and translation.
 /******************************************************************************/
 void M5Gfx::Draw(const M5Mtx44& worldMatrix)
 {
-	/*Set the matrix mode*/
-	glMatrixMode(GL_MODELVIEW);
-	/*Add this matrix to the view*/
-	glPushMatrix();
-	/*Right now my matrix is the transpose of open gl*/
-	glMultMatrixf(reinterpret_cast<const GLfloat*>(&worldMatrix.m[0][0]));
-
-	/*Set the start of my position data*/
-	glVertexPointer(3, GL_FLOAT, sizeof(M5Vertex), 0);
-	/*Set  my texture positions*/
-	glTexCoordPointer(2, GL_FLOAT, sizeof(M5Vertex),
-		((char*)0 + sizeof(float) * 3));
-
-	/*Draw my object*/
-	glDrawArrays(GL_TRIANGLES, 0, s_mesh.vertexCount);
-
-	/*Remove this matrix*/
-	glPopMatrix();
+	M5DEBUG_ASSERT(s_pList != 0, "Draw can only be called while M5Gfx is updating");
+	++s_stats.drawn;
+
+	s_pList->push_back(M5RenderItem());
+	M5RenderItem& item = s_pList->back();
+	item.world = worldMatrix;
+	item.texCoords = s_texCoords;
+	item.textureID = s_gfxState.textureID;
+	item.color[0] = s_gfxState.txRed;
+	item.color[1] = s_gfxState.txGreen;
+	item.color[2] = s_gfxState.txBlue;
+	item.color[3] = s_gfxState.txAlpha;
 }
 /******************************************************************************/
 /*!
@@ -421,7 +488,6 @@ The texture id to set.
 void M5Gfx::SetTexture(int textureID)
 {
 	s_gfxState.textureID = textureID;
-	glBindTexture(GL_TEXTURE_2D, textureID);
 }
 /******************************************************************************/
 /*!
@@ -469,11 +535,7 @@ The amount to translate in the y direction.
 /******************************************************************************/
 void M5Gfx::SetTextureCoords(float scaleX, float scaleY, float radians, float transX, float transY)
 {
-	M5Mtx44 transform;
-	transform.MakeTransform(scaleX, scaleY, radians, transX, transY, 0.f);
-	glMatrixMode(GL_TEXTURE);
-	glLoadMatrixf(&transform.m[0][0]);
-	glMatrixMode(GL_MODELVIEW);
+	s_texCoords.MakeTransform(scaleX, scaleY, radians, transX, transY, 0.f);
 	//save state
 	s_gfxState.scaleX = scaleX;
 	s_gfxState.scaleY = scaleY;
@@ -500,7 +562,6 @@ void M5Gfx::SetBackgroundColor(float red, float green, float blue)
 	s_gfxState.bgRed = red;
 	s_gfxState.bgGreen = green;
 	s_gfxState.bgBlue = blue;
-	glClearColor(red, green, blue, 1.0);
 }
 /******************************************************************************/
 /*!
@@ -571,8 +632,6 @@ void M5Gfx::SetTextureColor(unsigned color)
 	s_gfxState.txGreen = pColor[1];
 	s_gfxState.txBlue = pColor[2];
 	s_gfxState.txAlpha = pColor[3];
-
-	glColor4ubv(pColor);
 }
 /******************************************************************************/
 /*!
@@ -598,18 +657,10 @@ The amount of red that texture has.
 /******************************************************************************/
 void M5Gfx::SetTextureColor(unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha)
 {
-	unsigned char color[4];
-	color[0] = red;
-	color[1] = green;
-	color[2] = blue;
-	color[3] = alpha;
-
-	s_gfxState.txRed = color[0];
-	s_gfxState.txGreen = color[1];
-	s_gfxState.txBlue = color[2];
-	s_gfxState.txAlpha = color[3];
-
-	glColor4ubv(color);
+	s_gfxState.txRed = red;
+	s_gfxState.txGreen = green;
+	s_gfxState.txBlue = blue;
+	s_gfxState.txAlpha = alpha;
 }
 /******************************************************************************/
 /*!
@@ -629,21 +680,18 @@ A pointer to a float in screen space that will be changed to world space.
 /******************************************************************************/
 void M5Gfx::ConvertScreenToWorld(float& x, float& y)
 {
-	GLint viewPort[4];
 	GLdouble winX, winY, winZ;
 	GLdouble posX, posY, posZ;
 
-	glGetIntegerv(GL_VIEWPORT, viewPort);
-
 	/*Get my window z by projecting world space 0*/
-	gluProject(0, 0, 0, s_camera, s_persp, viewPort, &winX, &winY, &winZ);
+	gluProject(0, 0, 0, s_camera, s_persp, s_viewport, &winX, &winY, &winZ);
 
 	/*Get my window x and y*/
 	winX = x;
 	winY = y;
 
 	/*now figure out what the world location is*/
-	gluUnProject(winX, winY, winZ, s_camera, s_persp, viewPort, &posX, &posY, &posZ);
+	gluUnProject(winX, winY, winZ, s_camera, s_persp, s_viewport, &posX, &posY, &posZ);
 
 	x = static_cast<float>(posX);
 	y = static_cast<float>(posY);
@@ -666,11 +714,9 @@ A pointer to a float in world space that will be changed to screen space.
 /******************************************************************************/
 void M5Gfx::ConvertWorldToScreen(float& x, float& y)
 {
-	GLint viewPort[4];
 	GLdouble winX, winY, winZ;
 
-	glGetIntegerv(GL_VIEWPORT, viewPort);
-	gluProject(x, y, 0, s_camera, s_persp, viewPort, &winX, &winY, &winZ);
+	gluProject(x, y, 0, s_camera, s_persp, s_viewport, &winX, &winY, &winZ);
 
 	x = static_cast<float>(winX);
 	y = static_cast<float>(winY);
@@ -680,21 +726,21 @@ void M5Gfx::ConvertWorldToScreen(float& x, float& y)
 This mode sets the scene to use the perspective matrix.  This is the standard
 mode to draw objects in.  Z order is important and changing the distance
 of the camera effects object size.  The draw location must be in world
-coordinates.
+coordinates.  Draw calls after this go in the world list of the frame.
 */
 /******************************************************************************/
 void M5Gfx::SetToPerspective(void)
 {
 	SetPerspective(s_fov, s_aspectRatio, s_nearClip, s_farClip);
-	SetCamera(static_cast<float>(s_gfxState.cameraX),
-		static_cast<float>(s_gfxState.cameraY),
-		static_cast<float>(s_gfxState.cameraZ),
-		static_cast<float>(s_gfxState.cameraRot));
+	std::memcpy(s_pFrame->persp, s_persp, sizeof(s_persp));
+	std::memcpy(s_pFrame->camera, s_camera, sizeof(s_camera));
+	s_pList = &s_pFrame->world;
 }
 /******************************************************************************/
 /*!
 This mode is used to HUD objects.  Z order is still effective, but distance
 from the camera is not.  The draw location must be in screen coordinates.
+Draw calls after this go in the HUD list of the frame.
 
 \attention
 You should not set camera position while this mode is active.
@@ -702,16 +748,9 @@ You should not set camera position while this mode is active.
 /******************************************************************************/
 void M5Gfx::SetToOrtho(void)
 {
-	/*glDisable(GL_DEPTH_TEST);*/
-	/*Set our current view mode*/
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	/*Set up Perspective Matrix*/
-	/*glOrtho(0, gfxData.width, gfxData.height, 0, -1.0f, 1.0f);*/
-	gluOrtho2D(0, s_width, 0, s_height);
-	/*Switch back to Model view*/
-	glMatrixMode(GL_MODELVIEW);
-	glLoadIdentity();
+	s_pFrame->width = s_width;
+	s_pFrame->height = s_height;
+	s_pList = &s_pFrame->hud;
 }
 /******************************************************************************/
 /*!
@@ -732,7 +771,10 @@ The new height of the viewport in pixels
 /******************************************************************************/
 void M5Gfx::SetViewport(int xStart, int yStart, int width, int height)
 {
-	glViewport(xStart, yStart, width, height);
+	s_viewport[0] = xStart;
+	s_viewport[1] = yStart;
+	s_viewport[2] = width;
+	s_viewport[3] = height;
 }
 /******************************************************************************/
 /*!
@@ -777,125 +819,6 @@ void M5Gfx::CalulateWorldExtents(void)
 	s_worldBotRight.y = worldMaxX*rotMatrix.m[0][1] + worldMinY*rotMatrix.m[1][1];
 }
 
-/******************************************************************************/
-/*!
-Helper function to create a font for debug text drawing to the screen.
-*/
-/******************************************************************************/
-void M5Gfx::FontInit(void)
-{
-	const float FONT_HEIGHT_SCALE = .03f;
-	/*Get a list of bitmaps from openGl*/
-	s_fontBase = glGenLists(NUMBER_OF_CHARACTERS);
-
-	/*Create my windows font*/
-	s_font = CreateFont(
-		(int)(s_height * FONT_HEIGHT_SCALE),/*Height*/ //TODO: Make this const
-		0,                     /*width*/
-		0,                     /*angle of escapement*/
-		0,                     /*orientation,*/
-		400,                   /*font weight*/
-		FALSE,                 /*Italic*/
-		FALSE,                 /*Underlined*/
-		FALSE,                 /*Strike out*/
-		DEFAULT_CHARSET,       /*Char set identifier*/
-		OUT_TT_PRECIS,         /*Output Precision*/
-		CLIP_DEFAULT_PRECIS,   /*Clipping Precision*/
-		ANTIALIASED_QUALITY,   /*OutputQuality*/
-		DEFAULT_PITCH,         /*Family and Pitch*/
-		"Terminal");           /*Font name*/
-
-							   /*Switch to my created font*/
-	s_oldFont = (HFONT)SelectObject(s_deviceContext, s_font);
-
-	/*Tell open gl about my font*/
-	wglUseFontBitmaps(s_deviceContext, STARTING_CHARACTER, NUMBER_OF_CHARACTERS, s_fontBase);
-	/*Set back to original font*/
-	SelectObject(s_deviceContext, s_oldFont);
-	/*Deleted my created font.*/
-	DeleteObject(s_font);
-
-}
-/******************************************************************************/
-/*!
-Creates the single vertex buffer in the game.  Since this is currently only a
-2D game engine it only needs a Quad.
-
-My verts are like this
-
-2--------(1,6)
-|           |
-|           |
-|           |
-|           |
-(3,4)----- 5
-*/
-/******************************************************************************/
-void M5Gfx::VertexBufferInit(void)
-{
-	const int VERT_COUNT = 6;
-	/*Hard code my verts, because we are only supporting one vbo*/
-	M5Vertex vertArray[6] = {
-	  { .5f, .5f, 0.f, 1.f, 1.f }, /*1*/
-	  { -.5f, .5f, 0.f, 0.f, 1.f }, /*2*/
-	  { -.5f, -.5f, 0.f, 0.f, 0.f }, /*3*/
-
-	  { -.5f, -.5f, 0.f, 0.f, 0.f }, /*4*/
-	  { .5f, -.5f, 0.f, 1.f, 0.f }, /*5*/
-	  { .5f, .5f, 0.f, 1.f, 1.f } }; /*6*/
-	GLsizei dataSize = sizeof(M5Vertex) * VERT_COUNT;
-
-	/*Generate my vbo*/
-	glGenBuffers((GLsizei)1, &s_mesh.vboID);
-	s_mesh.vertexCount = VERT_COUNT;
-
-	/*Set my buffer to the current*/
-	glBindBuffer(GL_ARRAY_BUFFER, s_mesh.vboID);
-	/*Fill in data into my vbo*/
-	glBufferData(GL_ARRAY_BUFFER, dataSize, vertArray, GL_STATIC_DRAW);
-}
-/******************************************************************************/
-/*!
-This function will initialize the render context.  If it fails the program will
-assert in debug or crash in release mode.  After calling this the
-renderContext will be valid.
-*/
-/******************************************************************************/
-void M5Gfx::RenderContextInit(void)
-{
-	/*A struct the specifies information about the back buffer*/
-	PIXELFORMATDESCRIPTOR pfd;
-	int pixelFormat; /*The result value after choosing my pixel format*/
-	BOOL result; /*Used to check for errors.*/
-
-				 /*Clear my pfd and only set the values I need.*/
-	std::memset(&pfd, 0, sizeof(pfd));
-
-	/*Set up information about pixels for buffer and back buffer*/
-	pfd.nSize = sizeof(PIXELFORMATDESCRIPTOR);
-	pfd.nVersion = 1;
-	/*A set of flags that specify the properties of the pixel buffer*/
-	pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
-	pfd.iPixelType = PFD_TYPE_RGBA;
-	pfd.cColorBits = 32;
-	pfd.cDepthBits = 32;
-
-	/*Choose back buffer information*/
-	pixelFormat = ChoosePixelFormat(s_deviceContext, &pfd);
-	M5DEBUG_ASSERT(pixelFormat != 0, "Unable to chose PixelFormat. Your video card is out of date");
-
-	/*Set back buffer information*/
-	result = SetPixelFormat(s_deviceContext, pixelFormat, &pfd);
-	M5DEBUG_ASSERT(result != 0, "Unable to Set PixelFormat. Your video card is out of date");
-
-	/*Create openGL render context*/
-	s_renderContext = wglCreateContext(s_deviceContext);
-	M5DEBUG_ASSERT(s_renderContext != 0, "Unable to Create Render Context. Your video card is out of date");
-
-	/*Set the openGl render context*/
-	result = wglMakeCurrent(s_deviceContext, s_renderContext);
-	M5DEBUG_ASSERT(result != 0, "Unable to Set Render Context. Your video card is out of date");
-}
 /******************************************************************************/
 /*!
 The function to load a texture from a file.  This function will load 24 or 32
@@ -954,6 +877,57 @@ void M5Gfx::UnloadTexture(int textureID)
 }
 /******************************************************************************/
 /*!
+Reads and decodes a texture from disk without creating the GFX API texture.
+A later call to LoadTexture with the same name will only upload the data.
+Unlike the other functions, this is safe to call from a loading thread.
+
+\param fileName
+The name of the TGA file to read.
+*/
+/******************************************************************************/
+void M5Gfx::PrefetchTexture(const char* fileName)
+{
+	M5DEBUG_ASSERT(fileName != 0, "Filename is NULL");
+	s_resourceManager.PrefetchTexture(fileName);
+}
+/******************************************************************************/
+/*!
+Sets how many bytes of textures to keep.  Textures that are no longer used are
+kept until this is passed, so loading them again doesn't touch the disk.  The
+least recently used ones are deleted first.
+
+\param bytes
+The budget.  Zero deletes every texture as soon as it is unloaded.
+*/
+/******************************************************************************/
+void M5Gfx::SetTextureBudget(long long bytes)
+{
+	s_resourceManager.SetBudget(bytes);
+}
+/******************************************************************************/
+/*!
+Gets the bytes of textures in use and cached, along with the number of loads
+that hit or missed the cache and the number of textures evicted.
+
+\param [out] stats
+The struct to fill.
+*/
+/******************************************************************************/
+void M5Gfx::GetTextureStats(M5TextureStats& stats)
+{
+	s_resourceManager.GetStats(stats);
+}
+/******************************************************************************/
+/*!
+Frees any prefetched textures that were never loaded.
+*/
+/******************************************************************************/
+void M5Gfx::ClearPrefetchedTextures(void)
+{
+	s_resourceManager.ClearPrefetched();
+}
+/******************************************************************************/
+/*!
 Adds the given GfxComponent to the list of world object.
 
 \param pGfxComp
@@ -962,7 +936,14 @@ The Component to register.
 /******************************************************************************/
 void M5Gfx::RegisterWorldComponent(GfxComponent* pGfxComp)
 {
+	M5DEBUG_ASSERT(pGfxComp->m_drawIndex < 0, "Trying to register a component that is already registered");
+	pGfxComp->m_drawIndex = static_cast<int>(s_worldComponents.size());
+	pGfxComp->m_isInHud = false;
 	s_worldComponents.push_back(pGfxComp);
+	pGfxComp->m_layer = static_cast<int>(s_pauseStack.size());
+	AddToGrid(pGfxComp);
+	//New objects are usually placed after they are made
+	AddToMoved(pGfxComp);
 }
 /******************************************************************************/
 /*!
@@ -974,11 +955,16 @@ The Component to register.
 /******************************************************************************/
 void M5Gfx::RegisterHudComponent(GfxComponent* pGfxComp)
 {
+	M5DEBUG_ASSERT(pGfxComp->m_drawIndex < 0, "Trying to register a component that is already registered");
+	pGfxComp->m_drawIndex = static_cast<int>(s_hudComponents.size());
+	pGfxComp->m_isInHud = true;
 	s_hudComponents.push_back(pGfxComp);
 }
 /******************************************************************************/
 /*!
-Seaches the HUD and World Lists and removes the given component from both.
+Removes the given component from the HUD or World list it was registered in.
+The component knows its index, so it is swapped with the last component
+instead of searching the list.
 
 \param pGfxComp
 The Component to unregister.
@@ -986,46 +972,416 @@ The Component to unregister.
 /******************************************************************************/
 void M5Gfx::UnregisterComponent(GfxComponent* pGfxComp)
 {
-	//Unregister from world list if it exists there
-	for (size_t i = s_gfxState.worldStart; i < s_worldComponents.size(); ++i)
+	int index = pGfxComp->m_drawIndex;
+	if (index < 0)
+		return;
+
+	Components& list = pGfxComp->m_isInHud ? s_hudComponents : s_worldComponents;
+	M5DEBUG_ASSERT(index >= (pGfxComp->m_isInHud ? s_gfxState.hudStart : s_gfxState.worldStart),
+		"Trying to unregister a component from a paused stage");
+
+	if (!pGfxComp->m_isInHud)
 	{
-		if (s_worldComponents[i] == pGfxComp)
-		{
-			s_worldComponents[i] = s_worldComponents[s_worldComponents.size() - 1];
-			s_worldComponents.pop_back();
-		}
-	}
-	//Unregister from hud list if it exists there
-	for (size_t i = s_gfxState.hudStart; i < s_hudComponents.size(); ++i)
-	{
-		if (s_hudComponents[i] == pGfxComp)
-		{
-			s_hudComponents[i] = s_hudComponents[s_hudComponents.size() - 1];
-			s_hudComponents.pop_back();
-		}
+		RemoveFromGrid(pGfxComp);
+		RemoveFromMoved(pGfxComp);
 	}
+
+	//The last component is never paused, so the start offsets stay correct
+	GfxComponent* pLast = list.back();
+	list[index] = pLast;
+	pLast->m_drawIndex = index;
+	list.pop_back();
+	pGfxComp->m_drawIndex = -1;
 }
 /******************************************************************************/
 /*!
-Draws all registered components
+Fills a frame with all registered components and the text written this frame,
+then gives it to the render thread.  The render thread draws it while the next
+frame is simulated, so nothing in the frame can point back at game objects.
 
 */
 /******************************************************************************/
 void M5Gfx::Update(void)
 {
-	size_t size = s_worldComponents.size();
-	StartScene();
+	std::chrono::high_resolution_clock::time_point start =
+		std::chrono::high_resolution_clock::now();
+	s_stats.drawn = 0;
+	s_stats.culled = 0;
+	s_stats.matricesBuilt = 0;
+	s_stats.textGlyphs = 0;
+
+	/*The render thread never reads the back frame*/
+	s_pFrame = &s_renderThread.GetBackFrame();
+	s_pFrame->world.clear();
+	s_pFrame->hud.clear();
+	std::memcpy(s_pFrame->viewport, s_viewport, sizeof(s_viewport));
+	s_pFrame->background[0] = s_gfxState.bgRed;
+	s_pFrame->background[1] = s_gfxState.bgGreen;
+	s_pFrame->background[2] = s_gfxState.bgBlue;
+
+	/*Objects can move after their components update, so fix the grid before
+	culling.  Only the objects that moved are checked.*/
+	size_t size = s_moved.size();
+	for (size_t i = 0; i < size; ++i)
+	{
+		UpdateGridCell(s_moved[i]);
+		s_moved[i]->m_movedIndex = -1;
+	}
+	s_moved.clear();
 
+	size = s_worldComponents.size();
 	SetToPerspective();
-	for (size_t i = s_gfxState.worldStart; i < size; ++i)
-		s_worldComponents[i]->Draw();
+	DrawVisibleWorld();
+	s_stats.culled = static_cast<int>(size - s_gfxState.worldStart - s_visible.size());
 
 	SetToOrtho();
 	size = s_hudComponents.size();
 	for (size_t i = s_gfxState.hudStart; i < size; ++i)
 		s_hudComponents[i]->Draw();
 
-	EndScene();
+	/*Text goes on top of the HUD*/
+	const M5TextVertices& verts = s_text.GetVertices();
+	s_pFrame->text.assign(verts.begin(), verts.end());
+	s_stats.textGlyphs = static_cast<int>(verts.size()) / M5TextBatch::VERTS_PER_GLYPH;
+	s_text.EndFrame();
+
+	s_pList = 0;
+	s_pFrame = 0;
+	s_stats.drawTime = std::chrono::duration<float>(
+		std::chrono::high_resolution_clock::now() - start).count();
+
+	/*Textures unloaded this frame are safe to delete once the last frame is drawn*/
+	s_renderThread.Wait();
+	s_resourceManager.DeleteUnused();
+	s_stats.renderTime = s_renderThread.GetRenderTime();
+	s_renderThread.Submit();
+}
+/******************************************************************************/
+/*!
+Gets the number of objects drawn and world matrices rebuilt during the last
+frame, along with the time it took to build the frame and the time the render
+thread took to draw the frame before it.
+
+\param [out] stats
+The struct to fill.
+*/
+/******************************************************************************/
+void M5Gfx::GetStats(M5GfxStats& stats)
+{
+	stats = s_stats;
+}
+/******************************************************************************/
+/*!
+Writes the last frame to a TGA file.  This waits for the render thread to
+finish drawing it.
+
+\attention
+This only works with the software backend, use -software on the command line.
+
+\param [in] fileName
+The file to write.
+
+\return
+True if the file was written.
+*/
+/******************************************************************************/
+bool M5Gfx::SaveFrame(const char* fileName)
+{
+	M5DEBUG_ASSERT(s_isSoftware, "Only the software backend can save frames");
+	if (!s_isSoftware)
+		return false;
+
+	s_renderThread.Wait();
+	return s_softBackend.WriteImage(fileName);
+}
+/******************************************************************************/
+/*!
+Counts the pixels of the last frame that are different from a golden image
+saved by SaveFrame.  This waits for the render thread to finish drawing it.
+
+\attention
+This only works with the software backend, use -software on the command line.
+
+\param [in] fileName
+The golden image to compare against.
+
+\param [in] tolerance
+How much any channel of a pixel can be off before the pixel counts as
+different.
+
+\return
+The number of different pixels, or -1 if the file can't be read.
+*/
+/******************************************************************************/
+int M5Gfx::CompareFrame(const char* fileName, int tolerance)
+{
+	M5DEBUG_ASSERT(s_isSoftware, "Only the software backend can compare frames");
+	if (!s_isSoftware)
+		return -1;
+
+	s_renderThread.Wait();
+	return s_softBackend.CompareImage(fileName, tolerance);
+}
+/******************************************************************************/
+/*!
+Called by GfxComponent each time it has to rebuild its world matrix.
+*/
+/******************************************************************************/
+void M5Gfx::CountMatrixBuild(void)
+{
+	++s_stats.matricesBuilt;
+}
+/******************************************************************************/
+/*!
+Draws the world components that can be seen by the camera.  Only the grid
+cells that overlap the view are visited, so objects far off screen are never
+touched.  The view is padded by one cell, since an object in the grid can reach
+up to half a cell outside of its own cell.  The visible components are only
+sorted when they aren't the same ones as last frame.
+*/
+/******************************************************************************/
+void M5Gfx::DrawVisibleWorld(void)
+{
+	//The camera can be rotated, so use the box around the corners
+	float minX = std::min(std::min(s_worldTopLeft.x, s_worldTopRight.x), std::min(s_worldBotLeft.x, s_worldBotRight.x));
+	float maxX = std::max(std::max(s_worldTopLeft.x, s_worldTopRight.x), std::max(s_worldBotLeft.x, s_worldBotRight.x));
+	float minY = std::min(std::min(s_worldTopLeft.y, s_worldTopRight.y), std::min(s_worldBotLeft.y, s_worldBotRight.y));
+	float maxY = std::max(std::max(s_worldTopLeft.y, s_worldTopRight.y), std::max(s_worldBotLeft.y, s_worldBotRight.y));
+
+	int startX = ToCell(minX) - 1;
+	int endX   = ToCell(maxX) + 1;
+	int startY = ToCell(minY) - 1;
+	int endY   = ToCell(maxY) + 1;
+
+	s_visible.clear();
+	++s_cullFrame;
+	size_t stillVisible = 0;
+	//If the camera is far away, it is cheaper to walk the cells that exist
+	size_t viewCells = static_cast<size_t>(endX - startX + 1) * static_cast<size_t>(endY - startY + 1);
+	Grid::iterator cell = s_grid.begin();
+	Grid::iterator end = s_grid.end();
+	bool walkGrid = viewCells > s_grid.size();
+	int x = startX;
+	int y = startY;
+
+	for (;;)
+	{
+		Components* pList = 0;
+		if (walkGrid)
+		{
+			if (cell == end)
+				break;
+			pList = &cell->second;
+			++cell;
+		}
+		else
+		{
+			if (x > endX)
+				break;
+			Grid::iterator found = s_grid.find(MakeCellKey(x, y));
+			if (found != end)
+				pList = &found->second;
+			if (++y > endY)
+			{
+				y = startY;
+				++x;
+			}
+		}
+
+		if (pList == 0)
+			continue;
+
+		size_t size = pList->size();
+		for (size_t i = 0; i < size; ++i)
+		{
+			GfxComponent* pComp = (*pList)[i];
+			const M5Vec2& pos = pComp->m_pObj->pos;
+			float radius = CullRadius(pComp->m_pObj->scale);
+			if (pComp->m_layer >= s_gfxState.drawLayer &&
+				pos.x + radius >= minX && pos.x - radius <= maxX &&
+				pos.y + radius >= minY && pos.y - radius <= maxY)
+			{
+				stillVisible += pComp->m_visibleFrame == s_cullFrame - 1;
+				pComp->m_visibleFrame = s_cullFrame;
+				s_visible.push_back(pComp);
+			}
+		}
+	}
+
+	//Big objects are always tested
+	size_t size = s_largeComponents.size();
+	for (size_t i = 0; i < size; ++i)
+	{
+		GfxComponent* pComp = s_largeComponents[i];
+		if (pComp->m_layer < s_gfxState.drawLayer)
+			continue;
+		const M5Vec2& pos = pComp->m_pObj->pos;
+		float radius = CullRadius(pComp->m_pObj->scale);
+		if (pos.x + radius >= minX && pos.x - radius <= maxX &&
+			pos.y + radius >= minY && pos.y - radius <= maxY)
+		{
+			stillVisible += pComp->m_visibleFrame == s_cullFrame - 1;
+			pComp->m_visibleFrame = s_cullFrame;
+			s_visible.push_back(pComp);
+		}
+	}
+
+	//The grid doesn't keep an order, so draw oldest first like before.  If
+	//everything drawn last frame is visible again and nothing else is, last
+	//frame's order is still right.
+	size = s_visible.size();
+	if (stillVisible != size || s_drawOrder.size() != size)
+	{
+		s_drawOrder.assign(s_visible.begin(), s_visible.end());
+		std::sort(s_drawOrder.begin(), s_drawOrder.end(), DrawOrder);
+	}
+	for (size_t i = 0; i < size; ++i)
+		s_drawOrder[i]->Draw();
+}
+/******************************************************************************/
+/*!
+Gets the grid cell a world component belongs in.  Components without an object
+yet, and components too big to be found by padding the view with one cell, go
+in the large list instead.
+
+\param [in] pGfxComp
+The component to check.
+
+\param [out] cell
+The key of the cell.  This is 0 for large components.
+
+\return
+True if the component goes in the large list, false if it goes in the grid.
+*/
+/******************************************************************************/
+bool M5Gfx::GetGridCell(const GfxComponent* pGfxComp, unsigned long long& cell)
+{
+	const M5Object* pObj = pGfxComp->m_pObj;
+	cell = 0;
+	if (pObj == 0)
+		return true;
+
+	//Same as CullRadius(scale) > CELL_SIZE * .5f without the square root
+	const M5Vec2& scale = pObj->scale;
+	if (scale.x * scale.x + scale.y * scale.y > CELL_SIZE * CELL_SIZE)
+		return true;
+
+	cell = MakeCellKey(ToCell(pObj->pos.x), ToCell(pObj->pos.y));
+	return false;
+}
+/******************************************************************************/
+/*!
+Adds a world component to the culling grid.
+
+\param [in] pGfxComp
+The component to add.
+*/
+/******************************************************************************/
+void M5Gfx::AddToGrid(GfxComponent* pGfxComp)
+{
+	pGfxComp->m_isLarge = GetGridCell(pGfxComp, pGfxComp->m_cell);
+	Components& list = GetCellList(pGfxComp->m_isLarge, pGfxComp->m_cell);
+	pGfxComp->m_cellIndex = static_cast<int>(list.size());
+	list.push_back(pGfxComp);
+}
+/******************************************************************************/
+/*!
+Removes a world component from the culling grid, by swapping it with the last
+component in its cell.
+
+\param [in] pGfxComp
+The component to remove.
+*/
+/******************************************************************************/
+void M5Gfx::RemoveFromGrid(GfxComponent* pGfxComp)
+{
+	if (pGfxComp->m_cellIndex < 0)
+		return;
+
+	Components& list = GetCellList(pGfxComp->m_isLarge, pGfxComp->m_cell);
+	GfxComponent* pLast = list.back();
+	list[pGfxComp->m_cellIndex] = pLast;
+	pLast->m_cellIndex = pGfxComp->m_cellIndex;
+	list.pop_back();
+	pGfxComp->m_cellIndex = -1;
+}
+/******************************************************************************/
+/*!
+Moves a world component to a new cell if its object moved or changed size.
+This is called by M5Gfx::Update before culling, for the components in the
+moved list.
+
+\param [in] pGfxComp
+The component to update.
+*/
+/******************************************************************************/
+void M5Gfx::UpdateGridCell(GfxComponent* pGfxComp)
+{
+	if (pGfxComp->m_cellIndex < 0)
+		return;
+
+	unsigned long long cell;
+	bool isLarge = GetGridCell(pGfxComp, cell);
+	if (isLarge == pGfxComp->m_isLarge && cell == pGfxComp->m_cell)
+		return;
+
+	RemoveFromGrid(pGfxComp);
+	AddToGrid(pGfxComp);
+}
+/******************************************************************************/
+/*!
+Adds a world component to the list that is put in the right grid cell before
+the next cull.  Components already in the list are not added again.
+
+\param [in] pGfxComp
+The component to add.
+*/
+/******************************************************************************/
+void M5Gfx::AddToMoved(GfxComponent* pGfxComp)
+{
+	if (pGfxComp->m_movedIndex >= 0)
+		return;
+
+	pGfxComp->m_movedIndex = static_cast<int>(s_moved.size());
+	s_moved.push_back(pGfxComp);
+}
+/******************************************************************************/
+/*!
+Removes a world component from the moved list, by swapping it with the last
+component in the list.
+
+\param [in] pGfxComp
+The component to remove.
+*/
+/******************************************************************************/
+void M5Gfx::RemoveFromMoved(GfxComponent* pGfxComp)
+{
+	if (pGfxComp->m_movedIndex < 0)
+		return;
+
+	GfxComponent* pLast = s_moved.back();
+	s_moved[pGfxComp->m_movedIndex] = pLast;
+	pLast->m_movedIndex = pGfxComp->m_movedIndex;
+	s_moved.pop_back();
+	pGfxComp->m_movedIndex = -1;
+}
+/******************************************************************************/
+/*!
+Tells graphics that an object moved or changed size, so its GfxComponent is
+put in the right grid cell before the next cull.  The object manager does
+this for every object with a velocity.  Anything that moves or resizes an
+object some other way, after the frame it was made, must call this.
+
+\param [in] pObj
+The object that moved.
+*/
+/******************************************************************************/
+void M5Gfx::MarkMoved(M5Object* pObj)
+{
+	GfxComponent* pGfxComp;
+	pObj->GetComponent(CT_GfxComponent, pGfxComp);
+	if (pGfxComp != 0 && pGfxComp->m_drawIndex >= 0 && !pGfxComp->m_isInHud)
+		AddToMoved(pGfxComp);
 }
 /******************************************************************************/
 /*!
@@ -1042,6 +1398,7 @@ void M5Gfx::Pause(bool drawPaused /*= false*/)
 	{
 		s_gfxState.worldStart = s_worldComponents.size();
 		s_gfxState.hudStart = s_hudComponents.size();
+		s_gfxState.drawLayer = static_cast<int>(s_pauseStack.size());
 	}
 }
 /******************************************************************************/
@@ -19,8 +19,20 @@ Singleton class to draw and modify the view of the screen
 //Forward declarations
 struct M5Vec2;
 struct M5Mtx44;
+struct M5TextureStats;
 class  GfxComponent;
+class  M5Object;
 
+//! Counts from the last call to M5Gfx::Update
+struct M5GfxStats
+{
+	int   drawn;         //!< Number of GfxComponents drawn
+	int   culled;        //!< Number of world GfxComponents skipped because they were off screen
+	int   matricesBuilt; //!< Number of world matrices that had to be rebuilt
+	int   textGlyphs;    //!< Number of characters drawn by WriteText
+	float drawTime;      //!< Seconds spent building the frame for the render thread
+	float renderTime;    //!< Seconds the render thread spent drawing the frame before
+};
 
 //! Singleton class to draw and modify the view of the screen
 class M5Gfx
@@ -28,6 +40,8 @@ class M5Gfx
 public:
 	friend class M5App;
 	friend class M5StageManager;
+	friend class GfxComponent;
+	friend class M5Benchmark;
 
 	/*Use this to load a texture from file*/
 	static int LoadTexture(const char* fileName);
@@ -35,13 +49,19 @@ public:
 	static void UpdateTextureCount(int textureID);
 	/*You must unload every texture that you load*/
 	static void UnloadTexture(int textureID);
+	/*Reads a texture from disk so a later LoadTexture is fast. Safe to call from a loading thread*/
+	static void PrefetchTexture(const char* fileName);
+	/*Sets how many bytes of textures to keep before unused ones are deleted*/
+	static void SetTextureBudget(long long bytes);
+	/*Gets the texture memory in use and the cache hits, misses and evictions*/
+	static void GetTextureStats(M5TextureStats& stats);
 	/*Sets the position of the camera in perspective mode.  There is no camera in ortho mode.*/
 	static void SetCamera(float cameraX = 0, float cameraY = 0, float cameraZ = 0, float cameraRot = 0);
 	/*Changes the background color*/
 	static void SetBackgroundColor(float red = 0, float green = 0, float blue = 0);
-	/*Draws the selected texture based on the matrix*/
+	/*Adds the selected texture based on the matrix to this frame*/
 	static void Draw(const M5Mtx44& worldMatrix);
-	/*Writes text on the screen*/
+	/*Writes text on the screen.  All text is drawn at the end of the frame*/
 	static void WriteText(const char* text, float x, float y);
 	/*Use this to select the texture that you want to draw*/
 	static void SetTexture(int textureID);
@@ -68,24 +88,33 @@ public:
 	static void RegisterWorldComponent(GfxComponent* pGfxComp);
 	static void RegisterHudComponent(GfxComponent* pGfxComp);
 	static void UnregisterComponent(GfxComponent* pGfxComp);
+	/*Tells graphics an object moved or changed size without velocity, so it is culled in the right place*/
+	static void MarkMoved(M5Object* pObj);
+	/*Gets the draw counts from the last frame*/
+	static void GetStats(M5GfxStats& stats);
+	/*Writes the last frame to a TGA file.  Only works with the software backend*/
+	static bool SaveFrame(const char* fileName);
+	/*Counts the pixels of the last frame that differ from a saved frame.  Only works with the software backend*/
+	static int CompareFrame(const char* fileName, int tolerance);
 private:
 	//Private functions
-	/*This should be called once before drawing all objects*/
-	static void StartScene(void);
-	/*This should be called once after drawing all objects*/
-	static void EndScene(void);
 	static void Update(void);
 	static void Pause(bool drawPaused = false);
 	static void Resume(void);
 	static void SetResolution(int width, int height);
 	static void CalulateWorldExtents(void);
-	static void FontInit(void);
-	static void VertexBufferInit(void);
-	static void Init(HWND window, int width, int height);
+	static void Init(HWND window, int width, int height, bool headless, bool software);
 	static void Shutdown(void);
-	static void RenderContextInit(void);
+	static void ClearPrefetchedTextures(void);
+	static void CountMatrixBuild(void);
+	static void DrawVisibleWorld(void);
+	static void AddToGrid(GfxComponent* pGfxComp);
+	static void RemoveFromGrid(GfxComponent* pGfxComp);
+	static void UpdateGridCell(GfxComponent* pGfxComp);
+	static void AddToMoved(GfxComponent* pGfxComp);
+	static void RemoveFromMoved(GfxComponent* pGfxComp);
+	static bool GetGridCell(const GfxComponent* pGfxComp, unsigned long long& cell);
 
-	//Possibly depricated functions
 	/*Use this to draw game objects.  Z order and distance from the camera effects the size*/
 	static void SetToPerspective(void);
 	/*Use this to draw HUD objects. Distance from the camara doesn't  effect the object*/
@@ -0,0 +1,60 @@
+/******************************************************************************/
+/*!
+\file   M5Hash.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+FNV-1a string hash that gives the same value at compile time and run time, so
+the generated StringTo functions can switch on the hash of a name.
+
+*/
+/******************************************************************************/
+#ifndef M5_HASH_H
+#define M5_HASH_H
+
+const unsigned M5_HASH_SEED  = 2166136261u; //!< FNV-1a offset basis
+const unsigned M5_HASH_PRIME = 16777619u;   //!< FNV-1a prime
+
+/******************************************************************************/
+/*!
+Hashes a string at compile time so it can be used as a case label.  This is
+recursive because VS2015 constexpr functions can only have a return statement.
+
+\param [in] str
+The string to hash.
+
+\param [in] hash
+The hash of the characters before str.
+
+\return
+The same value M5Hash returns for the string.
+*/
+/******************************************************************************/
+constexpr unsigned M5HashLiteral(const char* str, unsigned hash = M5_HASH_SEED)
+{
+	return (*str == 0) ? hash :
+		M5HashLiteral(str + 1, (hash ^ static_cast<unsigned char>(*str)) * M5_HASH_PRIME);
+}
+/******************************************************************************/
+/*!
+Hashes a string at run time.
+
+\param [in] str
+The string to hash.
+
+\return
+The same value M5HashLiteral returns for the string.
+*/
+/******************************************************************************/
+inline unsigned M5Hash(const char* str)
+{
+	unsigned hash = M5_HASH_SEED;
+	for (; *str != 0; ++str)
+		hash = (hash ^ static_cast<unsigned char>(*str)) * M5_HASH_PRIME;
+	return hash;
+}
+
+
+#endif //M5_HASH_H
@@ -0,0 +1,213 @@
+/******************************************************************************/
+/*!
+\file   M5Histogram.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Class to count values into log spaced buckets so percentiles can be found
+without saving every value.
+
+*/
+/******************************************************************************/
+#include "M5Histogram.h"
+
+#include <climits>
+#include <cstring>
+
+/******************************************************************************/
+/*!
+Starts with no values.
+*/
+/******************************************************************************/
+M5Histogram::M5Histogram(void)
+{
+	Reset();
+}
+/******************************************************************************/
+/*!
+Counts a value.
+
+\param [in] value
+The value to count.
+*/
+/******************************************************************************/
+void M5Histogram::Record(unsigned value)
+{
+	++m_buckets[GetBucket(value)];
+	++m_count;
+	m_sum += value;
+	if (value < m_min)
+		m_min = value;
+	if (value > m_max)
+		m_max = value;
+}
+/******************************************************************************/
+/*!
+Adds all the values counted by another histogram, so short histograms can be
+combined into a longer one.
+
+\param [in] other
+The histogram to add.
+*/
+/******************************************************************************/
+void M5Histogram::Add(const M5Histogram& other)
+{
+	for (int i = 0; i < HISTOGRAM_BUCKETS; ++i)
+		m_buckets[i] += other.m_buckets[i];
+
+	m_count += other.m_count;
+	m_sum += other.m_sum;
+	if (other.m_min < m_min)
+		m_min = other.m_min;
+	if (other.m_max > m_max)
+		m_max = other.m_max;
+}
+/******************************************************************************/
+/*!
+Removes all values.
+*/
+/******************************************************************************/
+void M5Histogram::Reset(void)
+{
+	std::memset(m_buckets, 0, sizeof(m_buckets));
+	m_count = 0;
+	m_sum = 0;
+	m_min = UINT_MAX;
+	m_max = 0;
+}
+/******************************************************************************/
+/*!
+Gets the number of values counted.
+
+\return
+The number of values.
+*/
+/******************************************************************************/
+long long M5Histogram::GetCount(void) const
+{
+	return m_count;
+}
+/******************************************************************************/
+/*!
+Gets the smallest value counted.
+
+\return
+The smallest value, or 0 if nothing was counted.
+*/
+/******************************************************************************/
+unsigned M5Histogram::GetMin(void) const
+{
+	return (m_count == 0) ? 0 : m_min;
+}
+/******************************************************************************/
+/*!
+Gets the largest value counted.
+
+\return
+The largest value, or 0 if nothing was counted.
+*/
+/******************************************************************************/
+unsigned M5Histogram::GetMax(void) const
+{
+	return m_max;
+}
+/******************************************************************************/
+/*!
+Gets the average of the values counted.
+
+\return
+The average, or 0 if nothing was counted.
+*/
+/******************************************************************************/
+double M5Histogram::GetMean(void) const
+{
+	return (m_count == 0) ? 0 : m_sum / m_count;
+}
+/******************************************************************************/
+/*!
+Gets the value that percent of the values are at or below.  The answer is the
+top of the bucket the value is in, so it is never lower than the real value
+and never more than about 3% higher.
+
+\param [in] percent
+The percent of values, from 0 to 100.  For example 99.9 for the p99.9.
+
+\return
+The value at the percentile, or 0 if nothing was counted.
+*/
+/******************************************************************************/
+unsigned M5Histogram::GetPercentile(double percent) const
+{
+	if (m_count == 0)
+		return 0;
+
+	/*The number of values that must be at or below the answer*/
+	long long target = static_cast<long long>(percent / 100.0 * m_count + 0.5);
+	if (target < 1)
+		target = 1;
+
+	long long seen = 0;
+	for (int i = 0; i < HISTOGRAM_BUCKETS; ++i)
+	{
+		seen += m_buckets[i];
+		if (seen >= target)
+		{
+			/*The top of the bucket can be past anything that was counted*/
+			unsigned value = GetBucketMax(i);
+			return (value < m_max) ? value : m_max;
+		}
+	}
+	return m_max;
+}
+/******************************************************************************/
+/*!
+Gets the bucket a value is counted in.  Values below 64 are their own bucket.
+Bigger values are split by their highest bit, then by the next
+HISTOGRAM_SUB_BITS bits.
+
+\param [in] value
+The value to find the bucket of.
+
+\return
+The index of the bucket.
+*/
+/******************************************************************************/
+int M5Histogram::GetBucket(unsigned value)
+{
+	/*Find the highest set bit without a loop*/
+	int highBit = 0;
+	unsigned bits = value;
+	if (bits >= 1u << 16) { bits >>= 16; highBit += 16; }
+	if (bits >= 1u << 8)  { bits >>= 8;  highBit += 8; }
+	if (bits >= 1u << 4)  { bits >>= 4;  highBit += 4; }
+	if (bits >= 1u << 2)  { bits >>= 2;  highBit += 2; }
+	if (bits >= 1u << 1)  { highBit += 1; }
+
+	int shift = highBit - HISTOGRAM_SUB_BITS;
+	if (shift < 0)
+		shift = 0;
+
+	return shift * HISTOGRAM_SUB_COUNT + static_cast<int>(value >> shift);
+}
+/******************************************************************************/
+/*!
+Gets the largest value that is counted in a bucket.
+
+\param [in] bucket
+The index of the bucket.
+
+\return
+The largest value in the bucket.
+*/
+/******************************************************************************/
+unsigned M5Histogram::GetBucketMax(int bucket)
+{
+	if (bucket < 2 * HISTOGRAM_SUB_COUNT)
+		return static_cast<unsigned>(bucket);
+
+	int shift = bucket / HISTOGRAM_SUB_COUNT - 1;
+	unsigned sub = static_cast<unsigned>(bucket - shift * HISTOGRAM_SUB_COUNT);
+	return (sub << shift) + ((1u << shift) - 1);
+}
@@ -0,0 +1,58 @@
+/******************************************************************************/
+/*!
+\file   M5Histogram.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Class to count values into log spaced buckets so percentiles can be found
+without saving every value.
+
+*/
+/******************************************************************************/
+#ifndef M5_HISTOGRAM_H
+#define M5_HISTOGRAM_H
+
+const int HISTOGRAM_SUB_BITS = 5;                                   //!< Each power of two is split into 2^this buckets
+const int HISTOGRAM_SUB_COUNT = 1 << HISTOGRAM_SUB_BITS;            //!< Buckets for each power of two
+const int HISTOGRAM_BUCKETS = (33 - HISTOGRAM_SUB_BITS) * HISTOGRAM_SUB_COUNT; //!< Enough for any 32 bit value
+
+/*! Counts unsigned values, like frame times in microseconds, into buckets that
+get wider as the values get bigger.  Values below 64 get their own bucket and
+every bucket after that is within about 3% of the values in it, so a whole
+session can be kept in a few kilobytes and recording a value is a few
+instructions.*/
+class M5Histogram
+{
+public:
+	M5Histogram(void);
+	//Counts a value
+	void Record(unsigned value);
+	//Adds all the values counted by another histogram
+	void Add(const M5Histogram& other);
+	//Removes all values
+	void Reset(void);
+	//Gets the number of values counted
+	long long GetCount(void) const;
+	//Gets the smallest value counted
+	unsigned GetMin(void) const;
+	//Gets the largest value counted
+	unsigned GetMax(void) const;
+	//Gets the average of the values counted
+	double GetMean(void) const;
+	//Gets the value that percent of the values are at or below
+	unsigned GetPercentile(double percent) const;
+private:
+	static int GetBucket(unsigned value);
+	static unsigned GetBucketMax(int bucket);
+
+	long long m_buckets[HISTOGRAM_BUCKETS]; //!< The number of values in each bucket
+	long long m_count;                      //!< The number of values counted
+	double    m_sum;                        //!< The sum of the values, for the mean
+	unsigned  m_min;                        //!< The smallest value counted
+	unsigned  m_max;                        //!< The largest value counted
+};
+
+
+#endif //M5_HISTOGRAM_H
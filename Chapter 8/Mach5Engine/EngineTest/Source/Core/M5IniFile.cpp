@@ -73,6 +73,22 @@ void M5IniFile::ReadFile(const std::string& fileName)
 }
 /******************************************************************************/
 /*!
+Checks if the current section has a key, so optional keys can be read
+without GetValue asserting.
+
+\param [in] key
+The key to look for.
+
+\return
+True if the key is in the current section.
+*/
+/******************************************************************************/
+bool M5IniFile::HasKey(const std::string& key) const
+{
+	return m_currSection->find(key) != m_currSection->end();
+}
+/******************************************************************************/
+/*!
 Sets the active search section to the specified sectionName of the ini file.
 
 \param [in] sectionName
@@ -13,6 +13,7 @@ Class to read from or write to an ini file
 #define M5INI_FILE_H
 
 #include "M5Debug.h"
+#include "M5Memory.h"
 
 #include <map>
 #include <string>
@@ -27,6 +28,8 @@ public:
 	//Function to get the data from a section
 	template<typename T>
 	void GetValue(const std::string& key, T& value) const;
+	//Checks if the current section has a key
+	bool HasKey(const std::string& key) const;
 	void SetToSection(const std::string& sectionName);
 	void AddSection(const std::string& sectionName);
 	template<typename T>
@@ -37,7 +40,8 @@ private:
 	//! String pair used for reading key/values
 	typedef std::pair<std::string, std::string>        StringPair;
 	//! Map of keys to values
-	typedef std::map<std::string, std::string>         KeyValMap;
+	typedef std::map<std::string, std::string, std::less<std::string>,
+		M5Allocator<std::pair<const std::string, std::string>, MT_INI> > KeyValMap;
 	//! Iterator for key/value map
 	typedef KeyValMap::iterator                        KeyValMapItor;
 	//! Const interator for key/value map
@@ -45,7 +49,8 @@ private:
 	//! Pair for sections
 	typedef std::pair<std::string, KeyValMap>          StringMapPair;
 	//! Map of names to sections
-	typedef std::map<std::string, KeyValMap>           SectionMap;
+	typedef std::map<std::string, KeyValMap, std::less<std::string>,
+		M5Allocator<std::pair<const std::string, KeyValMap>, MT_INI> > SectionMap;
 	//! Iterator for name/section map
 	typedef SectionMap::iterator                       SectionMapItor;
 	//! Const Interator for name/section map
@@ -14,6 +14,7 @@ Singleton class to control get and set input.
 #include "M5Input.h"
 #include "M5Vec2.h"
 #include "M5Debug.h"
+#include "M5Replay.h"
 
 #include <cmath>    /*sqrt*/
 #include <climits>  /*max short*/
@@ -59,6 +60,8 @@ void M5Input::SetPressed(M5KeyCode key, int status)
   if (key < M5_INVALID || key >= M5_LAST)
     return;
 
+  M5Replay::RecordKey(key, status);
+
   if (status)/*If the key is pressed*/
   {
     if (s_pressed[key])/*if the key was already pressed*/
@@ -127,6 +130,10 @@ void M5Input::Reset(float dt)
     s_repeating[i] = false;
   }
 
+  /*The gamepad isn't polled while replaying, the log has its buttons*/
+  if (M5Replay::IsReplaying())
+    return;
+
   if (s_isGamePadConnected)
   {
     /*Do my Gamepad input*/
@@ -254,6 +261,7 @@ Use this to set x and y coordinates of the mouse.
 /******************************************************************************/
 void M5Input::SetMouse(int x, int y)
 {
+  M5Replay::RecordMouse(x, y);
   s_mouse.Set(static_cast<float>(x), static_cast<float>(y));
 }
 /******************************************************************************/
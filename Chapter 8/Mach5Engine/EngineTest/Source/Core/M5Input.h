@@ -114,6 +114,7 @@ class M5Input
 public:
   friend class M5App;
   friend class M5StageManager;
+  friend class M5Replay;
 
   /*Check if a specific key is being held down*/
   static bool  IsPressed(M5KeyCode key);
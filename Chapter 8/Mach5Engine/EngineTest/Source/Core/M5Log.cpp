@@ -0,0 +1,538 @@
+/******************************************************************************/
+/*!
+\file   M5Log.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/25
+
+Singleton class to log messages without slowing down the game.
+
+Every thread that logs gets its own ring buffer of records.  A record only
+holds the format pointer and the argument values, so writing one is a few
+stores with no locks.  A background thread reads the rings, does the slow
+printf work and writes to the file and console.
+
+*/
+/******************************************************************************/
+#include "M5Log.h"
+#include "M5Debug.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const unsigned RING_SIZE = 1024;           //!< Records per thread, must be a power of 2
+const unsigned RING_MASK = RING_SIZE - 1;  //!< Turns a count into an index
+const int      CACHE_LINE = 64;            //!< Keeps head and tail from sharing a line
+const int      SLEEP_MS = 2;               //!< How long the log thread waits when there is nothing to do
+const int      PIECE_SIZE = 256;           //!< Largest single formatted argument
+const int      SPEC_SIZE = 32;             //!< Largest single format spec
+
+static_assert((RING_SIZE & RING_MASK) == 0, "RING_SIZE must be a power of 2");
+
+//! One producer, one consumer ring of records
+struct M5LogRing
+{
+	std::atomic<unsigned> head; //!< Next record to write, only the owner thread changes this
+	char pad1[CACHE_LINE - sizeof(std::atomic<unsigned>)]; //!< Unused
+	std::atomic<unsigned> tail; //!< Next record to read, only the log thread changes this
+	char pad2[CACHE_LINE - sizeof(std::atomic<unsigned>)]; //!< Unused
+	M5LogRecord records[RING_SIZE]; //!< The records
+};
+
+const char* LEVEL_NAMES[] =
+{
+	"DEBUG",
+	"INFO",
+	"WARNING",
+	"ERROR"
+};
+
+const char* CATEGORY_NAMES[LC_COUNT] =
+{
+	"General",
+	"App",
+	"Gfx",
+	"Physics",
+	"Objects",
+	"Stage",
+	"Input",
+	"Game",
+	"Net"
+};
+
+typedef std::chrono::steady_clock LogClock;
+
+thread_local M5LogRing*  s_pRing = 0;     //!< The ring of the calling thread
+std::vector<M5LogRing*>  s_rings;         //!< Every ring, so the log thread can read them
+std::mutex               s_ringLock;      //!< Guards s_rings
+std::thread              s_thread;        //!< Formats and writes records
+std::atomic<bool>        s_isRunning;     //!< False before Init and after Shutdown
+std::atomic<int>         s_level;         //!< Messages below this are ignored
+std::atomic<unsigned>    s_categoryMask;  //!< One bit for each category that is on
+std::atomic<bool>        s_toConsole;     //!< True if messages are also printed
+std::atomic<int>         s_dropCount;     //!< Messages lost to full rings
+FILE*                    s_pFile = 0;     //!< The log file
+LogClock::time_point     s_startTime;     //!< Times are printed from here
+
+/******************************************************************************/
+/*!
+Gets an argument as a signed integer.
+
+\param [in] arg
+The argument to convert.
+
+\return
+The value of the argument.
+*/
+/******************************************************************************/
+long long ToInteger(const M5LogArg& arg)
+{
+	switch (arg.type)
+	{
+	case LA_INT:     return arg.value.i;
+	case LA_UINT:    return static_cast<long long>(arg.value.u);
+	case LA_DOUBLE:  return static_cast<long long>(arg.value.d);
+	case LA_POINTER: return reinterpret_cast<long long>(arg.value.p);
+	default:         return 0;
+	}
+}
+/******************************************************************************/
+/*!
+Gets an argument as a double.
+
+\param [in] arg
+The argument to convert.
+
+\return
+The value of the argument.
+*/
+/******************************************************************************/
+double ToDouble(const M5LogArg& arg)
+{
+	switch (arg.type)
+	{
+	case LA_INT:    return static_cast<double>(arg.value.i);
+	case LA_UINT:   return static_cast<double>(arg.value.u);
+	case LA_DOUBLE: return arg.value.d;
+	default:        return 0.0;
+	}
+}
+/******************************************************************************/
+/*!
+Does the printf work for one record.  Length modifiers in the format are
+skipped and replaced with the size the argument was saved as, so the game code
+doesn't need to get them right.
+
+\param [in] record
+The record to format.
+
+\param [out] line
+The formatted message.
+*/
+/******************************************************************************/
+void FormatRecord(const M5LogRecord& record, std::string& line)
+{
+	char piece[PIECE_SIZE];
+	char spec[SPEC_SIZE];
+	int  argIndex = 0;
+	const char* pFormat = record.format;
+
+	while (*pFormat)
+	{
+		if (*pFormat != '%')
+		{
+			line += *pFormat++;
+			continue;
+		}
+		if (pFormat[1] == '%')
+		{
+			line += '%';
+			pFormat += 2;
+			continue;
+		}
+
+		/*Copy the flags, width and precision, leaving room for ll, the
+		conversion and the terminator*/
+		int specSize = 0;
+		spec[specSize++] = *pFormat++;
+		while (*pFormat && std::strchr("-+ #0123456789.", *pFormat) && specSize < SPEC_SIZE - 4)
+			spec[specSize++] = *pFormat++;
+		while (*pFormat && std::strchr("hlLjzt", *pFormat))
+			++pFormat;
+
+		char conversion = *pFormat;
+		if (conversion == 0)
+			break;
+		++pFormat;
+
+		if (argIndex >= record.argCount)
+		{
+			line += "(missing)";
+			continue;
+		}
+		const M5LogArg& arg = record.args[argIndex++];
+
+		piece[0] = 0;
+		switch (conversion)
+		{
+		case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+			spec[specSize++] = 'l';
+			spec[specSize++] = 'l';
+			spec[specSize++] = conversion;
+			spec[specSize] = 0;
+			std::snprintf(piece, PIECE_SIZE, spec, ToInteger(arg));
+			break;
+		case 'c':
+			spec[specSize++] = conversion;
+			spec[specSize] = 0;
+			std::snprintf(piece, PIECE_SIZE, spec, static_cast<int>(ToInteger(arg)));
+			break;
+		case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+			spec[specSize++] = conversion;
+			spec[specSize] = 0;
+			std::snprintf(piece, PIECE_SIZE, spec, ToDouble(arg));
+			break;
+		case 's':
+			spec[specSize++] = conversion;
+			spec[specSize] = 0;
+			if (arg.type != LA_STRING)
+				std::snprintf(piece, PIECE_SIZE, "(not a string)");
+			else
+				std::snprintf(piece, PIECE_SIZE, spec, arg.value.s < 0 ? "" : record.text + arg.value.s);
+			break;
+		case 'p':
+			spec[specSize++] = conversion;
+			spec[specSize] = 0;
+			std::snprintf(piece, PIECE_SIZE, spec, arg.type == LA_POINTER ? arg.value.p : 0);
+			break;
+		default:
+			std::snprintf(piece, PIECE_SIZE, "(bad format)");
+			break;
+		}
+		line += piece;
+	}
+}
+/******************************************************************************/
+/*!
+Formats and writes every record waiting in every ring.
+
+\return
+The number of records written.
+*/
+/******************************************************************************/
+int DrainRings(void)
+{
+	static std::string line;
+	char prefix[PIECE_SIZE];
+	int count = 0;
+	bool toConsole = s_toConsole.load(std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> lock(s_ringLock);
+	for (size_t i = 0; i < s_rings.size(); ++i)
+	{
+		M5LogRing* pRing = s_rings[i];
+		unsigned tail = pRing->tail.load(std::memory_order_relaxed);
+		unsigned head = pRing->head.load(std::memory_order_acquire);
+
+		for (; tail != head; ++tail)
+		{
+			const M5LogRecord& record = pRing->records[tail & RING_MASK];
+			std::snprintf(prefix, PIECE_SIZE, "[%10.4f][%s][%s] ",
+				record.time / 1000000000.0,
+				LEVEL_NAMES[record.level],
+				CATEGORY_NAMES[record.category]);
+
+			line = prefix;
+			FormatRecord(record, line);
+			line += '\n';
+
+			if (s_pFile)
+				std::fputs(line.c_str(), s_pFile);
+			if (toConsole)
+				std::fputs(line.c_str(), stdout);
+			++count;
+		}
+
+		/*Let the owner thread reuse the records*/
+		pRing->tail.store(tail, std::memory_order_release);
+	}
+
+	if (count != 0)
+	{
+		if (s_pFile)
+			std::fflush(s_pFile);
+		if (toConsole)
+			std::fflush(stdout);
+	}
+	return count;
+}
+/******************************************************************************/
+/*!
+The body of the log thread.  Keeps writing records until M5Log::Shutdown.
+*/
+/******************************************************************************/
+void LogThread(void)
+{
+	while (s_isRunning.load())
+	{
+		if (DrainRings() == 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(SLEEP_MS));
+	}
+}
+}//end unnamed namespace
+
+
+/******************************************************************************/
+/*!
+Sets the least important level that will be logged.
+
+\param [in] level
+Messages less important than this are ignored.
+*/
+/******************************************************************************/
+void M5Log::SetLevel(M5LogLevel level)
+{
+	s_level.store(level);
+}
+/******************************************************************************/
+/*!
+Turns logging for a category on or off.  All categories start on.
+
+\param [in] category
+The category to change.
+
+\param [in] isOn
+True to log messages in the category, false to ignore them.
+*/
+/******************************************************************************/
+void M5Log::SetCategory(M5LogCategory category, bool isOn)
+{
+	M5DEBUG_ASSERT(category >= 0 && category < LC_COUNT, "Invalid log category");
+	if (isOn)
+		s_categoryMask |= (1u << category);
+	else
+		s_categoryMask &= ~(1u << category);
+}
+/******************************************************************************/
+/*!
+Sets if messages are printed to the console as well as the log file.
+
+\param [in] isOn
+True to print to the console.
+*/
+/******************************************************************************/
+void M5Log::SetConsoleOutput(bool isOn)
+{
+	s_toConsole.store(isOn);
+}
+/******************************************************************************/
+/*!
+Gets the number of messages that were thrown away because the ring buffer of
+the logging thread was full.
+
+\return
+The number of lost messages.
+*/
+/******************************************************************************/
+int M5Log::GetDropCount(void)
+{
+	return s_dropCount.load();
+}
+/******************************************************************************/
+/*!
+Opens the log file and starts the log thread.  This is called by M5App::Init.
+
+\param [in] fileName
+The file to write messages to.
+*/
+/******************************************************************************/
+void M5Log::Init(const char* fileName)
+{
+	//Make sure this function is called only 1 time.
+	M5DEBUG_CALL_CHECK(1);
+
+	s_pFile = std::fopen(fileName, "w");
+	if (s_pFile == 0)
+		std::printf("M5Log: Couldn't open %s, only the console will be used\n", fileName);
+
+#ifdef _DEBUG
+	s_level = LL_DEBUG;
+	s_toConsole = true;
+#else
+	s_level = LL_INFO;
+	s_toConsole = (s_pFile == 0);
+#endif
+	s_categoryMask = (1u << LC_COUNT) - 1;
+	s_dropCount = 0;
+	s_startTime = LogClock::now();
+	s_isRunning = true;
+	s_thread = std::thread(LogThread);
+}
+/******************************************************************************/
+/*!
+Stops the log thread, writes any messages that are left and closes the log
+file.  This is called by M5App::Shutdown.
+
+\attention
+Any other threads that log must be finished before this is called.
+*/
+/******************************************************************************/
+void M5Log::Shutdown(void)
+{
+	if (!s_isRunning.load())
+		return;
+
+	s_isRunning = false;
+	s_thread.join();
+	DrainRings();
+
+	if (s_dropCount.load() != 0)
+		std::printf("M5Log: %d messages were dropped\n", s_dropCount.load());
+
+	if (s_pFile)
+	{
+		std::fclose(s_pFile);
+		s_pFile = 0;
+	}
+
+	for (size_t i = 0; i < s_rings.size(); ++i)
+		delete s_rings[i];
+	s_rings.clear();
+}
+/******************************************************************************/
+/*!
+Gets the next free record in the calling thread's ring.  The ring is made the
+first time a thread logs.
+
+\param [in] level
+How important the message is.
+
+\param [in] category
+What the message is about.
+
+\return
+The record to fill in, or 0 if the message should be ignored or the ring is
+full.
+*/
+/******************************************************************************/
+M5LogRecord* M5Log::BeginRecord(M5LogLevel level, M5LogCategory category)
+{
+	if (level < s_level.load(std::memory_order_relaxed) ||
+		(s_categoryMask.load(std::memory_order_relaxed) & (1u << category)) == 0 ||
+		!s_isRunning.load(std::memory_order_relaxed))
+		return 0;
+
+	if (s_pRing == 0)
+	{
+		s_pRing = new M5LogRing;
+		s_pRing->head = 0;
+		s_pRing->tail = 0;
+		std::lock_guard<std::mutex> lock(s_ringLock);
+		s_rings.push_back(s_pRing);
+	}
+
+	unsigned head = s_pRing->head.load(std::memory_order_relaxed);
+	unsigned tail = s_pRing->tail.load(std::memory_order_acquire);
+	if (head - tail == RING_SIZE)
+	{
+		++s_dropCount;
+		return 0;
+	}
+
+	M5LogRecord* pRecord = &s_pRing->records[head & RING_MASK];
+	pRecord->time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		LogClock::now() - s_startTime).count();
+	pRecord->level = level;
+	pRecord->category = category;
+	pRecord->argCount = 0;
+	pRecord->textSize = 0;
+	return pRecord;
+}
+/******************************************************************************/
+/*!
+Lets the log thread see the record from BeginRecord.
+*/
+/******************************************************************************/
+void M5Log::EndRecord(void)
+{
+	unsigned head = s_pRing->head.load(std::memory_order_relaxed);
+	s_pRing->head.store(head + 1, std::memory_order_release);
+}
+/******************************************************************************/
+/*!
+Copies a string argument into the record.  Long strings are cut short.
+
+\param [in, out] record
+The record the argument is in.
+
+\param [out] arg
+The argument to set.
+
+\param [in] value
+The string to copy.
+*/
+/******************************************************************************/
+void M5Log::SetArg(M5LogRecord& record, M5LogArg& arg, const char* value)
+{
+	arg.type = LA_STRING;
+
+	int space = LOG_TEXT_SIZE - record.textSize;
+	if (space <= 1 || value == 0)
+	{
+		arg.value.s = -1;
+		return;
+	}
+
+	int length = 0;
+	while (value[length] && length < space - 1)
+		++length;
+
+	std::memcpy(record.text + record.textSize, value, length);
+	record.text[record.textSize + length] = 0;
+	arg.value.s = record.textSize;
+	record.textSize += length + 1;
+}
+/******************************************************************************/
+/*!
+Copies a string argument into the record.  Long strings are cut short.
+
+\param [in, out] record
+The record the argument is in.
+
+\param [out] arg
+The argument to set.
+
+\param [in] value
+The string to copy.
+*/
+/******************************************************************************/
+void M5Log::SetArg(M5LogRecord& record, M5LogArg& arg, char* value)
+{
+	SetArg(record, arg, static_cast<const char*>(value));
+}
+/******************************************************************************/
+/*!
+Copies a string argument into the record.  Long strings are cut short.
+
+\param [in, out] record
+The record the argument is in.
+
+\param [out] arg
+The argument to set.
+
+\param [in] value
+The string to copy.
+*/
+/******************************************************************************/
+void M5Log::SetArg(M5LogRecord& record, M5LogArg& arg, const std::string& value)
+{
+	SetArg(record, arg, value.c_str());
+}
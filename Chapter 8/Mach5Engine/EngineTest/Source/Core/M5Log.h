@@ -0,0 +1,282 @@
+/******************************************************************************/
+/*!
+\file   M5Log.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/25
+
+Singleton class to log messages without slowing down the game.
+
+*/
+/******************************************************************************/
+#ifndef M5_LOG_H
+#define M5_LOG_H
+
+#include <string>
+#include <type_traits>
+
+//! How important a log message is
+enum M5LogLevel
+{
+	LL_DEBUG,   //!< Details only needed while debugging
+	LL_INFO,    //!< Normal events
+	LL_WARNING, //!< Something unexpected that the game can handle
+	LL_ERROR    //!< Something that is broken
+};
+
+//! The part of the engine or game a log message is about
+enum M5LogCategory
+{
+	LC_GENERAL, //!< Anything else
+	LC_APP,     //!< Window and application
+	LC_GFX,     //!< Graphics and resources
+	LC_PHYSICS, //!< Colliders and collisions
+	LC_OBJECTS, //!< Objects and components
+	LC_STAGE,   //!< Stages and loading
+	LC_INPUT,   //!< Input and replays
+	LC_GAME,    //!< Game code
+	LC_NET,     //!< Replication and sockets
+	LC_COUNT    //!< The number of categories, not a real category
+};
+
+//! The type of value saved for a log argument
+enum M5LogArgType
+{
+	LA_INT,    //!< Any signed integer or enum
+	LA_UINT,   //!< Any unsigned integer
+	LA_DOUBLE, //!< Any floating point number
+	LA_STRING, //!< A string copied into the record
+	LA_POINTER //!< Any other pointer
+};
+
+//! One argument of a log message, saved as a value instead of text
+struct M5LogArg
+{
+	M5LogArgType type; //!< Which member of value is used
+	union
+	{
+		long long          i; //!< LA_INT
+		unsigned long long u; //!< LA_UINT
+		double             d; //!< LA_DOUBLE
+		const void*        p; //!< LA_POINTER
+		int                s; //!< LA_STRING, offset into the record's text
+	} value;                  //!< The saved value
+};
+
+const int LOG_MAX_ARGS = 6;  //!< The most arguments a log message can have
+const int LOG_TEXT_SIZE = 64; //!< Room in a record for copied strings
+
+//! Picks the SetValue overload for an argument type
+template <M5LogArgType Type>
+struct M5LogArgKind {};
+
+//! A log message before it is formatted
+struct M5LogRecord
+{
+	const char*   format;              //!< printf style format, must be a string literal
+	long long     time;                //!< When the message was logged
+	M5LogLevel    level;               //!< How important the message is
+	M5LogCategory category;            //!< What the message is about
+	int           argCount;            //!< The number of args used
+	int           textSize;            //!< The number of bytes of text used
+	M5LogArg      args[LOG_MAX_ARGS];  //!< The arguments of the format
+	char          text[LOG_TEXT_SIZE]; //!< Copies of string arguments
+};
+
+//! Singleton class to log messages without slowing down the game.
+class M5Log
+{
+public:
+	friend class M5App;
+
+	//Logs a printf style message.  The format must be a string literal
+	template <typename... Args>
+	static void Write(M5LogLevel level, M5LogCategory category, const char* format, const Args&... args);
+	//Messages less important than this are ignored
+	static void SetLevel(M5LogLevel level);
+	//Turns a category on or off
+	static void SetCategory(M5LogCategory category, bool isOn);
+	//Also print messages to the console
+	static void SetConsoleOutput(bool isOn);
+	//Gets the number of messages thrown away because a buffer was full
+	static int  GetDropCount(void);
+private:
+	static void Init(const char* fileName);
+	static void Shutdown(void);
+	static M5LogRecord* BeginRecord(M5LogLevel level, M5LogCategory category);
+	static void EndRecord(void);
+
+	static void Pack(M5LogRecord&) {}
+	template <typename T, typename... Rest>
+	static void Pack(M5LogRecord& record, const T& first, const Rest&... rest);
+
+	static void SetArg(M5LogRecord& record, M5LogArg& arg, const char* value);
+	static void SetArg(M5LogRecord& record, M5LogArg& arg, char* value);
+	static void SetArg(M5LogRecord& record, M5LogArg& arg, const std::string& value);
+	template <typename T>
+	static void SetArg(M5LogRecord& record, M5LogArg& arg, const T& value);
+	template <typename T>
+	static void SetValue(M5LogArg& arg, const T& value, M5LogArgKind<LA_INT>);
+	template <typename T>
+	static void SetValue(M5LogArg& arg, const T& value, M5LogArgKind<LA_UINT>);
+	template <typename T>
+	static void SetValue(M5LogArg& arg, const T& value, M5LogArgKind<LA_DOUBLE>);
+	template <typename T>
+	static void SetValue(M5LogArg& arg, const T& value, M5LogArgKind<LA_POINTER>);
+};//end M5Log
+
+/******************************************************************************/
+/*!
+Logs a printf style message.  The arguments are copied into a buffer owned by
+the calling thread and are formatted later on the logging thread, so this
+never waits on a file or the console.  If the buffer is full the message is
+thrown away and counted.
+
+\attention
+The format is saved as a pointer, so it must be a string literal.  Strings
+passed as arguments are copied, up to a short length.
+
+\param [in] level
+How important the message is.
+
+\param [in] category
+What the message is about.
+
+\param [in] format
+A printf style format.  Length modifiers like l or ll are not needed.
+
+\param [in] args
+Numbers, pointers or strings to format.
+*/
+/******************************************************************************/
+template <typename... Args>
+void M5Log::Write(M5LogLevel level, M5LogCategory category, const char* format, const Args&... args)
+{
+	static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many arguments to log");
+
+	M5LogRecord* pRecord = BeginRecord(level, category);
+	if (pRecord == 0)
+		return;
+
+	pRecord->format = format;
+	Pack(*pRecord, args...);
+	EndRecord();
+}
+/******************************************************************************/
+/*!
+Saves each argument into the record.
+
+\param [in, out] record
+The record to save into.
+
+\param [in] first
+The next argument to save.
+
+\param [in] rest
+The rest of the arguments.
+*/
+/******************************************************************************/
+template <typename T, typename... Rest>
+void M5Log::Pack(M5LogRecord& record, const T& first, const Rest&... rest)
+{
+	SetArg(record, record.args[record.argCount++], first);
+	Pack(record, rest...);
+}
+/******************************************************************************/
+/*!
+Saves a number, enum or pointer argument.
+
+\param [in, out] record
+The record the argument is in.
+
+\param [out] arg
+The argument to set.
+
+\param [in] value
+The value to save.
+*/
+/******************************************************************************/
+template <typename T>
+void M5Log::SetArg(M5LogRecord& /*record*/, M5LogArg& arg, const T& value)
+{
+	static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value,
+		"Only numbers, enums, pointers and strings can be logged");
+
+	SetValue(arg, value, M5LogArgKind<
+		std::is_floating_point<T>::value ? LA_DOUBLE :
+		std::is_pointer<T>::value        ? LA_POINTER :
+		std::is_unsigned<T>::value       ? LA_UINT : LA_INT>());
+}
+/******************************************************************************/
+/*!
+Saves a signed integer or enum argument.
+
+\param [out] arg
+The argument to set.
+
+\param [in] value
+The value to save.
+*/
+/******************************************************************************/
+template <typename T>
+void M5Log::SetValue(M5LogArg& arg, const T& value, M5LogArgKind<LA_INT>)
+{
+	arg.type = LA_INT;
+	arg.value.i = static_cast<long long>(value);
+}
+/******************************************************************************/
+/*!
+Saves an unsigned integer argument.
+
+\param [out] arg
+The argument to set.
+
+\param [in] value
+The value to save.
+*/
+/******************************************************************************/
+template <typename T>
+void M5Log::SetValue(M5LogArg& arg, const T& value, M5LogArgKind<LA_UINT>)
+{
+	arg.type = LA_UINT;
+	arg.value.u = static_cast<unsigned long long>(value);
+}
+/******************************************************************************/
+/*!
+Saves a floating point argument.
+
+\param [out] arg
+The argument to set.
+
+\param [in] value
+The value to save.
+*/
+/******************************************************************************/
+template <typename T>
+void M5Log::SetValue(M5LogArg& arg, const T& value, M5LogArgKind<LA_DOUBLE>)
+{
+	arg.type = LA_DOUBLE;
+	arg.value.d = static_cast<double>(value);
+}
+/******************************************************************************/
+/*!
+Saves a pointer argument.  Only the address is saved, so %s can't be used
+with it.
+
+\param [out] arg
+The argument to set.
+
+\param [in] value
+The value to save.
+*/
+/******************************************************************************/
+template <typename T>
+void M5Log::SetValue(M5LogArg& arg, const T& value, M5LogArgKind<LA_POINTER>)
+{
+	arg.type = LA_POINTER;
+	arg.value.p = value;
+}
+
+
+#endif //M5_LOG_H
@@ -12,6 +12,7 @@ This file contains math functions that are useful in a game.
 /******************************************************************************/
 #include "M5Math.h"
 #include "M5Debug.h"
+#include "M5FastMath.h"
 #include <cmath>
 #include <cstring> /*memcpy*/
 
@@ -288,6 +289,53 @@ float Lerp(float start, float end, float time)
   float diff = end - start;
   return start + diff * time;
 }
+/******************************************************************************/
+/*!
+Finds the sine and cosine of an angle.  When M5_FAST_TRIG is defined this uses
+M5FastMath::SinCos, which is faster but within 2e-7 instead of exact.
+
+\param radians
+The angle in radians.
+
+\param sin
+The sine of the angle.
+
+\param cos
+The cosine of the angle.
+*/
+/******************************************************************************/
+void SinCos(float radians, float& sin, float& cos)
+{
+#ifdef M5_FAST_TRIG
+  M5FastMath::SinCos(radians, sin, cos);
+#else
+  sin = std::sin(radians);
+  cos = std::cos(radians);
+#endif
+}
+/******************************************************************************/
+/*!
+Finds the angle of the vector x,y.  When M5_FAST_TRIG is defined this uses
+M5FastMath::Atan2, which is faster but within 1e-5 instead of exact.
+
+\param y
+The y value of the vector.
+
+\param x
+The x value of the vector.
+
+\return
+The angle in radians between -PI and PI.
+*/
+/******************************************************************************/
+float Atan2(float y, float x)
+{
+#ifdef M5_FAST_TRIG
+  return M5FastMath::Atan2(y, x);
+#else
+  return std::atan2(y, x);
+#endif
+}
 }//end namespace M5Math
 
 
@@ -52,6 +52,10 @@ int   GetNextPowerOf2(int x);
 int   Lerp(int start, int end, float time);
 /*Linearly interpolates between start and end*/
 char  Lerp(char start, char end, float time);
+/*Gets the sine and cosine of an angle, using M5FastMath if M5_FAST_TRIG is defined*/
+void  SinCos(float radians, float& sin, float& cos);
+/*Gets the angle of the vector x,y, using M5FastMath if M5_FAST_TRIG is defined*/
+float Atan2(float y, float x);
 }//end namespace M5Math
 
 
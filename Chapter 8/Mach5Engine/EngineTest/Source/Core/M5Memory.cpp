@@ -0,0 +1,239 @@
+/******************************************************************************/
+/*!
+\file   M5Memory.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/24
+
+Singleton class to track how much memory each part of the engine is using.
+
+Every allocation has a small header in front of it that remembers the size
+and tag, so Free doesn't need to be told either.  The counters are atomic
+because textures can be read on a loading thread.
+
+*/
+/******************************************************************************/
+#include "M5Memory.h"
+#include "M5Debug.h"
+#include "M5Log.h"
+
+#include <atomic>
+#include <new>
+#include <cstdio>
+
+namespace
+{
+//! Stored in front of every allocation
+struct M5AllocHeader
+{
+	size_t      size; //!< The number of bytes the user asked for
+	M5MemoryTag tag;  //!< The tag the bytes are counted for
+};
+
+//! Size of the header, big enough to keep the user's memory aligned
+const size_t HEADER_SIZE = 16;
+static_assert(sizeof(M5AllocHeader) <= HEADER_SIZE, "M5AllocHeader doesn't fit");
+
+const char* TAG_NAMES[MT_COUNT] =
+{
+	"Objects",
+	"Components",
+	"Physics",
+	"Gfx",
+	"Resources",
+	"Ini",
+	"Stage",
+	"Stream"
+};
+
+//! True for tags whose memory should all be freed by M5App::Shutdown
+const bool IS_OWNER[MT_COUNT] =
+{
+	true,  //Objects
+	true,  //Components
+	false, //Physics
+	false, //Gfx
+	true,  //Resources
+	false, //Ini
+	true,  //Stage
+	true   //Stream
+};
+
+//These are plain static data, so they are zero before any constructor runs
+std::atomic<long long> s_liveBytes[MT_COUNT];   //!< Bytes not freed
+std::atomic<long long> s_highWater[MT_COUNT];   //!< Most bytes ever live
+std::atomic<int>       s_liveCount[MT_COUNT];   //!< Allocations not freed
+std::atomic<int>       s_frameAllocs[MT_COUNT]; //!< Allocations this frame
+int                    s_lastFrame[MT_COUNT];   //!< Allocations last frame
+long long              s_budget[MT_COUNT];      //!< Bytes to warn at, 0 for none
+bool                   s_isOver[MT_COUNT];      //!< True if we already warned
+}//end unnamed namespace
+
+
+/******************************************************************************/
+/*!
+Allocates memory and counts it for the given tag.  This is safe to call from
+any thread.
+
+\param [in] size
+The number of bytes to allocate.
+
+\param [in] tag
+The part of the engine to count the memory for.
+
+\return
+The new memory.  It must be freed with M5Memory::Free.
+*/
+/******************************************************************************/
+void* M5Memory::Allocate(size_t size, M5MemoryTag tag)
+{
+	M5DEBUG_ASSERT(tag >= 0 && tag < MT_COUNT, "Invalid memory tag");
+
+	char* pBlock = static_cast<char*>(::operator new(size + HEADER_SIZE));
+	M5AllocHeader* pHeader = reinterpret_cast<M5AllocHeader*>(pBlock);
+	pHeader->size = size;
+	pHeader->tag = tag;
+
+	long long live = s_liveBytes[tag] += static_cast<long long>(size);
+	++s_liveCount[tag];
+	++s_frameAllocs[tag];
+
+	long long high = s_highWater[tag].load();
+	while (live > high && !s_highWater[tag].compare_exchange_weak(high, live))
+	{
+		//high was updated by the failed exchange, so just try again
+	}
+
+	return pBlock + HEADER_SIZE;
+}
+/******************************************************************************/
+/*!
+Frees memory that was allocated by M5Memory::Allocate.  This is safe to call
+from any thread.
+
+\param [in] pMemory
+The memory to free.  This can be 0.
+*/
+/******************************************************************************/
+void M5Memory::Free(void* pMemory)
+{
+	if (pMemory == 0)
+		return;
+
+	char* pBlock = static_cast<char*>(pMemory) - HEADER_SIZE;
+	M5AllocHeader* pHeader = reinterpret_cast<M5AllocHeader*>(pBlock);
+	s_liveBytes[pHeader->tag] -= static_cast<long long>(pHeader->size);
+	--s_liveCount[pHeader->tag];
+
+	::operator delete(pBlock);
+}
+/******************************************************************************/
+/*!
+Sets the number of bytes a tag should stay under.  A warning is printed at the
+end of the frame it goes over.
+
+\param [in] tag
+The tag to set the budget for.
+
+\param [in] bytes
+The max number of bytes, or 0 for no budget.
+*/
+/******************************************************************************/
+void M5Memory::SetBudget(M5MemoryTag tag, long long bytes)
+{
+	M5DEBUG_ASSERT(tag >= 0 && tag < MT_COUNT, "Invalid memory tag");
+	s_budget[tag] = bytes;
+	s_isOver[tag] = false;
+}
+/******************************************************************************/
+/*!
+Gets the memory use of a tag.
+
+\param [in] tag
+The tag to get the stats of.
+
+\param [out] stats
+The memory use of the tag.
+*/
+/******************************************************************************/
+void M5Memory::GetStats(M5MemoryTag tag, M5MemoryStats& stats)
+{
+	M5DEBUG_ASSERT(tag >= 0 && tag < MT_COUNT, "Invalid memory tag");
+	stats.liveBytes   = s_liveBytes[tag].load();
+	stats.highWater   = s_highWater[tag].load();
+	stats.budget      = s_budget[tag];
+	stats.liveCount   = s_liveCount[tag].load();
+	stats.frameAllocs = s_lastFrame[tag];
+}
+/******************************************************************************/
+/*!
+Gets the name of a tag for printing.
+
+\param [in] tag
+The tag to get the name of.
+
+\return
+The name of the tag.
+*/
+/******************************************************************************/
+const char* M5Memory::GetTagName(M5MemoryTag tag)
+{
+	M5DEBUG_ASSERT(tag >= 0 && tag < MT_COUNT, "Invalid memory tag");
+	return TAG_NAMES[tag];
+}
+/******************************************************************************/
+/*!
+Prints every tag that still has memory allocated.  This is called by
+M5App::Shutdown, after everything owned by the engine has been deleted.  It
+uses standard output so it works without a debug console.
+
+\attention
+Physics, Gfx and Ini memory belongs to static containers that are freed after
+main returns, so those tags are not reported.
+
+\return
+The number of allocations that are still live.
+*/
+/******************************************************************************/
+int M5Memory::ReportLeaks(void)
+{
+	int total = 0;
+	for (int i = 0; i < MT_COUNT; ++i)
+	{
+		int count = s_liveCount[i].load();
+		if (count == 0 || !IS_OWNER[i])
+			continue;
+
+		std::printf("M5Memory: %s still has %d allocations, %lld bytes (high water %lld bytes)\n",
+			TAG_NAMES[i], count, s_liveBytes[i].load(), s_highWater[i].load());
+		total += count;
+	}
+
+	if (total == 0)
+		std::printf("M5Memory: No leaks\n");
+
+	std::fflush(stdout);
+	return total;
+}
+/******************************************************************************/
+/*!
+Saves the allocation counts for this frame and logs a warning for tags that went
+over budget.  This is called by the M5StageManager at the end of every frame.
+*/
+/******************************************************************************/
+void M5Memory::EndFrame(void)
+{
+	for (int i = 0; i < MT_COUNT; ++i)
+	{
+		s_lastFrame[i] = s_frameAllocs[i].exchange(0);
+
+		bool isOver = s_budget[i] != 0 && s_liveBytes[i].load() > s_budget[i];
+		if (isOver && !s_isOver[i])
+		{
+			M5Log::Write(LL_WARNING, LC_GENERAL, "M5Memory: %s is over budget, %lld of %lld bytes",
+				TAG_NAMES[i], s_liveBytes[i].load(), s_budget[i]);
+		}
+		s_isOver[i] = isOver;
+	}
+}
@@ -0,0 +1,109 @@
+/******************************************************************************/
+/*!
+\file   M5Memory.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/24
+
+Singleton class to track how much memory each part of the engine is using.
+
+*/
+/******************************************************************************/
+#ifndef M5_MEMORY_H
+#define M5_MEMORY_H
+
+#include <cstddef>
+
+//! The parts of the engine that memory is tracked for
+enum M5MemoryTag
+{
+	MT_OBJECTS,    //!< M5Objects
+	MT_COMPONENTS, //!< All M5Components
+	MT_PHYSICS,    //!< Collider lists and collision pairs
+	MT_GFX,        //!< Draw lists and the culling grid
+	MT_RESOURCES,  //!< Texture data read from disk
+	MT_INI,        //!< Sections and values of M5IniFiles
+	MT_STAGE,      //!< M5Stages
+	MT_STREAM,     //!< Placements of streamed level chunks
+	MT_COUNT       //!< The number of tags, not a real tag
+};
+
+//! Memory use of one M5MemoryTag
+struct M5MemoryStats
+{
+	long long liveBytes;   //!< Bytes allocated and not freed
+	long long highWater;   //!< The most liveBytes has ever been
+	long long budget;      //!< Warn if liveBytes goes over this, 0 for no budget
+	int       liveCount;   //!< Allocations not freed
+	int       frameAllocs; //!< Allocations made during the last frame
+};
+
+//! Singleton class to track how much memory each part of the engine is using.
+class M5Memory
+{
+public:
+	friend class M5StageManager;
+
+	//Allocates memory and counts it for the tag
+	static void* Allocate(size_t size, M5MemoryTag tag);
+	//Frees memory from Allocate
+	static void  Free(void* pMemory);
+	//Sets the number of bytes a tag should stay under, 0 for no budget
+	static void  SetBudget(M5MemoryTag tag, long long bytes);
+	//Gets the memory use of a tag
+	static void  GetStats(M5MemoryTag tag, M5MemoryStats& stats);
+	//Gets the name of a tag for printing
+	static const char* GetTagName(M5MemoryTag tag);
+	//Prints every tag with memory that is still allocated
+	static int   ReportLeaks(void);
+private:
+	static void  EndFrame(void);
+};//end M5Memory
+
+/*! An STL allocator that counts its memory for a tag, for example
+std::vector<int, M5Allocator<int, MT_GFX> >.*/
+template <typename T, M5MemoryTag Tag>
+class M5Allocator
+{
+public:
+	typedef T value_type; //!< The type this allocates
+
+	//! Lets containers get an allocator for their internal nodes
+	template <typename U>
+	struct rebind
+	{
+		typedef M5Allocator<U, Tag> other; //!< The same tag for a different type
+	};
+
+	M5Allocator(void) {}
+	template <typename U>
+	M5Allocator(const M5Allocator<U, Tag>&) {}
+
+	//! Allocates room for count objects of type T
+	T* allocate(size_t count)
+	{
+		return static_cast<T*>(M5Memory::Allocate(count * sizeof(T), Tag));
+	}
+	//! Frees memory from allocate
+	void deallocate(T* pMemory, size_t)
+	{
+		M5Memory::Free(pMemory);
+	}
+};
+
+//! All allocators with the same tag can free each other's memory
+template <typename T, typename U, M5MemoryTag Tag>
+bool operator==(const M5Allocator<T, Tag>&, const M5Allocator<U, Tag>&)
+{
+	return true;
+}
+//! All allocators with the same tag can free each other's memory
+template <typename T, typename U, M5MemoryTag Tag>
+bool operator!=(const M5Allocator<T, Tag>&, const M5Allocator<U, Tag>&)
+{
+	return false;
+}
+
+
+#endif //M5_MEMORY_H
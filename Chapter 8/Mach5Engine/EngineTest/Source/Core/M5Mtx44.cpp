@@ -208,8 +208,9 @@ The angle in radians of the rotation about the z axis.
 /******************************************************************************/
 void M5Mtx44::MakeRotateZ(M5Mtx44& result, float radians)
 {
-  float sinAngle = std::sin(radians);
-  float cosAngle = std::cos(radians);
+  float sinAngle;
+  float cosAngle;
+  M5Math::SinCos(radians, sinAngle, cosAngle);
 
   std::memset(&result, 0, sizeof(result));
   result.m[0][0] = result.m[1][1] = cosAngle;
@@ -249,8 +250,9 @@ void M5Mtx44::MakeTransform(M5Mtx44& result, float scaleX, float scaleY,
   float transX, float transY,
   float zOrder)
 {
-  float sinAngle = std::sin(radians);
-  float cosAngle = std::cos(radians);
+  float sinAngle;
+  float cosAngle;
+  M5Math::SinCos(radians, sinAngle, cosAngle);
 
   /*Set the first ROW*/
   result.m[0][0] = scaleX * cosAngle;
@@ -407,8 +409,9 @@ The angle in radians of the rotation about the z axis.
 /******************************************************************************/
 void M5Mtx44::MakeRotateZ(float radians)
 {
-  float sinAngle = std::sin(radians);
-  float cosAngle = std::cos(radians);
+  float sinAngle;
+  float cosAngle;
+  M5Math::SinCos(radians, sinAngle, cosAngle);
 
   std::memset(this, 0, sizeof(*this));
   m[0][0] = m[1][1] = cosAngle;
@@ -443,8 +446,9 @@ The zOrder of the object.  This should be small, such as between 0 and 1.
 void M5Mtx44::MakeTransform(float scaleX, float scaleY, float radians,
   float transX, float transY, float zOrder)
 {
-  float sinAngle = std::sin(radians);
-  float cosAngle = std::cos(radians);
+  float sinAngle;
+  float cosAngle;
+  M5Math::SinCos(radians, sinAngle, cosAngle);
 
   /*Set the first ROW*/
   m[0][0] = scaleX * cosAngle;
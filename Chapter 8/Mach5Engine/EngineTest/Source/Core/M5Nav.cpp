@@ -0,0 +1,542 @@
+/******************************************************************************/
+/*!
+\file   M5Nav.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Singleton class that builds a flow field so any number of objects can find
+their way to a goal around obstacles.
+
+The field is built with Dijkstra's algorithm starting from every goal cell at
+once, so each cell ends up with its distance to the nearest goal.  Each cell
+then points at the neighbor closest to a goal.  Objects blend the directions of
+the four cells around them so they don't move in only eight directions.
+
+*/
+/******************************************************************************/
+#include "M5Nav.h"
+#include "M5Vec2.h"
+#include "M5Vec2Batch.h"
+#include "M5Gfx.h"
+#include "M5Debug.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace
+{
+const float DEFAULT_CELL_SIZE = 16.0f;   //!< Cell size used for the world bounds
+const int   STRAIGHT_COST = 10;          //!< Cost to move to a side neighbor
+const int   DIAGONAL_COST = 14;          //!< Cost to move to a corner neighbor
+const int   UNREACHABLE = INT_MAX;       //!< Cost of cells that can't reach a goal
+const int   NEIGHBORS = 8;               //!< Cells next to each cell
+const int   NEIGHBOR_X[NEIGHBORS] = { 1, -1, 0,  0, 1,  1, -1, -1 }; //!< Offsets to each neighbor
+const int   NEIGHBOR_Y[NEIGHBORS] = { 0,  0, 1, -1, 1, -1,  1, -1 }; //!< Offsets to each neighbor
+const float DIAGONAL = 0.70710678f;      //!< Length of each part of a normalized corner direction
+const float MIN_LENGTH = 0.0001f;        //!< Blended directions shorter than this are zero
+
+//! A circle objects must go around
+struct M5Obstacle
+{
+	M5Vec2 center; //!< Center of the circle
+	float  radius; //!< Radius of the circle
+};
+
+//! Typedef for a cell index and its cost, for the open list
+typedef std::pair<int, int> CostCell;
+//! Typedef for the open list, the cheapest cell is on top
+typedef std::priority_queue<CostCell, std::vector<CostCell>, std::greater<CostCell> > OpenList;
+
+M5Vec2                     s_botLeft;                        //!< Bottom left of the grid
+M5Vec2                     s_topRight;                       //!< Top right of the grid
+float                      s_cellSize = DEFAULT_CELL_SIZE;   //!< Width and height of each cell
+float                      s_invCellSize = 1.0f / DEFAULT_CELL_SIZE; //!< 1 / s_cellSize
+int                        s_width = 1;                      //!< Cells in each row
+int                        s_height = 1;                     //!< Cells in each column
+bool                       s_hasBounds = false;              //!< False to cover the visible world
+bool                       s_isDirty = true;                 //!< True if the field must be rebuilt
+int                        s_buildCount = 0;                 //!< Times the field has been built
+std::vector<M5Obstacle>    s_obstacles;                      //!< Circles to go around
+std::vector<M5Vec2>        s_goals;                          //!< Points to move towards
+std::vector<int>           s_goalCells;                      //!< Sorted cells of the goals
+std::vector<int>           s_newCells;                       //!< Reused to check if goal cells changed
+std::vector<unsigned char> s_blocked;                        //!< 1 for each cell inside an obstacle
+std::vector<int>           s_cost;                           //!< Cost of each cell to the nearest goal
+std::vector<float>         s_dirX;                           //!< x direction of each cell
+std::vector<float>         s_dirY;                           //!< y direction of each cell
+
+/******************************************************************************/
+/*!
+Gets the column or row of the cell that a coordinate is in, clamped to the
+grid.
+
+\param [in] value
+The x or y coordinate.
+
+\param [in] start
+The left or bottom of the grid.
+
+\param [in] count
+The number of columns or rows.
+
+\return
+The column or row.
+*/
+/******************************************************************************/
+int ToCell(float value, float start, int count)
+{
+	int cell = static_cast<int>(std::floor((value - start) * s_invCellSize));
+	return std::min(std::max(cell, 0), count - 1);
+}
+/******************************************************************************/
+/*!
+Gets the index of the cell that a point is in, clamped to the grid.
+
+\param [in] pos
+The point.
+
+\return
+The index of the cell.
+*/
+/******************************************************************************/
+int ToIndex(const M5Vec2& pos)
+{
+	return ToCell(pos.x, s_botLeft.x, s_width) +
+		ToCell(pos.y, s_botLeft.y, s_height) * s_width;
+}
+/******************************************************************************/
+/*!
+Checks if an object can move from a cell to one of its neighbors.  Objects
+can't move into obstacles, and they can't cut the corner of an obstacle when
+moving diagonally.
+
+\param [in] x
+The column of the cell.
+
+\param [in] y
+The row of the cell.
+
+\param [in] neighbor
+The index into NEIGHBOR_X and NEIGHBOR_Y.
+
+\return
+True if the move is allowed, false otherwise.
+*/
+/******************************************************************************/
+bool CanStep(int x, int y, int neighbor)
+{
+	int toX = x + NEIGHBOR_X[neighbor];
+	int toY = y + NEIGHBOR_Y[neighbor];
+	if (toX < 0 || toX >= s_width || toY < 0 || toY >= s_height)
+		return false;
+	if (s_blocked[toX + toY * s_width])
+		return false;
+	if (NEIGHBOR_X[neighbor] != 0 && NEIGHBOR_Y[neighbor] != 0)
+		return !s_blocked[toX + y * s_width] && !s_blocked[x + toY * s_width];
+	return true;
+}
+/******************************************************************************/
+/*!
+Marks every cell that touches an obstacle as blocked.
+*/
+/******************************************************************************/
+void BlockObstacles(void)
+{
+	for (size_t i = 0; i < s_obstacles.size(); ++i)
+	{
+		const M5Obstacle& obstacle = s_obstacles[i];
+		float radius = obstacle.radius;
+		int left = ToCell(obstacle.center.x - radius, s_botLeft.x, s_width);
+		int right = ToCell(obstacle.center.x + radius, s_botLeft.x, s_width);
+		int bottom = ToCell(obstacle.center.y - radius, s_botLeft.y, s_height);
+		int top = ToCell(obstacle.center.y + radius, s_botLeft.y, s_height);
+
+		for (int y = bottom; y <= top; ++y)
+		{
+			float cellBottom = s_botLeft.y + y * s_cellSize;
+			float closestY = std::min(std::max(obstacle.center.y, cellBottom), cellBottom + s_cellSize);
+			for (int x = left; x <= right; ++x)
+			{
+				float cellLeft = s_botLeft.x + x * s_cellSize;
+				float closestX = std::min(std::max(obstacle.center.x, cellLeft), cellLeft + s_cellSize);
+				float distX = closestX - obstacle.center.x;
+				float distY = closestY - obstacle.center.y;
+				if (distX * distX + distY * distY <= radius * radius)
+					s_blocked[x + y * s_width] = 1;
+			}
+		}
+	}
+}
+}//end unnamed namespace
+
+/******************************************************************************/
+/*!
+Sets the area covered by the grid.  Objects outside of this area use the
+direction of the closest cell.
+
+\param [in] botLeft
+The bottom left corner of the grid in world space.
+
+\param [in] topRight
+The top right corner of the grid in world space.
+
+\param [in] cellSize
+The width and height of each cell.  Smaller cells go around obstacles more
+closely but take longer to build.
+*/
+/******************************************************************************/
+void M5Nav::SetBounds(const M5Vec2& botLeft, const M5Vec2& topRight, float cellSize)
+{
+	M5DEBUG_ASSERT(cellSize > 0, "The cell size must be greater than zero");
+	M5DEBUG_ASSERT(topRight.x > botLeft.x && topRight.y > botLeft.y, "The bounds must not be empty");
+	s_hasBounds = true;
+	s_botLeft = botLeft;
+	s_topRight = topRight;
+	s_cellSize = cellSize;
+	s_invCellSize = 1.0f / cellSize;
+	s_width = std::max(1, static_cast<int>(std::ceil((topRight.x - botLeft.x) * s_invCellSize)));
+	s_height = std::max(1, static_cast<int>(std::ceil((topRight.y - botLeft.y) * s_invCellSize)));
+	s_isDirty = true;
+}
+/******************************************************************************/
+/*!
+Makes the grid cover the visible world with the default cell size.  The grid
+follows the world if the camera or resolution changes.  This is the default.
+*/
+/******************************************************************************/
+void M5Nav::UseWorldBounds(void)
+{
+	s_hasBounds = false;
+	s_isDirty = true;
+}
+/******************************************************************************/
+/*!
+Adds a circle that objects must go around.
+
+\param [in] center
+The center of the circle in world space.
+
+\param [in] radius
+The radius of the circle.
+*/
+/******************************************************************************/
+void M5Nav::AddObstacle(const M5Vec2& center, float radius)
+{
+	M5Obstacle obstacle;
+	obstacle.center = center;
+	obstacle.radius = radius;
+	s_obstacles.push_back(obstacle);
+	s_isDirty = true;
+}
+/******************************************************************************/
+/*!
+Removes all obstacles.
+*/
+/******************************************************************************/
+void M5Nav::ClearObstacles(void)
+{
+	s_obstacles.clear();
+	s_isDirty = true;
+}
+/******************************************************************************/
+/*!
+Sets a single goal to move towards.
+
+\param [in] goal
+The goal in world space.
+*/
+/******************************************************************************/
+void M5Nav::SetGoal(const M5Vec2& goal)
+{
+	SetGoals(&goal, 1);
+}
+/******************************************************************************/
+/*!
+Sets the goals to move towards.  Objects move towards the nearest goal.  This
+can be called every frame, since the field is only rebuilt if a goal is in a
+different cell than before.
+
+\param [in] pGoals
+The goals in world space.
+
+\param [in] count
+The number of goals.
+*/
+/******************************************************************************/
+void M5Nav::SetGoals(const M5Vec2* pGoals, size_t count)
+{
+	UpdateBounds();
+	s_goals.assign(pGoals, pGoals + count);
+
+	s_newCells.clear();
+	for (size_t i = 0; i < count; ++i)
+		s_newCells.push_back(ToIndex(pGoals[i]));
+	std::sort(s_newCells.begin(), s_newCells.end());
+	s_newCells.erase(std::unique(s_newCells.begin(), s_newCells.end()), s_newCells.end());
+
+	if (s_newCells != s_goalCells)
+	{
+		s_goalCells.swap(s_newCells);
+		s_isDirty = true;
+	}
+}
+/******************************************************************************/
+/*!
+Gets the direction to move from a point to get closer to the nearest goal.
+
+\param [out] dir
+The normalized direction, or zero if no goal can be reached from the point.
+
+\param [in] pos
+The point in world space.
+*/
+/******************************************************************************/
+void M5Nav::GetDirection(M5Vec2& dir, const M5Vec2& pos)
+{
+	UpdateBounds();
+	if (s_isDirty)
+		Build();
+
+	Sample(pos.x, pos.y, dir.x, dir.y);
+}
+/******************************************************************************/
+/*!
+Gets the direction to move from many points at once.  The field is checked
+once for the whole span, so this is cheaper than calling GetDirection for each
+point.
+
+\param [out] dirs
+The normalized directions, or zero if no goal can be reached from the point.
+
+\param [in] pos
+The points in world space.
+*/
+/******************************************************************************/
+void M5Nav::GetDirections(const M5Vec2Span& dirs, const M5Vec2Span& pos)
+{
+	M5DEBUG_ASSERT(dirs.size == pos.size, "The spans must be the same size");
+	UpdateBounds();
+	if (s_isDirty)
+		Build();
+
+	for (size_t i = 0; i < pos.size; ++i)
+		Sample(pos.x[i], pos.y[i], dirs.x[i], dirs.y[i]);
+}
+/******************************************************************************/
+/*!
+Gets the number of times the field has been built.  Compare this over a few
+frames to see how often goals change cells.
+
+\return
+The number of builds since the game started.
+*/
+/******************************************************************************/
+int M5Nav::GetBuildCount(void)
+{
+	return s_buildCount;
+}
+/******************************************************************************/
+/*!
+Removes the obstacles and goals and goes back to the world bounds.  This is
+called before a stage is initialized.
+*/
+/******************************************************************************/
+void M5Nav::Reset(void)
+{
+	s_obstacles.clear();
+	s_goals.clear();
+	s_goalCells.clear();
+	UseWorldBounds();
+}
+/******************************************************************************/
+/*!
+If the grid covers the visible world, checks if the world has changed and
+resizes the grid to match.
+*/
+/******************************************************************************/
+void M5Nav::UpdateBounds(void)
+{
+	if (s_hasBounds)
+		return;
+
+	M5Vec2 botLeft;
+	M5Vec2 topRight;
+	M5Gfx::GetWorldBotLeft(botLeft);
+	M5Gfx::GetWorldTopRight(topRight);
+	if (!s_isDirty && botLeft == s_botLeft && topRight == s_topRight)
+		return;
+
+	s_botLeft = botLeft;
+	s_topRight = topRight;
+	s_cellSize = DEFAULT_CELL_SIZE;
+	s_invCellSize = 1.0f / DEFAULT_CELL_SIZE;
+	s_width = std::max(1, static_cast<int>(std::ceil((topRight.x - botLeft.x) * s_invCellSize)));
+	s_height = std::max(1, static_cast<int>(std::ceil((topRight.y - botLeft.y) * s_invCellSize)));
+	s_isDirty = true;
+}
+/******************************************************************************/
+/*!
+Finds the cost from every cell to the nearest goal, then points each cell at
+its cheapest neighbor.
+*/
+/******************************************************************************/
+void M5Nav::Build(void)
+{
+	size_t cells = static_cast<size_t>(s_width) * s_height;
+	s_blocked.assign(cells, 0);
+	s_cost.assign(cells, UNREACHABLE);
+	s_dirX.assign(cells, 0.0f);
+	s_dirY.assign(cells, 0.0f);
+	BlockObstacles();
+
+	/*The grid may have changed size since the goals were set*/
+	OpenList open;
+	s_goalCells.clear();
+	for (size_t i = 0; i < s_goals.size(); ++i)
+	{
+		int cell = ToIndex(s_goals[i]);
+		s_goalCells.push_back(cell);
+		if (!s_blocked[cell] && s_cost[cell] != 0)
+		{
+			s_cost[cell] = 0;
+			open.push(CostCell(0, cell));
+		}
+	}
+	std::sort(s_goalCells.begin(), s_goalCells.end());
+	s_goalCells.erase(std::unique(s_goalCells.begin(), s_goalCells.end()), s_goalCells.end());
+
+	while (!open.empty())
+	{
+		CostCell top = open.top();
+		open.pop();
+		int cell = top.second;
+		if (top.first != s_cost[cell])
+			continue;/*A cheaper way to this cell was already found*/
+
+		int x = cell % s_width;
+		int y = cell / s_width;
+		for (int i = 0; i < NEIGHBORS; ++i)
+		{
+			if (!CanStep(x, y, i))
+				continue;
+
+			int next = cell + NEIGHBOR_X[i] + NEIGHBOR_Y[i] * s_width;
+			int cost = top.first + ((i < 4) ? STRAIGHT_COST : DIAGONAL_COST);
+			if (cost < s_cost[next])
+			{
+				s_cost[next] = cost;
+				open.push(CostCell(cost, next));
+			}
+		}
+	}
+
+	for (int y = 0; y < s_height; ++y)
+	{
+		for (int x = 0; x < s_width; ++x)
+		{
+			int cell = x + y * s_width;
+			int best = s_cost[cell];
+			if (best == 0 || best == UNREACHABLE)
+				continue;
+
+			int bestNeighbor = -1;
+			for (int i = 0; i < NEIGHBORS; ++i)
+			{
+				if (!CanStep(x, y, i))
+					continue;
+				int next = cell + NEIGHBOR_X[i] + NEIGHBOR_Y[i] * s_width;
+				if (s_cost[next] < best)
+				{
+					best = s_cost[next];
+					bestNeighbor = i;
+				}
+			}
+
+			float scale = (bestNeighbor < 4) ? 1.0f : DIAGONAL;
+			s_dirX[cell] = NEIGHBOR_X[bestNeighbor] * scale;
+			s_dirY[cell] = NEIGHBOR_Y[bestNeighbor] * scale;
+		}
+	}
+
+	s_isDirty = false;
+	++s_buildCount;
+}
+/******************************************************************************/
+/*!
+Gets the direction at a point by blending the four closest cell centers.  In
+a goal cell the direction points straight at the nearest goal instead.
+
+\param [in] x
+The x coordinate of the point.
+
+\param [in] y
+The y coordinate of the point.
+
+\param [out] dirX
+The x part of the normalized direction.
+
+\param [out] dirY
+The y part of the normalized direction.
+*/
+/******************************************************************************/
+void M5Nav::Sample(float x, float y, float& dirX, float& dirY)
+{
+	float cellX = (x - s_botLeft.x) * s_invCellSize - 0.5f;
+	float cellY = (y - s_botLeft.y) * s_invCellSize - 0.5f;
+	cellX = std::min(std::max(cellX, 0.0f), static_cast<float>(s_width - 1));
+	cellY = std::min(std::max(cellY, 0.0f), static_cast<float>(s_height - 1));
+
+	int x0 = static_cast<int>(cellX);
+	int y0 = static_cast<int>(cellY);
+	float tx = cellX - x0;
+	float ty = cellY - y0;
+	int nearest = static_cast<int>(cellX + 0.5f) + static_cast<int>(cellY + 0.5f) * s_width;
+
+	if (s_cost[nearest] == 0)
+	{
+		/*Close enough to steer right at the goal*/
+		float bestDist = -1.0f;
+		dirX = dirY = 0.0f;
+		for (size_t i = 0; i < s_goals.size(); ++i)
+		{
+			float toX = s_goals[i].x - x;
+			float toY = s_goals[i].y - y;
+			float dist = toX * toX + toY * toY;
+			if (bestDist < 0 || dist < bestDist)
+			{
+				bestDist = dist;
+				dirX = toX;
+				dirY = toY;
+			}
+		}
+	}
+	else
+	{
+		int x1 = std::min(x0 + 1, s_width - 1);
+		int y1 = std::min(y0 + 1, s_height - 1);
+		int row0 = y0 * s_width;
+		int row1 = y1 * s_width;
+		float bottomX = s_dirX[x0 + row0] + (s_dirX[x1 + row0] - s_dirX[x0 + row0]) * tx;
+		float bottomY = s_dirY[x0 + row0] + (s_dirY[x1 + row0] - s_dirY[x0 + row0]) * tx;
+		float topX = s_dirX[x0 + row1] + (s_dirX[x1 + row1] - s_dirX[x0 + row1]) * tx;
+		float topY = s_dirY[x0 + row1] + (s_dirY[x1 + row1] - s_dirY[x0 + row1]) * tx;
+		dirX = bottomX + (topX - bottomX) * ty;
+		dirY = bottomY + (topY - bottomY) * ty;
+	}
+
+	float length = std::sqrt(dirX * dirX + dirY * dirY);
+	if (length < MIN_LENGTH)
+	{
+		dirX = dirY = 0.0f;
+		return;
+	}
+	dirX /= length;
+	dirY /= length;
+}
@@ -0,0 +1,60 @@
+/******************************************************************************/
+/*!
+\file   M5Nav.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Singleton class that builds a flow field so any number of objects can find
+their way to a goal around obstacles.
+
+*/
+/******************************************************************************/
+#ifndef M5_NAV_H
+#define M5_NAV_H
+
+#include <cstddef>
+
+//Forward declarations
+struct M5Vec2;
+struct M5Vec2Span;
+
+/*! Singleton class that builds a flow field for the world.  The world is split
+into a grid of cells and each open cell stores the direction to move to get
+closer to the nearest goal.  The field is only rebuilt when a goal moves to a
+different cell or the obstacles change, so every object that steers with it
+shares the cost of one search.*/
+class M5Nav
+{
+public:
+	friend class M5StageManager;
+	friend class M5Benchmark;
+
+	//Sets the area covered by the grid and the size of each cell
+	static void SetBounds(const M5Vec2& botLeft, const M5Vec2& topRight, float cellSize);
+	//Makes the grid cover the visible world again
+	static void UseWorldBounds(void);
+	//Adds a circle that objects must go around
+	static void AddObstacle(const M5Vec2& center, float radius);
+	//Removes all obstacles
+	static void ClearObstacles(void);
+	//Sets a single goal to move towards
+	static void SetGoal(const M5Vec2& goal);
+	//Sets goals to move towards, objects go to the nearest one
+	static void SetGoals(const M5Vec2* pGoals, size_t count);
+	//Gets the direction to move from a point
+	static void GetDirection(M5Vec2& dir, const M5Vec2& pos);
+	//Gets the direction to move from many points at once
+	static void GetDirections(const M5Vec2Span& dirs, const M5Vec2Span& pos);
+	//Gets the number of times the field has been built
+	static int GetBuildCount(void);
+private:
+	static void Reset(void);
+	static void UpdateBounds(void);
+	static void Build(void);
+	static void Sample(float x, float y, float& dirX, float& dirY);
+};
+
+
+#endif //M5_NAV_H
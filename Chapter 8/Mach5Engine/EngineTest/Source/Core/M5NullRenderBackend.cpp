@@ -0,0 +1,124 @@
+/******************************************************************************/
+/*!
+\file   M5NullRenderBackend.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+A render backend that reads every frame but doesn't draw anything.
+
+*/
+/******************************************************************************/
+#include "M5NullRenderBackend.h"
+#include "M5RenderList.h"
+
+/******************************************************************************/
+/*!
+Sets the counts to zero.
+*/
+/******************************************************************************/
+M5NullRenderBackend::M5NullRenderBackend(void) :
+	m_nextTexture(1),
+	m_frames(0),
+	m_items(0),
+	m_checksum(0)
+{
+}
+/******************************************************************************/
+/*!
+There is no context to make current.
+*/
+/******************************************************************************/
+void M5NullRenderBackend::StartThread(void)
+{
+}
+/******************************************************************************/
+/*!
+There is no context to release.
+*/
+/******************************************************************************/
+void M5NullRenderBackend::EndThread(void)
+{
+}
+/******************************************************************************/
+/*!
+Reads every quad in the frame the way a real backend would, without drawing.
+
+\param [in] frame
+The frame to read.
+*/
+/******************************************************************************/
+void M5NullRenderBackend::Execute(const M5RenderFrame& frame)
+{
+	size_t size = frame.world.size();
+	for (size_t i = 0; i < size; ++i)
+		m_checksum += frame.world[i].world.m[3][0] + frame.world[i].world.m[3][1];
+
+	size = frame.hud.size();
+	for (size_t i = 0; i < size; ++i)
+		m_checksum += frame.hud[i].world.m[3][0] + frame.hud[i].world.m[3][1];
+
+	++m_frames;
+	m_items += frame.world.size() + frame.hud.size() + frame.text.size();
+}
+/******************************************************************************/
+/*!
+Gives out a new id without keeping the pixels.
+
+\param [in] pixels
+The pixels of the texture.
+
+\param [in] width
+The width of the texture.
+
+\param [in] height
+The height of the texture.
+
+\param [in] format
+The format of the pixels.
+
+\return
+A new texture id.
+*/
+/******************************************************************************/
+int M5NullRenderBackend::CreateTexture(const unsigned char* /*pixels*/, int /*width*/,
+	int /*height*/, unsigned /*format*/)
+{
+	return m_nextTexture++;
+}
+/******************************************************************************/
+/*!
+There is nothing to free.
+
+\param [in] textureID
+The texture to delete.
+*/
+/******************************************************************************/
+void M5NullRenderBackend::DeleteTexture(int /*textureID*/)
+{
+}
+/******************************************************************************/
+/*!
+Gets the number of frames executed.
+
+\return
+The number of frames executed.
+*/
+/******************************************************************************/
+int M5NullRenderBackend::GetFrameCount(void) const
+{
+	return m_frames;
+}
+/******************************************************************************/
+/*!
+Gets the number of quads and text vertices in every frame executed.
+
+\return
+The number of quads and text vertices in every frame executed.
+*/
+/******************************************************************************/
+long long M5NullRenderBackend::GetItemCount(void) const
+{
+	return m_items;
+}
@@ -0,0 +1,42 @@
+/******************************************************************************/
+/*!
+\file   M5NullRenderBackend.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+A render backend that reads every frame but doesn't draw anything.
+
+*/
+/******************************************************************************/
+#ifndef M5_NULL_RENDER_BACKEND_H
+#define M5_NULL_RENDER_BACKEND_H
+
+#include "M5RenderBackend.h"
+
+/*! A render backend that reads every frame but doesn't draw anything.  It
+doesn't use a window or a GPU, so the rest of the engine can be timed on
+machines without one.*/
+class M5NullRenderBackend : public M5RenderBackend
+{
+public:
+	M5NullRenderBackend(void);
+	virtual void StartThread(void);
+	virtual void EndThread(void);
+	virtual void Execute(const M5RenderFrame& frame);
+	virtual int  CreateTexture(const unsigned char* pixels, int width, int height, unsigned format);
+	virtual void DeleteTexture(int textureID);
+	//Gets the number of frames executed, only call while the render thread is idle
+	int GetFrameCount(void) const;
+	//Gets the number of quads and text vertices, only call while the render thread is idle
+	long long GetItemCount(void) const;
+private:
+	int       m_nextTexture; //!< The id of the next texture
+	int       m_frames;      //!< Number of frames executed
+	long long m_items;       //!< Number of quads and text vertices in every frame executed
+	float     m_checksum;    //!< Sum of positions, so the frame is really read
+};
+
+
+#endif //M5_NULL_RENDER_BACKEND_H
@@ -13,6 +13,9 @@
 #include "M5Debug.h"
 #include "M5Component.h"
 #include "M5IniFile.h"
+#include "M5Snapshot.h"
+#include "M5ObjectManager.h"
+#include "M5Memory.h"
 #include <algorithm>
 
 namespace
@@ -41,7 +44,8 @@ M5Object::M5Object(M5ArcheTypes type) :
 	isDead(false),
 	m_components(),
 	m_type(type),
-	m_id(++s_objectIDCounter)
+	m_id(++s_objectIDCounter),
+	m_inSystems(false)
 {
 	m_components.reserve(START_SIZE);
 }
@@ -56,6 +60,33 @@ M5Object::~M5Object(void)
 }
 /******************************************************************************/
 /*!
+Allocates memory for an object so it is counted by M5Memory.
+
+\param [in] size
+The number of bytes to allocate.
+
+\return
+The memory for the object.
+*/
+/******************************************************************************/
+void* M5Object::operator new(size_t size)
+{
+	return M5Memory::Allocate(size, MT_OBJECTS);
+}
+/******************************************************************************/
+/*!
+Frees memory allocated by operator new.
+
+\param [in] pMemory
+The memory to free.
+*/
+/******************************************************************************/
+void M5Object::operator delete(void* pMemory)
+{
+	M5Memory::Free(pMemory);
+}
+/******************************************************************************/
+/*!
 Removes all components from this game object and deletes the component 
 pointers
 
@@ -74,7 +105,8 @@ void M5Object::RemoveAllComponents(void)
 }
 /******************************************************************************/
 /*!
-Updates all components in the game object
+Updates all components in the game object.  Components of a type with an
+M5UpdateRate are only updated when it is their turn.
 
 \param [in] dt
 The time in seconds since the last frame.
@@ -94,11 +126,55 @@ void M5Object::Update(float dt)
 		}
 		else
 		{
-			m_components[i]->Update(dt);
+			float updateDt;
+			if (m_components[i]->IsDue(dt, updateDt))
+				m_components[i]->Update(updateDt);
 		}
 	}
 
-	//Update object data
+	Integrate(dt);
+}
+/******************************************************************************/
+/*!
+Deletes all components that have been marked as dead.  This is used by the
+type based update, which updates components without going through the object.
+*/
+/******************************************************************************/
+void M5Object::RemoveDeadComponents(void)
+{
+	for (size_t i = 0; i < m_components.size(); ++i)
+	{
+		if (m_components[i]->isDead)
+		{
+			delete m_components[i];
+			m_components[i] = m_components[m_components.size() - 1];
+			m_components.pop_back();
+			--i;//so that we can check the shifted component
+		}
+	}
+}
+/******************************************************************************/
+/*!
+Removes every component from the engine lists it registered with.  This is
+used when the object is queued to be deleted later.
+*/
+/******************************************************************************/
+void M5Object::UnregisterComponents(void)
+{
+	size_t size = m_components.size();
+	for (size_t i = 0; i < size; ++i)
+		m_components[i]->Unregister();
+}
+/******************************************************************************/
+/*!
+Moves the object based on its velocity and rotational velocity.
+
+\param [in] dt
+The time in seconds since the last frame.
+*/
+/******************************************************************************/
+void M5Object::Integrate(float dt)
+{
 	pos.x += vel.x * dt;
 	pos.y += vel.y * dt;
 	rotation += rotationVel * dt;
@@ -164,6 +240,9 @@ void M5Object::AddComponent(M5Component* pComponent)
 	//Set this object as the parent
 	pComponent->SetParent(this);
 	m_components.push_back(pComponent);
+
+	if (m_inSystems)
+		M5ObjectManager::RegisterComponent(pComponent);
 }
 /******************************************************************************/
 /*!
@@ -240,4 +319,110 @@ void M5Object::FromFile(M5IniFile& iniFile)
 	iniFile.GetValue("scaleY", scale.y);
 	iniFile.GetValue("rot", rotation);
 	iniFile.GetValue("rotVel", rotationVel);
-}
\ No newline at end of file
+}
+/******************************************************************************/
+/*!
+Saves the object data and the data of every component into a snapshot,
+including when each component updates next.  The id and ArcheType are saved
+by the M5ObjectManager.
+
+\param snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+void M5Object::Save(M5Snapshot& snapshot) const
+{
+	snapshot.Write(pos);
+	snapshot.Write(scale);
+	snapshot.Write(vel);
+	snapshot.Write(rotation);
+	snapshot.Write(rotationVel);
+	snapshot.Write(isDead);
+
+	size_t size = m_components.size();
+	snapshot.Write(size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		snapshot.Write(m_components[i]->m_type);
+		snapshot.Write(m_components[i]->m_untilUpdate);
+		snapshot.Write(m_components[i]->m_sinceUpdate);
+		m_components[i]->Save(snapshot);
+	}
+}
+/******************************************************************************/
+/*!
+Saves the replicated data of every component into a snapshot.  The object
+data is quantized by M5ReplicaWorld, so it isn't written here.
+
+\param snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+void M5Object::Replicate(M5Snapshot& snapshot) const
+{
+	size_t size = m_components.size();
+	for (size_t i = 0; i < size; ++i)
+		m_components[i]->Replicate(snapshot);
+}
+/******************************************************************************/
+/*!
+Restores the object data and components from a snapshot.  Components that still
+match the saved ones are restored in place.  If the components have changed
+since the save, the rest are rebuilt from the component factory.
+
+\param snapshot
+The snapshot to read from.
+*/
+/******************************************************************************/
+void M5Object::Load(M5Snapshot& snapshot)
+{
+	snapshot.Read(pos);
+	snapshot.Read(scale);
+	snapshot.Read(vel);
+	snapshot.Read(rotation);
+	snapshot.Read(rotationVel);
+	snapshot.Read(isDead);
+
+	size_t size;
+	snapshot.Read(size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		M5ComponentTypes type;
+		float untilUpdate;
+		float sinceUpdate;
+		snapshot.Read(type);
+		snapshot.Read(untilUpdate);
+		snapshot.Read(sinceUpdate);
+
+		if (i < m_components.size() && m_components[i]->m_type == type)
+		{
+			m_components[i]->m_untilUpdate = untilUpdate;
+			m_components[i]->m_sinceUpdate = sinceUpdate;
+			m_components[i]->Load(snapshot);
+			continue;
+		}
+
+		//The components changed, so remove everything from here on
+		while (m_components.size() > i)
+		{
+			delete m_components.back();
+			m_components.pop_back();
+		}
+
+		//Clone so the new component registers with the engine like normal
+		M5Component* pTemp = M5ObjectManager::CreateComponent(type);
+		pTemp->Load(snapshot);
+		M5Component* pNew = pTemp->Clone();
+		pNew->m_untilUpdate = untilUpdate;
+		pNew->m_sinceUpdate = sinceUpdate;
+		AddComponent(pNew);
+		delete pTemp;
+	}
+
+	//Remove components that were added after the save
+	while (m_components.size() > size)
+	{
+		delete m_components.back();
+		m_components.pop_back();
+	}
+}
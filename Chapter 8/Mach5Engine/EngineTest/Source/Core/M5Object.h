@@ -15,18 +15,23 @@
 #include "M5Vec2.h"
 #include "M5ComponentTypes.h"
 #include "M5ArcheTypes.h"
+#include "M5Component.h" /*GetComponent calls GetType*/
 #include <vector>
 
 //Forward Declarations
-class M5Component;
 class M5IniFile;
+class M5Snapshot;
 
 //! Component based Game object used in the Mach 5 Engine
 class M5Object
 {
 public:
+	friend class M5ObjectManager;
+
 	M5Object(M5ArcheTypes type);
 	~M5Object(void);
+	static void* operator new(size_t size);
+	static void  operator delete(void* pMemory);
 
 	void         Update(float dt);
 	void         AddComponent(M5Component* pComponent);
@@ -34,6 +39,9 @@ public:
 	void         RemoveAllComponents(void);
 	void         RemoveAllComponents(M5ComponentTypes type);
 	void         FromFile(M5IniFile& iniFile);
+	void         Save(M5Snapshot& snapshot) const;
+	void         Load(M5Snapshot& snapshot);
+	void         Replicate(M5Snapshot& snapshot) const;
 	int          GetID(void) const;
 	M5ArcheTypes GetType(void) const;
 	M5Object*    Clone(void) const;
@@ -52,13 +60,17 @@ public:
 	bool         isDead;      //!< flag to control when a game object should be destroyed
 private:
 	M5Object(const M5Object& rhs) = delete;
+	void RemoveDeadComponents(void);
+	void Integrate(float dt);
+	void UnregisterComponents(void);
 
 	typedef std::vector<M5Component*> ComponentVec; //!< Typedef for my Vector of Components
 	typedef ComponentVec::iterator VecItor;         //!< Typedef for my container iterator
 
 	ComponentVec m_components;                      //!< Vector of Components to Update
 	const M5ArcheTypes m_type;                            //!< The ArcheType of the Game Object
-	const int    m_id;                              //!< Unique ID of the Game Object
+	int          m_id;                              //!< Unique ID of the Game Object, only changed by M5ObjectManager::Restore
+	bool         m_inSystems;                       //!< True if the components are in the type based update
 	static int   s_objectIDCounter;                 //!< Shared ID counter for all Game Objects 
 
 };
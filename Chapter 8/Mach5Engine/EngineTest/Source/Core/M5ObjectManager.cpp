@@ -16,50 +16,137 @@ game objects.
 #include "M5Command.h"
 #include "M5Debug.h"
 #include "M5IniFile.h"
+#include "M5Gfx.h"
+#include "M5Log.h"
 #include "../RegisterComponents.h"
 #include "../RegisterArcheTypes.h"
 #include "../RegisterCommands.h"
 
 #include "M5Component.h"
 #include "M5ComponentBuilder.h"
-#include "M5Factory.h"
+#include "M5ComponentPool.h"
 #include "M5CommandTypes.h"
+#include "M5Snapshot.h"
+#include "M5ReplicaWorld.h"
 
 #include <vector>
+#include <algorithm>
 #include <stack>
+#include <deque>
 #include <unordered_map>
 #include <string>
 #include <sstream>
+#include <chrono>
+#include <climits>
+#include <thread>
+#include <atomic>
 
 namespace
 {
 typedef std::vector<M5Object*>           ObjectVec;    //!< typedef Container to hold all game objects
 typedef ObjectVec::iterator              VecItor;      //!< typdef Iterator for object container
-typedef std::unordered_map<M5ArcheTypes, 
-	                       M5Object*>    ArcheTypeMap; //!< typedef Container to hold prototypes objects
-typedef ArcheTypeMap::iterator           ArcheTypeItor;//!< typedef Iterator for archetype map
-typedef std::unordered_map<M5CommandTypes,
-	                       M5Command*>   CommandMap;   //!< typedef containter to hold prototype commands
-typedef CommandMap::iterator             CommandMapItor;//!< typdef iterator for the command map
-typedef M5Factory<M5ComponentTypes, 
-	    M5ComponentBuilder, 
-	    M5Component>                    ComponentFactory;
+typedef std::unordered_map<int,
+	                       M5Object*>    ObjectIDMap;  //!< typedef Container to find objects by id
+typedef std::vector<M5Component*>        ComponentVec; //!< typedef Container for components of one type
+typedef std::deque<M5Object*>            ObjectQueue;  //!< typedef Container for objects waiting to be deleted
+
+//! All active components of one type, so they can be updated together
+struct M5System
+{
+	ComponentVec        components; //!< Every component of this type in an active object
+	int                 start;      //!< The value to start updating the components from
+};
+
+//! The start of every M5System, saved when the object manager is paused
+struct M5SystemStarts
+{
+	int start[CT_INVALID]; //!< The start of each M5System
+};
 
 const int START_SIZE = 100;                                      //!< Starting alloc count of object pointers
+const float DESTROY_TIME = .002f;                                //!< Default seconds per frame for deleting objects
 
 
- ComponentFactory   s_componentFactory;                    //!< Factory of all registered components
- ArcheTypeMap       s_archetypes;                          //!< Map of active archetypes in game
- CommandMap         s_commands;                            //!< Map of active commands in the game
+ const M5ComponentBuilder* s_pComponentBuilders;           //!< Generated builders indexed by M5ComponentTypes
+ const M5CommandBuilder*   s_pCommandBuilders;             //!< Generated builders indexed by M5CommandTypes
+ M5Object*          s_archetypes[AT_INVALID];              //!< Prototype of each archetype, 0 until loaded
  ObjectVec          s_objects;                             //!< Vector of active objects in game    
  int                s_objectStart;                         //!< The value to start updating the object list from.
  std::stack<int>    s_pauseStack;
+ ObjectIDMap        s_restoreMap;                          //!< Reused by Restore so it doesn't allocate
+ ObjectVec          s_restored;                            //!< Reused by Restore so it doesn't allocate
+ ObjectVec          s_deadComponentObjs;                   //!< Reused by UpdateSystems for objects with dead components
+ M5System           s_systems[CT_INVALID];                 //!< Components by type for the type based update
+ std::stack<M5SystemStarts> s_systemPauseStack;            //!< Saved M5System starts for each pause
+ bool               s_useSystems;                          //!< True if components are updated by type
+ bool               s_useUpdateRates = true;               //!< False to update every component every frame
+ bool               s_hasEvent[CT_INVALID];                //!< True for UPDATE_ON_EVENT types with an event this frame
+ float              s_updateTime;                          //!< How long the last Update took in seconds
+ int                s_frameCount;                          //!< The number of times Update has run
+ ObjectQueue        s_destroyQueue;                        //!< Destroyed objects waiting to be deleted
+ float              s_destroyTimeBudget = DESTROY_TIME;    //!< Max seconds per frame for deleting objects
+ int                s_destroyCountBudget = INT_MAX;        //!< Max objects per frame to delete
+ float              s_destroyTime;                         //!< Seconds spent deleting objects last frame
+ std::vector<M5ArcheTypeFile> s_archeTypeFiles;            //!< Archetypes added by RegisterArcheTypes, loaded together
+ bool               s_isRegistering;                       //!< True while RegisterArcheTypes is adding archetypes
+ int                s_loadThreads;                         //!< Threads that read archetype files, 0 for one per core
+ float              s_archeTypeLoadTime;                   //!< Seconds it took to load the archetypes at startup
+
+/******************************************************************************/
+/*!
+Runs on each load thread.  Takes the next file nobody has read until there are
+none left, reads it and decodes the texture its GfxComponent will load, so
+building the prototype later only has to give the pixels to the GFX API.
+
+\param [in] pFiles
+The files to read.
+
+\param [in] pNext
+The index of the next file nobody has taken.
+*/
+/******************************************************************************/
+void ReadArcheTypeFiles(std::vector<M5ArcheTypeFile>* pFiles, std::atomic<int>* pNext)
+{
+	int size = static_cast<int>(pFiles->size());
+	for (int i = (*pNext)++; i < size; i = (*pNext)++)
+	{
+		M5IniFile& file = (*pFiles)[i].file;
+		file.ReadFile((*pFiles)[i].fileName);
+
+		std::string components;
+		file.GetValue("components", components);
+		if (components.find("GfxComponent") == std::string::npos)
+			continue;
+
+		std::string texture;
+		file.SetToSection("GfxComponent");
+		file.GetValue("texture", texture);
+		file.SetToSection("");
+		M5Gfx::PrefetchTexture(("Textures/" + texture).c_str());
+	}
+}
+/******************************************************************************/
+/*!
+Tells graphics about an object that was just moved by its velocity, so only
+objects that move have their culling cell checked.
+
+\param [in] pObj
+The object that was just integrated.
+*/
+/******************************************************************************/
+void MarkIfMoving(M5Object* pObj)
+{
+	if (pObj->vel.x != 0 || pObj->vel.y != 0)
+		M5Gfx::MarkMoved(pObj);
+}
 }//end unnamed namespace
 
  /******************************************************************************/
  /*!
    Init function for the M5ObjectMangager.  This function reserves space for
-   objects as well as Registers all M5Components.
+   objects and loads the archetypes.  The component and command builders are
+   generated tables, so there is nothing to register.  The archetypes are
+   only queued while RegisterArcheTypes runs, then loaded all at once.
  */
  /******************************************************************************/
 void M5ObjectManager::Init(void)
@@ -68,10 +155,113 @@ void M5ObjectManager::Init(void)
 	s_objects.reserve(START_SIZE);
 	s_objectStart = 0;
 
-	//We must register components before we can create our prototypes
-	RegisterCommands();
-	RegisterComponents();
+	//We must have the builders before we can create our prototypes
+	s_pComponentBuilders = GetComponentBuilders();
+	s_pCommandBuilders = GetCommandBuilders();
+
+	s_isRegistering = true;
 	RegisterArcheTypes();
+	s_isRegistering = false;
+	LoadArcheTypes();
+}
+/******************************************************************************/
+/*!
+Loads every archetype queued by RegisterArcheTypes.  The files are read and
+their textures decoded on the load threads, then the prototypes are built on
+this thread in the order they were added, so textures are made in the GFX API
+in the same order on every run.
+*/
+/******************************************************************************/
+void M5ObjectManager::LoadArcheTypes(void)
+{
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	int threadCount = ReadArcheTypes(s_archeTypeFiles);
+	size_t size = s_archeTypeFiles.size();
+	for (size_t i = 0; i < size; ++i)
+	{
+		M5ArcheTypeFile& archeType = s_archeTypeFiles[i];
+		M5DEBUG_ASSERT(s_archetypes[archeType.type] == 0, "Trying to add a prototype that already exists");
+		s_archetypes[archeType.type] = BuildArcheType(archeType.type, archeType.file);
+	}
+	std::vector<M5ArcheTypeFile>().swap(s_archeTypeFiles);
+
+	s_archeTypeLoadTime = std::chrono::duration<float>(
+		std::chrono::high_resolution_clock::now() - start).count();
+	M5Log::Write(LL_INFO, LC_OBJECTS, "M5ObjectManager: loaded %d archetypes in %.1f ms on %d threads",
+		static_cast<int>(size), s_archeTypeLoadTime * 1000.0f, threadCount);
+}
+/******************************************************************************/
+/*!
+Reads archetype files and decodes the textures of their GfxComponents.  The
+files are shared between the load threads, and this thread reads them too.
+This is safe to call from a loading thread, since it never touches the GFX
+API or the prototypes.
+
+\param [in,out] files
+The files to read.  The contents of each is put in its M5IniFile.
+
+\return
+The number of threads that read files.
+*/
+/******************************************************************************/
+int M5ObjectManager::ReadArcheTypes(std::vector<M5ArcheTypeFile>& files)
+{
+	int size = static_cast<int>(files.size());
+	int threadCount = s_loadThreads;
+	if (threadCount <= 0)
+		threadCount = static_cast<int>(std::thread::hardware_concurrency());
+	threadCount = std::max(1, std::min(threadCount, size));
+
+	std::atomic<int> next(0);
+	std::vector<std::thread> threads;
+	for (int i = 1; i < threadCount; ++i)
+		threads.push_back(std::thread(ReadArcheTypeFiles, &files, &next));
+
+	ReadArcheTypeFiles(&files, &next);
+	for (size_t i = 0; i < threads.size(); ++i)
+		threads[i].join();
+
+	return threadCount;
+}
+/******************************************************************************/
+/*!
+Sets how many threads read archetype files.  To change the threads used at
+startup, this must be called before M5App::Init.
+
+\param [in] threadCount
+The number of threads, including the calling thread.  0 uses one per core.
+*/
+/******************************************************************************/
+void M5ObjectManager::SetLoadThreads(int threadCount)
+{
+	M5DEBUG_ASSERT(threadCount >= 0, "The load thread count can't be negative");
+	s_loadThreads = threadCount;
+}
+/******************************************************************************/
+/*!
+Gets how many threads read archetype files.
+
+\return
+The number of threads, or 0 for one per core.
+*/
+/******************************************************************************/
+int M5ObjectManager::GetLoadThreads(void)
+{
+	return s_loadThreads;
+}
+/******************************************************************************/
+/*!
+Gets the time it took to read the archetype files and build the prototypes
+at startup.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+float M5ObjectManager::GetArcheTypeLoadTime(void)
+{
+	return s_archeTypeLoadTime;
 }
 /******************************************************************************/
 /*!
@@ -83,56 +273,181 @@ void M5ObjectManager::Shutdown(void)
 	M5DEBUG_CALL_CHECK(1);
 	s_objectStart = 0;
 	DestroyAllObjects();
+	FlushDestroyQueue();
 
 	//Delete prototypes
-	ArcheTypeItor archeTypeStart = s_archetypes.begin();
-	ArcheTypeItor archeTypeEnd = s_archetypes.end();
-
-	while (archeTypeStart != archeTypeEnd)
+	for (int i = 0; i < AT_INVALID; ++i)
 	{
-		delete archeTypeStart->second;
-		archeTypeStart->second = 0;
-		++archeTypeStart;
+		delete s_archetypes[i];
+		s_archetypes[i] = 0;
 	}
 
-	CommandMapItor commandStart = s_commands.begin();
-	CommandMapItor commandEnd = s_commands.end();
+	//Every component is deleted, so the pools can give back their memory
+	M5ComponentPool::Shutdown();
+}
+/******************************************************************************/
+/*!
+Deletes some of the objects destroyed in earlier frames, then updates all game
+objects.  Only the update is timed for GetUpdateTime, the deleting is timed for
+GetDestroyTime.
+
+\param [in] dt
+The time in seconds since the last frame.
+*/
+/******************************************************************************/
+void M5ObjectManager::Update(float dt)
+{
+	++s_frameCount;
+	UpdateDestroyQueue();
+
+	std::chrono::high_resolution_clock::time_point start =
+		std::chrono::high_resolution_clock::now();
 
-	while (commandStart != commandEnd)
+	CheckEvents();
+	if (s_useSystems)
 	{
-		delete commandStart->second;
-		commandStart->second = 0;
-		++commandStart;
+		UpdateSystems(dt);
 	}
+	else
+	{
+		for (size_t i = s_objectStart; i < s_objects.size(); ++i)
+		{
+			if (s_objects[i]->isDead)
+			{
+				QueueDestroy(s_objects[i]);
+				s_objects[i] = s_objects[s_objects.size() - 1];
+				s_objects.pop_back();
+				--i;//so that we can update the shifted object 
+			}
+			else
+			{
+				s_objects[i]->Update(dt);
+				MarkIfMoving(s_objects[i]);
+			}
+		}
+	}
+
+	std::chrono::duration<float> time = std::chrono::high_resolution_clock::now() - start;
+	s_updateTime = time.count();
 }
 /******************************************************************************/
 /*!
-Updates all game objects
+Updates all components one type at a time, in the order of M5ComponentTypes.
+Every component of a type is updated in one loop without virtual calls, and
+types with an empty Update are skipped.  Types with an M5UpdateRate only update
+the components whose turn it is.
+
+Components only mark themselves dead in their own Update, so dead components
+are found by walking the lists that were just updated, which sit together in
+the M5ComponentPool, instead of going through every object.  The object list
+is only walked once, after every system, to remove dead objects and move the
+live ones.  An object that died since the last frame has its components
+updated one more time, the same as an object that dies during this update.
 
 \param [in] dt
 The time in seconds since the last frame.
 */
 /******************************************************************************/
-void M5ObjectManager::Update(float dt)
+void M5ObjectManager::UpdateSystems(float dt)
 {
+	for (int i = 0; i < CT_INVALID; ++i)
+	{
+		const M5ComponentBuilder& builder = s_pComponentBuilders[i];
+		if (!builder.hasUpdate)
+			continue;
+
+		if (builder.updateRate == UPDATE_EVERY_FRAME || !s_useUpdateRates)
+			builder.UpdateAll(s_systems[i].components, s_systems[i].start, dt);
+		else
+			builder.UpdateDue(s_systems[i].components, s_systems[i].start, dt);
+	}
+
+	//Deleting a component changes the lists, so find the objects first
+	s_deadComponentObjs.clear();
+	for (int i = 0; i < CT_INVALID; ++i)
+	{
+		if (!s_pComponentBuilders[i].hasUpdate)
+			continue;
+
+		const ComponentVec& components = s_systems[i].components;
+		for (size_t j = s_systems[i].start; j < components.size(); ++j)
+		{
+			if (components[j]->isDead)
+				s_deadComponentObjs.push_back(components[j]->m_pObj);
+		}
+	}
+	for (size_t i = 0; i < s_deadComponentObjs.size(); ++i)
+		s_deadComponentObjs[i]->RemoveDeadComponents();
+
 	for (size_t i = s_objectStart; i < s_objects.size(); ++i)
 	{
 		if (s_objects[i]->isDead)
 		{
-			delete s_objects[i];
+			QueueDestroy(s_objects[i]);
 			s_objects[i] = s_objects[s_objects.size() - 1];
 			s_objects.pop_back();
-			--i;//so that we can update the shifted object 
+			--i;//so that we can check the shifted object 
 		}
 		else
 		{
-			s_objects[i]->Update(dt);
+			s_objects[i]->Integrate(dt);
+			MarkIfMoving(s_objects[i]);
 		}
 	}
 }
 /******************************************************************************/
 /*!
-Function to delete all currently active game objects.
+Asks every UPDATE_ON_EVENT component type once if it has an event this frame,
+so each component doesn't have to ask.
+*/
+/******************************************************************************/
+void M5ObjectManager::CheckEvents(void)
+{
+	for (int i = 0; i < CT_INVALID; ++i)
+	{
+		const M5ComponentBuilder& builder = s_pComponentBuilders[i];
+		s_hasEvent[i] = builder.updateRate == UPDATE_ON_EVENT && builder.HasEvent();
+	}
+}
+/******************************************************************************/
+/*!
+Checks if an UPDATE_ON_EVENT component type has an event this frame.
+
+\param [in] type
+The type of component.
+
+\return
+True if components of the type should update this frame.
+*/
+/******************************************************************************/
+bool M5ObjectManager::HasEvent(M5ComponentTypes type)
+{
+	return s_hasEvent[type];
+}
+/******************************************************************************/
+/*!
+Gets the time between updates for a component type, from its M5UpdateRate.
+
+\param [in] type
+The type of component.
+
+\return
+The seconds between updates, 0 for every frame or less than 0 for on event.
+*/
+/******************************************************************************/
+float M5ObjectManager::GetUpdateInterval(M5ComponentTypes type)
+{
+	//Components can't be made before the builders are set, but check anyway
+	if (s_pComponentBuilders == 0)
+		return 0;
+
+	float rate = s_pComponentBuilders[type].updateRate;
+	return (rate > 0) ? 1.0f / rate : rate;
+}
+/******************************************************************************/
+/*!
+Function to delete all currently active game objects.  The objects are removed
+right away, but deleted over the next few frames.
 
 \param destroyPause
 A flag to know if we should even destroy objects int the paused stage
@@ -145,7 +460,7 @@ void M5ObjectManager::DestroyAllObjects(bool destroyPaused /*= false*/)
 		int size = s_objects.size();
 		for (int i = 0; i < size; ++i)
 		{
-			delete s_objects[i];
+			QueueDestroy(s_objects[i]);
 			s_objects[i] = 0;
 		}
 
@@ -156,7 +471,7 @@ void M5ObjectManager::DestroyAllObjects(bool destroyPaused /*= false*/)
 		int size = s_objects.size();
 		for (int i = size - 1; i >= s_objectStart; --i)
 		{
-			delete s_objects[i];
+			QueueDestroy(s_objects[i]);
 			s_objects[i] = 0;
 			s_objects.pop_back();
 		}
@@ -176,7 +491,7 @@ void M5ObjectManager::DestroyAllObjects(M5ArcheTypes type)
 	{
 		if (s_objects[i]->GetType() == type)
 		{
-			delete s_objects[i];
+			QueueDestroy(s_objects[i]);
 			s_objects[i] = s_objects[s_objects.size() - 1];
 			s_objects.pop_back();
 		}
@@ -195,11 +510,12 @@ A new object of the given M5ArcheTypes type.
 /******************************************************************************/
 M5Object* M5ObjectManager::CreateObject(M5ArcheTypes type)
 {
-	ArcheTypeItor found = s_archetypes.find(type);
-	M5DEBUG_ASSERT(found != s_archetypes.end(), "Trying to create and Archetype that doesn't exist");
+	M5DEBUG_ASSERT(type >= 0 && type < AT_INVALID && s_archetypes[type] != 0,
+		"Trying to create and Archetype that doesn't exist");
 
-	M5Object* pClone = found->second->Clone();
+	M5Object* pClone = s_archetypes[type]->Clone();
 	s_objects.push_back(pClone);
+	RegisterObject(pClone);
 	return pClone;
 
 }
@@ -217,6 +533,7 @@ void M5ObjectManager::AddObject(M5Object* pToAdd)
 	M5DEBUG_ASSERT(found == s_objects.end(), "Trying to Add an Object that already exists");
 
 	s_objects.push_back(pToAdd);
+	RegisterObject(pToAdd);
 }
 /******************************************************************************/
 /*!
@@ -239,7 +556,7 @@ void M5ObjectManager::DestroyObject(M5Object* pToDestroy)
 	VecItor itor = std::find(s_objects.begin() + s_objectStart, s_objects.end(), pToDestroy);
 	M5DEBUG_ASSERT(itor != s_objects.end(), "Trying to destroy an object that doesn't exist");
 
-	delete *itor;
+	QueueDestroy(*itor);
 	std::iter_swap(itor, --s_objects.end());
 	s_objects.pop_back();
 }
@@ -257,7 +574,7 @@ void M5ObjectManager::DestroyObject(int objectID)
 	{
 		if (s_objects[i]->GetID() == objectID)
 		{
-			delete s_objects[i];
+			QueueDestroy(s_objects[i]);
 			s_objects[i] = s_objects[s_objects.size() - 1];
 			s_objects.pop_back();
 		}
@@ -265,6 +582,35 @@ void M5ObjectManager::DestroyObject(int objectID)
 }
 /******************************************************************************/
 /*!
+Finds many objects by ID and deletes them with one pass over the objects,
+instead of one pass for each ID.  IDs that aren't found are ignored, so this
+is safe to call with objects that may already be destroyed.
+
+\param [in] objectIDs
+The IDs of the objects to delete, sorted smallest first.
+*/
+/******************************************************************************/
+void M5ObjectManager::DestroyObjects(const std::vector<int>& objectIDs)
+{
+	M5DEBUG_ASSERT(std::is_sorted(objectIDs.begin(), objectIDs.end()), "Object IDs must be sorted");
+
+	size_t i = s_objectStart;
+	while (i < s_objects.size())
+	{
+		if (std::binary_search(objectIDs.begin(), objectIDs.end(), s_objects[i]->GetID()))
+		{
+			QueueDestroy(s_objects[i]);
+			s_objects[i] = s_objects[s_objects.size() - 1];
+			s_objects.pop_back();
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+/******************************************************************************/
+/*!
 Finds the first object of the specifed type returns it via the parameter
 
 \param [in] type
@@ -337,7 +683,9 @@ void M5ObjectManager::GetAllObjectsByType(M5ArcheTypes type, std::vector<M5Objec
 }
 /******************************************************************************/
 /*!
-Creates a component of the given type
+Creates a component of the given type in the M5ComponentPool of that type.
+The builder is found by indexing the generated table, so there is no hashing
+or virtual call.
 
 \param [in] type
 The type of component to Create
@@ -345,38 +693,13 @@ The type of component to Create
 /******************************************************************************/
 M5Component* M5ObjectManager::CreateComponent(M5ComponentTypes type)
 {
-	return s_componentFactory.Build(type);
-}
-/******************************************************************************/
-/*!
-  Adds a component to the M5ObjectManager component factory.
-
-  \param [in] type
-  The component type to associate with the pBuilder.
-
-  \param [in] pBuilder
-  The M5ComponentBuilder to use when creating new component of the given type.
-*/
-/******************************************************************************/
-void M5ObjectManager::AddComponent(M5ComponentTypes type, M5ComponentBuilder* pBuilder)
-{
-	s_componentFactory.AddBuilder(type, pBuilder);
-}
-/******************************************************************************/
-/*!
-Removes a component and deletes the builder associated with the component type.
-
-\param [in] type
-The component type to remove
-*/
-/******************************************************************************/
-void M5ObjectManager::RemoveComponent(M5ComponentTypes type)
-{
-	s_componentFactory.RemoveBuilder(type);
+	M5DEBUG_ASSERT(type >= 0 && type < CT_INVALID, "Trying to create a component that doesn't exist");
+	return s_pComponentBuilders[type].Build(type);
 }
 /******************************************************************************/
 /*!
-Adds and Archetype from an ini file.
+Adds and Archetype from an ini file.  While RegisterArcheTypes is running, the
+archetype is only queued so Init can load them all together.
 
 \param [in] type
 The type archetype to associate with the given file.
@@ -387,13 +710,38 @@ The of an ini file that will load data bout the archetype
 /******************************************************************************/
 void M5ObjectManager::AddArcheType(M5ArcheTypes type, const char* fileName)
 {
-	ArcheTypeItor found = s_archetypes.find(type);
-	M5DEBUG_ASSERT(found == s_archetypes.end(), "Trying to add a prototype that already exists");
+	M5DEBUG_ASSERT(type >= 0 && type < AT_INVALID, "Trying to add a prototype that doesn't exist");
+	M5DEBUG_ASSERT(s_archetypes[type] == 0, "Trying to add a prototype that already exists");
+
+	if (s_isRegistering)
+	{
+		M5ArcheTypeFile archeType;
+		archeType.type = type;
+		archeType.fileName = fileName;
+		s_archeTypeFiles.push_back(archeType);
+		return;
+	}
 
 	M5IniFile file;//My inifile to open	
 	file.ReadFile(fileName);
+	s_archetypes[type] = BuildArcheType(type, file);
+}
+/******************************************************************************/
+/*!
+Builds a prototype from an archetype file that was already read.
 
+\param [in] type
+The type of archetype being built.
+
+\param [in] file
+The contents of the archetype file.
 
+\return
+The new prototype.  The caller must add it to the prototype table.
+*/
+/******************************************************************************/
+M5Object* M5ObjectManager::BuildArcheType(M5ArcheTypes type, M5IniFile& file)
+{
 	M5Object* pObj = new M5Object(type);
 	pObj->FromFile(file);
 
@@ -406,17 +754,16 @@ void M5ObjectManager::AddArcheType(M5ArcheTypes type, const char* fileName)
 	//Loop through the stream and get each component name
 	while (ss >> name)
 	{
-		M5Component* pComp = s_componentFactory.Build(StringToComponent(name));
+		M5Component* pComp = CreateComponent(StringToComponent(name));
 		pComp->FromFile(file);
 		pObj->AddComponent(pComp);
 	}
 
-	//Add the prototype to the prototype map
-	s_archetypes.insert(std::make_pair(type, pObj));
+	return pObj;
 }
 /******************************************************************************/
 /*!
-Removes and deletes the associated Archetype from the prototype map.
+Removes and deletes the associated Archetype from the prototype table.
 
 \param [in] type
 The archetype to remove and delete
@@ -424,11 +771,10 @@ The archetype to remove and delete
 /******************************************************************************/
 void M5ObjectManager::RemoveArcheType(M5ArcheTypes type)
 {
-	ArcheTypeItor found = s_archetypes.find(type);
-	M5DEBUG_ASSERT(found != s_archetypes.end(), "Trying to Remove a prototype that doesn't exist");
-	delete found->second;
-	found->second = 0;
-	s_archetypes.erase(found);
+	M5DEBUG_ASSERT(type >= 0 && type < AT_INVALID && s_archetypes[type] != 0,
+		"Trying to Remove a prototype that doesn't exist");
+	delete s_archetypes[type];
+	s_archetypes[type] = 0;
 }
 /******************************************************************************/
 /*!
@@ -441,62 +787,447 @@ The command to create
 /******************************************************************************/
 M5Command* M5ObjectManager::CreateCommand(M5CommandTypes type)
 {
-	CommandMapItor itor = s_commands.find(type);
-	M5DEBUG_ASSERT(itor != s_commands.end(), "Tring to Create a command that doesn't exist");
+	M5DEBUG_ASSERT(type >= 0 && type < CMD_INVALID, "Tring to Create a command that doesn't exist");
+	return s_pCommandBuilders[type]();
+}
+/******************************************************************************/
+/*!
+Stops Updating all objects creating up to this point.
+*/
+/******************************************************************************/
+void M5ObjectManager::Pause(void)
+{
+	s_pauseStack.push(s_objectStart);
+	s_objectStart = s_objects.size();
+
+	M5SystemStarts starts;
+	for (int i = 0; i < CT_INVALID; ++i)
+	{
+		starts.start[i] = s_systems[i].start;
+		s_systems[i].start = static_cast<int>(s_systems[i].components.size());
+	}
+	s_systemPauseStack.push(starts);
+}
+/******************************************************************************/
+/*!
+Resumes updating objects created before the last pause.
+*/
+/******************************************************************************/
+void M5ObjectManager::Resume(void)
+{
+	s_objectStart = s_pauseStack.top();
+	s_pauseStack.pop();
 
-	return itor->second->Clone();
+	const M5SystemStarts& starts = s_systemPauseStack.top();
+	for (int i = 0; i < CT_INVALID; ++i)
+		s_systems[i].start = starts.start[i];
+	s_systemPauseStack.pop();
 }
 /******************************************************************************/
 /*!
-Adds a cloneable command to the object manager.  Note that the M5ObjectManager
-will delete the given command.
+Saves the state of all active objects and their components into a snapshot.
+Paused objects are not saved.
 
-\param [in] type
-The command to add
+\param [out] snapshot
+The snapshot to fill.  Any old data is removed.
+*/
+/******************************************************************************/
+void M5ObjectManager::Snapshot(M5Snapshot& snapshot)
+{
+	snapshot.Clear();
+
+	size_t count = s_objects.size() - s_objectStart;
+	snapshot.Write(count);
+	for (size_t i = s_objectStart; i < s_objects.size(); ++i)
+	{
+		snapshot.Write(s_objects[i]->m_id);
+		snapshot.Write(s_objects[i]->m_type);
+		s_objects[i]->Save(snapshot);
+	}
+}
+/******************************************************************************/
+/*!
+Restores all active objects to the state in the snapshot.  Objects that still
+exist are restored in place.  Objects that were destroyed since the save are
+cloned from their ArcheType and restored with the ID they had, so IDs held by
+other code still find them.  Objects created since the save are destroyed.
 
-\param [in] pCommand
-The M5Command that will be cloned.
+\param [in] snapshot
+The snapshot to read from.  It can be restored again later.
 */
 /******************************************************************************/
-void M5ObjectManager::AddCommand(M5CommandTypes type, M5Command* pCommand)
+void M5ObjectManager::Restore(M5Snapshot& snapshot)
 {
-	CommandMapItor itor = s_commands.find(type);
-	M5DEBUG_ASSERT(itor == s_commands.end(), "Tring to Create a command that alraedy exist");
-	s_commands.insert(std::make_pair(type, pCommand));
+	snapshot.Rewind();
+
+	size_t count;
+	snapshot.Read(count);
+	s_restored.clear();
+	s_restored.reserve(count);
+
+	/*Objects are usually still in the order they were saved, so they are only
+	looked up by id after the first one that isn't*/
+	size_t next = s_objectStart;
+	bool useMap = false;
+	s_restoreMap.clear();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		int id;
+		M5ArcheTypes type;
+		snapshot.Read(id);
+		snapshot.Read(type);
+
+		M5Object* pObj = 0;
+		if (!useMap && next < s_objects.size() && s_objects[next]->m_id == id)
+		{
+			pObj = s_objects[next];
+			++next;
+		}
+		else
+		{
+			if (!useMap)
+			{
+				//Find the objects that haven't been restored yet by id
+				for (size_t j = next; j < s_objects.size(); ++j)
+					s_restoreMap.insert(std::make_pair(s_objects[j]->GetID(), s_objects[j]));
+				useMap = true;
+			}
+
+			ObjectIDMap::iterator found = s_restoreMap.find(id);
+			if (found != s_restoreMap.end())
+			{
+				pObj = found->second;
+				s_restoreMap.erase(found);
+			}
+			else
+			{
+				M5DEBUG_ASSERT(type >= 0 && type < AT_INVALID && s_archetypes[type] != 0,
+					"Trying to restore an Archetype that doesn't exist");
+				pObj = s_archetypes[type]->Clone();
+				pObj->m_id = id;
+			}
+		}
+
+		M5Vec2 oldPos = pObj->pos;
+		M5Vec2 oldScale = pObj->scale;
+		pObj->Load(snapshot);
+		if (pObj->pos.x != oldPos.x || pObj->pos.y != oldPos.y ||
+			pObj->scale.x != oldScale.x || pObj->scale.y != oldScale.y)
+		{
+			M5Gfx::MarkMoved(pObj);
+		}
+		if (!pObj->m_inSystems)
+			RegisterObject(pObj);
+		s_restored.push_back(pObj);
+	}
+
+	//Anything left was created after the save
+	if (useMap)
+	{
+		for (ObjectIDMap::iterator itor = s_restoreMap.begin(); itor != s_restoreMap.end(); ++itor)
+			QueueDestroy(itor->second);
+		s_restoreMap.clear();
+	}
+	else
+	{
+		for (size_t i = next; i < s_objects.size(); ++i)
+			QueueDestroy(s_objects[i]);
+	}
+
+	s_objects.resize(s_objectStart);
+	s_objects.insert(s_objects.end(), s_restored.begin(), s_restored.end());
 }
 /******************************************************************************/
 /*!
-Removes and deletes the associated Command from the M5ObjectManager
+Saves the state of all active objects into a replica world, so it can be sent
+to replication clients.  Dead objects are left out, so clients see them
+removed on the same frame.
 
-\param [in] type
-The archetype to remove and delete
+\param [in] world
+The world to fill.  Anything already in it is removed.
 */
 /******************************************************************************/
-void M5ObjectManager::RemoveCommand(M5CommandTypes type)
+void M5ObjectManager::Replicate(M5ReplicaWorld& world)
 {
-	CommandMapItor itor = s_commands.find(type);
-	M5DEBUG_ASSERT(itor != s_commands.end(), "Tring to delete a command that doesn't exist");
-	delete itor->second;
-	itor->second = nullptr;
-	s_commands.erase(itor);
+	world.Clear();
+	for (size_t i = s_objectStart; i < s_objects.size(); ++i)
+	{
+		if (!s_objects[i]->isDead)
+			world.AddObject(*s_objects[i]);
+	}
+	world.Sort();
 }
 /******************************************************************************/
 /*!
-Stops Updating all objects creating up to this point.
+Switches between updating each object and its components in turn, and updating
+all components of one type at a time.  The type based update keeps every
+component of a type in one list, so each loop runs the same code without
+virtual calls.  Components with an empty Update, see M5HasUpdate, are skipped.
+
+\attention
+This must be called while the object manager is not paused.
+
+\param [in] useSystems
+True to update components by type, false to update each object in turn.
 */
 /******************************************************************************/
-void M5ObjectManager::Pause(void)
+void M5ObjectManager::SetSystemUpdate(bool useSystems)
 {
-	s_pauseStack.push(s_objectStart);
-	s_objectStart = s_objects.size();
+	M5DEBUG_ASSERT(s_pauseStack.empty(), "The update mode can't be changed while paused");
+	if (useSystems == s_useSystems)
+		return;
+
+	s_useSystems = useSystems;
+	for (size_t i = 0; i < s_objects.size(); ++i)
+	{
+		if (useSystems)
+			RegisterObject(s_objects[i]);
+		else
+			UnregisterObject(s_objects[i]);
+	}
 }
 /******************************************************************************/
 /*!
-Resumes updating objects created before the last pause.
+Checks if components are updated one type at a time.
+
+\return
+True if components are updated by type, false if each object is updated in
+turn.
 */
 /******************************************************************************/
-void M5ObjectManager::Resume(void)
+bool M5ObjectManager::GetSystemUpdate(void)
 {
-	s_objectStart = s_pauseStack.top();
-	s_pauseStack.pop();
-}
\ No newline at end of file
+	return s_useSystems;
+}
+/******************************************************************************/
+/*!
+Turns the M5UpdateRate of each component type on or off.  When it is off, every
+component is updated every frame like before, which is useful for comparing
+the cost or checking if a bug comes from a slower rate.
+
+\param [in] useRates
+True to use the update rates, false to update everything every frame.
+*/
+/******************************************************************************/
+void M5ObjectManager::SetUpdateRates(bool useRates)
+{
+	s_useUpdateRates = useRates;
+}
+/******************************************************************************/
+/*!
+Checks if components are updated at the M5UpdateRate of their type.
+
+\return
+True if the update rates are used.
+*/
+/******************************************************************************/
+bool M5ObjectManager::GetUpdateRates(void)
+{
+	return s_useUpdateRates;
+}
+/******************************************************************************/
+/*!
+Gets the time the last Update took to update the objects.  This doesn't
+include deleting destroyed objects at the start of Update, use GetDestroyTime
+for that.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+float M5ObjectManager::GetUpdateTime(void)
+{
+	return s_updateTime;
+}
+/******************************************************************************/
+/*!
+Gets the number of times Update has run.  Components can use this to do work
+shared by their whole type only once per frame.
+
+\return
+The frame number.
+*/
+/******************************************************************************/
+int M5ObjectManager::GetFrameCount(void)
+{
+	return s_frameCount;
+}
+/******************************************************************************/
+/*!
+Adds all components of an active object to the type based update.  Components
+added to the object later are added by M5Object::AddComponent.
+
+\param [in] pObj
+The object to add.
+*/
+/******************************************************************************/
+void M5ObjectManager::RegisterObject(M5Object* pObj)
+{
+	if (!s_useSystems)
+		return;
+
+	pObj->m_inSystems = true;
+	size_t size = pObj->m_components.size();
+	for (size_t i = 0; i < size; ++i)
+		RegisterComponent(pObj->m_components[i]);
+}
+/******************************************************************************/
+/*!
+Removes all components of an object from the type based update.
+
+\param [in] pObj
+The object to remove.
+*/
+/******************************************************************************/
+void M5ObjectManager::UnregisterObject(M5Object* pObj)
+{
+	pObj->m_inSystems = false;
+	size_t size = pObj->m_components.size();
+	for (size_t i = 0; i < size; ++i)
+		UnregisterComponent(pObj->m_components[i]);
+}
+/******************************************************************************/
+/*!
+Adds a component to the list for its type.
+
+\param [in] pComp
+The component to add.
+*/
+/******************************************************************************/
+void M5ObjectManager::RegisterComponent(M5Component* pComp)
+{
+	M5DEBUG_ASSERT(pComp->m_systemIndex < 0, "Trying to add a component to the type based update twice");
+	ComponentVec& components = s_systems[pComp->GetType()].components;
+	pComp->m_systemIndex = static_cast<int>(components.size());
+	components.push_back(pComp);
+}
+/******************************************************************************/
+/*!
+Removes a component from the list for its type, by swapping it with the last
+component of that type.  This is called when a component is deleted.
+
+\param [in] pComp
+The component to remove.
+*/
+/******************************************************************************/
+void M5ObjectManager::UnregisterComponent(M5Component* pComp)
+{
+	if (pComp->m_systemIndex < 0)
+		return;
+
+	ComponentVec& components = s_systems[pComp->GetType()].components;
+	M5Component* pLast = components.back();
+	components[pComp->m_systemIndex] = pLast;
+	pLast->m_systemIndex = pComp->m_systemIndex;
+	components.pop_back();
+	pComp->m_systemIndex = -1;
+}
+/******************************************************************************/
+/*!
+Sets the budget for deleting destroyed objects each frame.  Destroyed objects
+are removed from the game right away, but deleting them can be slow, so only
+this many are deleted per frame.  At least one object is always deleted per
+frame so the queue can't grow forever.
+
+\param [in] maxTime
+The max seconds per frame to spend deleting objects.
+
+\param [in] maxCount
+The max number of objects to delete per frame.
+*/
+/******************************************************************************/
+void M5ObjectManager::SetDestroyBudget(float maxTime, int maxCount)
+{
+	s_destroyTimeBudget = maxTime;
+	s_destroyCountBudget = maxCount;
+}
+/******************************************************************************/
+/*!
+Gets the number of objects being updated.  Objects from paused stages are not
+counted.
+
+\return
+The number of active objects.
+*/
+/******************************************************************************/
+int M5ObjectManager::GetObjectCount(void)
+{
+	return static_cast<int>(s_objects.size()) - s_objectStart;
+}
+/******************************************************************************/
+/*!
+Gets the number of destroyed objects that haven't been deleted yet.
+
+\return
+The number of objects waiting to be deleted.
+*/
+/******************************************************************************/
+int M5ObjectManager::GetDestroyQueueSize(void)
+{
+	return static_cast<int>(s_destroyQueue.size());
+}
+/******************************************************************************/
+/*!
+Gets the time spent deleting objects at the start of the last Update.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+float M5ObjectManager::GetDestroyTime(void)
+{
+	return s_destroyTime;
+}
+/******************************************************************************/
+/*!
+Removes an object from the type based update and its components from the other
+engines, then queues it to be deleted.  The object must already be removed from
+the object list.
+
+\param [in] pObj
+The object to destroy.
+*/
+/******************************************************************************/
+void M5ObjectManager::QueueDestroy(M5Object* pObj)
+{
+	UnregisterObject(pObj);
+	pObj->UnregisterComponents();
+	s_destroyQueue.push_back(pObj);
+}
+/******************************************************************************/
+/*!
+Deletes objects from the destroy queue until the time or count budget is used.
+*/
+/******************************************************************************/
+void M5ObjectManager::UpdateDestroyQueue(void)
+{
+	std::chrono::high_resolution_clock::time_point start =
+		std::chrono::high_resolution_clock::now();
+	std::chrono::duration<float> time(0);
+
+	int count = 0;
+	while (!s_destroyQueue.empty() && (count == 0 ||
+		(count < s_destroyCountBudget && time.count() < s_destroyTimeBudget)))
+	{
+		delete s_destroyQueue.front();
+		s_destroyQueue.pop_front();
+		++count;
+		time = std::chrono::high_resolution_clock::now() - start;
+	}
+
+	s_destroyTime = time.count();
+}
+/******************************************************************************/
+/*!
+Deletes every object in the destroy queue, ignoring the budget.
+*/
+/******************************************************************************/
+void M5ObjectManager::FlushDestroyQueue(void)
+{
+	while (!s_destroyQueue.empty())
+	{
+		delete s_destroyQueue.front();
+		s_destroyQueue.pop_front();
+	}
+}
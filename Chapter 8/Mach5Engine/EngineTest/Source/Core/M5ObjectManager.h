@@ -13,17 +13,28 @@ game objects.
 #ifndef M5OBJECT_MANAGER_H
 #define M5OBJECT_MANAGER_H
 
-#include "M5ComponentFactory.h"
 #include "M5ComponentTypes.h"
 #include "M5CommandTypes.h"
 #include "M5ArcheTypes.h"
+#include "M5IniFile.h"
+#include <string>
 #include <vector>
 
 
 //Forward declarations
 class M5Object;
-class M5ComponentBuilder;
+class M5Component;
 class M5Command;
+class M5Snapshot;
+class M5ReplicaWorld;
+
+//! An archetype file to read, so many can be read at the same time
+struct M5ArcheTypeFile
+{
+	M5ArcheTypes type;     //!< The ArcheType the file is for
+	std::string  fileName; //!< The ini file to read
+	M5IniFile    file;     //!< The contents once it is read
+};
 
 //! Globally accessible static class for easy creation and destruction of game objects.
 class M5ObjectManager
@@ -31,6 +42,9 @@ class M5ObjectManager
 public:
 	friend class M5App;
 	friend class M5StageManager;
+	friend class M5Object;
+	friend class M5Component;
+	friend class M5Benchmark;
 
 	// Adds an user created object to the M5ObjectManager
 	static void AddObject(M5Object* toAdd);
@@ -40,6 +54,8 @@ public:
 	static void DestroyObject(M5Object* pToDestroy);
 	// Removes and deletes the object with the given object id
 	static void DestroyObject(int objectID);
+	// Removes and deletes every object in a sorted list of object ids
+	static void DestroyObjects(const std::vector<int>& objectIDs);
 	//Removes and deletes all objects from the object manager
 	static void DestroyAllObjects(bool destroyPaused = false);
 	//Destroys and deletes all objects of the given M5ArcheType from the M5ObjectManager
@@ -52,28 +68,67 @@ public:
 	static void GetAllObjectsByType(M5ArcheTypes type, std::vector<M5Object*>& returnVec);
 	//Creates a component of the given type
 	static M5Component* CreateComponent(M5ComponentTypes type);
-	// Creates an assocaitation between the given type and a builder 
-	static void AddComponent(M5ComponentTypes type, M5ComponentBuilder* pBuilder);
-	// Removes the builder assocaited with the given type
-	static void RemoveComponent(M5ComponentTypes type);
 	// Creates an association between the given type and the contents of the given file
 	static void AddArcheType(M5ArcheTypes type, const char* fileName);
 	// Removes the Archetype from the object factory
 	static void RemoveArcheType(M5ArcheTypes type);
+	//Reads archetype files and decodes their textures on the load threads
+	static int ReadArcheTypes(std::vector<M5ArcheTypeFile>& files);
+	//Sets how many threads read archetype files, 0 for one per core
+	static void SetLoadThreads(int threadCount);
+	//Gets how many threads read archetype files, 0 for one per core
+	static int GetLoadThreads(void);
+	//Gets the time in seconds it took to load the archetypes at startup
+	static float GetArcheTypeLoadTime(void);
 	//Creates a Command of the given type
 	static M5Command* CreateCommand(M5CommandTypes type);
-	//Adds a cloneable command to the M5ObjectManager
-	static void AddCommand(M5CommandTypes type, M5Command* pCommand);
-	//Removes the clonable command from the M5ObjectManager
-	static void RemoveCommand(M5CommandTypes type);
+	//Saves the state of all active objects into the snapshot
+	static void Snapshot(M5Snapshot& snapshot);
+	//Restores all active objects to the state saved in the snapshot
+	static void Restore(M5Snapshot& snapshot);
+	//Saves the quantized state of all active objects for replication clients
+	static void Replicate(M5ReplicaWorld& world);
+	//Updates components one type at a time instead of one object at a time
+	static void SetSystemUpdate(bool useSystems);
+	//Checks if components are updated one type at a time
+	static bool GetSystemUpdate(void);
+	//Turns the M5UpdateRate of each component type on or off, off updates every component every frame
+	static void SetUpdateRates(bool useRates);
+	//Checks if components are updated at the M5UpdateRate of their type
+	static bool GetUpdateRates(void);
+	//Gets the time in seconds the last Update took, not counting deleting objects
+	static float GetUpdateTime(void);
+	//Gets the number of times Update has run
+	static int GetFrameCount(void);
+	//Gets the number of objects being updated, not counting paused stages
+	static int GetObjectCount(void);
+	//Sets how much time and how many objects can be deleted each frame
+	static void SetDestroyBudget(float maxTime, int maxCount);
+	//Gets the number of destroyed objects waiting to be deleted
+	static int GetDestroyQueueSize(void);
+	//Gets the time in seconds spent deleting objects last frame
+	static float GetDestroyTime(void);
 
 
 private:
 	static void Init(void);
 	static void Shutdown(void);
+	static void LoadArcheTypes(void);
+	static M5Object* BuildArcheType(M5ArcheTypes type, M5IniFile& file);
 	static void Update(float dt);
+	static void UpdateSystems(float dt);
+	static void CheckEvents(void);
+	static bool HasEvent(M5ComponentTypes type);
+	static float GetUpdateInterval(M5ComponentTypes type);
+	static void QueueDestroy(M5Object* pObj);
+	static void UpdateDestroyQueue(void);
+	static void FlushDestroyQueue(void);
 	static void Pause(void);
 	static void Resume(void);
+	static void RegisterObject(M5Object* pObj);
+	static void UnregisterObject(M5Object* pObj);
+	static void RegisterComponent(M5Component* pComp);
+	static void UnregisterComponent(M5Component* pComp);
 };
 
 
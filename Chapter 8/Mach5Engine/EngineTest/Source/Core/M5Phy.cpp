@@ -12,6 +12,7 @@ Basis Physics engine for Mach 5.  This is a work in progress.
 #include "M5Phy.h"
 #include "M5Object.h"
 #include "ColliderComponent.h"
+#include "M5Debug.h"
 
 #include <stack>
 
@@ -19,7 +20,10 @@ namespace
 {
 //Class Private variables
 
-static std::vector<ColliderComponent*> s_colliders;      //!< Vector of regiestered colliders
+//! Typedef for my vector of colliders
+typedef std::vector<ColliderComponent*, M5Allocator<ColliderComponent*, MT_PHYSICS> > Colliders;
+
+static Colliders                       s_colliders;      //!< Vector of regiestered colliders
 static CollisionPairs                  s_collisionPairs; //!< This frames collision pairs. 
 static int                             s_colliderStart = 0;  //!< The index to start updating on
 static std::stack<int>                 s_pauseStack;
@@ -28,18 +32,23 @@ static std::stack<int>                 s_pauseStack;
 
 void M5Phy::RegisterCollider(ColliderComponent* pCollider)
 {
+	M5DEBUG_ASSERT(pCollider->m_colliderIndex < 0, "Trying to register a collider that is already registered");
+	pCollider->m_colliderIndex = static_cast<int>(s_colliders.size());
 	s_colliders.push_back(pCollider);
 }
 void M5Phy::UnregisterCollider(ColliderComponent* pCollider)
 {
-	for (size_t i = s_colliderStart; i < s_colliders.size(); ++i)
-	{
-		if (s_colliders[i] == pCollider)
-		{
-			s_colliders[i] = s_colliders[s_colliders.size() - 1];
-			s_colliders.pop_back();
-		}
-	}
+	int index = pCollider->m_colliderIndex;
+	if (index < 0)
+		return;
+	M5DEBUG_ASSERT(index >= s_colliderStart, "Trying to unregister a collider from a paused stage");
+
+	//Swap with the last collider, which is never paused, so the start stays correct
+	ColliderComponent* pLast = s_colliders.back();
+	s_colliders[index] = pLast;
+	pLast->m_colliderIndex = index;
+	s_colliders.pop_back();
+	pCollider->m_colliderIndex = -1;
 }
 void M5Phy::GetCollisionPairs(CollisionPairs& pairs)
 {
@@ -49,6 +58,10 @@ void M5Phy::AddCollisionPair(int firstID, int secondID)
 {
 	s_collisionPairs.push_back(std::make_pair(firstID, secondID));
 }
+int M5Phy::GetColliderCount(void)
+{
+	return static_cast<int>(s_colliders.size()) - s_colliderStart;
+}
 void M5Phy::Update(void)
 {
 	s_collisionPairs.clear();
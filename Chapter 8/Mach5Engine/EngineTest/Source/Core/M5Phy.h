@@ -12,6 +12,7 @@ Basis Physics engine for Mach 5.  This is a work in progress.
 #ifndef M5PHY_H
 #define M5PHY_H
 
+#include "M5Memory.h"
 #include <vector>
 
 
@@ -19,13 +20,15 @@ Basis Physics engine for Mach 5.  This is a work in progress.
 class ColliderComponent;
 
 //! Typedef name for my pairs of collided objectIDs
-typedef std::vector < std::pair<int, int> > CollisionPairs;
+typedef std::vector < std::pair<int, int>,
+	M5Allocator<std::pair<int, int>, MT_PHYSICS> > CollisionPairs;
 
 //! Singleton class to test collision between pairs of M5Objects
 class M5Phy
 {
 public:
 	friend class M5StageManager;
+	friend class M5Benchmark;
 
 	//Registers a collider with the physics engine
 	static void RegisterCollider(ColliderComponent* pCollider);
@@ -35,6 +38,8 @@ public:
 	static void GetCollisionPairs(CollisionPairs& pairs);
 	//Marks a pair of M5Objects as having collided.
 	static void AddCollisionPair(int firstID, int secondID);
+	//Gets the number of colliders being tested, not counting paused stages
+	static int GetColliderCount(void);
 
 private:
 	static void Update(void);
@@ -0,0 +1,39 @@
+/******************************************************************************/
+/*!
+\file   M5RenderBackend.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Base class for the code that turns a render frame into pixels.
+
+*/
+/******************************************************************************/
+#ifndef M5_RENDER_BACKEND_H
+#define M5_RENDER_BACKEND_H
+
+//Forward declarations
+struct M5RenderFrame;
+
+/*! Base class for the code that turns a render frame into pixels.  Execute,
+StartThread and EndThread are called on the render thread.  The texture
+functions are called on the main thread.*/
+class M5RenderBackend
+{
+public:
+	virtual ~M5RenderBackend(void) {} //empty virtual destructor
+	//! Called on the render thread before the first frame
+	virtual void StartThread(void) = 0;
+	//! Called on the render thread after the last frame
+	virtual void EndThread(void) = 0;
+	//! Draws a frame and shows it
+	virtual void Execute(const M5RenderFrame& frame) = 0;
+	//! Makes a texture from pixels and returns its id
+	virtual int  CreateTexture(const unsigned char* pixels, int width, int height, unsigned format) = 0;
+	//! Deletes a texture, only called while the render thread is idle
+	virtual void DeleteTexture(int textureID) = 0;
+};
+
+
+#endif //M5_RENDER_BACKEND_H
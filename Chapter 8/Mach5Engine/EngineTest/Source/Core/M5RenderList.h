@@ -0,0 +1,50 @@
+/******************************************************************************/
+/*!
+\file   M5RenderList.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Everything the render thread needs to draw one frame.  M5Gfx fills a frame at
+the end of the simulation, and after that it is only read.
+
+*/
+/******************************************************************************/
+#ifndef M5_RENDER_LIST_H
+#define M5_RENDER_LIST_H
+
+#include "M5Mtx44.h"
+#include "M5Memory.h"
+#include "M5TextBatch.h"
+
+#include <vector>
+
+//! One textured quad for the render thread to draw
+struct M5RenderItem
+{
+	M5Mtx44       world;     //!< The world matrix, or the screen matrix for the HUD
+	M5Mtx44       texCoords; //!< The texture matrix from M5Gfx::SetTextureCoords
+	int           textureID; //!< The texture to draw with
+	unsigned char color[4];  //!< Red, green, blue and alpha blended with the texture
+};
+
+//! Typedef for a list of render items
+typedef std::vector<M5RenderItem, M5Allocator<M5RenderItem, MT_GFX> > M5RenderItems;
+
+//! Everything needed to draw one frame
+struct M5RenderFrame
+{
+	M5RenderItems  world;         //!< Quads drawn with the camera, in draw order
+	M5RenderItems  hud;           //!< Quads drawn in screen space after the world
+	M5TextVertices text;          //!< Text quads drawn on top of the HUD
+	double         persp[16];     //!< The perspective matrix for the world
+	double         camera[16];    //!< The camera matrix for the world
+	int            viewport[4];   //!< The x, y, width and height of the viewport
+	int            width;         //!< The width of the screen, for the HUD
+	int            height;        //!< The height of the screen, for the HUD
+	float          background[3]; //!< The red, green and blue clear color
+};
+
+
+#endif //M5_RENDER_LIST_H
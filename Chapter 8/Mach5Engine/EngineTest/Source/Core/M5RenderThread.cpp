@@ -0,0 +1,162 @@
+/******************************************************************************/
+/*!
+\file   M5RenderThread.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Class to draw one frame on its own thread while the next frame is simulated.
+
+*/
+/******************************************************************************/
+#include "M5RenderThread.h"
+#include "M5RenderBackend.h"
+#include "M5Debug.h"
+
+#include <chrono>
+
+/******************************************************************************/
+/*!
+Sets starting values.  The thread isn't started until Start is called.
+*/
+/******************************************************************************/
+M5RenderThread::M5RenderThread(void) :
+	m_pBackend(0),
+	m_back(0),
+	m_hasFrame(false),
+	m_isRunning(false),
+	m_renderTime(0)
+{
+}
+/******************************************************************************/
+/*!
+Starts the render thread.
+
+\param [in] pBackend
+The backend that draws the frames.  StartThread is called on the new thread.
+*/
+/******************************************************************************/
+void M5RenderThread::Start(M5RenderBackend* pBackend)
+{
+	M5DEBUG_ASSERT(!m_isRunning, "The render thread is already running");
+	m_pBackend = pBackend;
+	m_back = 0;
+	m_hasFrame = false;
+	m_isRunning = true;
+	m_thread = std::thread(&M5RenderThread::Run, this);
+}
+/******************************************************************************/
+/*!
+Lets the render thread finish the last submitted frame, then waits for the
+thread to end.
+*/
+/******************************************************************************/
+void M5RenderThread::Stop(void)
+{
+	if (!m_isRunning)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isRunning = false;
+	}
+	m_signal.notify_all();
+	m_thread.join();
+}
+/******************************************************************************/
+/*!
+Gets the frame the simulation should fill.  The render thread never reads this
+frame until it is submitted.
+
+\return
+The back frame.
+*/
+/******************************************************************************/
+M5RenderFrame& M5RenderThread::GetBackFrame(void)
+{
+	return m_frames[m_back];
+}
+/******************************************************************************/
+/*!
+Waits until the render thread is done with the last submitted frame.  After
+this, resources used by that frame can be freed.
+*/
+/******************************************************************************/
+void M5RenderThread::Wait(void)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_hasFrame)
+		m_signal.wait(lock);
+}
+/******************************************************************************/
+/*!
+Hands the back frame to the render thread and returns right away.  If the
+render thread is still drawing the last frame, this waits for it first.  The
+other frame becomes the new back frame.
+*/
+/******************************************************************************/
+void M5RenderThread::Submit(void)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (m_hasFrame)
+			m_signal.wait(lock);
+
+		m_back = 1 - m_back;
+		m_hasFrame = true;
+	}
+	m_signal.notify_all();
+}
+/******************************************************************************/
+/*!
+Gets how long the render thread took on the last frame it finished.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+float M5RenderThread::GetRenderTime(void)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_renderTime;
+}
+/******************************************************************************/
+/*!
+The render thread.  It sleeps until a frame is submitted, draws it, then tells
+the simulation it is done.  Submit only changes m_back while no frame is being
+drawn, so the front frame is safe to read without the lock.
+*/
+/******************************************************************************/
+void M5RenderThread::Run(void)
+{
+	m_pBackend->StartThread();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;)
+	{
+		while (!m_hasFrame && m_isRunning)
+			m_signal.wait(lock);
+
+		//Stop only after the last submitted frame is drawn
+		if (!m_hasFrame)
+			break;
+
+		const M5RenderFrame& frame = m_frames[1 - m_back];
+		lock.unlock();
+
+		std::chrono::high_resolution_clock::time_point start =
+			std::chrono::high_resolution_clock::now();
+		m_pBackend->Execute(frame);
+		float time = std::chrono::duration<float>(
+			std::chrono::high_resolution_clock::now() - start).count();
+
+		lock.lock();
+		m_renderTime = time;
+		m_hasFrame = false;
+		m_signal.notify_all();
+	}
+	lock.unlock();
+
+	m_pBackend->EndThread();
+}
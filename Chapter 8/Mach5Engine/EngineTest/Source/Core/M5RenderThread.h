@@ -0,0 +1,59 @@
+/******************************************************************************/
+/*!
+\file   M5RenderThread.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Class to draw one frame on its own thread while the next frame is simulated.
+
+*/
+/******************************************************************************/
+#ifndef M5_RENDER_THREAD_H
+#define M5_RENDER_THREAD_H
+
+#include "M5RenderList.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//Forward declarations
+class M5RenderBackend;
+
+/*! Draws one frame on its own thread while the next frame is simulated.  There
+are two frames.  The simulation fills the back frame, and Submit hands it to
+the render thread once the render thread is done with the other one.*/
+class M5RenderThread
+{
+public:
+	M5RenderThread(void);
+	//Starts the thread that executes frames with the backend
+	void Start(M5RenderBackend* pBackend);
+	//Finishes the last submitted frame and stops the thread
+	void Stop(void);
+	//Gets the frame to fill before the next Submit
+	M5RenderFrame& GetBackFrame(void);
+	//Waits until the render thread is done with the last submitted frame
+	void Wait(void);
+	//Gives the back frame to the render thread without waiting for it to be drawn
+	void Submit(void);
+	//Gets the seconds the render thread spent on the last frame it finished
+	float GetRenderTime(void);
+private:
+	void Run(void);
+
+	M5RenderFrame           m_frames[2];  //!< The back frame and the frame being drawn
+	M5RenderBackend*        m_pBackend;   //!< Draws the frames
+	std::thread             m_thread;     //!< The render thread
+	std::mutex              m_mutex;      //!< Guards everything below
+	std::condition_variable m_signal;     //!< Wakes either thread when a frame is submitted or done
+	int                     m_back;       //!< Index of the frame the simulation fills
+	bool                    m_hasFrame;   //!< True from Submit until the render thread is done
+	bool                    m_isRunning;  //!< False once Stop is called
+	float                   m_renderTime; //!< Seconds spent on the last frame
+};
+
+
+#endif //M5_RENDER_THREAD_H
@@ -0,0 +1,281 @@
+/******************************************************************************/
+/*!
+file    M5Replay.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/20
+
+Singleton class to record the input of a session and play it back exactly.
+
+The log is a small header followed by a stream of events.  Every key and mouse
+event is written as it arrives from the window, and a frame event marks the
+end of input for a frame along with the frame time the game was given.  On
+replay the same events are handed to M5Input at the same frames, and the
+recorded frame time replaces the measured one, so the game sees exactly the
+same input and time step.
+
+*/
+/******************************************************************************/
+#include "M5Replay.h"
+#include "M5Random.h"
+#include "M5StageManager.h"
+#include "M5Debug.h"
+
+#include <fstream>
+#include <cstring>
+
+
+namespace
+{
+const char     REPLAY_MAGIC[4] = { 'M', '5', 'R', 'P' };
+const unsigned REPLAY_VERSION  = 1;
+
+//! The types of events that can be in a replay log
+enum M5ReplayEvent
+{
+  RE_KEY,   //!< Followed by the key and the status
+  RE_MOUSE, //!< Followed by the x and y screen position
+  RE_FRAME  //!< Followed by the frame time
+};
+
+std::ofstream s_outFile;     /*!< The log being recorded*/
+std::ifstream s_inFile;      /*!< The log being replayed*/
+bool          s_isRecording; /*!< True if we are writing input*/
+bool          s_isReplaying; /*!< True if we are reading input*/
+
+/******************************************************************************/
+/*!
+Writes the bytes of a value to the recording.
+
+\param [in] value
+The value to write.
+*/
+/******************************************************************************/
+template<typename T>
+void Write(const T& value)
+{
+  s_outFile.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+/******************************************************************************/
+/*!
+Reads the bytes of a value from the replay.
+
+\param [out] value
+The value to fill.
+
+\return
+True if the value was read, false if the log ended.
+*/
+/******************************************************************************/
+template<typename T>
+bool Read(T& value)
+{
+  s_inFile.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return s_inFile.gcount() == sizeof(T);
+}
+
+}//end unnamed namespace
+
+
+/******************************************************************************/
+/*!
+Starts writing all input to a file.  This should be called after M5App::Init
+and before M5App::Update so the whole session is recorded.
+
+\param [in] fileName
+The name of the log to write.
+
+\param [in] seed
+The value to seed M5Random with.  It is saved so a replay uses the same seed.
+*/
+/******************************************************************************/
+void M5Replay::StartRecording(const char* fileName, unsigned seed)
+{
+  M5DEBUG_ASSERT(!s_isRecording && !s_isReplaying, "Already recording or replaying");
+
+  s_outFile.open(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  M5DEBUG_ASSERT(s_outFile.is_open(), "Replay file could not be opened");
+
+  s_outFile.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+  Write(REPLAY_VERSION);
+  Write(seed);
+
+  M5Random::Seed(seed);
+  s_isRecording = true;
+}
+/******************************************************************************/
+/*!
+Starts feeding input from a recorded file.  While replaying, input from the
+window and gamepad is ignored.  When the log runs out the game quits, since
+that is where the recorded session ended.
+
+\param [in] fileName
+The name of the log to read.
+*/
+/******************************************************************************/
+void M5Replay::StartReplay(const char* fileName)
+{
+  M5DEBUG_ASSERT(!s_isRecording && !s_isReplaying, "Already recording or replaying");
+
+  s_inFile.open(fileName, std::ios::in | std::ios::binary);
+  M5DEBUG_ASSERT(s_inFile.is_open(), "Replay file could not be opened");
+
+  char magic[sizeof(REPLAY_MAGIC)];
+  unsigned version = 0;
+  unsigned seed = 0;
+  s_inFile.read(magic, sizeof(magic));
+  Read(version);
+  Read(seed);
+  M5DEBUG_ASSERT(std::memcmp(magic, REPLAY_MAGIC, sizeof(magic)) == 0, "Not a replay file");
+  M5DEBUG_ASSERT(version == REPLAY_VERSION, "Replay file version doesn't match");
+
+  M5Random::Seed(seed);
+  s_isReplaying = true;
+}
+/******************************************************************************/
+/*!
+Stops recording or replaying and closes the log.  Input goes back to coming
+from the window.
+*/
+/******************************************************************************/
+void M5Replay::Stop(void)
+{
+  if (s_outFile.is_open())
+    s_outFile.close();
+  if (s_inFile.is_open())
+    s_inFile.close();
+
+  s_isRecording = false;
+  s_isReplaying = false;
+}
+/******************************************************************************/
+/*!
+Returns true if input is being recorded.
+
+\return
+True if input is being recorded, false otherwise.
+*/
+/******************************************************************************/
+bool M5Replay::IsRecording(void)
+{
+  return s_isRecording;
+}
+/******************************************************************************/
+/*!
+Returns true if input is coming from a recorded file.
+
+\return
+True if input is being replayed, false otherwise.
+*/
+/******************************************************************************/
+bool M5Replay::IsReplaying(void)
+{
+  return s_isReplaying;
+}
+/******************************************************************************/
+/*!
+Writes a key event to the log if we are recording.
+
+\param [in] key
+The key that changed.
+
+\param [in] status
+If the key is being pressed or not.
+*/
+/******************************************************************************/
+void M5Replay::RecordKey(M5KeyCode key, int status)
+{
+  if (!s_isRecording)
+    return;
+
+  Write(static_cast<unsigned char>(RE_KEY));
+  Write(static_cast<unsigned char>(key));
+  Write(static_cast<unsigned char>(status != 0));
+}
+/******************************************************************************/
+/*!
+Writes a mouse event to the log if we are recording.
+
+\param [in] x
+The x coordinate of the mouse in screen space.
+
+\param [in] y
+The y coordinate of the mouse in screen space.
+*/
+/******************************************************************************/
+void M5Replay::RecordMouse(int x, int y)
+{
+  if (!s_isRecording)
+    return;
+
+  Write(static_cast<unsigned char>(RE_MOUSE));
+  Write(static_cast<short>(x));
+  Write(static_cast<short>(y));
+}
+/******************************************************************************/
+/*!
+Called once per frame after the window messages are processed.  When recording
+this closes the frame with the frame time.  When replaying, this sends all of
+the recorded input for the frame to M5Input and replaces the frame time.
+
+\param [in, out] dt
+The frame time the game is about to use.
+*/
+/******************************************************************************/
+void M5Replay::EndInput(float& dt)
+{
+  if (s_isRecording)
+  {
+    Write(static_cast<unsigned char>(RE_FRAME));
+    Write(dt);
+    return;
+  }
+
+  if (!s_isReplaying)
+    return;
+
+  unsigned char type;
+  while (Read(type))
+  {
+    if (type == RE_FRAME)
+    {
+      Read(dt);
+      return;
+    }
+    else if (type == RE_KEY)
+    {
+      unsigned char key;
+      unsigned char status;
+      Read(key);
+      Read(status);
+      M5Input::SetPressed(static_cast<M5KeyCode>(key), status);
+    }
+    else if (type == RE_MOUSE)
+    {
+      short x;
+      short y;
+      Read(x);
+      Read(y);
+      M5Input::SetMouse(x, y);
+    }
+    else
+    {
+      M5DEBUG_ASSERT(false, "Replay file is corrupt");
+      break;
+    }
+  }
+
+  //The recorded session is over
+  Stop();
+  M5StageManager::Quit();
+}
+/******************************************************************************/
+/*!
+Makes sure the recording is flushed to disk.  This is called by the system.
+*/
+/******************************************************************************/
+void M5Replay::Shutdown(void)
+{
+  Stop();
+}
@@ -0,0 +1,46 @@
+/******************************************************************************/
+/*!
+\file   M5Replay.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/20
+
+Singleton class to record the input of a session and play it back exactly.
+
+*/
+/******************************************************************************/
+#ifndef M5_REPLAY_H
+#define M5_REPLAY_H
+
+#include "M5Input.h"
+
+//! Singleton class to record the input of a session and play it back exactly.
+class M5Replay
+{
+public:
+  friend class M5App;
+  friend class M5Input;
+  friend class M5StageManager;
+
+  /*Seeds M5Random and starts writing all input to a file*/
+  static void StartRecording(const char* fileName, unsigned seed);
+  /*Seeds M5Random and feeds input from a recorded file instead of the window*/
+  static void StartReplay(const char* fileName);
+  /*Stops recording or replaying*/
+  static void Stop(void);
+  /*Returns true if input is being recorded*/
+  static bool IsRecording(void);
+  /*Returns true if input is coming from a recorded file*/
+  static bool IsReplaying(void);
+private:
+  static void RecordKey(M5KeyCode key, int status);
+  static void RecordMouse(int x, int y);
+  static void EndInput(float& dt);
+  static void Shutdown(void);
+};//end M5Replay
+
+
+
+
+#endif
@@ -0,0 +1,291 @@
+/******************************************************************************/
+/*!
+\file   M5ReplicaClient.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Receives snapshots from an M5Replication server and rebuilds the world it
+sent.
+
+Only one delta is put back together at a time.  A fragment of a newer
+snapshot throws away a delta that is still missing pieces, since the newer
+one will be written against a world this client already has.
+
+*/
+/******************************************************************************/
+#include "M5ReplicaClient.h"
+#include "M5Debug.h"
+#include "M5Log.h"
+
+#include <cstring>
+#include <utility>
+
+namespace
+{
+const float CONNECT_TIME = 1.0f; //!< Seconds without a snapshot before the connect is sent again
+}
+
+/******************************************************************************/
+/*!
+Starts disconnected.
+*/
+/******************************************************************************/
+M5ReplicaClient::M5ReplicaClient(void):
+	m_deltaSequence(0),
+	m_deltaBaseline(0),
+	m_missingFragments(0),
+	m_deltaSize(0),
+	m_sequence(0),
+	m_quietTime(0),
+	m_receivedBytes(0),
+	m_snapshotCount(0)
+{
+	m_server.ip = 0;
+	m_server.port = 0;
+}
+/******************************************************************************/
+/*!
+Tells the server to stop sending if it is still connected.
+*/
+/******************************************************************************/
+M5ReplicaClient::~M5ReplicaClient(void)
+{
+	Disconnect();
+}
+/******************************************************************************/
+/*!
+Opens a socket and asks a server for snapshots.  The first snapshot arrives
+in a later Update.
+
+\param [in] ip
+The address of the server, like 127.0.0.1.
+
+\param [in] port
+The port the server is open on.
+
+\return
+True if the socket was opened and the address is valid.
+*/
+/******************************************************************************/
+bool M5ReplicaClient::Connect(const char* ip, unsigned short port)
+{
+	M5DEBUG_ASSERT(!m_socket.IsOpen(), "The replica client is already connected");
+
+	if (!M5Socket::MakeAddress(ip, port, m_server) || !m_socket.Open(0))
+	{
+		M5Log::Write(LL_ERROR, LC_NET, "M5ReplicaClient: could not connect to %s:%d", ip, port);
+		return false;
+	}
+
+	m_deltaSequence = 0;
+	m_sequence = 0;
+	m_quietTime = 0;
+	m_receivedBytes = 0;
+	m_snapshotCount = 0;
+	for (unsigned i = 0; i < REPLICA_HISTORY; ++i)
+	{
+		m_history[i].Clear();
+		m_history[i].sequence = 0;
+	}
+
+	SendPacket(RP_CONNECT, 0);
+	return true;
+}
+/******************************************************************************/
+/*!
+Tells the server to stop sending and closes the socket.  The last world is
+kept.  It is safe to call when not connected.
+*/
+/******************************************************************************/
+void M5ReplicaClient::Disconnect(void)
+{
+	if (!m_socket.IsOpen())
+		return;
+
+	SendPacket(RP_DISCONNECT, m_sequence);
+	m_socket.Close();
+}
+/******************************************************************************/
+/*!
+Reads every waiting packet, puts deltas back together and acks each snapshot
+that is read.  If no snapshot has arrived for a while the connect is sent
+again, in case it or the server was lost.
+
+\param [in] dt
+The frame time in seconds.
+*/
+/******************************************************************************/
+void M5ReplicaClient::Update(float dt)
+{
+	if (!m_socket.IsOpen())
+		return;
+
+	M5Address from;
+	int size;
+	while ((size = m_socket.Receive(from, m_packet, REPLICA_PACKET_SIZE)) != 0)
+	{
+		M5ReplicaHeader header;
+		if (!M5Socket::IsSame(from, m_server) || size < static_cast<int>(sizeof(header)))
+			continue;
+		std::memcpy(&header, m_packet, sizeof(header));
+		if (header.magic != REPLICA_MAGIC || header.version != REPLICA_VERSION || header.type != RP_SNAPSHOT)
+			continue;
+
+		m_receivedBytes += size;
+		ReadFragment(header, m_packet + sizeof(header), size - static_cast<int>(sizeof(header)));
+	}
+
+	m_quietTime += dt;
+	if (m_quietTime >= CONNECT_TIME)
+	{
+		SendPacket(RP_CONNECT, 0);
+		m_quietTime = 0;
+	}
+}
+/******************************************************************************/
+/*!
+Checks if a snapshot has been read since connecting.
+
+\return
+True if GetWorld has something in it.
+*/
+/******************************************************************************/
+bool M5ReplicaClient::HasWorld(void) const
+{
+	return m_sequence != 0;
+}
+/******************************************************************************/
+/*!
+Gets the newest world the server sent.
+
+\return
+The world.  It is empty until HasWorld is true.
+*/
+/******************************************************************************/
+const M5ReplicaWorld& M5ReplicaClient::GetWorld(void) const
+{
+	return (m_sequence == 0) ? m_empty : m_history[m_sequence % REPLICA_HISTORY];
+}
+/******************************************************************************/
+/*!
+Gets the bytes received from the server, including packet headers but not
+the UDP and IP headers.
+
+\return
+The bytes since connecting.
+*/
+/******************************************************************************/
+long long M5ReplicaClient::GetReceivedBytes(void) const
+{
+	return m_receivedBytes;
+}
+/******************************************************************************/
+/*!
+Gets the number of snapshots read.  Snapshots that were lost or arrived too
+late to use aren't counted.
+
+\return
+The number of snapshots since connecting.
+*/
+/******************************************************************************/
+int M5ReplicaClient::GetSnapshotCount(void) const
+{
+	return m_snapshotCount;
+}
+/******************************************************************************/
+/*!
+Sends a packet with only a header to the server.
+
+\param [in] type
+The kind of packet.
+
+\param [in] sequence
+The snapshot the packet is about.
+*/
+/******************************************************************************/
+void M5ReplicaClient::SendPacket(M5ReplicaPacket type, unsigned sequence)
+{
+	M5ReplicaHeader header;
+	header.sequence = sequence;
+	header.baseline = 0;
+	header.magic = REPLICA_MAGIC;
+	header.fragment = 0;
+	header.fragmentCount = 0;
+	header.type = static_cast<unsigned char>(type);
+	header.version = REPLICA_VERSION;
+	m_socket.Send(m_server, &header, sizeof(header));
+}
+/******************************************************************************/
+/*!
+Adds a fragment to the delta being put back together, and reads the delta
+once every fragment is there.
+
+\param [in] header
+The header of the packet.
+
+\param [in] pData
+The part of the delta in the packet.
+
+\param [in] size
+The number of bytes in pData.
+*/
+/******************************************************************************/
+void M5ReplicaClient::ReadFragment(const M5ReplicaHeader& header, const unsigned char* pData, int size)
+{
+	int count = header.fragmentCount;
+	int fragment = header.fragment;
+	if (header.sequence <= m_sequence || header.sequence < m_deltaSequence ||
+		count == 0 || count > REPLICA_MAX_FRAGMENTS || fragment >= count)
+		return;
+
+	/*Every fragment is full except the last*/
+	bool isLast = (fragment == count - 1);
+	if (size > REPLICA_FRAGMENT_SIZE || (isLast ? size == 0 : size != REPLICA_FRAGMENT_SIZE))
+		return;
+
+	if (header.sequence != m_deltaSequence)
+	{
+		m_deltaSequence = header.sequence;
+		m_deltaBaseline = header.baseline;
+		m_delta.resize(count * REPLICA_FRAGMENT_SIZE);
+		m_hasFragment.assign(count, false);
+		m_missingFragments = count;
+		m_deltaSize = 0;
+	}
+
+	if (header.baseline != m_deltaBaseline || count != static_cast<int>(m_hasFragment.size()) ||
+		m_hasFragment[fragment])
+		return;
+
+	std::memcpy(&m_delta[fragment * REPLICA_FRAGMENT_SIZE], pData, size);
+	m_hasFragment[fragment] = true;
+	if (isLast)
+		m_deltaSize = fragment * REPLICA_FRAGMENT_SIZE + size;
+	if (--m_missingFragments != 0)
+		return;
+
+	/*The baseline must be a world this client still has*/
+	const M5ReplicaWorld* pBaseline = &m_empty;
+	if (m_deltaBaseline != 0)
+	{
+		const M5ReplicaWorld& world = m_history[m_deltaBaseline % REPLICA_HISTORY];
+		if (world.sequence != m_deltaBaseline || m_deltaSequence - m_deltaBaseline >= REPLICA_HISTORY)
+			return;
+		pBaseline = &world;
+	}
+
+	if (!m_read.ReadDelta(*pBaseline, &m_delta[0], m_deltaSize))
+	{
+		M5Log::Write(LL_WARNING, LC_NET, "M5ReplicaClient: snapshot %u could not be read", m_deltaSequence);
+		return;
+	}
+
+	m_read.sequence = m_deltaSequence;
+	std::swap(m_read, m_history[m_deltaSequence % REPLICA_HISTORY]);
+	m_sequence = m_deltaSequence;
+	m_quietTime = 0;
+	++m_snapshotCount;
+	SendPacket(RP_ACK, m_sequence);
+}
@@ -0,0 +1,71 @@
+/******************************************************************************/
+/*!
+\file   M5ReplicaClient.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Receives snapshots from an M5Replication server and rebuilds the world it
+sent.
+
+*/
+/******************************************************************************/
+#ifndef M5_REPLICA_CLIENT_H
+#define M5_REPLICA_CLIENT_H
+
+#include "M5Replication.h"
+#include "M5ReplicaWorld.h"
+#include "M5Socket.h"
+#include <vector>
+
+/*! Receives snapshots from an M5Replication server.  Fragments are put back
+together, each delta is read against the world it was written for, and
+every world that is read is acked so the server can send smaller deltas.
+It only uses its own socket, so a client can run in the same process as the
+server to test on 127.0.0.1.*/
+class M5ReplicaClient
+{
+public:
+	M5ReplicaClient(void);
+	~M5ReplicaClient(void);
+	//Opens a socket and asks a server for snapshots
+	bool Connect(const char* ip, unsigned short port);
+	//Tells the server to stop sending and closes the socket
+	void Disconnect(void);
+	//Reads every waiting packet and acks new snapshots
+	void Update(float dt);
+	//Checks if at least one snapshot has been read
+	bool HasWorld(void) const;
+	//Gets the newest world the server sent
+	const M5ReplicaWorld& GetWorld(void) const;
+	//Gets the total bytes received
+	long long GetReceivedBytes(void) const;
+	//Gets the number of snapshots read
+	int GetSnapshotCount(void) const;
+private:
+	M5ReplicaClient(const M5ReplicaClient& rhs) = delete;
+	M5ReplicaClient& operator=(const M5ReplicaClient& rhs) = delete;
+	void SendPacket(M5ReplicaPacket type, unsigned sequence);
+	void ReadFragment(const M5ReplicaHeader& header, const unsigned char* pData, int size);
+
+	M5Socket                   m_socket;                    //!< Where snapshots arrive
+	M5Address                  m_server;                    //!< Where acks are sent
+	M5ReplicaWorld             m_history[REPLICA_HISTORY];  //!< Worlds read, by sequence % REPLICA_HISTORY
+	M5ReplicaWorld             m_empty;                     //!< Baseline for full snapshots
+	M5ReplicaWorld             m_read;                      //!< The world being read, swapped into m_history if it works
+	std::vector<unsigned char> m_delta;                     //!< The delta being put back together
+	std::vector<bool>          m_hasFragment;               //!< Which fragments of m_delta have arrived
+	unsigned                   m_deltaSequence;             //!< The snapshot m_delta is for, 0 for none
+	unsigned                   m_deltaBaseline;             //!< The baseline of m_delta
+	int                        m_missingFragments;          //!< Fragments of m_delta still to arrive
+	int                        m_deltaSize;                 //!< Bytes in m_delta, known once the last fragment arrives
+	unsigned                   m_sequence;                  //!< The newest snapshot read, 0 for none
+	float                      m_quietTime;                 //!< Seconds since the last snapshot, connects are resent when it gets long
+	long long                  m_receivedBytes;             //!< Total bytes received
+	int                        m_snapshotCount;             //!< Number of snapshots read
+	unsigned char              m_packet[REPLICA_PACKET_SIZE]; //!< Reused for every packet
+};
+
+
+#endif //M5_REPLICA_CLIENT_H
@@ -0,0 +1,667 @@
+/******************************************************************************/
+/*!
+\file   M5ReplicaWorld.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+The quantized state of every replicated object, and the delta compression
+used to send it from a server to its clients.
+
+A delta starts with the number of objects in the new world, followed by one
+entry for each object that was added, removed or changed since the baseline,
+in id order.  An entry is the id as a varint difference from the last entry,
+a byte of RF_ flags, and then each changed field as a zigzag varint
+difference from the baseline value.  Added objects are written as a
+difference from zero, so a delta against an empty world is a full snapshot.
+
+*/
+/******************************************************************************/
+#include "M5ReplicaWorld.h"
+#include "M5Object.h"
+#include "M5Snapshot.h"
+#include "M5Math.h"
+#include "M5Debug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+const float REPLICA_STEPS = 16.0f;          //!< Quantized steps in one world unit
+const float MAX_STEPS = 134217728.0f;       //!< Largest quantized value, so differences fit in an int
+const float ANGLE_STEPS = 65536.0f;         //!< Quantized steps in a full turn
+const int   ANGLE_MASK = 0xFFFF;            //!< Keeps a quantized angle in one turn
+const int   MAX_VARINT_BYTES = 5;           //!< Bytes needed for any 32 bit varint
+
+//! Flags at the start of each entry of a delta
+enum M5ReplicaFlags
+{
+	RF_POS     = 1 << 0, //!< The position changed
+	RF_VEL     = 1 << 1, //!< The velocity changed
+	RF_SCALE   = 1 << 2, //!< The scale changed
+	RF_ROT     = 1 << 3, //!< The rotation changed
+	RF_DATA    = 1 << 4, //!< The component bytes changed, followed by the size and the bytes
+	RF_NEW     = 1 << 5, //!< The object isn't in the baseline, followed by the ArcheType
+	RF_REMOVED = 1 << 6  //!< The object is in the baseline but not in the new world
+};
+
+//! Added objects are written as changes from this
+const M5ReplicaObject ZERO_OBJECT = { 0, AT_INVALID, { 0, 0 }, { 0, 0 }, { 0, 0 }, 0, 0, 0 };
+
+//! Reused by AddObject for the component bytes, so worlds don't each need one
+M5Snapshot s_componentData;
+
+/******************************************************************************/
+/*!
+Converts a world value to quantized steps.
+
+\param [in] value
+The value to convert.
+
+\return
+The nearest step, clamped so differences between steps fit in an int.
+*/
+/******************************************************************************/
+int Quantize(float value)
+{
+	float steps = value * REPLICA_STEPS;
+	//Written so NaN is clamped too
+	if (!(steps > -MAX_STEPS))
+		return -static_cast<int>(MAX_STEPS);
+	if (!(steps < MAX_STEPS))
+		return static_cast<int>(MAX_STEPS);
+	return static_cast<int>(std::floor(steps + 0.5f));
+}
+/******************************************************************************/
+/*!
+Converts an angle in radians to a fraction of a turn.
+
+\param [in] angle
+The angle to convert.
+
+\return
+The nearest step, from 0 to ANGLE_MASK.
+*/
+/******************************************************************************/
+int QuantizeAngle(float angle)
+{
+	float turns = angle / M5Math::TWO_PI;
+	turns -= std::floor(turns);
+	if (!(turns >= 0.0f))
+		return 0;
+	return static_cast<int>(std::floor(turns * ANGLE_STEPS + 0.5f)) & ANGLE_MASK;
+}
+/******************************************************************************/
+/*!
+Maps signed values to unsigned ones so small negative numbers stay small.
+
+\param [in] value
+The signed value.
+
+\return
+The value as 0, -1, 1, -2, 2 and so on becomes 0, 1, 2, 3, 4.
+*/
+/******************************************************************************/
+unsigned ZigZag(int value)
+{
+	return (static_cast<unsigned>(value) << 1) ^ static_cast<unsigned>(value >> 31);
+}
+/******************************************************************************/
+/*!
+Reverses ZigZag.
+
+\param [in] value
+The value from ZigZag.
+
+\return
+The signed value.
+*/
+/******************************************************************************/
+int UnZigZag(unsigned value)
+{
+	return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+}
+/******************************************************************************/
+/*!
+Writes a value seven bits at a time, so small values take one byte.
+
+\param [out] out
+The buffer to add to.
+
+\param [in] value
+The value to write.
+*/
+/******************************************************************************/
+void WriteVarint(std::vector<unsigned char>& out, unsigned value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back(static_cast<unsigned char>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<unsigned char>(value));
+}
+/******************************************************************************/
+/*!
+Reads a value written by WriteVarint.
+
+\param [in, out] pData
+The place to read from, moved past the value.
+
+\param [in] pEnd
+The end of the data.
+
+\param [out] value
+The value read.
+
+\return
+False if the data ended or the value is too long.
+*/
+/******************************************************************************/
+bool ReadVarint(const unsigned char*& pData, const unsigned char* pEnd, unsigned& value)
+{
+	value = 0;
+	for (int i = 0; i < MAX_VARINT_BYTES && pData != pEnd; ++i)
+	{
+		unsigned char byte = *pData++;
+		value |= static_cast<unsigned>(byte & 0x7F) << (7 * i);
+		if ((byte & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+/******************************************************************************/
+/*!
+Reads a zigzag varint and adds it to a baseline value.
+
+\param [in, out] pData
+The place to read from, moved past the value.
+
+\param [in] pEnd
+The end of the data.
+
+\param [in, out] value
+The baseline value, changed to the new value.
+
+\return
+False if the data ended.
+*/
+/******************************************************************************/
+bool ReadChange(const unsigned char*& pData, const unsigned char* pEnd, int& value)
+{
+	unsigned change;
+	if (!ReadVarint(pData, pEnd, change))
+		return false;
+	value = static_cast<int>(static_cast<unsigned>(value) + static_cast<unsigned>(UnZigZag(change)));
+	return true;
+}
+/******************************************************************************/
+/*!
+Writes the changed fields of an object as differences from a baseline.
+
+\param [out] out
+The buffer to add to.
+
+\param [in] flags
+The RF_ flags of the fields to write.
+
+\param [in] obj
+The new state.
+
+\param [in] pData
+The component bytes of the new state.
+
+\param [in] base
+The baseline state.
+*/
+/******************************************************************************/
+void WriteFields(std::vector<unsigned char>& out, unsigned flags,
+	const M5ReplicaObject& obj, const unsigned char* pData, const M5ReplicaObject& base)
+{
+	if (flags & RF_POS)
+	{
+		WriteVarint(out, ZigZag(obj.pos[0] - base.pos[0]));
+		WriteVarint(out, ZigZag(obj.pos[1] - base.pos[1]));
+	}
+	if (flags & RF_VEL)
+	{
+		WriteVarint(out, ZigZag(obj.vel[0] - base.vel[0]));
+		WriteVarint(out, ZigZag(obj.vel[1] - base.vel[1]));
+	}
+	if (flags & RF_SCALE)
+	{
+		WriteVarint(out, ZigZag(obj.scale[0] - base.scale[0]));
+		WriteVarint(out, ZigZag(obj.scale[1] - base.scale[1]));
+	}
+	//The short way around the circle is always the smaller number
+	if (flags & RF_ROT)
+		WriteVarint(out, ZigZag(static_cast<short>(obj.rotation - base.rotation)));
+	if (flags & RF_DATA)
+	{
+		WriteVarint(out, obj.dataSize);
+		out.insert(out.end(), pData, pData + obj.dataSize);
+	}
+}
+/******************************************************************************/
+/*!
+Used to sort objects by id.
+
+\param [in] left
+The first object.
+
+\param [in] right
+The second object.
+
+\return
+True if left has the lower id.
+*/
+/******************************************************************************/
+bool IsLowerID(const M5ReplicaObject& left, const M5ReplicaObject& right)
+{
+	return left.id < right.id;
+}
+
+}//end unnamed namespace
+
+/******************************************************************************/
+/*!
+Starts with no objects.
+*/
+/******************************************************************************/
+M5ReplicaWorld::M5ReplicaWorld(void):
+	sequence(0)
+{
+}
+/******************************************************************************/
+/*!
+Removes every object.  The memory is kept so filling it again is fast.
+*/
+/******************************************************************************/
+void M5ReplicaWorld::Clear(void)
+{
+	m_objects.clear();
+	m_data.clear();
+}
+/******************************************************************************/
+/*!
+Quantizes an object and adds it to the end of the world.  The components add
+whatever they write in Replicate.
+
+\param [in] obj
+The object to add.
+*/
+/******************************************************************************/
+void M5ReplicaWorld::AddObject(const M5Object& obj)
+{
+	M5ReplicaObject replica;
+	replica.id = obj.GetID();
+	replica.type = obj.GetType();
+	replica.pos[0] = Quantize(obj.pos.x);
+	replica.pos[1] = Quantize(obj.pos.y);
+	replica.vel[0] = Quantize(obj.vel.x);
+	replica.vel[1] = Quantize(obj.vel.y);
+	replica.scale[0] = Quantize(obj.scale.x);
+	replica.scale[1] = Quantize(obj.scale.y);
+	replica.rotation = QuantizeAngle(obj.rotation);
+
+	s_componentData.Clear();
+	obj.Replicate(s_componentData);
+	replica.dataStart = 0;
+	replica.dataSize = static_cast<unsigned>(s_componentData.GetSize());
+	AddCopy(replica, s_componentData.GetData());
+}
+/******************************************************************************/
+/*!
+Sorts the objects by id, so deltas can walk two worlds together.  Objects are
+usually close to sorted already, since ids only go up.
+*/
+/******************************************************************************/
+void M5ReplicaWorld::Sort(void)
+{
+	std::sort(m_objects.begin(), m_objects.end(), IsLowerID);
+}
+/******************************************************************************/
+/*!
+Writes the difference between this world and an older one.  An empty baseline
+writes every object in full.
+
+\param [in] baseline
+The world the client already has.
+
+\param [out] out
+The buffer to write to.  Anything already in it is removed.
+*/
+/******************************************************************************/
+void M5ReplicaWorld::WriteDelta(const M5ReplicaWorld& baseline, std::vector<unsigned char>& out) const
+{
+	out.clear();
+	WriteVarint(out, static_cast<unsigned>(m_objects.size()));
+
+	const std::vector<M5ReplicaObject>& bases = baseline.m_objects;
+	size_t baseCount = bases.size();
+	size_t b = 0;
+	int lastID = 0;
+
+	for (size_t i = 0; i < m_objects.size(); ++i)
+	{
+		const M5ReplicaObject& obj = m_objects[i];
+		const unsigned char* pData = GetData(static_cast<int>(i));
+
+		//Anything in the baseline with a lower id was removed
+		for (; b < baseCount && bases[b].id < obj.id; ++b)
+		{
+			WriteVarint(out, static_cast<unsigned>(bases[b].id - lastID));
+			out.push_back(static_cast<unsigned char>(RF_REMOVED));
+			lastID = bases[b].id;
+		}
+
+		unsigned flags;
+		if (b < baseCount && bases[b].id == obj.id)
+		{
+			const unsigned char* pBaseData = baseline.GetData(static_cast<int>(b));
+			flags = GetChanges(obj, pData, bases[b], pBaseData);
+			++b;
+			if (flags == 0)
+				continue;
+
+			WriteVarint(out, static_cast<unsigned>(obj.id - lastID));
+			out.push_back(static_cast<unsigned char>(flags));
+			WriteFields(out, flags, obj, pData, bases[b - 1]);
+		}
+		else
+		{
+			flags = RF_NEW | GetChanges(obj, pData, ZERO_OBJECT, 0);
+			WriteVarint(out, static_cast<unsigned>(obj.id - lastID));
+			out.push_back(static_cast<unsigned char>(flags));
+			WriteVarint(out, static_cast<unsigned>(obj.type));
+			WriteFields(out, flags, obj, pData, ZERO_OBJECT);
+		}
+		lastID = obj.id;
+	}
+
+	for (; b < baseCount; ++b)
+	{
+		WriteVarint(out, static_cast<unsigned>(bases[b].id - lastID));
+		out.push_back(static_cast<unsigned char>(RF_REMOVED));
+		lastID = bases[b].id;
+	}
+}
+/******************************************************************************/
+/*!
+Rebuilds this world from an older one and a delta written by WriteDelta.  The
+data comes from the network, so anything that doesn't make sense is rejected
+instead of asserted.
+
+\param [in] baseline
+The world the delta was written against.  It can't be this world.
+
+\param [in] pData
+The delta.
+
+\param [in] size
+The number of bytes in the delta.
+
+\return
+True if the delta was read, false if it was damaged or doesn't match the
+baseline.  The world is empty after a failure.
+*/
+/******************************************************************************/
+bool M5ReplicaWorld::ReadDelta(const M5ReplicaWorld& baseline, const unsigned char* pData, size_t size)
+{
+	M5DEBUG_ASSERT(&baseline != this, "A world can't be read from a delta against itself");
+	Clear();
+
+	const unsigned char* pEnd = pData + size;
+	const std::vector<M5ReplicaObject>& bases = baseline.m_objects;
+	size_t baseCount = bases.size();
+	size_t b = 0;
+	int lastID = 0;
+	bool isFirst = true;
+	bool isValid = true;
+
+	unsigned count;
+	if (!ReadVarint(pData, pEnd, count) || count > baseCount + size)
+		return false;
+	m_objects.reserve(count);
+
+	while (isValid && pData != pEnd)
+	{
+		/*Ids must go up, or the walk through the baseline breaks*/
+		unsigned idChange;
+		isValid = ReadVarint(pData, pEnd, idChange) && pData != pEnd;
+		int id = static_cast<int>(static_cast<unsigned>(lastID) + idChange);
+		if (!isValid || (isFirst ? id < 0 : id <= lastID))
+		{
+			isValid = false;
+			break;
+		}
+		lastID = id;
+		isFirst = false;
+		unsigned flags = *pData++;
+
+		//Everything before this entry is unchanged
+		for (; b < baseCount && bases[b].id < id; ++b)
+			AddCopy(bases[b], baseline.GetData(static_cast<int>(b)));
+		const M5ReplicaObject* pBase = (b < baseCount && bases[b].id == id) ? &bases[b] : 0;
+		const unsigned char* pBytes = (pBase != 0) ? baseline.GetData(static_cast<int>(b++)) : 0;
+
+		M5ReplicaObject obj;
+		if (flags & RF_REMOVED)
+		{
+			isValid = (pBase != 0 && flags == RF_REMOVED);
+			continue;
+		}
+		else if (flags & RF_NEW)
+		{
+			unsigned type = 0;
+			isValid = (pBase == 0 && ReadVarint(pData, pEnd, type) && type < AT_INVALID);
+			obj = ZERO_OBJECT;
+			obj.type = static_cast<M5ArcheTypes>(type);
+		}
+		else
+		{
+			isValid = (pBase != 0);
+			obj = isValid ? *pBase : ZERO_OBJECT;
+		}
+		obj.id = id;
+
+		if (flags & RF_POS)
+			isValid = isValid && ReadChange(pData, pEnd, obj.pos[0]) && ReadChange(pData, pEnd, obj.pos[1]);
+		if (flags & RF_VEL)
+			isValid = isValid && ReadChange(pData, pEnd, obj.vel[0]) && ReadChange(pData, pEnd, obj.vel[1]);
+		if (flags & RF_SCALE)
+			isValid = isValid && ReadChange(pData, pEnd, obj.scale[0]) && ReadChange(pData, pEnd, obj.scale[1]);
+		if (flags & RF_ROT)
+		{
+			isValid = isValid && ReadChange(pData, pEnd, obj.rotation);
+			obj.rotation &= ANGLE_MASK;
+		}
+		if (flags & RF_DATA)
+		{
+			isValid = isValid && ReadVarint(pData, pEnd, obj.dataSize) &&
+				obj.dataSize <= static_cast<size_t>(pEnd - pData);
+			pBytes = pData;
+			if (isValid)
+				pData += obj.dataSize;
+		}
+
+		if (isValid)
+			AddCopy(obj, pBytes);
+	}
+
+	if (!isValid)
+	{
+		Clear();
+		return false;
+	}
+
+	for (; b < baseCount; ++b)
+		AddCopy(bases[b], baseline.GetData(static_cast<int>(b)));
+
+	if (m_objects.size() != count)
+	{
+		Clear();
+		return false;
+	}
+	return true;
+}
+/******************************************************************************/
+/*!
+Gets the number of objects in the world.
+
+\return
+The number of objects.
+*/
+/******************************************************************************/
+int M5ReplicaWorld::GetObjectCount(void) const
+{
+	return static_cast<int>(m_objects.size());
+}
+/******************************************************************************/
+/*!
+Gets the quantized state of an object.
+
+\param [in] index
+The index of the object, from 0 to GetObjectCount.  Objects are sorted by id.
+
+\return
+The state of the object.
+*/
+/******************************************************************************/
+const M5ReplicaObject& M5ReplicaWorld::GetObject(int index) const
+{
+	M5DEBUG_ASSERT(index >= 0 && index < GetObjectCount(), "Replica object index is out of range");
+	return m_objects[index];
+}
+/******************************************************************************/
+/*!
+Gets the state of an object converted back to engine values.
+
+\param [in] index
+The index of the object, from 0 to GetObjectCount.
+
+\param [out] pos
+The position.
+
+\param [out] vel
+The velocity.
+
+\param [out] scale
+The scale.
+
+\param [out] rotation
+The rotation in radians, from 0 to 2PI.
+*/
+/******************************************************************************/
+void M5ReplicaWorld::GetState(int index, M5Vec2& pos, M5Vec2& vel, M5Vec2& scale, float& rotation) const
+{
+	const M5ReplicaObject& obj = GetObject(index);
+	pos.x = obj.pos[0] / REPLICA_STEPS;
+	pos.y = obj.pos[1] / REPLICA_STEPS;
+	vel.x = obj.vel[0] / REPLICA_STEPS;
+	vel.y = obj.vel[1] / REPLICA_STEPS;
+	scale.x = obj.scale[0] / REPLICA_STEPS;
+	scale.y = obj.scale[1] / REPLICA_STEPS;
+	rotation = obj.rotation * (M5Math::TWO_PI / ANGLE_STEPS);
+}
+/******************************************************************************/
+/*!
+Gets the bytes the components of an object wrote in Replicate.  There are
+GetObject(index).dataSize of them.
+
+\param [in] index
+The index of the object, from 0 to GetObjectCount.
+
+\return
+The first byte, or 0 if the components didn't write anything.
+*/
+/******************************************************************************/
+const unsigned char* M5ReplicaWorld::GetData(int index) const
+{
+	const M5ReplicaObject& obj = GetObject(index);
+	return (obj.dataSize == 0) ? 0 : &m_data[obj.dataStart];
+}
+/******************************************************************************/
+/*!
+Checks if two worlds have the same objects in the same state.  Clients can use
+this to test that they rebuilt exactly what the server sent.
+
+\param [in] other
+The world to compare to.
+
+\return
+True if every object and its component bytes match.
+*/
+/******************************************************************************/
+bool M5ReplicaWorld::Matches(const M5ReplicaWorld& other) const
+{
+	if (m_objects.size() != other.m_objects.size())
+		return false;
+
+	for (size_t i = 0; i < m_objects.size(); ++i)
+	{
+		const M5ReplicaObject& obj = m_objects[i];
+		if (obj.id != other.m_objects[i].id || obj.type != other.m_objects[i].type ||
+			GetChanges(obj, GetData(static_cast<int>(i)), other.m_objects[i], other.GetData(static_cast<int>(i))) != 0)
+			return false;
+	}
+	return true;
+}
+/******************************************************************************/
+/*!
+Finds the fields of an object that are different from a baseline.
+
+\param [in] obj
+The new state.
+
+\param [in] pData
+The component bytes of the new state.
+
+\param [in] base
+The baseline state.
+
+\param [in] pBaseData
+The component bytes of the baseline state.
+
+\return
+The RF_ flags of the fields that changed, 0 if nothing changed.
+*/
+/******************************************************************************/
+unsigned M5ReplicaWorld::GetChanges(const M5ReplicaObject& obj, const unsigned char* pData,
+	const M5ReplicaObject& base, const unsigned char* pBaseData)
+{
+	unsigned flags = 0;
+	if (obj.pos[0] != base.pos[0] || obj.pos[1] != base.pos[1])
+		flags |= RF_POS;
+	if (obj.vel[0] != base.vel[0] || obj.vel[1] != base.vel[1])
+		flags |= RF_VEL;
+	if (obj.scale[0] != base.scale[0] || obj.scale[1] != base.scale[1])
+		flags |= RF_SCALE;
+	if (obj.rotation != base.rotation)
+		flags |= RF_ROT;
+	if (obj.dataSize != base.dataSize ||
+		(obj.dataSize != 0 && std::memcmp(pData, pBaseData, obj.dataSize) != 0))
+		flags |= RF_DATA;
+	return flags;
+}
+/******************************************************************************/
+/*!
+Adds an object to the end of the world along with its component bytes.
+
+\param [in] obj
+The object to add.  Its dataStart is replaced.
+
+\param [in] pData
+Its component bytes, obj.dataSize of them.
+*/
+/******************************************************************************/
+void M5ReplicaWorld::AddCopy(const M5ReplicaObject& obj, const unsigned char* pData)
+{
+	m_objects.push_back(obj);
+	m_objects.back().dataStart = static_cast<unsigned>(m_data.size());
+	if (obj.dataSize != 0)
+		m_data.insert(m_data.end(), pData, pData + obj.dataSize);
+}
@@ -0,0 +1,77 @@
+/******************************************************************************/
+/*!
+\file   M5ReplicaWorld.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+The quantized state of every replicated object, and the delta compression
+used to send it from a server to its clients.
+
+*/
+/******************************************************************************/
+#ifndef M5_REPLICA_WORLD_H
+#define M5_REPLICA_WORLD_H
+
+#include "M5ArcheTypes.h"
+#include "M5Vec2.h"
+#include <vector>
+
+//Forward declarations
+class M5Object;
+
+//! The quantized state of one object as replication clients see it
+struct M5ReplicaObject
+{
+	int          id;        //!< The id of the object on the server
+	M5ArcheTypes type;      //!< The ArcheType of the object
+	int          pos[2];    //!< Position in 1/16ths of a unit
+	int          vel[2];    //!< Velocity in 1/16ths of a unit
+	int          scale[2];  //!< Scale in 1/16ths of a unit
+	int          rotation;  //!< Rotation as a fraction of a full turn, from 0 to 65535
+	unsigned     dataStart; //!< Index of the first byte written by component Replicate
+	unsigned     dataSize;  //!< Number of bytes written by component Replicate
+};
+
+/*! The quantized state of every replicated object at one point in time.  A
+server saves one of these each time it sends, and writes the difference
+from the last world a client acknowledged.  Objects that didn't change since
+that world cost nothing, and changed fields are sent as small varints.*/
+class M5ReplicaWorld
+{
+public:
+	M5ReplicaWorld(void);
+	//Removes every object but keeps the memory
+	void Clear(void);
+	//Quantizes an object and adds it to the end of the world
+	void AddObject(const M5Object& obj);
+	//Sorts the objects by id, must be called after the last AddObject
+	void Sort(void);
+	//Writes the difference between this world and an older one
+	void WriteDelta(const M5ReplicaWorld& baseline, std::vector<unsigned char>& out) const;
+	//Rebuilds this world from an older one and the difference written by WriteDelta
+	bool ReadDelta(const M5ReplicaWorld& baseline, const unsigned char* pData, size_t size);
+	//Gets the number of objects
+	int GetObjectCount(void) const;
+	//Gets the quantized state of an object
+	const M5ReplicaObject& GetObject(int index) const;
+	//Gets the state of an object as engine values
+	void GetState(int index, M5Vec2& pos, M5Vec2& vel, M5Vec2& scale, float& rotation) const;
+	//Gets the bytes written by the components of an object
+	const unsigned char* GetData(int index) const;
+	//Checks if two worlds have the same objects in the same state
+	bool Matches(const M5ReplicaWorld& other) const;
+
+	unsigned sequence; //!< The number of the snapshot this world was sent in, 0 for none
+private:
+	static unsigned GetChanges(const M5ReplicaObject& obj, const unsigned char* pData,
+		const M5ReplicaObject& base, const unsigned char* pBaseData);
+	void AddCopy(const M5ReplicaObject& obj, const unsigned char* pData);
+
+	std::vector<M5ReplicaObject> m_objects; //!< Every object, sorted by id
+	std::vector<unsigned char>   m_data;    //!< The bytes written by component Replicate
+};
+
+
+#endif //M5_REPLICA_WORLD_H
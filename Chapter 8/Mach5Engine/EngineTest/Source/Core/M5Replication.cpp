@@ -0,0 +1,428 @@
+/******************************************************************************/
+/*!
+\file   M5Replication.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Singleton class to host the simulation and send the state of every object to
+clients over UDP.
+
+The server keeps the last REPLICA_HISTORY worlds it sent.  Clients ack every
+snapshot they read, and the next delta for a client is written against the
+newest world it acked, or against an empty world if that one is too old.
+Nothing is ever resent, so a lost packet only costs a bigger delta later.
+
+*/
+/******************************************************************************/
+#include "M5Replication.h"
+#include "M5ReplicaWorld.h"
+#include "M5Socket.h"
+#include "M5ObjectManager.h"
+#include "M5Debug.h"
+#include "M5Log.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+const float CLIENT_TIMEOUT = 5.0f;   //!< Seconds without hearing from a client before it is dropped
+const float BANDWIDTH_TIME = 1.0f;   //!< Seconds of sends averaged for GetClientBandwidth
+const int   MAX_CLIENTS = 32;        //!< Connects past this are ignored
+
+//! A client that asked for snapshots
+struct M5ReplicaClientInfo
+{
+	M5Address address;     //!< Where to send snapshots
+	unsigned  acked;       //!< The newest snapshot the client read, 0 for none
+	float     idleTime;    //!< Seconds since the client sent anything
+	long long windowBytes; //!< Bytes sent since the bandwidth was last measured
+	float     windowTime;  //!< Seconds since the bandwidth was last measured
+	float     bandwidth;   //!< Bytes per second over the last BANDWIDTH_TIME
+	long long totalBytes;  //!< Bytes sent since the client connected
+	float     totalTime;   //!< Seconds since the client connected
+};
+
+typedef std::vector<M5ReplicaClientInfo> ClientVec; //!< typedef Container of connected clients
+
+M5Socket                   s_socket;                    //!< The port clients connect to
+bool                       s_isRunning;                 //!< True between StartServer and StopServer
+float                      s_sendInterval;              //!< Seconds between snapshots
+float                      s_sendTime;                  //!< Seconds since the last snapshot
+unsigned                   s_sequence;                  //!< The number of the last snapshot, 0 for none
+M5ReplicaWorld             s_history[REPLICA_HISTORY];  //!< The last worlds sent, by sequence % REPLICA_HISTORY
+M5ReplicaWorld             s_empty;                     //!< Baseline for clients that haven't acked anything
+ClientVec                  s_clients;                   //!< Every connected client
+std::vector<unsigned char> s_delta;                     //!< Reused by SendSnapshot so it doesn't allocate
+unsigned char              s_packet[REPLICA_PACKET_SIZE]; //!< Reused for every packet sent and received
+float                      s_encodeTime;                //!< Seconds spent writing deltas for the last snapshot
+
+/******************************************************************************/
+/*!
+Logs a client joining or leaving, with how much was sent to it.
+
+\param [in] client
+The client.
+
+\param [in] reason
+What happened to it.
+*/
+/******************************************************************************/
+void LogClient(const M5ReplicaClientInfo& client, const char* reason)
+{
+	float average = (client.totalTime > 0) ? client.totalBytes / client.totalTime : 0.0f;
+	unsigned ip = client.address.ip;
+	char address[32];
+	std::snprintf(address, sizeof(address), "%u.%u.%u.%u:%u",
+		ip >> 24, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF, client.address.port);
+	M5Log::Write(LL_INFO, LC_NET, "M5Replication: client %s %s, %lld bytes, %.1f KB/s average",
+		address, reason, client.totalBytes, average / 1024.0f);
+}
+/******************************************************************************/
+/*!
+Finds a client by address.
+
+\param [in] address
+The address to look for.
+
+\return
+The index of the client, or -1 if it isn't connected.
+*/
+/******************************************************************************/
+int FindClient(const M5Address& address)
+{
+	for (size_t i = 0; i < s_clients.size(); ++i)
+	{
+		if (M5Socket::IsSame(s_clients[i].address, address))
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+}//end unnamed namespace
+
+/******************************************************************************/
+/*!
+Opens a UDP port and starts sending snapshots to anyone that connects.
+
+\param [in] port
+The port to listen on, or 0 to let the system pick one.
+
+\param [in] sendRate
+Snapshots per second.  Sending less often than the game updates saves
+bandwidth.
+
+\return
+True if the port was opened.
+*/
+/******************************************************************************/
+bool M5Replication::StartServer(unsigned short port, float sendRate)
+{
+	M5DEBUG_ASSERT(!s_isRunning, "The replication server is already running");
+	M5DEBUG_ASSERT(sendRate > 0, "The send rate must be more than 0");
+
+	if (!s_socket.Open(port))
+	{
+		M5Log::Write(LL_ERROR, LC_NET, "M5Replication: could not open port %d", port);
+		return false;
+	}
+
+	s_isRunning = true;
+	s_sendInterval = 1.0f / sendRate;
+	s_sendTime = s_sendInterval;
+	s_sequence = 0;
+	s_encodeTime = 0;
+	s_clients.clear();
+	for (unsigned i = 0; i < REPLICA_HISTORY; ++i)
+	{
+		s_history[i].Clear();
+		s_history[i].sequence = 0;
+	}
+
+	M5Log::Write(LL_INFO, LC_NET, "M5Replication: serving on port %d at %.1f snapshots/s",
+		s_socket.GetPort(), sendRate);
+	return true;
+}
+/******************************************************************************/
+/*!
+Stops sending snapshots, forgets every client and closes the port.  It is safe
+to call when the server isn't running.
+*/
+/******************************************************************************/
+void M5Replication::StopServer(void)
+{
+	if (!s_isRunning)
+		return;
+
+	for (size_t i = 0; i < s_clients.size(); ++i)
+		LogClient(s_clients[i], "stopped");
+
+	s_clients.clear();
+	s_socket.Close();
+	s_isRunning = false;
+}
+/******************************************************************************/
+/*!
+Checks if the server is running.
+
+\return
+True between StartServer and StopServer.
+*/
+/******************************************************************************/
+bool M5Replication::IsRunning(void)
+{
+	return s_isRunning;
+}
+/******************************************************************************/
+/*!
+Gets the port the server is open on.
+
+\return
+The port, or 0 if the server isn't running.
+*/
+/******************************************************************************/
+unsigned short M5Replication::GetPort(void)
+{
+	return s_socket.GetPort();
+}
+/******************************************************************************/
+/*!
+Gets the number of connected clients.
+
+\return
+The number of clients.
+*/
+/******************************************************************************/
+int M5Replication::GetClientCount(void)
+{
+	return static_cast<int>(s_clients.size());
+}
+/******************************************************************************/
+/*!
+Gets the bytes per second being sent to a client, including packet headers
+but not the UDP and IP headers.
+
+\param [in] client
+The index of the client, from 0 to GetClientCount.
+
+\return
+The bytes per second averaged over the last second.  Before the first second
+it is averaged over the time so far.
+*/
+/******************************************************************************/
+float M5Replication::GetClientBandwidth(int client)
+{
+	M5DEBUG_ASSERT(client >= 0 && client < GetClientCount(), "Replication client index is out of range");
+	const M5ReplicaClientInfo& info = s_clients[client];
+	if (info.bandwidth == 0 && info.windowTime > 0)
+		return info.windowBytes / info.windowTime;
+	return info.bandwidth;
+}
+/******************************************************************************/
+/*!
+Gets the time spent writing deltas for the last snapshot.  Each client has its
+own baseline, so this grows with the number of clients.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+float M5Replication::GetEncodeTime(void)
+{
+	return s_encodeTime;
+}
+/******************************************************************************/
+/*!
+Gets the number of objects in the last snapshot.
+
+\return
+The number of objects, or 0 if nothing was sent yet.
+*/
+/******************************************************************************/
+int M5Replication::GetObjectCount(void)
+{
+	if (s_sequence == 0)
+		return 0;
+	return s_history[s_sequence % REPLICA_HISTORY].GetObjectCount();
+}
+/******************************************************************************/
+/*!
+Reads packets from clients and sends a snapshot when it is time.  This is
+called by M5StageManager after the stage update, so snapshots have the
+state of the finished frame.
+
+\param [in] dt
+The frame time in seconds.
+*/
+/******************************************************************************/
+void M5Replication::Update(float dt)
+{
+	if (!s_isRunning)
+		return;
+
+	Receive();
+
+	for (size_t i = 0; i < s_clients.size();)
+	{
+		M5ReplicaClientInfo& client = s_clients[i];
+		client.idleTime += dt;
+		client.windowTime += dt;
+		client.totalTime += dt;
+		if (client.windowTime >= BANDWIDTH_TIME)
+		{
+			client.bandwidth = client.windowBytes / client.windowTime;
+			client.windowBytes = 0;
+			client.windowTime = 0;
+		}
+
+		if (client.idleTime > CLIENT_TIMEOUT)
+		{
+			LogClient(client, "timed out");
+			s_clients[i] = s_clients.back();
+			s_clients.pop_back();
+		}
+		else
+			++i;
+	}
+
+	s_sendTime += dt;
+	if (s_sendTime < s_sendInterval)
+		return;
+
+	/*Don't try to catch up after a long frame*/
+	s_sendTime -= s_sendInterval;
+	if (s_sendTime > s_sendInterval)
+		s_sendTime = 0;
+
+	SendSnapshot();
+}
+/******************************************************************************/
+/*!
+Stops the server when the engine shuts down.
+*/
+/******************************************************************************/
+void M5Replication::Shutdown(void)
+{
+	StopServer();
+	for (unsigned i = 0; i < REPLICA_HISTORY; ++i)
+		s_history[i] = M5ReplicaWorld();
+	std::vector<unsigned char>().swap(s_delta);
+}
+/******************************************************************************/
+/*!
+Reads every waiting packet.  Connects add a client, acks move its baseline
+forward, and disconnects remove it.  Anything else is ignored.
+*/
+/******************************************************************************/
+void M5Replication::Receive(void)
+{
+	M5Address from;
+	int size;
+	while ((size = s_socket.Receive(from, s_packet, REPLICA_PACKET_SIZE)) != 0)
+	{
+		M5ReplicaHeader header;
+		if (size < static_cast<int>(sizeof(header)))
+			continue;
+		std::memcpy(&header, s_packet, sizeof(header));
+		if (header.magic != REPLICA_MAGIC || header.version != REPLICA_VERSION)
+			continue;
+
+		int index = FindClient(from);
+		if (header.type == RP_CONNECT && index == -1)
+		{
+			if (static_cast<int>(s_clients.size()) >= MAX_CLIENTS)
+				continue;
+
+			M5ReplicaClientInfo client;
+			std::memset(&client, 0, sizeof(client));
+			client.address = from;
+			s_clients.push_back(client);
+			LogClient(client, "connected");
+			continue;
+		}
+		if (index == -1)
+			continue;
+
+		M5ReplicaClientInfo& client = s_clients[index];
+		client.idleTime = 0;
+		if (header.type == RP_ACK)
+		{
+			/*Acks can arrive out of order, and only sent snapshots can be acked*/
+			if (header.sequence > client.acked && header.sequence <= s_sequence)
+				client.acked = header.sequence;
+		}
+		else if (header.type == RP_DISCONNECT)
+		{
+			LogClient(client, "disconnected");
+			s_clients[index] = s_clients.back();
+			s_clients.pop_back();
+		}
+	}
+}
+/******************************************************************************/
+/*!
+Saves the world and sends each client the difference from the newest world it
+acked, split into packets.
+*/
+/******************************************************************************/
+void M5Replication::SendSnapshot(void)
+{
+	++s_sequence;
+	M5ReplicaWorld& world = s_history[s_sequence % REPLICA_HISTORY];
+	M5ObjectManager::Replicate(world);
+	world.sequence = s_sequence;
+
+	s_encodeTime = 0;
+	for (size_t i = 0; i < s_clients.size(); ++i)
+	{
+		M5ReplicaClientInfo& client = s_clients[i];
+
+		/*Use the acked world if it is still in the history*/
+		const M5ReplicaWorld* pBaseline = &s_empty;
+		if (client.acked != 0 && s_sequence - client.acked < REPLICA_HISTORY)
+		{
+			const M5ReplicaWorld& acked = s_history[client.acked % REPLICA_HISTORY];
+			if (acked.sequence == client.acked)
+				pBaseline = &acked;
+		}
+
+		std::chrono::high_resolution_clock::time_point encodeStart = std::chrono::high_resolution_clock::now();
+		world.WriteDelta(*pBaseline, s_delta);
+		s_encodeTime += std::chrono::duration<float>(
+			std::chrono::high_resolution_clock::now() - encodeStart).count();
+
+		int deltaSize = static_cast<int>(s_delta.size());
+		int fragmentCount = (deltaSize + REPLICA_FRAGMENT_SIZE - 1) / REPLICA_FRAGMENT_SIZE;
+		if (fragmentCount > REPLICA_MAX_FRAGMENTS)
+		{
+			M5Log::Write(LL_ERROR, LC_NET, "M5Replication: snapshot of %d bytes is too big to send", deltaSize);
+			continue;
+		}
+
+		M5ReplicaHeader header;
+		header.sequence = s_sequence;
+		header.baseline = pBaseline->sequence;
+		header.magic = REPLICA_MAGIC;
+		header.fragmentCount = static_cast<unsigned short>(fragmentCount);
+		header.type = RP_SNAPSHOT;
+		header.version = REPLICA_VERSION;
+
+		for (int fragment = 0; fragment < fragmentCount; ++fragment)
+		{
+			int start = fragment * REPLICA_FRAGMENT_SIZE;
+			int size = (deltaSize - start < REPLICA_FRAGMENT_SIZE) ? deltaSize - start : REPLICA_FRAGMENT_SIZE;
+			header.fragment = static_cast<unsigned short>(fragment);
+			std::memcpy(s_packet, &header, sizeof(header));
+			std::memcpy(s_packet + sizeof(header), &s_delta[start], size);
+
+			int packetSize = static_cast<int>(sizeof(header)) + size;
+			s_socket.Send(client.address, s_packet, packetSize);
+			client.windowBytes += packetSize;
+			client.totalBytes += packetSize;
+		}
+	}
+}
@@ -0,0 +1,82 @@
+/******************************************************************************/
+/*!
+\file   M5Replication.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Singleton class to host the simulation and send the state of every object to
+clients over UDP.
+
+*/
+/******************************************************************************/
+#ifndef M5_REPLICATION_H
+#define M5_REPLICATION_H
+
+//! The kinds of packets sent between a replication server and its clients
+enum M5ReplicaPacket
+{
+	RP_CONNECT,    //!< Client to server, asks for snapshots
+	RP_SNAPSHOT,   //!< Server to client, one fragment of a delta
+	RP_ACK,        //!< Client to server, the sequence of a snapshot that was read
+	RP_DISCONNECT  //!< Client to server, stops the snapshots
+};
+
+//! The start of every replication packet
+struct M5ReplicaHeader
+{
+	unsigned       sequence;      //!< The snapshot this packet is about
+	unsigned       baseline;      //!< The snapshot the delta was written against, 0 for none
+	unsigned short magic;         //!< REPLICA_MAGIC, so stray packets are ignored
+	unsigned short fragment;      //!< Which piece of the delta this is
+	unsigned short fragmentCount; //!< How many pieces the delta was split into
+	unsigned char  type;          //!< An M5ReplicaPacket
+	unsigned char  version;       //!< REPLICA_VERSION, so old clients are ignored
+};
+
+const unsigned short REPLICA_MAGIC = 0x4D35;       //!< The value of M5ReplicaHeader::magic
+const unsigned char  REPLICA_VERSION = 1;          //!< The value of M5ReplicaHeader::version
+const int            REPLICA_PACKET_SIZE = 1200;   //!< Largest packet, small enough to never be split by the network
+const int            REPLICA_FRAGMENT_SIZE = REPLICA_PACKET_SIZE - static_cast<int>(sizeof(M5ReplicaHeader)); //!< Delta bytes in one packet
+const int            REPLICA_MAX_FRAGMENTS = 1024; //!< Largest delta is this many packets
+const unsigned       REPLICA_HISTORY = 32;         //!< Snapshots kept as baselines, acks older than this are ignored
+
+/*! Singleton class to host the simulation for remote clients.  Every send,
+it saves the quantized state of every object as an M5ReplicaWorld.  Each
+client gets the difference from the last world it acknowledged, split into
+packets small enough to never be split by the network.  Lost packets are
+never sent again.  The next snapshot is just written against an older
+baseline, so clients catch up without waiting for a resend.*/
+class M5Replication
+{
+public:
+	friend class M5App;
+	friend class M5StageManager;
+	friend class M5Benchmark;
+
+	//Opens a UDP port and starts sending snapshots sendRate times a second
+	static bool StartServer(unsigned short port, float sendRate);
+	//Stops sending and forgets every client
+	static void StopServer(void);
+	//Checks if the server is running
+	static bool IsRunning(void);
+	//Gets the port the server is open on
+	static unsigned short GetPort(void);
+	//Gets the number of connected clients
+	static int GetClientCount(void);
+	//Gets the bytes per second being sent to a client
+	static float GetClientBandwidth(int client);
+	//Gets the seconds spent writing deltas for the last snapshot, for every client
+	static float GetEncodeTime(void);
+	//Gets the number of objects in the last snapshot
+	static int GetObjectCount(void);
+private:
+	static void Update(float dt);
+	static void Shutdown(void);
+	static void Receive(void);
+	static void SendSnapshot(void);
+};//end M5Replication
+
+
+#endif //M5_REPLICATION_H
@@ -8,11 +8,19 @@
 
 Class to help load graphics resources such as textures, shaders and meshes.
 For now it only loads textures of type tga.
+
+Textures are found by id in one map and by file name in another, so
+unloading never searches.  A texture nobody uses is not deleted right away.
+It is kept in a cache list until the textures in the GFX API go over the
+budget, then the least recently used ones are deleted.  Loading a cached
+texture again is just a map lookup.
 */
 /******************************************************************************/
 #include "M5ResourceManager.h"
 #include "M5Math.h"
 #include "M5Debug.h"
+#include "M5Memory.h"
+#include "M5RenderBackend.h"
 
 //opengl
 #include "gl/glew.h"
@@ -27,6 +35,9 @@ For now it only loads textures of type tga.
 
 namespace
 {
+const long long TEXTURE_BUDGET  = 64 * 1024 * 1024; /*Default bytes of textures to keep*/
+const long long BYTES_PER_PIXEL = 4;                /*Both backends keep 32 bits per pixel, even for GL_RGB*/
+
 /*A struct to pass Texture data to open gl*/
 struct M5Texture
 {
@@ -72,7 +83,7 @@ void LoadFail(M5Texture* pTexture, FILE** ppFile, const char* p)
 	/*Sometimes I don't need to delete the texture*/
 	if (pTexture)
 	{
-		delete[] pTexture->imageData;
+		M5Memory::Free(pTexture->imageData);
 		pTexture->imageData = 0;
 	}
 	/*Always close the file*/
@@ -127,7 +138,7 @@ int UpdateTexture(M5Texture* pTexture, const M5TGAHeader* pHeader)
 	}
 
 	/*Allocate image data*/
-	pTexture->imageData = new GLubyte[pTexture->imageSize];
+	pTexture->imageData = static_cast<GLubyte*>(M5Memory::Allocate(pTexture->imageSize, MT_RESOURCES));
 
 	return true;
 }
@@ -387,6 +398,22 @@ int LoadTGA(M5Texture* pTexture, const char* fileName)
 
 }//end unnamed namespace
 
+/******************************************************************************/
+/*!
+Constructor for ResourceManager class.  SetBackend must be called before any
+texture is loaded.
+*/
+/******************************************************************************/
+M5ResourceManager::M5ResourceManager(void) :
+	m_pBackend(0),
+	m_residentBytes(0),
+	m_cachedBytes(0),
+	m_budget(TEXTURE_BUDGET),
+	m_hits(0),
+	m_misses(0),
+	m_evictions(0)
+{
+}
  /******************************************************************************/
  /*!
 Destructor for ResourceManager class.  This checks to make sure all textures
@@ -399,22 +426,121 @@ M5ResourceManager::~M5ResourceManager(void)
 }
 /******************************************************************************/
 /*!
-Helper function to clear all textures in the texture map
+Sets the render backend that makes and deletes textures.  This must be called
+before any texture is loaded.
+
+\param pBackend
+The backend to use.
+*/
+/******************************************************************************/
+void M5ResourceManager::SetBackend(M5RenderBackend* pBackend)
+{
+	m_pBackend = pBackend;
+}
+/******************************************************************************/
+/*!
+Deletes the textures that were unloaded since the last call.  Textures aren't
+deleted in UnloadTexture because the render thread might still be drawing a
+frame that uses them, so this must only be called while it is idle.
+*/
+/******************************************************************************/
+void M5ResourceManager::DeleteUnused(void)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t size = m_unused.size();
+	for (size_t i = 0; i < size; ++i)
+		m_pBackend->DeleteTexture(m_unused[i]);
+
+	m_unused.clear();
+}
+/******************************************************************************/
+/*!
+Helper function to clear all textures in the texture map, including the ones
+that are only cached.
 */
 /******************************************************************************/
 void M5ResourceManager::Clear(void)
 {
+	ClearPrefetched();
+	DeleteUnused();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
 	//Get itors to start and end
 	M5TextureMapItor itor = m_textureMap.begin();
 	M5TextureMapItor end = m_textureMap.end();
 
 	while (itor != end)
 	{
-		glDeleteTextures(1, (GLuint*)&itor->second.id);
+		m_pBackend->DeleteTexture(itor->second.id);
 		++itor;
 	}
 
 	m_textureMap.clear();
+	m_nameMap.clear();
+	m_cache.clear();
+	m_residentBytes = 0;
+	m_cachedBytes = 0;
+}
+/******************************************************************************/
+/*!
+Sets how many bytes of textures to keep in the GFX API.  Textures that are in
+use are never evicted, so this can be passed.  Cached textures are evicted
+right away if there are too many.
+
+\param bytes
+The budget.  Zero deletes every texture as soon as it is unloaded.
+*/
+/******************************************************************************/
+void M5ResourceManager::SetBudget(long long bytes)
+{
+	M5DEBUG_ASSERT(bytes >= 0, "The texture budget can't be negative");
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_budget = bytes;
+	EvictToBudget();
+}
+/******************************************************************************/
+/*!
+Gets the texture memory in use and the cache counts since the game started.
+
+\param [out] stats
+The struct to fill.
+*/
+/******************************************************************************/
+void M5ResourceManager::GetStats(M5TextureStats& stats)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	stats.residentBytes = m_residentBytes;
+	stats.cachedBytes   = m_cachedBytes;
+	stats.budget        = m_budget;
+	stats.residentCount = static_cast<int>(m_textureMap.size());
+	stats.cachedCount   = static_cast<int>(m_cache.size());
+	stats.hits          = m_hits;
+	stats.misses        = m_misses;
+	stats.evictions     = m_evictions;
+}
+/******************************************************************************/
+/*!
+Deletes the least recently used cached textures until the textures in the GFX
+API fit in the budget or nothing is cached.  m_mutex must be locked.
+*/
+/******************************************************************************/
+void M5ResourceManager::EvictToBudget(void)
+{
+	while (m_residentBytes > m_budget && !m_cache.empty())
+	{
+		int id = m_cache.front();
+		m_cache.pop_front();
+
+		M5TextureMapItor itor = m_textureMap.find(id);
+		m_residentBytes -= itor->second.bytes;
+		m_cachedBytes -= itor->second.bytes;
+		m_nameMap.erase(itor->second.fileName);
+		m_textureMap.erase(itor);
+
+		//The render thread might still be drawing with it
+		m_unused.push_back(id);
+		++m_evictions;
+	}
 }
 /******************************************************************************/
 /*!
@@ -438,42 +564,123 @@ returns -1, the texture was not loaded.
 /******************************************************************************/
 int M5ResourceManager::LoadTexture(const char* fileName)
 {
-	//Check if we have already loaded the texture
-	M5TextureMapItor itor = m_textureMap.find(fileName);
-	if (itor != m_textureMap.end())
+	M5Texture texture;
+	bool prefetched = false;
 	{
-		++(itor->second.count);
-		return itor->second.id;
+		std::lock_guard<std::mutex> lock(m_mutex);
+		//Check if we have already loaded the texture, or still have it cached
+		M5NameMapItor name = m_nameMap.find(fileName);
+		if (name != m_nameMap.end())
+		{
+			M5LoadedTexture& loaded = m_textureMap.find(name->second)->second;
+			if (loaded.count == 0)
+			{
+				m_cache.erase(loaded.lru);
+				m_cachedBytes -= loaded.bytes;
+			}
+			++loaded.count;
+			++m_hits;
+			return loaded.id;
+		}
+
+		//Check if the loading thread already read it from disk
+		M5DecodedMapItor decoded = m_decodedMap.find(fileName);
+		if (decoded != m_decodedMap.end())
+		{
+			texture.imageData = decoded->second.imageData;
+			texture.width     = decoded->second.width;
+			texture.height    = decoded->second.height;
+			texture.format    = decoded->second.format;
+			m_decodedMap.erase(decoded);
+			prefetched = true;
+		}
 	}
 
-	M5Texture texture;
 	int id = -1;
 	/*Try to load the data*/
-	if (!LoadTGA(&texture, fileName))
+	if (!prefetched && !LoadTGA(&texture, fileName))
 		return id;
 
-	/*Request a texture from openGL*/
-	glGenTextures(1, (GLuint*)&id);
-	/*Set up my texture*/
-	glBindTexture(GL_TEXTURE_2D, id);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	glTexImage2D(GL_TEXTURE_2D, 0, texture.format, texture.width, texture.height,
-		0, texture.format, GL_UNSIGNED_BYTE, texture.imageData);
+	/*Give the pixels to the render backend*/
+	id = m_pBackend->CreateTexture(texture.imageData, texture.width, texture.height, texture.format);
 
 	/*Free texture data now*/
-	delete[] texture.imageData;
+	M5Memory::Free(texture.imageData);
 
 	//Add LoadedTexture to texture map
-	M5LoadedTexture loadedTex(fileName, id);
-	m_textureMap.insert(std::make_pair(fileName, loadedTex));
+	long long bytes = static_cast<long long>(texture.width) * texture.height * BYTES_PER_PIXEL;
+	M5LoadedTexture loadedTex(fileName, id, bytes);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	M5DEBUG_ASSERT(m_textureMap.find(id) == m_textureMap.end(),
+		"The render backend gave out a texture id that is still in use");
+	m_textureMap.insert(std::make_pair(id, loadedTex));
+	m_nameMap.insert(std::make_pair(fileName, id));
+	m_residentBytes += bytes;
+	++m_misses;
+
+	//Make room for it by deleting old cached textures
+	EvictToBudget();
 
 	/*return given id.*/
 	return id;
 }
 /******************************************************************************/
 /*!
+Reads and decodes a texture from disk without giving it to the GFX API.  The
+next call to LoadTexture with the same file name will skip the disk access.
+This is safe to call from a loading thread, because it never touches the GFX
+API.
+
+\param fileName
+The name of the TGA file to read.
+*/
+/******************************************************************************/
+void M5ResourceManager::PrefetchTexture(const char* fileName)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		//No need to read it twice
+		if (m_nameMap.find(fileName) != m_nameMap.end() ||
+			m_decodedMap.find(fileName) != m_decodedMap.end())
+			return;
+	}
+
+	M5Texture texture;
+	if (!LoadTGA(&texture, fileName))
+		return;
+
+	M5DecodedTexture decoded;
+	decoded.imageData = texture.imageData;
+	decoded.width     = texture.width;
+	decoded.height    = texture.height;
+	decoded.format    = texture.format;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	//The main thread might have loaded it while we were reading
+	if (m_nameMap.find(fileName) != m_nameMap.end() ||
+		!m_decodedMap.insert(std::make_pair(fileName, decoded)).second)
+	{
+		M5Memory::Free(texture.imageData);
+	}
+}
+/******************************************************************************/
+/*!
+Frees the data of all prefetched textures that were never loaded.
+*/
+/******************************************************************************/
+void M5ResourceManager::ClearPrefetched(void)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	M5DecodedMapItor itor = m_decodedMap.begin();
+	M5DecodedMapItor end = m_decodedMap.end();
+
+	for (; itor != end; ++itor)
+		M5Memory::Free(itor->second.imageData);
+
+	m_decodedMap.clear();
+}
+/******************************************************************************/
+/*!
 This function adds one to the given texture count.  This should be called if
 The textureID is shared, for example in a clone function.
 
@@ -484,25 +691,26 @@ The ID to update
 /******************************************************************************/
 void M5ResourceManager::UpdateTextureCount(int textureID)
 {
-	//Get itors to start and end
-	M5TextureMapItor begin = m_textureMap.begin();
-	M5TextureMapItor end = m_textureMap.end();
+	std::lock_guard<std::mutex> lock(m_mutex);
+	M5TextureMapItor itor = m_textureMap.find(textureID);
+	if (itor == m_textureMap.end())
+		return;
 
-	//loop through and find the correct id
-	for (; begin != end; ++begin)
+	//A cached texture is in use again
+	if (itor->second.count == 0)
 	{
-		if (begin->second.id == textureID)
-		{
-			++(begin->second.count);
-			break;
-		}
+		m_cache.erase(itor->second.lru);
+		m_cachedBytes -= itor->second.bytes;
 	}
+	++(itor->second.count);
 }
 /******************************************************************************/
 /*!
 This function returns the texture memory (allocated when you called
 LoadTexture) back to the graphics card.  This must be called for every texture
-you loaded.
+you loaded.  When the last load is unloaded, the texture is cached so loading
+it again is fast.  It is deleted by the next call to DeleteUnused once the
+cached textures go over the budget.
 
 \attention
 You must unload every texture id that you loaded.
@@ -513,25 +721,17 @@ A valid textureID from LoadTexture
 /******************************************************************************/
 void M5ResourceManager::UnloadTexture(int textureID)
 {
-	//Get itors to start and end
-	M5TextureMapItor begin = m_textureMap.begin();
-	M5TextureMapItor end = m_textureMap.end();
+	std::lock_guard<std::mutex> lock(m_mutex);
+	M5TextureMapItor itor = m_textureMap.find(textureID);
+	if (itor == m_textureMap.end() || itor->second.count == 0)
+		return;
 
-	//loop through and find the correct id
-	for (; begin != end; ++begin)
+	//if that was the last load, cache the texture
+	if (--(itor->second.count) == 0)
 	{
-		if (begin->second.id == textureID)
-		{
-			//decrement id
-			--(begin->second.count);
-			//if that was the last load, delete the texture
-			if (begin->second.count == 0)
-			{
-				m_textureMap.erase(begin);
-				glDeleteTextures(1, (GLuint*)&textureID);
-				break;
-			}
-		}
+		itor->second.lru = m_cache.insert(m_cache.end(), textureID);
+		m_cachedBytes += itor->second.bytes;
+		EvictToBudget();
 	}
 }
 /******************************************************************************/
@@ -544,9 +744,12 @@ The name of the texture that has been loaded.
 
 \param newID
 The id of the texture that is now loaded.
+
+\param newBytes
+The memory the GFX API uses for the texture.
 */
 /******************************************************************************/
-M5ResourceManager::M5LoadedTexture::M5LoadedTexture(const std::string& str, int newID) :
-	fileName(str), id(newID), count(1)
+M5ResourceManager::M5LoadedTexture::M5LoadedTexture(const std::string& str, int newID, long long newBytes) :
+	fileName(str), id(newID), count(1), bytes(newBytes)
 {
 }
\ No newline at end of file
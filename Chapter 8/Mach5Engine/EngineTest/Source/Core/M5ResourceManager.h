@@ -15,34 +15,109 @@ For now it only loads textures of type tga.
 
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <list>
+#include <mutex>
+
+//Forward declarations
+class M5RenderBackend;
+
+//! Texture memory and how well the cache is working
+struct M5TextureStats
+{
+	long long residentBytes; //!< Bytes of every texture the GFX API holds, used or cached
+	long long cachedBytes;   //!< Bytes of textures nobody uses that are kept in case they are loaded again
+	long long budget;        //!< Most bytes that are kept before cached textures are evicted
+	int       residentCount; //!< Number of textures the GFX API holds
+	int       cachedCount;   //!< Number of cached textures
+	int       hits;          //!< Loads that found the texture already made
+	int       misses;        //!< Loads that had to make the texture
+	int       evictions;     //!< Cached textures deleted to stay under the budget
+};
 
 
 //! Class to Load Resources and hold the associated resource ids used in the game.
 class M5ResourceManager
 {
 public:
+	M5ResourceManager(void);
 	~M5ResourceManager(void);
+	void SetBackend(M5RenderBackend* pBackend);
 	int LoadTexture(const char* fileName);
 	void UpdateTextureCount(int textureID);
 	void UnloadTexture(int textureID);
+	void PrefetchTexture(const char* fileName);
+	void ClearPrefetched(void);
+	void DeleteUnused(void);
 	void Clear(void);
+	void SetBudget(long long bytes);
+	void GetStats(M5TextureStats& stats);
 
 private:
+	void EvictToBudget(void);
+
+	//! typedef for the list of cached texture ids, least recently used first
+	typedef std::list<int> M5CacheList;
+
 	/*!A struct to hold loaded textures and ids so they be placed in a map together*/
 	struct M5LoadedTexture
 	{
-		M5LoadedTexture(const std::string& str, int newID);
-		std::string fileName; //!< The name of the loaded texture
-		int id;               //!< GFX API's return id for this texture
-		int count;            //!< The number of times this texture has been loaded.
+		M5LoadedTexture(const std::string& str, int newID, long long newBytes);
+		std::string fileName;      //!< The name of the loaded texture
+		int id;                    //!< GFX API's return id for this texture
+		int count;                 //!< The number of times this texture has been loaded.
+		long long bytes;           //!< The memory the GFX API uses for this texture
+		M5CacheList::iterator lru; //!< Where it is in m_cache, only valid when count is 0
 	};
 
-	//! Typedef Container to hold loaded textures
-	typedef std::unordered_map<std::string, M5LoadedTexture> M5TextureMap;
+	//! Typedef Container to hold loaded textures by id
+	typedef std::unordered_map<int, M5LoadedTexture> M5TextureMap;
 	//! typedef for my texturemap interators
 	typedef M5TextureMap::iterator M5TextureMapItor;
+	//! Typedef Container to find loaded texture ids by file name
+	typedef std::unordered_map<std::string, int> M5NameMap;
+	//! typedef for my name map interators
+	typedef M5NameMap::iterator M5NameMapItor;
+	/*!A struct to hold image data that was read from disk but not given to the GFX API*/
+	struct M5DecodedTexture
+	{
+		unsigned char* imageData; //!< The decoded pixels
+		unsigned       width;     //!< Image width
+		unsigned       height;    //!< Image height
+		unsigned       format;    //!< GFX API's format of the pixels
+	};
+
+	//! Typedef Container to hold prefetched textures
+	typedef std::unordered_map<std::string, M5DecodedTexture> M5DecodedMap;
+	//! typedef for my decoded map interators
+	typedef M5DecodedMap::iterator M5DecodedMapItor;
+
 	//! Map of ids to loadedtexture info
 	M5TextureMap m_textureMap;
+	//! Map of file names to the ids in m_textureMap
+	M5NameMap    m_nameMap;
+	//! Textures nobody uses, least recently used first
+	M5CacheList  m_cache;
+	//! Map of file names to textures that were prefetched on another thread
+	M5DecodedMap m_decodedMap;
+	//! Textures that were unloaded but might still be drawn by the render thread
+	std::vector<int> m_unused;
+	//! Makes and deletes the textures
+	M5RenderBackend* m_pBackend;
+	//! Guards the maps, since PrefetchTexture is called from a loading thread
+	std::mutex   m_mutex;
+	//! Bytes of every texture in m_textureMap
+	long long    m_residentBytes;
+	//! Bytes of the textures in m_cache
+	long long    m_cachedBytes;
+	//! Most bytes to keep before cached textures are evicted
+	long long    m_budget;
+	//! Loads that found the texture in m_textureMap
+	int          m_hits;
+	//! Loads that had to make the texture
+	int          m_misses;
+	//! Cached textures deleted by EvictToBudget
+	int          m_evictions;
 };
 
 
@@ -0,0 +1,127 @@
+/******************************************************************************/
+/*!
+\file   M5Snapshot.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/22
+
+A contiguous buffer to save and restore the state of game objects and
+components.
+*/
+/******************************************************************************/
+#include "M5Snapshot.h"
+#include "M5Debug.h"
+
+namespace
+{
+const size_t START_SIZE = 1024 * 64; //!< Starting bytes so small worlds never allocate twice
+}
+
+/******************************************************************************/
+/*!
+Constructor for M5Snapshot. Makes space in the buffer.
+*/
+/******************************************************************************/
+M5Snapshot::M5Snapshot(void):
+	m_buffer(START_SIZE),
+	m_size(0),
+	m_readPos(0)
+{
+}
+/******************************************************************************/
+/*!
+Removes all saved data.  The memory is kept so saving again is fast.
+*/
+/******************************************************************************/
+void M5Snapshot::Clear(void)
+{
+	m_size = 0;
+	m_readPos = 0;
+}
+/******************************************************************************/
+/*!
+Moves the read position back to the start of the buffer.
+*/
+/******************************************************************************/
+void M5Snapshot::Rewind(void)
+{
+	m_readPos = 0;
+}
+/******************************************************************************/
+/*!
+Gets the number of bytes saved in the snapshot.
+
+\return
+The size of the snapshot in bytes.
+*/
+/******************************************************************************/
+size_t M5Snapshot::GetSize(void) const
+{
+	return m_size;
+}
+/******************************************************************************/
+/*!
+Gets the bytes saved in the snapshot, so they can be compared or sent
+somewhere.  The pointer is only valid until the next write or Clear.
+
+\return
+The first saved byte, or 0 if nothing is saved.
+*/
+/******************************************************************************/
+const unsigned char* M5Snapshot::GetData(void) const
+{
+	return m_size == 0 ? 0 : m_buffer.data();
+}
+/******************************************************************************/
+/*!
+Copies bytes to the end of the buffer.
+
+\param [in] pData
+The bytes to copy.
+
+\param [in] size
+The number of bytes to copy.
+*/
+/******************************************************************************/
+void M5Snapshot::WriteBytes(const void* pData, size_t size)
+{
+	if (m_size + size > m_buffer.size())
+		Grow(size);
+
+	std::memcpy(m_buffer.data() + m_size, pData, size);
+	m_size += size;
+}
+/******************************************************************************/
+/*!
+Copies bytes from the current read position and moves the read position.
+
+\param [out] pData
+The place to copy to.
+
+\param [in] size
+The number of bytes to copy.
+*/
+/******************************************************************************/
+void M5Snapshot::ReadBytes(void* pData, size_t size)
+{
+	M5DEBUG_ASSERT(m_readPos + size <= m_size, "Reading past the end of the snapshot");
+	std::memcpy(pData, m_buffer.data() + m_readPos, size);
+	m_readPos += size;
+}
+/******************************************************************************/
+/*!
+Makes the buffer at least twice as big, so writing is only slow once in a
+while.
+
+\param [in] size
+The number of bytes about to be written.
+*/
+/******************************************************************************/
+void M5Snapshot::Grow(size_t size)
+{
+	size_t newSize = m_buffer.size() * 2;
+	if (newSize < m_size + size)
+		newSize = m_size + size;
+	m_buffer.resize(newSize);
+}
@@ -0,0 +1,90 @@
+/******************************************************************************/
+/*!
+\file   M5Snapshot.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/22
+
+A contiguous buffer to save and restore the state of game objects and
+components.
+*/
+/******************************************************************************/
+#ifndef M5SNAPSHOT_H
+#define M5SNAPSHOT_H
+
+#include "M5Debug.h"
+
+#include <vector>
+#include <cstring>
+#include <type_traits>
+
+//! A contiguous buffer to save and restore the state of game objects.
+class M5Snapshot
+{
+public:
+	M5Snapshot(void);
+	//Removes all data but keeps the memory so the next save doesn't allocate
+	void   Clear(void);
+	//Moves back to the start of the buffer so it can be read again
+	void   Rewind(void);
+	//Gets the number of bytes saved
+	size_t GetSize(void) const;
+	//Gets the saved bytes, only valid until the next write
+	const unsigned char* GetData(void) const;
+	//Copies bytes to the end of the buffer
+	void   WriteBytes(const void* pData, size_t size);
+	//Copies bytes from the current read position
+	void   ReadBytes(void* pData, size_t size);
+
+	template<typename T>
+	void Write(const T& data);
+	template<typename T>
+	void Read(T& data);
+private:
+	void Grow(size_t size);
+
+	std::vector<unsigned char> m_buffer;  //!< The saved bytes, followed by unused space
+	size_t                     m_size;    //!< The number of saved bytes
+	size_t                     m_readPos; //!< Where the next read will start
+};
+/******************************************************************************/
+/*!
+Copies a value to the end of the buffer.  Only plain data can be written this
+way, anything that owns memory or resources must write the parts it needs.
+This is inline since objects write many small values, and the buffer only
+grows when it is full.
+
+\param [in] data
+The value to save.
+*/
+/******************************************************************************/
+template<typename T>
+void M5Snapshot::Write(const T& data)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be copied into a snapshot");
+	if (m_size + sizeof(T) > m_buffer.size())
+		Grow(sizeof(T));
+
+	std::memcpy(m_buffer.data() + m_size, &data, sizeof(T));
+	m_size += sizeof(T);
+}
+/******************************************************************************/
+/*!
+Copies a value from the current read position.
+
+\param [out] data
+The value to restore.
+*/
+/******************************************************************************/
+template<typename T>
+void M5Snapshot::Read(T& data)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be copied from a snapshot");
+	M5DEBUG_ASSERT(m_readPos + sizeof(T) <= m_size, "Reading past the end of the snapshot");
+	std::memcpy(&data, m_buffer.data() + m_readPos, sizeof(T));
+	m_readPos += sizeof(T);
+}
+
+
+#endif //M5SNAPSHOT_H
@@ -0,0 +1,262 @@
+/******************************************************************************/
+/*!
+\file   M5Socket.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+A non blocking UDP socket, so replication can send and receive without
+waiting on the network.
+
+*/
+/******************************************************************************/
+/*winsock2.h must come before anything that includes windows.h*/
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+#include "M5Socket.h"
+#include "M5Debug.h"
+
+#include <cstring>
+
+namespace
+{
+const int BUFFER_SIZE = 1024 * 1024; //!< Socket buffer bytes, so a burst of fragments isn't dropped
+}
+
+/******************************************************************************/
+/*!
+Starts closed.
+*/
+/******************************************************************************/
+M5Socket::M5Socket(void):
+	m_handle(INVALID_SOCKET),
+	m_port(0),
+	m_isOpen(false)
+{
+}
+/******************************************************************************/
+/*!
+Closes the socket if it is still open.
+*/
+/******************************************************************************/
+M5Socket::~M5Socket(void)
+{
+	Close();
+}
+/******************************************************************************/
+/*!
+Opens a non blocking UDP socket on any local address.
+
+\param [in] port
+The port to open on, or 0 to let the system pick one.  Use GetPort to find
+which one it picked.
+
+\return
+True if the socket is open.
+*/
+/******************************************************************************/
+bool M5Socket::Open(unsigned short port)
+{
+	M5DEBUG_ASSERT(!m_isOpen, "The socket is already open");
+
+	/*Winsock counts starts, so every open socket holds one*/
+	WSADATA data;
+	if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+		return false;
+
+	SOCKET handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (handle == INVALID_SOCKET)
+	{
+		WSACleanup();
+		return false;
+	}
+
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(port);
+
+	u_long nonBlocking = 1;
+	int bufferSize = BUFFER_SIZE;
+	int addressSize = sizeof(address);
+	if (bind(handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+		ioctlsocket(handle, FIONBIO, &nonBlocking) != 0 ||
+		getsockname(handle, reinterpret_cast<sockaddr*>(&address), &addressSize) != 0)
+	{
+		closesocket(handle);
+		WSACleanup();
+		return false;
+	}
+
+	/*Bigger buffers are only a request, so failing is fine*/
+	setsockopt(handle, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&bufferSize), sizeof(bufferSize));
+	setsockopt(handle, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&bufferSize), sizeof(bufferSize));
+
+	m_handle = handle;
+	m_port = ntohs(address.sin_port);
+	m_isOpen = true;
+	return true;
+}
+/******************************************************************************/
+/*!
+Closes the socket.  It is safe to call on a closed socket.
+*/
+/******************************************************************************/
+void M5Socket::Close(void)
+{
+	if (!m_isOpen)
+		return;
+
+	closesocket(static_cast<SOCKET>(m_handle));
+	WSACleanup();
+	m_handle = INVALID_SOCKET;
+	m_port = 0;
+	m_isOpen = false;
+}
+/******************************************************************************/
+/*!
+Checks if the socket is open.
+
+\return
+True if the socket is open.
+*/
+/******************************************************************************/
+bool M5Socket::IsOpen(void) const
+{
+	return m_isOpen;
+}
+/******************************************************************************/
+/*!
+Gets the port the socket is open on.
+
+\return
+The port in host byte order, or 0 if the socket is closed.
+*/
+/******************************************************************************/
+unsigned short M5Socket::GetPort(void) const
+{
+	return m_port;
+}
+/******************************************************************************/
+/*!
+Sends a packet without waiting.  UDP doesn't promise the packet arrives, so
+callers must be able to live without it.
+
+\param [in] to
+The address to send to.
+
+\param [in] pData
+The bytes to send.
+
+\param [in] size
+The number of bytes to send.
+
+\return
+True if the whole packet was handed to the system.
+*/
+/******************************************************************************/
+bool M5Socket::Send(const M5Address& to, const void* pData, int size)
+{
+	M5DEBUG_ASSERT(m_isOpen, "Sending on a closed socket");
+
+	sockaddr_in address;
+	std::memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(to.ip);
+	address.sin_port = htons(to.port);
+
+	int sent = sendto(static_cast<SOCKET>(m_handle), static_cast<const char*>(pData), size, 0,
+		reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+	return sent == size;
+}
+/******************************************************************************/
+/*!
+Gets the next packet that has arrived.  Call this until it returns 0 to empty
+the socket.
+
+\param [out] from
+The address that sent the packet.
+
+\param [out] pData
+The place to copy the packet to.
+
+\param [in] size
+The number of bytes pData can hold.  Longer packets are dropped.
+
+\return
+The size of the packet, or 0 if nothing is waiting.
+*/
+/******************************************************************************/
+int M5Socket::Receive(M5Address& from, void* pData, int size)
+{
+	M5DEBUG_ASSERT(m_isOpen, "Receiving on a closed socket");
+
+	for (;;)
+	{
+		sockaddr_in address;
+		int addressSize = sizeof(address);
+		int received = recvfrom(static_cast<SOCKET>(m_handle), static_cast<char*>(pData), size, 0,
+			reinterpret_cast<sockaddr*>(&address), &addressSize);
+
+		if (received > 0)
+		{
+			from.ip = ntohl(address.sin_addr.s_addr);
+			from.port = ntohs(address.sin_port);
+			return received;
+		}
+
+		/*Windows reports a port that refused an earlier send and packets that
+		were too big as errors, skip them and keep reading*/
+		int error = WSAGetLastError();
+		if (received == 0 || (error != WSAECONNRESET && error != WSAEMSGSIZE))
+			return 0;
+	}
+}
+/******************************************************************************/
+/*!
+Converts a dotted IPv4 string to an address.
+
+\param [in] ip
+The address, like 127.0.0.1.
+
+\param [in] port
+The port.
+
+\param [out] address
+The address to fill.
+
+\return
+True if the string was an IPv4 address.
+*/
+/******************************************************************************/
+bool M5Socket::MakeAddress(const char* ip, unsigned short port, M5Address& address)
+{
+	in_addr parsed;
+	if (inet_pton(AF_INET, ip, &parsed) != 1)
+		return false;
+
+	address.ip = ntohl(parsed.s_addr);
+	address.port = port;
+	return true;
+}
+/******************************************************************************/
+/*!
+Checks if two addresses are the same.
+
+\param [in] first
+The first address.
+
+\param [in] second
+The second address.
+
+\return
+True if the ip and port both match.
+*/
+/******************************************************************************/
+bool M5Socket::IsSame(const M5Address& first, const M5Address& second)
+{
+	return first.ip == second.ip && first.port == second.port;
+}
@@ -0,0 +1,60 @@
+/******************************************************************************/
+/*!
+\file   M5Socket.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+A non blocking UDP socket, so replication can send and receive without
+waiting on the network.
+
+*/
+/******************************************************************************/
+#ifndef M5_SOCKET_H
+#define M5_SOCKET_H
+
+#include <cstddef>
+
+//! An IPv4 address and port, both in host byte order
+struct M5Address
+{
+	unsigned       ip;   //!< The IPv4 address, 127.0.0.1 is 0x7F000001
+	unsigned short port; //!< The UDP port
+};
+
+/*! A non blocking UDP socket.  It uses Winsock, which is started by the first
+socket that opens and stopped by the last one that closes.  Sends and
+receives never wait, so they are safe to call every frame.*/
+class M5Socket
+{
+public:
+	M5Socket(void);
+	~M5Socket(void);
+	//Opens the socket on a port, 0 lets the system pick one
+	bool Open(unsigned short port);
+	//Closes the socket
+	void Close(void);
+	//Checks if the socket is open
+	bool IsOpen(void) const;
+	//Gets the port the socket is open on
+	unsigned short GetPort(void) const;
+	//Sends a packet without waiting
+	bool Send(const M5Address& to, const void* pData, int size);
+	//Gets the next waiting packet, or returns 0 if there isn't one
+	int Receive(M5Address& from, void* pData, int size);
+	//Converts a string like 127.0.0.1 to an address
+	static bool MakeAddress(const char* ip, unsigned short port, M5Address& address);
+	//Checks if two addresses are the same
+	static bool IsSame(const M5Address& first, const M5Address& second);
+private:
+	M5Socket(const M5Socket& rhs) = delete;
+	M5Socket& operator=(const M5Socket& rhs) = delete;
+
+	size_t         m_handle; //!< The Winsock SOCKET, kept as size_t so this header doesn't need winsock2.h
+	unsigned short m_port;   //!< The port the socket is open on
+	bool           m_isOpen; //!< True if m_handle is a valid socket
+};
+
+
+#endif //M5_SOCKET_H
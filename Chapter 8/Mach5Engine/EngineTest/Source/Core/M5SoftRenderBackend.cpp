@@ -0,0 +1,1243 @@
+/******************************************************************************/
+/*!
+\file   M5SoftRenderBackend.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+A render backend that draws frames on the CPU into an image in memory.
+
+*/
+/******************************************************************************/
+#include "M5SoftRenderBackend.h"
+#include "M5Debug.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "gl/gl.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+/*! Defined if four pixels are tested at a time with SSE2*/
+#define M5_SOFT_RENDER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+const int    TILE_SIZE = 64;          //!< Width and height of the tiles the screen is split into
+const double MIN_W = 0.00001;         //!< Quads with a corner this close to the camera are skipped
+const int    TGA_HEADER_SIZE = 18;    //!< Bytes in the header of a TGA file
+const float  INV_255 = 1.0f / 255.0f; //!< Converts a color byte to 0 to 1
+
+/*! The corners of the quad every item is drawn with, the same as the
+M5GLRenderBackend vertex buffer.  The quad is the triangles 0 1 2 and 2 3 0.*/
+const float QUAD[4][4] = {
+	/*  x     y     u    v */
+	{  .5f,  .5f, 1.f, 1.f },
+	{ -.5f,  .5f, 0.f, 1.f },
+	{ -.5f, -.5f, 0.f, 0.f },
+	{  .5f, -.5f, 1.f, 0.f }
+};
+
+/******************************************************************************/
+/*!
+Helper function to find a plane equation for a value across a triangle, so the
+value at any pixel is plane[0] * x + plane[1] * y + plane[2].  If the value is
+the same at every corner, the plane is exactly flat, so quads at the same depth
+always pass the depth test.
+
+\param [out] plane
+The three values of the plane equation.
+
+\param [in] x
+The x of each corner.
+
+\param [in] y
+The y of each corner.
+
+\param [in] value
+The value at each corner.
+
+\param [in] area
+Twice the signed area of the triangle.
+*/
+/******************************************************************************/
+void MakePlane(float* plane, const double* x, const double* y, const double* value, double area)
+{
+	double d1 = value[1] - value[0];
+	double d2 = value[2] - value[0];
+	double a = (d1 * (y[2] - y[0]) - d2 * (y[1] - y[0])) / area;
+	double b = (d2 * (x[1] - x[0]) - d1 * (x[2] - x[0])) / area;
+	plane[0] = static_cast<float>(a);
+	plane[1] = static_cast<float>(b);
+	plane[2] = static_cast<float>(value[0] - a * x[0] - b * y[0]);
+}
+/******************************************************************************/
+/*!
+Helper function to pack a color from 0 to 255 into bytes.
+
+\param [in] color
+The red, green, blue and alpha.
+
+\return
+The color with red in the lowest byte.
+*/
+/******************************************************************************/
+unsigned PackColor(const float* color)
+{
+	unsigned packed = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		float channel = color[i] + 0.5f;
+		channel = (channel < 0.0f) ? 0.0f : ((channel > 255.0f) ? 255.0f : channel);
+		packed |= static_cast<unsigned>(channel) << (i * 8);
+	}
+	return packed;
+}
+/******************************************************************************/
+/*!
+Helper function to write a 16 bit number the way TGA files store it.
+
+\param [out] bytes
+Where to write the two bytes.
+
+\param [in] value
+The number to write.
+*/
+/******************************************************************************/
+void WriteShort(unsigned char* bytes, int value)
+{
+	bytes[0] = static_cast<unsigned char>(value & 0xff);
+	bytes[1] = static_cast<unsigned char>((value >> 8) & 0xff);
+}
+
+#ifdef M5_SOFT_RENDER_SSE2
+/******************************************************************************/
+/*!
+Helper function to turn a packed color into four floats from 0 to 255.
+
+\param [in] pixel
+The color with red in the lowest byte.
+
+\return
+The red, green, blue and alpha.
+*/
+/******************************************************************************/
+__m128 Unpack(unsigned pixel)
+{
+	__m128i zero = _mm_setzero_si128();
+	__m128i bytes = _mm_cvtsi32_si128(static_cast<int>(pixel));
+	bytes = _mm_unpacklo_epi8(bytes, zero);
+	bytes = _mm_unpacklo_epi16(bytes, zero);
+	return _mm_cvtepi32_ps(bytes);
+}
+/******************************************************************************/
+/*!
+Helper function to turn four floats from 0 to 255 into a packed color.
+
+\param [in] color
+The red, green, blue and alpha.
+
+\return
+The color with red in the lowest byte.
+*/
+/******************************************************************************/
+unsigned Pack(__m128 color)
+{
+	__m128i ints = _mm_cvtps_epi32(color);
+	ints = _mm_packs_epi32(ints, ints);
+	ints = _mm_packus_epi16(ints, ints);
+	return static_cast<unsigned>(_mm_cvtsi128_si32(ints));
+}
+/******************************************************************************/
+/*!
+Helper function to round four floats down.
+
+\param [in] value
+The floats to round, which must fit in an int.
+
+\return
+The largest whole numbers at or below the values.
+*/
+/******************************************************************************/
+__m128 Floor(__m128 value)
+{
+	__m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+	return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.0f)));
+}
+/******************************************************************************/
+/*!
+Helper function to wrap or clamp four texture coords at a time and find the
+two texels each is between.
+
+\param [in] coord
+The texture coords, 0 to 1 covers the texture once.
+
+\param [in] size
+The width or height of the texture, a power of two.
+
+\param [in] isClamped
+True to clamp the coords, false to repeat the texture.
+
+\param [out] first
+The texels at or before the coords.
+
+\param [out] second
+The texels after the coords.
+
+\return
+How far each coord is from the first texel to the second, from 0 to 1.
+*/
+/******************************************************************************/
+__m128 GetTexels(__m128 coord, int size, bool isClamped, __m128i& first, __m128i& second)
+{
+	__m128 zero = _mm_setzero_ps();
+	__m128 one = _mm_set1_ps(1.0f);
+	if (isClamped)
+		coord = _mm_min_ps(_mm_max_ps(coord, zero), one);
+	else
+		coord = _mm_sub_ps(coord, Floor(coord));
+
+	/*Texel centers are half a texel in*/
+	__m128 texel = _mm_sub_ps(_mm_mul_ps(coord, _mm_set1_ps(static_cast<float>(size))), _mm_set1_ps(0.5f));
+	__m128 start = Floor(texel);
+
+	if (isClamped)
+	{
+		__m128 last = _mm_set1_ps(static_cast<float>(size - 1));
+		first = _mm_cvttps_epi32(_mm_max_ps(start, zero));
+		second = _mm_cvttps_epi32(_mm_min_ps(_mm_add_ps(start, one), last));
+	}
+	else
+	{
+		__m128i mask = _mm_set1_epi32(size - 1);
+		__m128i index = _mm_cvttps_epi32(start);
+		first = _mm_and_si128(index, mask);
+		second = _mm_and_si128(_mm_add_epi32(index, _mm_set1_epi32(1)), mask);
+	}
+	return _mm_sub_ps(texel, start);
+}
+/******************************************************************************/
+/*!
+Helper function to blend between two colors.
+
+\param [in] first
+The color when t is 0.
+
+\param [in] second
+The color when t is 1.
+
+\param [in] t
+How far to go from first to second, the same in every lane.
+
+\return
+The blended color.
+*/
+/******************************************************************************/
+__m128 Lerp(__m128 first, __m128 second, __m128 t)
+{
+	return _mm_add_ps(first, _mm_mul_ps(_mm_sub_ps(second, first), t));
+}
+#else
+/******************************************************************************/
+/*!
+Helper function to wrap or clamp a texture coord and find the two texels it is
+between.
+
+\param [in] coord
+The texture coord, 0 to 1 covers the texture once.
+
+\param [in] size
+The width or height of the texture, a power of two.
+
+\param [in] isClamped
+True to clamp the coord, false to repeat the texture.
+
+\param [out] first
+The texel at or before the coord.
+
+\param [out] second
+The texel after the coord.
+
+\return
+How far the coord is from the first texel to the second, from 0 to 1.
+*/
+/******************************************************************************/
+float GetTexels(float coord, int size, bool isClamped, int& first, int& second)
+{
+	if (isClamped)
+		coord = (coord < 0.0f) ? 0.0f : ((coord > 1.0f) ? 1.0f : coord);
+	else
+		coord -= std::floor(coord);
+
+	/*Texel centers are half a texel in*/
+	float texel = coord * size - 0.5f;
+	float start = std::floor(texel);
+	first = static_cast<int>(start);
+	second = first + 1;
+
+	if (isClamped)
+	{
+		first = (first < 0) ? 0 : first;
+		second = (second >= size) ? size - 1 : second;
+	}
+	else
+	{
+		first &= size - 1;
+		second &= size - 1;
+	}
+	return texel - start;
+}
+#endif
+}//end unnamed namespace
+
+/******************************************************************************/
+/*!
+Sets starting values.  The frame is made by the first Execute.
+*/
+/******************************************************************************/
+M5SoftRenderBackend::M5SoftRenderBackend(void) :
+	m_window(0),
+	m_deviceContext(0),
+	m_width(0),
+	m_height(0),
+	m_tilesX(0),
+	m_tilesY(0),
+	m_clearColor(0),
+	m_nextTile(0),
+	m_generation(0),
+	m_busyWorkers(0),
+	m_isRunning(false)
+{
+	std::memset(m_viewport, 0, sizeof(m_viewport));
+	m_font.width = 0;
+	m_font.height = 0;
+}
+/******************************************************************************/
+/*!
+Frees any textures that were not deleted.
+*/
+/******************************************************************************/
+M5SoftRenderBackend::~M5SoftRenderBackend(void)
+{
+	Shutdown();
+}
+/******************************************************************************/
+/*!
+Saves the window and makes the glyph atlas for text.
+
+\param [in] window
+The window to show each frame in, or 0 to only draw into memory.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::Init(HWND window)
+{
+	m_window = window;
+
+	M5TextBatch text;
+	std::vector<unsigned char> pixels;
+	text.GetAtlas(pixels);
+
+	m_font.width = M5TextBatch::ATLAS_WIDTH;
+	m_font.height = M5TextBatch::ATLAS_HEIGHT;
+	m_font.pixels.resize(m_font.width * m_font.height);
+	std::memcpy(&m_font.pixels[0], &pixels[0], m_font.pixels.size() * sizeof(unsigned));
+}
+/******************************************************************************/
+/*!
+Frees every texture.  The render thread must be stopped first.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::Shutdown(void)
+{
+	std::lock_guard<std::mutex> lock(m_textureMutex);
+	size_t size = m_textures.size();
+	for (size_t i = 0; i < size; ++i)
+		delete m_textures[i];
+
+	m_textures.clear();
+}
+/******************************************************************************/
+/*!
+Gets the window's device context and starts the worker threads.  The render
+thread draws tiles too, so one less worker is made than there are cores.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::StartThread(void)
+{
+	if (m_window)
+		m_deviceContext = GetDC(m_window);
+
+	int workers = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+	m_isRunning = true;
+	for (int i = 0; i < workers; ++i)
+		m_workers.push_back(std::thread(&M5SoftRenderBackend::RunWorker, this, m_generation));
+}
+/******************************************************************************/
+/*!
+Stops the worker threads and releases the device context.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::EndThread(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_workMutex);
+		m_isRunning = false;
+	}
+	m_workSignal.notify_all();
+
+	size_t size = m_workers.size();
+	for (size_t i = 0; i < size; ++i)
+		m_workers[i].join();
+	m_workers.clear();
+
+	if (m_deviceContext)
+	{
+		ReleaseDC(m_window, m_deviceContext);
+		m_deviceContext = 0;
+	}
+}
+/******************************************************************************/
+/*!
+Draws the world with the camera, then the HUD and text in screen space, the
+same way M5GLRenderBackend does.  Every triangle is set up and sorted into
+tiles here, then the tiles are drawn by the workers and this thread together.
+The frame is shown in the window if there is one.
+
+\param [in] frame
+The frame to draw.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::Execute(const M5RenderFrame& frame)
+{
+	if (frame.width <= 0 || frame.height <= 0)
+		return;
+
+	if (frame.width != m_width || frame.height != m_height)
+	{
+		m_width = frame.width;
+		m_height = frame.height;
+		m_color.resize(m_width * m_height);
+		m_depth.resize(m_width * m_height);
+		m_tilesX = (m_width + TILE_SIZE - 1) / TILE_SIZE;
+		m_tilesY = (m_height + TILE_SIZE - 1) / TILE_SIZE;
+		m_bins.resize(m_tilesX * m_tilesY);
+	}
+
+	std::memcpy(m_viewport, frame.viewport, sizeof(m_viewport));
+	float background[4] = {
+		frame.background[0] * 255.0f,
+		frame.background[1] * 255.0f,
+		frame.background[2] * 255.0f,
+		255.0f };
+	m_clearColor = PackColor(background);
+
+	/*Textures can be made on the main thread while this frame is drawn*/
+	{
+		std::lock_guard<std::mutex> lock(m_textureMutex);
+		m_frameTextures.assign(m_textures.begin(), m_textures.end());
+	}
+
+	/*World objects use the perspective and camera*/
+	m_triangles.clear();
+	double world[16];
+	Multiply(world, frame.persp, frame.camera);
+	SetupItems(frame.world, world);
+
+	/*HUD objects are in screen space, the same as gluOrtho2D*/
+	double ortho[16] = {
+		2.0 / m_width, 0, 0, 0,
+		0, 2.0 / m_height, 0, 0,
+		0, 0, -1, 0,
+		-1, -1, 0, 1 };
+	SetupItems(frame.hud, ortho);
+	SetupText(frame.text, ortho);
+
+	/*Sort the triangles into tiles, keeping the draw order in each tile*/
+	size_t binCount = m_bins.size();
+	for (size_t i = 0; i < binCount; ++i)
+		m_bins[i].clear();
+
+	int triangleCount = static_cast<int>(m_triangles.size());
+	for (int i = 0; i < triangleCount; ++i)
+	{
+		const Triangle& tri = m_triangles[i];
+		for (int y = tri.minY / TILE_SIZE; y <= tri.maxY / TILE_SIZE; ++y)
+		{
+			for (int x = tri.minX / TILE_SIZE; x <= tri.maxX / TILE_SIZE; ++x)
+				m_bins[y * m_tilesX + x].push_back(i);
+		}
+	}
+
+	/*Wake the workers and help them until every tile is done*/
+	m_nextTile = 0;
+	{
+		std::lock_guard<std::mutex> lock(m_workMutex);
+		m_busyWorkers = static_cast<int>(m_workers.size());
+		++m_generation;
+	}
+	m_workSignal.notify_all();
+
+	DrawTiles();
+
+	{
+		std::unique_lock<std::mutex> lock(m_workMutex);
+		while (m_busyWorkers != 0)
+			m_doneSignal.wait(lock);
+	}
+
+	Present();
+}
+/******************************************************************************/
+/*!
+Copies pixels into a new texture.  This is called on the main thread, maybe
+while a frame is being drawn.
+
+\param [in] pixels
+The pixels of the texture, starting with the bottom row.
+
+\param [in] width
+The width of the texture, a power of two.
+
+\param [in] height
+The height of the texture, a power of two.
+
+\param [in] format
+GL_RGB or GL_RGBA.
+
+\return
+The id of the new texture.
+*/
+/******************************************************************************/
+int M5SoftRenderBackend::CreateTexture(const unsigned char* pixels, int width, int height, unsigned format)
+{
+	M5DEBUG_ASSERT((width & (width - 1)) == 0 && (height & (height - 1)) == 0,
+		"Software textures must be powers of two");
+
+	Texture* pTexture = new Texture;
+	pTexture->width = width;
+	pTexture->height = height;
+	pTexture->pixels.resize(width * height);
+
+	int bytesPerPixel = (format == GL_RGBA) ? 4 : 3;
+	int size = width * height;
+	for (int i = 0; i < size; ++i)
+	{
+		const unsigned char* pPixel = pixels + i * bytesPerPixel;
+		unsigned alpha = (bytesPerPixel == 4) ? pPixel[3] : 255;
+		pTexture->pixels[i] = pPixel[0] | (pPixel[1] << 8) | (pPixel[2] << 16) | (alpha << 24);
+	}
+
+	/*Reuse the first free id*/
+	std::lock_guard<std::mutex> lock(m_textureMutex);
+	size_t count = m_textures.size();
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (m_textures[i] == 0)
+		{
+			m_textures[i] = pTexture;
+			return static_cast<int>(i) + 1;
+		}
+	}
+	m_textures.push_back(pTexture);
+	return static_cast<int>(m_textures.size());
+}
+/******************************************************************************/
+/*!
+Deletes a texture.  This is called on the main thread while the render thread
+is idle.
+
+\param [in] textureID
+The texture to delete.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::DeleteTexture(int textureID)
+{
+	std::lock_guard<std::mutex> lock(m_textureMutex);
+	if (textureID < 1 || textureID > static_cast<int>(m_textures.size()))
+		return;
+
+	delete m_textures[textureID - 1];
+	m_textures[textureID - 1] = 0;
+}
+/******************************************************************************/
+/*!
+Writes the last frame to an uncompressed 32 bit TGA file.  The file can be
+loaded as a texture, or used as a golden image for CompareImage.
+
+\param [in] fileName
+The file to write.
+
+\return
+True if the file was written.
+*/
+/******************************************************************************/
+bool M5SoftRenderBackend::WriteImage(const char* fileName) const
+{
+	FILE* pFile = std::fopen(fileName, "wb");
+	if (pFile == 0)
+		return false;
+
+	/*Uncompressed true color, with the bottom row first like the frame*/
+	unsigned char header[TGA_HEADER_SIZE] = { 0 };
+	header[2] = 2;
+	WriteShort(header + 12, m_width);
+	WriteShort(header + 14, m_height);
+	header[16] = 32;
+	header[17] = 8;
+	std::fwrite(header, sizeof(header), 1, pFile);
+
+	/*TGA stores blue first*/
+	std::vector<unsigned char> row(m_width * 4);
+	for (int y = 0; y < m_height; ++y)
+	{
+		for (int x = 0; x < m_width; ++x)
+		{
+			unsigned pixel = m_color[y * m_width + x];
+			row[x * 4 + 0] = static_cast<unsigned char>(pixel >> 16);
+			row[x * 4 + 1] = static_cast<unsigned char>(pixel >> 8);
+			row[x * 4 + 2] = static_cast<unsigned char>(pixel);
+			row[x * 4 + 3] = static_cast<unsigned char>(pixel >> 24);
+		}
+		std::fwrite(&row[0], row.size(), 1, pFile);
+	}
+
+	std::fclose(pFile);
+	return true;
+}
+/******************************************************************************/
+/*!
+Counts the pixels of the last frame that are different from a TGA file written
+by WriteImage.
+
+\param [in] fileName
+The file to compare against.
+
+\param [in] tolerance
+How much any channel of a pixel can be off before the pixel counts as
+different.
+
+\return
+The number of different pixels.  Every pixel is different if the sizes don't
+match, and -1 is returned if the file can't be read.
+*/
+/******************************************************************************/
+int M5SoftRenderBackend::CompareImage(const char* fileName, int tolerance) const
+{
+	FILE* pFile = std::fopen(fileName, "rb");
+	if (pFile == 0)
+		return -1;
+
+	unsigned char header[TGA_HEADER_SIZE];
+	if (std::fread(header, sizeof(header), 1, pFile) != 1 || header[2] != 2 || header[16] != 32)
+	{
+		std::fclose(pFile);
+		return -1;
+	}
+
+	int width = header[12] | (header[13] << 8);
+	int height = header[14] | (header[15] << 8);
+	if (width != m_width || height != m_height)
+	{
+		std::fclose(pFile);
+		return m_width * m_height;
+	}
+
+	int different = 0;
+	std::vector<unsigned char> row(m_width * 4);
+	for (int y = 0; y < m_height; ++y)
+	{
+		if (std::fread(&row[0], row.size(), 1, pFile) != 1)
+		{
+			different += (m_height - y) * m_width;
+			break;
+		}
+
+		for (int x = 0; x < m_width; ++x)
+		{
+			unsigned pixel = m_color[y * m_width + x];
+			const int order[4] = { 2, 1, 0, 3 }; /*TGA stores blue first*/
+			for (int i = 0; i < 4; ++i)
+			{
+				int channel = static_cast<int>((pixel >> (i * 8)) & 0xff);
+				if (std::abs(channel - row[x * 4 + order[i]]) > tolerance)
+				{
+					++different;
+					break;
+				}
+			}
+		}
+	}
+
+	std::fclose(pFile);
+	return different;
+}
+/******************************************************************************/
+/*!
+Multiplies two column major matrices, the way OpenGL stacks them.
+
+\param [out] result
+first * second.
+
+\param [in] first
+The matrix on the left.
+
+\param [in] second
+The matrix on the right.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::Multiply(double* result, const double* first, const double* second)
+{
+	for (int col = 0; col < 4; ++col)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			double sum = 0;
+			for (int i = 0; i < 4; ++i)
+				sum += first[i * 4 + row] * second[col * 4 + i];
+			result[col * 4 + row] = sum;
+		}
+	}
+}
+/******************************************************************************/
+/*!
+Transforms the corners of each quad and adds its two triangles.
+
+\param [in] items
+The quads to set up.
+
+\param [in] matrix
+The column major projection times the camera.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::SetupItems(const M5RenderItems& items, const double* matrix)
+{
+	int textureCount = static_cast<int>(m_frameTextures.size());
+	size_t size = items.size();
+	for (size_t i = 0; i < size; ++i)
+	{
+		const M5RenderItem& item = items[i];
+		const float(*m)[M5_COLS] = item.world.m;
+		const float(*t)[M5_COLS] = item.texCoords.m;
+
+		Vertex corners[4];
+		bool isVisible = true;
+		for (int c = 0; c < 4; ++c)
+		{
+			float x = QUAD[c][0];
+			float y = QUAD[c][1];
+
+			/*The matrix uses row vectors, the same as glMultMatrixf of it*/
+			double eye[4];
+			for (int j = 0; j < 4; ++j)
+				eye[j] = x * m[0][j] + y * m[1][j] + m[3][j];
+
+			double clip[4];
+			for (int j = 0; j < 4; ++j)
+			{
+				clip[j] = matrix[j] * eye[0] + matrix[4 + j] * eye[1] +
+					matrix[8 + j] * eye[2] + matrix[12 + j] * eye[3];
+			}
+
+			if (clip[3] < MIN_W)
+				isVisible = false;
+
+			ToScreen(corners[c], clip);
+			corners[c].u = QUAD[c][2] * t[0][0] + QUAD[c][3] * t[1][0] + t[3][0];
+			corners[c].v = QUAD[c][2] * t[0][1] + QUAD[c][3] * t[1][1] + t[3][1];
+		}
+
+		/*OpenGL would clip these, but a 2D camera never gets that close*/
+		if (!isVisible)
+			continue;
+
+		/*An unknown texture draws just the color, like texture 0 in OpenGL*/
+		const Texture* pTexture = 0;
+		if (item.textureID > 0 && item.textureID <= textureCount)
+			pTexture = m_frameTextures[item.textureID - 1];
+
+		AddTriangle(corners[0], corners[1], corners[2], item.color, pTexture, false);
+		AddTriangle(corners[2], corners[3], corners[0], item.color, pTexture, false);
+	}
+}
+/******************************************************************************/
+/*!
+Adds the text triangles with the glyph atlas.  Every glyph is one color, so
+each triangle uses the color of its first vertex.
+
+\param [in] verts
+The text triangles in screen space.
+
+\param [in] matrix
+The column major screen space projection.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::SetupText(const M5TextVertices& verts, const double* matrix)
+{
+	size_t size = verts.size() - verts.size() % 3;
+	for (size_t i = 0; i < size; i += 3)
+	{
+		Vertex corners[3];
+		for (int c = 0; c < 3; ++c)
+		{
+			const M5TextVertex& vert = verts[i + c];
+			double clip[4];
+			for (int j = 0; j < 4; ++j)
+				clip[j] = matrix[j] * vert.x + matrix[4 + j] * vert.y + matrix[12 + j];
+
+			ToScreen(corners[c], clip);
+			corners[c].u = vert.u;
+			corners[c].v = vert.v;
+		}
+		AddTriangle(corners[0], corners[1], corners[2], verts[i].color, &m_font, true);
+	}
+}
+/******************************************************************************/
+/*!
+Divides by w and moves the position into the viewport, the way OpenGL does.
+
+\param [out] vert
+The vertex to set the position of.
+
+\param [in] clip
+The x, y, z and w after the projection.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::ToScreen(Vertex& vert, const double* clip) const
+{
+	vert.w = clip[3];
+	vert.x = m_viewport[0] + (clip[0] / clip[3] + 1.0) * 0.5 * m_viewport[2];
+	vert.y = m_viewport[1] + (clip[1] / clip[3] + 1.0) * 0.5 * m_viewport[3];
+	vert.z = (clip[2] / clip[3] + 1.0) * 0.5;
+}
+/******************************************************************************/
+/*!
+Finds the edges and plane equations of a triangle and adds it to the frame if
+it covers any pixels in the viewport.  Texture coords are divided by w here,
+so they are correct in perspective.
+
+\param [in] v0
+The first corner.
+
+\param [in] v1
+The second corner.
+
+\param [in] v2
+The third corner.
+
+\param [in] color
+The red, green, blue and alpha.
+
+\param [in] pTexture
+The texture, or 0 for just the color.
+
+\param [in] isClamped
+True to clamp texture coords instead of repeating.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::AddTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2,
+	const unsigned char* color, const Texture* pTexture, bool isClamped)
+{
+	const Vertex* verts[3] = { &v0, &v1, &v2 };
+	double x[3] = { v0.x, v1.x, v2.x };
+	double y[3] = { v0.y, v1.y, v2.y };
+
+	/*Skip triangles seen edge on*/
+	double area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (!(area > 0.0) && !(area < 0.0))
+		return;
+
+	/*Pixel centers are at half pixels*/
+	double minX = std::fmin(x[0], std::fmin(x[1], x[2])) - 0.5;
+	double maxX = std::fmax(x[0], std::fmax(x[1], x[2])) - 0.5;
+	double minY = std::fmin(y[0], std::fmin(y[1], y[2])) - 0.5;
+	double maxY = std::fmax(y[0], std::fmax(y[1], y[2])) - 0.5;
+
+	/*Only pixels in the viewport and the frame are drawn*/
+	double left = std::fmax(0.0, m_viewport[0]);
+	double bottom = std::fmax(0.0, m_viewport[1]);
+	double right = std::fmin(m_width, m_viewport[0] + m_viewport[2]) - 1;
+	double top = std::fmin(m_height, m_viewport[1] + m_viewport[3]) - 1;
+	minX = std::fmax(std::ceil(minX), left);
+	minY = std::fmax(std::ceil(minY), bottom);
+	maxX = std::fmin(std::floor(maxX), right);
+	maxY = std::fmin(std::floor(maxY), top);
+	if (minX > maxX || minY > maxY)
+		return;
+
+	Triangle tri;
+	tri.minX = static_cast<int>(minX);
+	tri.minY = static_cast<int>(minY);
+	tri.maxX = static_cast<int>(maxX);
+	tri.maxY = static_cast<int>(maxY);
+
+	/*Flip the edges of clockwise triangles so inside is always positive.  An
+	edge shared by two triangles has exactly the opposite A, B and C in each,
+	so the top left rule gives pixels on it to only one of them*/
+	double sign = (area > 0.0) ? 1.0 : -1.0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const Vertex& start = *verts[i];
+		const Vertex& end = *verts[(i + 1) % 3];
+		tri.edge[i][0] = static_cast<float>(sign * (start.y - end.y));
+		tri.edge[i][1] = static_cast<float>(sign * (end.x - start.x));
+		tri.edge[i][2] = static_cast<float>(sign * (start.x * end.y - end.x * start.y));
+		tri.topLeft[i] = tri.edge[i][0] > 0.0f || (tri.edge[i][0] == 0.0f && tri.edge[i][1] > 0.0f);
+	}
+
+	double z[3] = { v0.z, v1.z, v2.z };
+	double invW[3] = { 1.0 / v0.w, 1.0 / v1.w, 1.0 / v2.w };
+	double u[3] = { v0.u * invW[0], v1.u * invW[1], v2.u * invW[2] };
+	double v[3] = { v0.v * invW[0], v1.v * invW[1], v2.v * invW[2] };
+	MakePlane(tri.depth, x, y, z, area);
+	MakePlane(tri.invW, x, y, invW, area);
+	MakePlane(tri.uOverW, x, y, u, area);
+	MakePlane(tri.vOverW, x, y, v, area);
+
+	for (int i = 0; i < 4; ++i)
+		tri.color[i] = color[i] * INV_255;
+	tri.pTexture = pTexture;
+	tri.isClamped = isClamped;
+
+	m_triangles.push_back(tri);
+}
+/******************************************************************************/
+/*!
+Draws tiles until there are none left.  This runs on the render thread and
+every worker at the same time.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::DrawTiles(void)
+{
+	int tileCount = m_tilesX * m_tilesY;
+	for (int tile = m_nextTile++; tile < tileCount; tile = m_nextTile++)
+		DrawTile(tile);
+}
+/******************************************************************************/
+/*!
+Clears a tile, then draws every triangle that touches it in order.
+
+\param [in] tile
+The index of the tile, starting at the bottom left.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::DrawTile(int tile)
+{
+	int minX = (tile % m_tilesX) * TILE_SIZE;
+	int minY = (tile / m_tilesX) * TILE_SIZE;
+	int maxX = (minX + TILE_SIZE < m_width) ? minX + TILE_SIZE - 1 : m_width - 1;
+	int maxY = (minY + TILE_SIZE < m_height) ? minY + TILE_SIZE - 1 : m_height - 1;
+
+	for (int y = minY; y <= maxY; ++y)
+	{
+		int start = y * m_width;
+		for (int x = minX; x <= maxX; ++x)
+		{
+			m_color[start + x] = m_clearColor;
+			m_depth[start + x] = 1.0f;
+		}
+	}
+
+	const std::vector<int>& bin = m_bins[tile];
+	size_t size = bin.size();
+	for (size_t i = 0; i < size; ++i)
+	{
+		const Triangle& tri = m_triangles[bin[i]];
+		DrawTriangle(tri,
+			(tri.minX > minX) ? tri.minX : minX,
+			(tri.minY > minY) ? tri.minY : minY,
+			(tri.maxX < maxX) ? tri.maxX : maxX,
+			(tri.maxY < maxY) ? tri.maxY : maxY);
+	}
+}
+/******************************************************************************/
+/*!
+Draws the part of a triangle inside a rectangle of pixels.  Pixels pass if
+their center is inside and they are at or in front of the depth buffer, then
+the texture is sampled with bilinear filtering, multiplied by the color and
+alpha blended, the same as the OpenGL state.  With SSE2 the inside and depth
+tests are done for four pixels at a time and each channel of a pixel is
+blended at once.
+
+\param [in] tri
+The triangle to draw.
+
+\param [in] minX
+The leftmost pixel to draw.
+
+\param [in] minY
+The bottom pixel to draw.
+
+\param [in] maxX
+The rightmost pixel to draw.
+
+\param [in] maxY
+The top pixel to draw.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::DrawTriangle(const Triangle& tri, int minX, int minY, int maxX, int maxY)
+{
+	const Texture* pTexture = tri.pTexture;
+
+#ifdef M5_SOFT_RENDER_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 lanes = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 color = _mm_setr_ps(tri.color[0], tri.color[1], tri.color[2], tri.color[3]);
+	const __m128 white = _mm_set1_ps(255.0f);
+	const __m128 inv255 = _mm_set1_ps(INV_255);
+
+	__m128 edgeA[3];
+	__m128 topLeft[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		edgeA[i] = _mm_set1_ps(tri.edge[i][0]);
+		topLeft[i] = tri.topLeft[i] ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : zero;
+	}
+	__m128 depthA = _mm_set1_ps(tri.depth[0]);
+	__m128 uA = _mm_set1_ps(tri.uOverW[0]);
+	__m128 vA = _mm_set1_ps(tri.vOverW[0]);
+	__m128 invWA = _mm_set1_ps(tri.invW[0]);
+
+	/*Without perspective w is the same everywhere, so don't divide per pixel*/
+	bool isAffine = tri.invW[0] == 0.0f && tri.invW[1] == 0.0f;
+	__m128 w = _mm_set1_ps(1.0f / tri.invW[2]);
+
+	for (int y = minY; y <= maxY; ++y)
+	{
+		float py = y + 0.5f;
+		unsigned* pColor = &m_color[y * m_width];
+		float* pDepth = &m_depth[y * m_width];
+
+		__m128 edgeRow[3];
+		for (int i = 0; i < 3; ++i)
+			edgeRow[i] = _mm_set1_ps(tri.edge[i][1] * py + tri.edge[i][2]);
+		__m128 depthRow = _mm_set1_ps(tri.depth[1] * py + tri.depth[2]);
+		__m128 uRow = _mm_set1_ps(tri.uOverW[1] * py + tri.uOverW[2]);
+		__m128 vRow = _mm_set1_ps(tri.vOverW[1] * py + tri.vOverW[2]);
+		__m128 invWRow = _mm_set1_ps(tri.invW[1] * py + tri.invW[2]);
+
+		for (int x = minX; x <= maxX; x += 4)
+		{
+			__m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lanes);
+
+			/*Inside every edge, or on an edge that owns its pixels*/
+			__m128 mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (int i = 0; i < 3; ++i)
+			{
+				__m128 edge = _mm_add_ps(_mm_mul_ps(edgeA[i], px), edgeRow[i]);
+				__m128 inside = _mm_or_ps(_mm_cmpgt_ps(edge, zero),
+					_mm_and_ps(_mm_cmpeq_ps(edge, zero), topLeft[i]));
+				mask = _mm_and_ps(mask, inside);
+			}
+			if (_mm_movemask_ps(mask) == 0)
+				continue;
+
+			/*Don't read pixels past the rectangle, another thread owns them*/
+			__m128 oldDepth;
+			if (x + 3 <= maxX)
+			{
+				oldDepth = _mm_loadu_ps(pDepth + x);
+			}
+			else
+			{
+				float depths[4] = { 0, 0, 0, 0 };
+				for (int i = 0; x + i <= maxX; ++i)
+					depths[i] = pDepth[x + i];
+				oldDepth = _mm_loadu_ps(depths);
+			}
+
+			/*Depth test is GL_LEQUAL, and OpenGL clips outside 0 to 1*/
+			__m128 depth = _mm_add_ps(_mm_mul_ps(depthA, px), depthRow);
+			mask = _mm_and_ps(mask, _mm_cmple_ps(depth, oldDepth));
+			mask = _mm_and_ps(mask, _mm_cmpge_ps(depth, zero));
+			mask = _mm_and_ps(mask, _mm_cmple_ps(depth, one));
+
+			int bits = _mm_movemask_ps(mask);
+			if (x + 3 > maxX)
+				bits &= (1 << (maxX - x + 1)) - 1;
+			if (bits == 0)
+				continue;
+
+			float depths[4];
+			_mm_storeu_ps(depths, depth);
+
+			/*Find the texels for all four pixels at once*/
+			int x0[4], x1[4], y0[4], y1[4];
+			float tx[4], ty[4];
+			if (pTexture)
+			{
+				__m128 u = _mm_add_ps(_mm_mul_ps(uA, px), uRow);
+				__m128 v = _mm_add_ps(_mm_mul_ps(vA, px), vRow);
+				if (!isAffine)
+					w = _mm_div_ps(one, _mm_add_ps(_mm_mul_ps(invWA, px), invWRow));
+
+				__m128i first, second;
+				_mm_storeu_ps(tx, GetTexels(_mm_mul_ps(u, w), pTexture->width, tri.isClamped, first, second));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(x0), first);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(x1), second);
+				_mm_storeu_ps(ty, GetTexels(_mm_mul_ps(v, w), pTexture->height, tri.isClamped, first, second));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(y0), first);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(y1), second);
+			}
+
+			for (int i = 0; i < 4; ++i)
+			{
+				if ((bits & (1 << i)) == 0)
+					continue;
+
+				__m128 src = white;
+				if (pTexture)
+				{
+					const unsigned* pBottom = &pTexture->pixels[y0[i] * pTexture->width];
+					const unsigned* pTop = &pTexture->pixels[y1[i] * pTexture->width];
+					__m128 blendX = _mm_set1_ps(tx[i]);
+					src = Lerp(Lerp(Unpack(pBottom[x0[i]]), Unpack(pBottom[x1[i]]), blendX),
+						Lerp(Unpack(pTop[x0[i]]), Unpack(pTop[x1[i]]), blendX), _mm_set1_ps(ty[i]));
+				}
+				src = _mm_mul_ps(src, color);
+
+				/*GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, skipping the read when
+				the blend can't change anything*/
+				__m128 alpha = _mm_mul_ps(_mm_shuffle_ps(src, src, _MM_SHUFFLE(3, 3, 3, 3)), inv255);
+				float srcAlpha = _mm_cvtss_f32(alpha);
+				if (srcAlpha >= 1.0f)
+					pColor[x + i] = Pack(src);
+				else if (srcAlpha > 0.0f)
+					pColor[x + i] = Pack(Lerp(Unpack(pColor[x + i]), src, alpha));
+				pDepth[x + i] = depths[i];
+			}
+		}
+	}
+#else
+	for (int y = minY; y <= maxY; ++y)
+	{
+		float py = y + 0.5f;
+		unsigned* pColor = &m_color[y * m_width];
+		float* pDepth = &m_depth[y * m_width];
+
+		for (int x = minX; x <= maxX; ++x)
+		{
+			float px = x + 0.5f;
+
+			/*Inside every edge, or on an edge that owns its pixels*/
+			bool isInside = true;
+			for (int i = 0; i < 3 && isInside; ++i)
+			{
+				float edge = tri.edge[i][0] * px + (tri.edge[i][1] * py + tri.edge[i][2]);
+				isInside = edge > 0.0f || (edge == 0.0f && tri.topLeft[i]);
+			}
+
+			/*Depth test is GL_LEQUAL, and OpenGL clips outside 0 to 1*/
+			float depth = tri.depth[0] * px + (tri.depth[1] * py + tri.depth[2]);
+			if (!isInside || depth > pDepth[x] || depth < 0.0f || depth > 1.0f)
+				continue;
+
+			float src[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+			if (pTexture)
+			{
+				float w = 1.0f / (tri.invW[0] * px + tri.invW[1] * py + tri.invW[2]);
+				float u = (tri.uOverW[0] * px + tri.uOverW[1] * py + tri.uOverW[2]) * w;
+				float v = (tri.vOverW[0] * px + tri.vOverW[1] * py + tri.vOverW[2]) * w;
+
+				int x0, x1, y0, y1;
+				float tx = GetTexels(u, pTexture->width, tri.isClamped, x0, x1);
+				float ty = GetTexels(v, pTexture->height, tri.isClamped, y0, y1);
+				const unsigned* pBottom = &pTexture->pixels[y0 * pTexture->width];
+				const unsigned* pTop = &pTexture->pixels[y1 * pTexture->width];
+				for (int i = 0; i < 4; ++i)
+				{
+					int shift = i * 8;
+					float b0 = static_cast<float>((pBottom[x0] >> shift) & 0xff);
+					float b1 = static_cast<float>((pBottom[x1] >> shift) & 0xff);
+					float t0 = static_cast<float>((pTop[x0] >> shift) & 0xff);
+					float t1 = static_cast<float>((pTop[x1] >> shift) & 0xff);
+					float bottom = b0 + (b1 - b0) * tx;
+					float top = t0 + (t1 - t0) * tx;
+					src[i] = bottom + (top - bottom) * ty;
+				}
+			}
+
+			/*GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA*/
+			for (int i = 0; i < 4; ++i)
+				src[i] *= tri.color[i];
+			float alpha = src[3] * INV_255;
+			float result[4];
+			for (int i = 0; i < 4; ++i)
+			{
+				float dst = static_cast<float>((pColor[x] >> (i * 8)) & 0xff);
+				result[i] = dst + (src[i] - dst) * alpha;
+			}
+			pColor[x] = PackColor(result);
+			pDepth[x] = depth;
+		}
+	}
+#endif
+}
+/******************************************************************************/
+/*!
+Shows the frame in the window.  Windows wants blue first, but the rows are
+already bottom first.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::Present(void)
+{
+	if (m_deviceContext == 0)
+		return;
+
+	size_t size = m_color.size();
+	m_present.resize(size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		unsigned pixel = m_color[i];
+		m_present[i] = (pixel & 0xff00ff00) | ((pixel & 0xff) << 16) | ((pixel >> 16) & 0xff);
+	}
+
+	BITMAPINFO info;
+	std::memset(&info, 0, sizeof(info));
+	info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	info.bmiHeader.biWidth = m_width;
+	info.bmiHeader.biHeight = m_height;
+	info.bmiHeader.biPlanes = 1;
+	info.bmiHeader.biBitCount = 32;
+	info.bmiHeader.biCompression = BI_RGB;
+
+	SetDIBitsToDevice(m_deviceContext, 0, 0, m_width, m_height, 0, 0, 0, m_height,
+		&m_present[0], &info, DIB_RGB_COLORS);
+}
+/******************************************************************************/
+/*!
+A worker thread.  It sleeps until Execute has tiles to draw, helps draw them,
+then tells Execute it is done.
+
+\param [in] generation
+The frame count when the worker was started, so it waits for the next frame.
+*/
+/******************************************************************************/
+void M5SoftRenderBackend::RunWorker(int generation)
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_workMutex);
+			while (m_generation == generation && m_isRunning)
+				m_workSignal.wait(lock);
+
+			if (!m_isRunning)
+				break;
+			generation = m_generation;
+		}
+
+		DrawTiles();
+
+		{
+			std::lock_guard<std::mutex> lock(m_workMutex);
+			--m_busyWorkers;
+		}
+		m_doneSignal.notify_one();
+	}
+}
@@ -0,0 +1,130 @@
+/******************************************************************************/
+/*!
+\file   M5SoftRenderBackend.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+A render backend that draws frames on the CPU into an image in memory.
+
+*/
+/******************************************************************************/
+#ifndef M5_SOFT_RENDER_BACKEND_H
+#define M5_SOFT_RENDER_BACKEND_H
+
+#include "M5RenderBackend.h"
+#include "M5RenderList.h"
+
+/*! Used to exclude rarely-used stuff from Windows */
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/*! A render backend that draws frames on the CPU, so frames can be drawn and
+saved on machines without a GPU.  It draws the same thing as
+M5GLRenderBackend.  Every quad is split into triangles, the triangles are
+sorted into tiles of the screen, and worker threads draw whole tiles, four
+pixels at a time, so no two threads touch the same pixel.*/
+class M5SoftRenderBackend : public M5RenderBackend
+{
+public:
+	M5SoftRenderBackend(void);
+	~M5SoftRenderBackend(void);
+	//Sets the window to show frames in, or 0 to only keep them in memory
+	void Init(HWND window);
+	//Frees every texture, after the render thread has stopped
+	void Shutdown(void);
+	virtual void StartThread(void);
+	virtual void EndThread(void);
+	virtual void Execute(const M5RenderFrame& frame);
+	virtual int  CreateTexture(const unsigned char* pixels, int width, int height, unsigned format);
+	virtual void DeleteTexture(int textureID);
+	//Writes the last frame to a TGA file, only call while the render thread is idle
+	bool WriteImage(const char* fileName) const;
+	//Counts the pixels that differ from a TGA file, only call while the render thread is idle
+	int CompareImage(const char* fileName, int tolerance) const;
+private:
+	//! A texture as RGBA pixels, starting with the bottom row
+	struct Texture
+	{
+		std::vector<unsigned> pixels; //!< The pixels, red in the lowest byte
+		int                   width;  //!< Width in pixels, a power of two
+		int                   height; //!< Height in pixels, a power of two
+	};
+
+	//! A triangle in screen space with everything needed to draw it
+	struct Triangle
+	{
+		float          edge[3][3];   //!< A, B and C of each edge, Ax + By + C > 0 is inside
+		bool           topLeft[3];   //!< True if pixels exactly on the edge are inside
+		float          depth[3];     //!< Plane equation for depth
+		float          invW[3];      //!< Plane equation for 1 / w
+		float          uOverW[3];    //!< Plane equation for u / w
+		float          vOverW[3];    //!< Plane equation for v / w
+		float          color[4];     //!< Red, green, blue and alpha from 0 to 1
+		const Texture* pTexture;     //!< The texture, or 0 for just the color
+		bool           isClamped;    //!< True to clamp texture coords instead of repeating
+		int            minX;         //!< Leftmost pixel that might be covered
+		int            minY;         //!< Bottom pixel that might be covered
+		int            maxX;         //!< Rightmost pixel that might be covered
+		int            maxY;         //!< Top pixel that might be covered
+	};
+
+	//! A corner of a quad after the transforms
+	struct Vertex
+	{
+		double x; //!< The x position in pixels
+		double y; //!< The y position in pixels
+		double z; //!< The depth from 0 to 1
+		double w; //!< The w from the projection
+		float  u; //!< The u texture coord
+		float  v; //!< The v texture coord
+	};
+
+	static void Multiply(double* result, const double* first, const double* second);
+	void SetupItems(const M5RenderItems& items, const double* matrix);
+	void SetupText(const M5TextVertices& verts, const double* matrix);
+	void ToScreen(Vertex& vert, const double* clip) const;
+	void AddTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2,
+		const unsigned char* color, const Texture* pTexture, bool isClamped);
+	void DrawTiles(void);
+	void DrawTile(int tile);
+	void DrawTriangle(const Triangle& tri, int minX, int minY, int maxX, int maxY);
+	void Present(void);
+	void RunWorker(int generation);
+
+	HWND                           m_window;        //!< The window to show frames in, or 0
+	HDC                            m_deviceContext; //!< The device context of the window
+	std::vector<Texture*>          m_textures;      //!< Textures by id - 1, 0 for free ids
+	std::vector<const Texture*>    m_frameTextures; //!< Copy of m_textures for the frame being drawn
+	std::mutex                     m_textureMutex;  //!< Guards m_textures
+	Texture                        m_font;          //!< The glyph atlas for text
+	std::vector<unsigned>          m_color;         //!< The last frame, starting with the bottom row
+	std::vector<float>             m_depth;         //!< Depth of every pixel
+	std::vector<unsigned>          m_present;       //!< The last frame in the order windows wants
+	std::vector<Triangle>          m_triangles;     //!< Every triangle in the frame, in draw order
+	std::vector<std::vector<int> > m_bins;          //!< Indices of the triangles that touch each tile
+	int                            m_width;         //!< Width of the frame in pixels
+	int                            m_height;        //!< Height of the frame in pixels
+	int                            m_tilesX;        //!< Number of tiles across
+	int                            m_tilesY;        //!< Number of tiles down
+	int                            m_viewport[4];   //!< The x, y, width and height of the viewport
+	unsigned                       m_clearColor;    //!< The background color
+	std::vector<std::thread>       m_workers;       //!< Threads that help draw tiles
+	std::atomic<int>               m_nextTile;      //!< The next tile to draw
+	std::mutex                     m_workMutex;     //!< Guards everything below
+	std::condition_variable        m_workSignal;    //!< Wakes workers when there are tiles to draw
+	std::condition_variable        m_doneSignal;    //!< Wakes the render thread when workers are done
+	int                            m_generation;    //!< Counts frames handed to the workers
+	int                            m_busyWorkers;   //!< Workers still drawing this frame
+	bool                           m_isRunning;     //!< False once the workers should stop
+};
+
+
+#endif //M5_SOFT_RENDER_BACKEND_H
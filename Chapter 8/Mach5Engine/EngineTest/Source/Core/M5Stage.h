@@ -13,6 +13,7 @@ Base class for M5Stage
 #ifndef M5_STAGE_H
 #define M5_STAGE_H
 
+#include "M5Memory.h"
 
 /*! A struct to hold the function pointers for a stage.*/
 class M5Stage
@@ -28,6 +29,10 @@ public:
 	virtual void Update(float dt) = 0;
 	//!Called after a Stage Change or request to restart
 	virtual void Shutdown(void) = 0;
+	//!All stages are counted by M5Memory
+	static void* operator new(size_t size) { return M5Memory::Allocate(size, MT_STAGE); }
+	//!Frees memory allocated by operator new
+	static void  operator delete(void* pMemory) { M5Memory::Free(pMemory); }
 
 };
 
@@ -14,18 +14,30 @@ between levels and menus.
 #include "M5App.h"
 #include "M5Gfx.h"
 #include "M5Phy.h"
+#include "M5Nav.h"
 #include "M5Input.h"
+#include "M5Replay.h"
 #include "M5Timer.h"
 #include "M5Debug.h"
 #include "M5ObjectManager.h"
-#include "..\RegisterStages.h"
+#include "../RegisterStages.h"
 #include "M5GameData.h"
 #include "M5Stage.h"
 #include "M5StageBuilder.h"
 #include "M5Factory.h"
+#include "M5IniFile.h"
+#include "M5Memory.h"
+#include "M5Telemetry.h"
+#include "M5Replication.h"
+#include "M5StreamManager.h"
+#include "M5Random.h"
+#include "M5Log.h"
 
 #include <vector>
 #include <stack>
+#include <future>
+#include <sstream>
+#include <chrono>
 
 
 namespace
@@ -39,6 +51,10 @@ struct PauseInfo
 	M5StageTypes type;
 };
 
+const unsigned GOLDEN_SEED = 1;             //!< Random seed for TestStage, so every run matches
+const float    GOLDEN_DT = 1.0f / 60.0f;    //!< Frame time for TestStage, so every run matches
+const int      GOLDEN_TOLERANCE = 2;        //!< How far a channel can be off before a pixel is different
+
 //"Private" class data
 static M5Factory<M5StageTypes, M5StageBuilder, M5Stage>
 s_stageFactory; /*!< Factory for creating Stages based off of the */
@@ -54,6 +70,49 @@ static bool                  s_isRestarting; /*!< TRUE if we are restarting, FAL
 static bool                  s_isPausing;
 static bool                  s_isResuming;
 static bool                  s_drawPaused;   /*< True if we are pausing and want to draw the paused items*/
+static std::future<void>     s_prefetch;     /*!< The running prefetch, if any*/
+static std::string           s_prefetchFile; /*!< The stage file being prefetched*/
+static M5IniFile             s_prefetchIni;  /*!< Only touched by the loading thread until s_prefetch is done*/
+static bool                  s_isPrefetching = true; /*!< FALSE if PrefetchStage should do nothing*/
+static float                 s_switchTime;   /*!< Seconds the last stage change took*/
+static float                 s_runTime;      /*!< Seconds of frames since the game started*/
+static float                 s_quitTime;     /*!< Quit when s_runTime gets here, 0 to never quit*/
+static std::chrono::high_resolution_clock::time_point
+                             s_switchStart;  /*!< When the current stage change started*/
+
+/******************************************************************************/
+/*!
+Runs on the loading thread.  Reads the stage file, then every archetype file it
+uses, and decodes the textures those archetypes will load.  The archetype
+files are spread over the load threads.  Prototypes are already built at
+startup, so their textures are normally resident, but this keeps the disk
+access off the main thread for anything that isn't.
+
+\param [in] fileName
+The stage file to read.
+*/
+/******************************************************************************/
+void PrefetchStageFile(std::string fileName)
+{
+	s_prefetchIni.ReadFile(fileName);
+
+	std::string archetypes;
+	s_prefetchIni.SetToSection("");
+	s_prefetchIni.GetValue("ArcheTypes", archetypes);
+
+	std::vector<M5ArcheTypeFile> files;
+	std::stringstream ss(archetypes);
+	std::string name;
+	while (ss >> name)
+	{
+		M5ArcheTypeFile archeType;
+		archeType.type = AT_INVALID;
+		archeType.fileName = "ArcheTypes/" + name + ".ini";
+		files.push_back(archeType);
+	}
+
+	M5ObjectManager::ReadArcheTypes(files);
+}
 
 
 }//end unnamed namespace
@@ -87,6 +146,10 @@ void M5StageManager::Init(const M5GameData& gameData, int framesPerSecond)
 	s_isResuming   = false;
 	s_isChanging   = true; //make sure we load the first stage
 	s_timer.Init(framesPerSecond);
+	s_switchTime   = 0.0f;
+	s_runTime      = 0.0f;
+	s_quitTime     = 0.0f;
+	s_switchStart  = std::chrono::high_resolution_clock::now();
 
 	/*Allocate space for game data, I don't know the details so just copy bytes*/
 	s_pGameData = new M5GameData(gameData);
@@ -101,6 +164,8 @@ by the user.  It will be called automatically by the system.
 /******************************************************************************/
 void M5StageManager::Shutdown(void)
 {
+	WaitForPrefetch();
+
 	//This was allocated as an array of bytes
 	delete s_pGameData;
 	s_pGameData = 0;
@@ -193,26 +258,70 @@ GameLoop.
 void M5StageManager::Update(void)
 {
 	float frameTime = 0.0f;
+	/*Totals of M5GfxStats for this stage*/
+	M5GfxStats gfxStats;
+	int frames = 0;
+	int drawn = 0;
+	int matricesBuilt = 0;
+	float drawTime = 0.0f;
 	/*Get the Current stage*/
 	
 	InitStage();
+	s_switchTime = std::chrono::duration<float>(
+		std::chrono::high_resolution_clock::now() - s_switchStart).count();
+	M5Log::Write(LL_INFO, LC_STAGE, "M5StageManager: switching to stage %d took %.2f ms",
+		static_cast<int>(s_currStage), s_switchTime * 1000.0f);
 
 	/*Keep going until the stage has changed or we are quitting.*/
 	while (!s_isChanging && !s_isQuitting && !s_isRestarting)
 	{
 		/*Our main game loop*/
 		s_timer.StartFrame();/*Save the start time of the frame*/
+		M5Telemetry::StartFrame();
 		M5Input::Reset(frameTime);
 		M5App::ProcessMessages();
+		M5Replay::EndInput(frameTime);
+		M5Telemetry::EndPhase(TP_INPUT);
 		M5ObjectManager::Update(frameTime);
+		M5Telemetry::EndPhase(TP_OBJECTS);
 		M5Phy::Update();
+		M5Telemetry::EndPhase(TP_PHYSICS);
 		s_pStage->Update(frameTime);
+		M5StreamManager::Update();
+		M5Telemetry::EndPhase(TP_STAGE);
 		M5Gfx::Update();
+		M5Telemetry::EndPhase(TP_GFX);
+		M5Gfx::GetStats(gfxStats);
+		++frames;
+		drawn += gfxStats.drawn;
+		matricesBuilt += gfxStats.matricesBuilt;
+		drawTime += gfxStats.drawTime;
+		M5Replication::Update(frameTime);
+		M5Memory::EndFrame();
 		frameTime = s_timer.EndFrame();/*Get the total frame time*/
+		M5Telemetry::EndFrame(frameTime);
+
+		/*Windowless runs have nobody to close the window*/
+		s_runTime += frameTime;
+		if (s_quitTime > 0 && s_runTime >= s_quitTime)
+			Quit();
+	}
+
+	if (frames > 0)
+	{
+		M5Log::Write(LL_INFO, LC_STAGE,
+			"M5StageManager: stage %d drew %.1f sprites a frame over %d frames, "
+			"rebuilt %.1f%% of matrices, %.3f ms average draw prep",
+			static_cast<int>(s_currStage), static_cast<float>(drawn) / frames, frames,
+			drawn > 0 ? 100.0f * matricesBuilt / drawn : 0.0f, drawTime * 1000.0f / frames);
 	}
 
 	/*Change Stage*/
 	ChangeStage();
+
+	/*Graphics shuts down before the object manager, so delete textures now*/
+	if (s_isQuitting)
+		M5ObjectManager::FlushDestroyQueue();
 }
 /******************************************************************************/
 /*!
@@ -284,6 +393,19 @@ void M5StageManager::Quit(void)
 }
 /******************************************************************************/
 /*!
+Makes the game quit once it has run for some seconds.  Use this for soak tests
+and other runs without a window, where nobody can close the game.
+
+\param [in] seconds
+The seconds of frames to run before quitting, or 0 to never quit.
+*/
+/******************************************************************************/
+void M5StageManager::QuitAfter(float seconds)
+{
+	s_quitTime = seconds;
+}
+/******************************************************************************/
+/*!
 Sets if the game stage manager should restart the current stage.  Use this to
 restart the current from inside a stage.
 
@@ -305,6 +427,7 @@ void M5StageManager::InitStage(void)
 {
 	if (s_isRestarting)
 	{
+		M5Nav::Reset();
 		s_pStage->Init();/*Call the initialize function*/
 		s_isRestarting = false;/*We need to reset our restart flag*/
 	}
@@ -313,6 +436,7 @@ void M5StageManager::InitStage(void)
 		M5ObjectManager::Resume();
 		M5Phy::Resume();
 		M5Gfx::Resume();
+		M5StreamManager::Resume();
 		s_isResuming = s_isChanging = false;
 		PauseInfo pi = s_pauseStack.top();
 		s_pauseStack.pop();
@@ -322,6 +446,7 @@ void M5StageManager::InitStage(void)
 	else if (s_isChanging)
 	{
 		s_pStage = s_stageFactory.Build(s_currStage);
+		M5Nav::Reset();
 		s_pStage->Init();/*Call the initialize function*/
 		s_isChanging = false;
 	}
@@ -333,12 +458,15 @@ Used to change the stage ids after the stage has shutdown.
 /******************************************************************************/
 void M5StageManager::ChangeStage(void)
 {
+	s_switchStart = std::chrono::high_resolution_clock::now();
+
 	/*Only unload if we are not restarting*/
 	if (s_isPausing)
 	{
 		M5ObjectManager::Pause();
 		M5Phy::Pause();
 		M5Gfx::Pause(s_drawPaused);
+		M5StreamManager::Pause();
 		PauseInfo pi(s_pStage, s_currStage);
 		s_pauseStack.push(pi);
 		s_isPausing = false;
@@ -364,6 +492,7 @@ void M5StageManager::ChangeStage(void)
 			M5Gfx::Resume();
 			M5Phy::Resume();
 			M5ObjectManager::Resume();
+			M5StreamManager::Resume();
 			PauseInfo pi = s_pauseStack.top();
 			pi.pStage->Shutdown();
 			delete pi.pStage;
@@ -379,3 +508,151 @@ void M5StageManager::ChangeStage(void)
 
 	s_currStage = s_nextStage;
 }
+/******************************************************************************/
+/*!
+Starts reading a stage file on a loading thread, along with the archetype
+files and textures it uses.  Call this from a stage that knows what will be
+loaded next, then use LoadStageFile in the next stage's Init.  Any earlier
+prefetch that was never used is thrown away.
+
+\param [in] fileName
+The stage file that will be loaded by a later stage.
+*/
+/******************************************************************************/
+void M5StageManager::PrefetchStage(const std::string& fileName)
+{
+	if (!s_isPrefetching)
+		return;
+
+	WaitForPrefetch();
+	M5Gfx::ClearPrefetchedTextures();
+
+	s_prefetchFile = fileName;
+	s_prefetch = std::async(std::launch::async, PrefetchStageFile, fileName);
+}
+/******************************************************************************/
+/*!
+Turns PrefetchStage on or off.  With it off every stage file is read when the
+stage that uses it starts, which is how long stage changes took before
+prefetching.
+
+\param [in] isPrefetching
+True to let stages prefetch, false to ignore PrefetchStage.
+*/
+/******************************************************************************/
+void M5StageManager::SetPrefetch(bool isPrefetching)
+{
+	s_isPrefetching = isPrefetching;
+}
+/******************************************************************************/
+/*!
+Reads a stage file.  If the file was prefetched this only waits for the
+loading thread to finish, otherwise the file is read now.
+
+\param [in] fileName
+The stage file to read.
+
+\param [out] iniFile
+The ini file to fill.  It will be set to the global section.
+*/
+/******************************************************************************/
+void M5StageManager::LoadStageFile(const std::string& fileName, M5IniFile& iniFile)
+{
+	if (s_prefetch.valid() && s_prefetchFile == fileName)
+	{
+		s_prefetch.get();
+		s_prefetchFile.clear();
+		iniFile = s_prefetchIni;
+		//The copy still points at the prefetched section
+		iniFile.SetToSection("");
+	}
+	else
+	{
+		iniFile.ReadFile(fileName);
+	}
+}
+/******************************************************************************/
+/*!
+Gets how long the last stage change took, from the old stage's Shutdown to the
+end of the new stage's Init.
+
+\return
+The time in seconds.
+*/
+/******************************************************************************/
+float M5StageManager::GetStageSwitchTime(void)
+{
+	return s_switchTime;
+}
+/******************************************************************************/
+/*!
+Checks that a stage still draws the same thing.  The stage is loaded and
+updated for a number of frames without input, with a fixed seed and frame time
+so every run is the same, then the last frame is compared to a golden image.
+If the golden image doesn't exist yet it is saved instead, and if the frame is
+different it is saved next to the golden image with .fail.tga added.  This
+should be called instead of M5App::Update.
+
+\attention
+This needs the software backend, use -software on the command line.
+
+\param [in] stage
+The stage to test.
+
+\param [in] frames
+The number of frames to update before comparing.
+
+\param [in] imageFile
+The golden image.
+
+\return
+The number of pixels that are different, so 0 means the test passed.
+*/
+/******************************************************************************/
+int M5StageManager::TestStage(M5StageTypes stage, int frames, const char* imageFile)
+{
+	M5Random::Seed(GOLDEN_SEED);
+	SetStartStage(stage);
+	InitStage();
+
+	for (int i = 0; i < frames && !s_isChanging && !s_isQuitting && !s_isRestarting; ++i)
+	{
+		M5ObjectManager::Update(GOLDEN_DT);
+		M5Phy::Update();
+		s_pStage->Update(GOLDEN_DT);
+		M5StreamManager::Update();
+		M5Gfx::Update();
+		M5Memory::EndFrame();
+	}
+
+	int different = M5Gfx::CompareFrame(imageFile, GOLDEN_TOLERANCE);
+	if (different < 0)
+	{
+		M5Gfx::SaveFrame(imageFile);
+		M5Log::Write(LL_INFO, LC_STAGE, "M5StageManager: saved new golden image %s", imageFile);
+		different = 0;
+	}
+	else if (different > 0)
+	{
+		std::string failFile = std::string(imageFile) + ".fail.tga";
+		M5Gfx::SaveFrame(failFile.c_str());
+		M5Log::Write(LL_ERROR, LC_STAGE, "M5StageManager: %d pixels differ from %s, see %s",
+			different, imageFile, failFile.c_str());
+	}
+
+	/*Shut the stage down the same way quitting does*/
+	s_isQuitting = true;
+	ChangeStage();
+	M5ObjectManager::FlushDestroyQueue();
+	return different;
+}
+/******************************************************************************/
+/*!
+Blocks until the current prefetch, if any, is finished.
+*/
+/******************************************************************************/
+void M5StageManager::WaitForPrefetch(void)
+{
+	if (s_prefetch.valid())
+		s_prefetch.wait();
+}
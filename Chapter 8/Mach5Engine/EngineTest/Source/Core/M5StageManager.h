@@ -17,8 +17,10 @@ Singleton to control quitting, restarting and switching stages.
 class M5Stage;
 struct M5GameData;
 class M5StageBuilder;
+class M5IniFile;
 
 #include "M5StageTypes.h"
+#include <string>
 
 
 //! Singleton to control quitting, restarting and switching stages.
@@ -49,14 +51,27 @@ public:
   static void Resume(void);
   //Tells the game to quit
   static void Quit(void);
+  //Tells the game to quit after running for some seconds, 0 to never quit
+  static void QuitAfter(float seconds);
   //Tells the stage to restart
   static void Restart(void);
+  //Starts reading a stage file and its textures on a loading thread
+  static void PrefetchStage(const std::string& fileName);
+  //Turns PrefetchStage on or off, so stage changes can be timed both ways
+  static void SetPrefetch(bool isPrefetching);
+  //Reads a stage file, using the prefetched copy if it is ready
+  static void LoadStageFile(const std::string& fileName, M5IniFile& iniFile);
+  //Gets the time in seconds the last stage change took
+  static float GetStageSwitchTime(void);
+  //Updates a stage for some frames and compares the last one to a golden image
+  static int TestStage(M5StageTypes stage, int frames, const char* imageFile);
 private:
   static void Init(const M5GameData& gameData, int framesPerSecond);
   static void Update(void);
   static void Shutdown(void);
   static void InitStage(void);
   static void ChangeStage(void);
+  static void WaitForPrefetch(void);
 
 };//end M5StageManager
 
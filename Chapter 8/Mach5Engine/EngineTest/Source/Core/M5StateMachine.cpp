@@ -40,4 +40,17 @@ void M5StateMachine::Update(float dt)
 void M5StateMachine::SetNextState(M5State* pNext)
 {
 	m_pNext = pNext;
-}
\ No newline at end of file
+}
+M5State* M5StateMachine::GetCurrState(void) const
+{
+	return m_pCurr;
+}
+M5State* M5StateMachine::GetNextState(void) const
+{
+	return m_pNext;
+}
+void M5StateMachine::SetStates(M5State* pCurr, M5State* pNext)
+{
+	m_pCurr = pCurr;
+	m_pNext = pNext;
+}
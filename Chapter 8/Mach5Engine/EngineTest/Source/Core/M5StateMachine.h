@@ -37,6 +37,10 @@ public:
 	virtual ~M5StateMachine(void);
 	virtual void Update(float dt);
 	void SetNextState(M5State* pNext);
+protected:
+	M5State* GetCurrState(void) const;
+	M5State* GetNextState(void) const;
+	void     SetStates(M5State* pCurr, M5State* pNext);
 private:
 	M5State* m_pCurr; //!< a pointer to our current state to be updated
 	M5State* m_pNext; //!< a pointer to the next state to be updated
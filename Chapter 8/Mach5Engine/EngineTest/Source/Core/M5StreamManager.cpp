@@ -0,0 +1,927 @@
+/******************************************************************************/
+/*!
+\file   M5StreamManager.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Singleton class to stream the objects of a large level in and out in chunks
+as the camera moves.
+
+A chunk file starts with an M5ChunkHeader, then the ArcheType names it uses,
+then an M5ChunkIndex for every chunk that has objects, then the placements of
+each chunk together.  Only the index is read by Open.  A chunk goes from
+unloaded, to loading on the loading thread, to loaded, to active once its
+objects are being made.  Chunks become active and loaded within a margin
+around the screen, and are only deactivated or unloaded one chunk past that
+margin, so a camera moving back and forth over a chunk edge doesn't make and
+destroy the same objects every frame.
+
+*/
+/******************************************************************************/
+#include "M5StreamManager.h"
+#include "M5ObjectManager.h"
+#include "M5Object.h"
+#include "M5Gfx.h"
+#include "M5IniFile.h"
+#include "M5Memory.h"
+#include "M5Debug.h"
+#include "M5Log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace
+{
+typedef std::chrono::high_resolution_clock                           StreamClock;  //!< typedef Clock for the activation budget
+typedef std::vector<M5Placement, M5Allocator<M5Placement, MT_STREAM> > PlacementVec; //!< typedef Placements of one chunk
+typedef std::vector<int, M5Allocator<int, MT_STREAM> >                 IDVec;        //!< typedef Objects made by one chunk
+
+//! How far along a chunk is
+enum M5ChunkState
+{
+	CS_UNLOADED, //!< Only the index is in memory
+	CS_LOADING,  //!< The loading thread is reading its placements
+	CS_LOADED,   //!< The placements are in memory but no objects are made
+	CS_ACTIVE    //!< Its objects are being made or have been made
+};
+
+//! The start of a chunk file
+struct M5ChunkHeader
+{
+	unsigned magic;      //!< CHUNK_MAGIC, so other files are rejected
+	unsigned version;    //!< CHUNK_VERSION, so old files are rejected
+	float    chunkSize;  //!< Width and height of every chunk
+	int      typeCount;  //!< Type names after the header
+	int      chunkCount; //!< M5ChunkIndex entries after the type names
+};
+
+//! Where a chunk is in the world and in the chunk file
+struct M5ChunkIndex
+{
+	int      x;      //!< Grid column, x / chunkSize rounded down
+	int      y;      //!< Grid row, y / chunkSize rounded down
+	unsigned offset; //!< Bytes from the start of the file to its placements
+	int      count;  //!< Number of placements
+};
+
+//! A placement as it is saved in a chunk file
+struct M5ChunkRecord
+{
+	float x;    //!< Position x
+	float y;    //!< Position y
+	int   type; //!< Index into the type names of the file
+};
+
+//! A chunk of the level being streamed
+struct M5Chunk
+{
+	M5ChunkIndex index;      //!< Where it is in the world and in the file
+	M5ChunkState state;      //!< How far along it is
+	PlacementVec placements; //!< Filled once it is loaded
+	IDVec        objectIDs;  //!< Objects made so far, oldest first so the ids are increasing
+};
+
+//! Work for or from the loading thread
+struct M5StreamJob
+{
+	int          chunk;      //!< The chunk to read, or -1 to only free placements
+	unsigned     offset;     //!< Copied from the index so the thread doesn't touch M5Chunk
+	int          count;      //!< Copied from the index so the thread doesn't touch M5Chunk
+	PlacementVec placements; //!< The placements that were read or should be freed
+};
+
+//! A range of chunks, inclusive
+struct M5ChunkRect
+{
+	int minX; //!< Lowest column
+	int minY; //!< Lowest row
+	int maxX; //!< Highest column
+	int maxY; //!< Highest row
+};
+
+typedef std::vector<M5StreamJob> JobVec;   //!< typedef Container of jobs
+typedef std::deque<M5StreamJob>  JobQueue; //!< typedef Container of jobs waiting for the loading thread
+
+const unsigned CHUNK_MAGIC = 0x4B43354D; //!< "M5CK" in a little endian file
+const unsigned CHUNK_VERSION = 1;        //!< Change when the layout of the file changes
+const float    ACTIVATE_TIME = .002f;    //!< Default seconds per frame for making objects
+const int      ACTIVATE_COUNT = 256;     //!< Default objects per frame
+const int      ACTIVE_MARGIN = 1;        //!< Default chunks past the screen that are active
+const int      LOADED_MARGIN = 2;        //!< Default chunks past the screen that are loaded
+
+std::vector<M5Chunk>               s_chunks;                                //!< Every chunk in the file
+std::unordered_map<long long, int> s_chunkMap;                              //!< Index into s_chunks by grid cell
+std::vector<int>                   s_resident;                              //!< Chunks that aren't CS_UNLOADED
+std::vector<M5ArcheTypes>          s_types;                                 //!< The ArcheType of each type name in the file
+std::vector<int>                   s_activating;                            //!< Reused by ActivateChunks so it doesn't allocate
+std::vector<int>                   s_destroyIDs;                            //!< Reused by DeactivateChunks so it doesn't allocate
+JobVec                             s_requests;                              //!< Jobs to hand to the loading thread this frame
+JobVec                             s_received;                              //!< Reused by ReceiveLoads so it doesn't allocate
+std::string                        s_fileName;                              //!< The chunk file, read by the loading thread
+float                              s_chunkSize;                             //!< Width and height of every chunk
+M5ChunkRect                        s_view;                                  //!< Chunks on screen this frame
+M5Vec2                             s_viewCenter;                            //!< Center of the screen this frame
+bool                               s_isOpen;                                //!< True between Open and Close
+int                                s_pauseCount;                            //!< Nothing streams while above 0
+float                              s_activateTimeBudget = ACTIVATE_TIME;    //!< Max seconds per frame for making objects
+int                                s_activateCountBudget = ACTIVATE_COUNT;  //!< Max objects per frame to make
+int                                s_activeMargin = ACTIVE_MARGIN;          //!< Chunks past the screen that are active
+int                                s_loadedMargin = LOADED_MARGIN;          //!< Chunks past the screen that are loaded
+M5StreamStats                      s_stats;                                 //!< Returned by GetStats
+
+std::thread                        s_thread;                                //!< Reads and frees placements
+std::mutex                         s_jobLock;                               //!< Guards s_jobs, s_done, s_isRunning and s_isBusy
+std::condition_variable            s_jobSignal;                             //!< Wakes the loading thread
+std::condition_variable            s_idleSignal;                            //!< Wakes WaitForLoads when the loading thread runs out of work
+JobQueue                           s_jobs;                                  //!< Jobs waiting for the loading thread
+JobVec                             s_done;                                  //!< Chunks the loading thread has read
+bool                               s_isRunning;                             //!< False tells the loading thread to stop
+bool                               s_isBusy;                                //!< True while the loading thread works on a job
+
+/******************************************************************************/
+/*!
+Gets the key of a grid cell in s_chunkMap.
+
+\param [in] x
+The column of the cell.
+
+\param [in] y
+The row of the cell.
+
+\return
+A key that is different for every cell.
+*/
+/******************************************************************************/
+long long ChunkKey(int x, int y)
+{
+	return static_cast<long long>((static_cast<unsigned long long>(static_cast<unsigned>(x)) << 32) |
+		static_cast<unsigned>(y));
+}
+/******************************************************************************/
+/*!
+Gets the chunk column or row that a world position is in.
+
+\param [in] value
+The x or y of the position.
+
+\param [in] chunkSize
+The width and height of every chunk.
+
+\return
+The column or row.
+*/
+/******************************************************************************/
+int ToChunk(float value, float chunkSize)
+{
+	return static_cast<int>(std::floor(value / chunkSize));
+}
+/******************************************************************************/
+/*!
+Checks if a chunk is within some chunks of the screen.
+
+\param [in] index
+The chunk to check.
+
+\param [in] margin
+How many chunks past the edge of the screen count.
+
+\return
+True if the chunk is within the margin.
+*/
+/******************************************************************************/
+bool IsWithin(const M5ChunkIndex& index, int margin)
+{
+	return index.x >= s_view.minX - margin && index.x <= s_view.maxX + margin &&
+		index.y >= s_view.minY - margin && index.y <= s_view.maxY + margin;
+}
+/******************************************************************************/
+/*!
+Gets how far the center of a chunk is from the center of the screen.
+
+\param [in] index
+The chunk to measure.
+
+\return
+The distance squared.
+*/
+/******************************************************************************/
+float DistanceSquared(const M5ChunkIndex& index)
+{
+	float x = (index.x + .5f) * s_chunkSize - s_viewCenter.x;
+	float y = (index.y + .5f) * s_chunkSize - s_viewCenter.y;
+	return x * x + y * y;
+}
+/******************************************************************************/
+/*!
+Sorts chunks nearest to the center of the screen first.
+
+\param [in] first
+The index of the first chunk.
+
+\param [in] second
+The index of the second chunk.
+
+\return
+True if first is nearer.
+*/
+/******************************************************************************/
+bool IsNearer(int first, int second)
+{
+	return DistanceSquared(s_chunks[first].index) < DistanceSquared(s_chunks[second].index);
+}
+/******************************************************************************/
+/*!
+Forgets the objects of an active chunk and counts it as only loaded.
+
+\param [in, out] chunk
+The chunk to deactivate.
+*/
+/******************************************************************************/
+void ForgetObjects(M5Chunk& chunk)
+{
+	s_stats.activeObjects -= static_cast<int>(chunk.objectIDs.size());
+	--s_stats.activeChunks;
+	IDVec().swap(chunk.objectIDs);
+	chunk.state = CS_LOADED;
+}
+}//end unnamed namespace
+
+
+/******************************************************************************/
+/*!
+Splits the objects of a stage file into a chunk file.  The stage file uses the
+same ArcheTypes, count and pos keys as a stage loaded all at once, so a level
+can be made the usual way and split when it gets too big.
+
+\param [in] stageFile
+The stage file to read.
+
+\param [in] chunkFile
+The chunk file to write.
+
+\param [in] chunkSize
+The width and height of every chunk.  A few screens of objects in a chunk
+is a good start.
+
+\return
+True if the chunk file was written.
+*/
+/******************************************************************************/
+bool M5StreamManager::BuildChunkFile(const std::string& stageFile, const std::string& chunkFile, float chunkSize)
+{
+	M5IniFile iniFile;
+	iniFile.ReadFile(stageFile);
+
+	std::string archeTypesList;
+	iniFile.GetValue("ArcheTypes", archeTypesList);
+	std::stringstream ss(archeTypesList);
+
+	std::vector<M5Placement> placements;
+	std::string typeAsString;
+	while (ss >> typeAsString)
+	{
+		int count;
+		std::string posList;
+		iniFile.SetToSection(typeAsString);
+		iniFile.GetValue("count", count);
+		iniFile.GetValue("pos", posList);
+		std::stringstream posStream(posList);
+
+		M5Placement placement;
+		placement.type = StringToArcheType(typeAsString);
+		for (int i = 0; i < count; ++i)
+		{
+			posStream >> placement.pos;
+			placements.push_back(placement);
+		}
+	}
+
+	return WriteChunkFile(chunkFile, placements, chunkSize);
+}
+/******************************************************************************/
+/*!
+Writes placements to a chunk file, split into square chunks.  Chunks without
+any placements aren't written.
+
+\param [in] chunkFile
+The chunk file to write.
+
+\param [in] placements
+Every object of the level.
+
+\param [in] chunkSize
+The width and height of every chunk.
+
+\return
+True if the chunk file was written.
+*/
+/******************************************************************************/
+bool M5StreamManager::WriteChunkFile(const std::string& chunkFile, const std::vector<M5Placement>& placements, float chunkSize)
+{
+	M5DEBUG_ASSERT(chunkSize > 0, "Chunks must be bigger than 0");
+
+	/*Sort by chunk, and by order in the level inside each chunk*/
+	std::vector<std::pair<long long, int> > order(placements.size());
+	for (size_t i = 0; i < placements.size(); ++i)
+	{
+		order[i].first = ChunkKey(ToChunk(placements[i].pos.x, chunkSize), ToChunk(placements[i].pos.y, chunkSize));
+		order[i].second = static_cast<int>(i);
+	}
+	std::sort(order.begin(), order.end());
+
+	/*Only the types that are used get a name*/
+	std::vector<int> typeIndex(AT_INVALID, -1);
+	std::vector<std::string> names;
+	std::vector<M5ChunkRecord> records(placements.size());
+	std::vector<M5ChunkIndex> chunks;
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		const M5Placement& placement = placements[order[i].second];
+		M5DEBUG_ASSERT(placement.type >= 0 && placement.type < AT_INVALID, "Placing an ArcheType that doesn't exist");
+		if (typeIndex[placement.type] == -1)
+		{
+			typeIndex[placement.type] = static_cast<int>(names.size());
+			names.push_back(ARCHETYPE_NAMES[placement.type]);
+		}
+
+		records[i].x = placement.pos.x;
+		records[i].y = placement.pos.y;
+		records[i].type = typeIndex[placement.type];
+
+		if (i == 0 || order[i].first != order[i - 1].first)
+		{
+			M5ChunkIndex index;
+			index.x = ToChunk(placement.pos.x, chunkSize);
+			index.y = ToChunk(placement.pos.y, chunkSize);
+			index.offset = static_cast<unsigned>(i * sizeof(M5ChunkRecord));
+			index.count = 0;
+			chunks.push_back(index);
+		}
+		++chunks.back().count;
+	}
+
+	M5ChunkHeader header;
+	header.magic = CHUNK_MAGIC;
+	header.version = CHUNK_VERSION;
+	header.chunkSize = chunkSize;
+	header.typeCount = static_cast<int>(names.size());
+	header.chunkCount = static_cast<int>(chunks.size());
+
+	/*Offsets so far are from the first placement, make them from the start*/
+	size_t dataStart = sizeof(header) + chunks.size() * sizeof(M5ChunkIndex);
+	for (size_t i = 0; i < names.size(); ++i)
+		dataStart += 1 + names[i].size();
+	for (size_t i = 0; i < chunks.size(); ++i)
+		chunks[i].offset += static_cast<unsigned>(dataStart);
+
+	std::ofstream file(chunkFile, std::ios::out | std::ios::binary);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		unsigned char length = static_cast<unsigned char>(names[i].size());
+		file.write(reinterpret_cast<const char*>(&length), 1);
+		file.write(names[i].c_str(), length);
+	}
+	if (!chunks.empty())
+		file.write(reinterpret_cast<const char*>(&chunks[0]), chunks.size() * sizeof(M5ChunkIndex));
+	if (!records.empty())
+		file.write(reinterpret_cast<const char*>(&records[0]), records.size() * sizeof(M5ChunkRecord));
+
+	if (!file)
+	{
+		M5Log::Write(LL_ERROR, LC_STAGE, "M5StreamManager: could not write %s", chunkFile.c_str());
+		return false;
+	}
+
+	M5Log::Write(LL_INFO, LC_STAGE, "M5StreamManager: wrote %d objects in %d chunks to %s",
+		static_cast<int>(placements.size()), header.chunkCount, chunkFile.c_str());
+	return true;
+}
+/******************************************************************************/
+/*!
+Reads the index of a chunk file and starts the loading thread.  No objects are
+made until the next Update, where the chunks around the camera are loaded.
+Any chunk file that was already open is closed first.
+
+\param [in] chunkFile
+The chunk file to stream.
+
+\return
+True if the file is a chunk file and its index was read.
+*/
+/******************************************************************************/
+bool M5StreamManager::Open(const std::string& chunkFile)
+{
+	Close();
+
+	std::ifstream file(chunkFile, std::ios::in | std::ios::binary);
+	M5ChunkHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		header.magic != CHUNK_MAGIC || header.version != CHUNK_VERSION ||
+		!(header.chunkSize > 0) || header.typeCount < 0 || header.chunkCount < 0)
+	{
+		M5Log::Write(LL_ERROR, LC_STAGE, "M5StreamManager: %s is not a chunk file", chunkFile.c_str());
+		return false;
+	}
+
+	s_types.resize(header.typeCount);
+	for (int i = 0; i < header.typeCount && file; ++i)
+	{
+		unsigned char length = 0;
+		file.read(reinterpret_cast<char*>(&length), 1);
+		std::string name(length, ' ');
+		if (length != 0)
+			file.read(&name[0], length);
+
+		/*Objects of types this build doesn't know are skipped when loaded*/
+		s_types[i] = StringToArcheType(name);
+		if (file && s_types[i] == AT_INVALID)
+			M5Log::Write(LL_WARNING, LC_STAGE, "M5StreamManager: %s uses unknown ArcheType %s",
+				chunkFile.c_str(), name.c_str());
+	}
+
+	s_chunks.resize(header.chunkCount);
+	for (int i = 0; i < header.chunkCount && file; ++i)
+	{
+		M5Chunk& chunk = s_chunks[i];
+		file.read(reinterpret_cast<char*>(&chunk.index), sizeof(chunk.index));
+		chunk.state = CS_UNLOADED;
+		if (chunk.index.count < 0)
+			file.setstate(std::ios::failbit);
+		s_chunkMap[ChunkKey(chunk.index.x, chunk.index.y)] = i;
+	}
+
+	if (!file)
+	{
+		M5Log::Write(LL_ERROR, LC_STAGE, "M5StreamManager: the index of %s is cut short", chunkFile.c_str());
+		s_types.clear();
+		std::vector<M5Chunk>().swap(s_chunks);
+		s_chunkMap.clear();
+		return false;
+	}
+
+	s_fileName = chunkFile;
+	s_chunkSize = header.chunkSize;
+	s_stats.chunkCount = header.chunkCount;
+	s_stats.loadedChunks = 0;
+	s_stats.activeChunks = 0;
+	s_stats.pendingLoads = 0;
+	s_stats.activeObjects = 0;
+	s_stats.activated = 0;
+	s_stats.updateTime = 0;
+
+	s_isRunning = true;
+	s_isBusy = false;
+	s_thread = std::thread(LoadThread);
+	s_isOpen = true;
+
+	M5Log::Write(LL_INFO, LC_STAGE, "M5StreamManager: streaming %d chunks from %s",
+		header.chunkCount, chunkFile.c_str());
+	return true;
+}
+/******************************************************************************/
+/*!
+Stops the loading thread and frees every chunk.  Objects that chunks made are
+left for the stage to destroy.  It is safe to call when nothing is open.
+*/
+/******************************************************************************/
+void M5StreamManager::Close(void)
+{
+	if (!s_isOpen)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(s_jobLock);
+		s_isRunning = false;
+	}
+	s_jobSignal.notify_one();
+	s_thread.join();
+
+	s_jobs.clear();
+	s_done.clear();
+	s_requests.clear();
+	s_received.clear();
+	std::vector<M5Chunk>().swap(s_chunks);
+	s_chunkMap.clear();
+	s_resident.clear();
+	s_types.clear();
+	s_fileName.clear();
+	s_isOpen = false;
+}
+/******************************************************************************/
+/*!
+Checks if a chunk file is being streamed.
+
+\return
+True between Open and Close.
+*/
+/******************************************************************************/
+bool M5StreamManager::IsOpen(void)
+{
+	return s_isOpen;
+}
+/******************************************************************************/
+/*!
+Forgets the objects of every active chunk, so the chunks near the camera make
+them again.  Call this after the objects were destroyed some other way, like
+by M5ObjectManager::Restore with a snapshot saved before they were made.
+*/
+/******************************************************************************/
+void M5StreamManager::ResetChunks(void)
+{
+	for (size_t i = 0; i < s_resident.size(); ++i)
+	{
+		M5Chunk& chunk = s_chunks[s_resident[i]];
+		if (chunk.state == CS_ACTIVE)
+			ForgetObjects(chunk);
+	}
+}
+/******************************************************************************/
+/*!
+Sets how much work making objects can do each frame.  Chunks that can't be
+finished in one frame keep making objects in the next frames.
+
+\param [in] maxTime
+The most seconds to spend making objects each frame.
+
+\param [in] maxCount
+The most objects to make each frame.
+*/
+/******************************************************************************/
+void M5StreamManager::SetActivationBudget(float maxTime, int maxCount)
+{
+	M5DEBUG_ASSERT(maxTime > 0 && maxCount > 0, "The activation budget must let some objects be made");
+	s_activateTimeBudget = maxTime;
+	s_activateCountBudget = maxCount;
+}
+/******************************************************************************/
+/*!
+Sets how far past the edge of the screen chunks are streamed.  Bigger margins
+hide objects being made from the player when the camera moves fast, but keep
+more objects alive.
+
+\param [in] activeChunks
+Chunks this far past the screen have their objects made.
+
+\param [in] loadedChunks
+Chunks this far past the screen are read into memory.  It must be at least
+activeChunks.
+*/
+/******************************************************************************/
+void M5StreamManager::SetMargins(int activeChunks, int loadedChunks)
+{
+	M5DEBUG_ASSERT(activeChunks >= 0 && loadedChunks >= activeChunks,
+		"Chunks must be loaded before they can be active");
+	s_activeMargin = activeChunks;
+	s_loadedMargin = loadedChunks;
+}
+/******************************************************************************/
+/*!
+Gets what the streamer is doing.
+
+\param [out] stats
+The stats to fill.  Counts are from the end of the last Update.
+*/
+/******************************************************************************/
+void M5StreamManager::GetStats(M5StreamStats& stats)
+{
+	stats = s_stats;
+}
+/******************************************************************************/
+/*!
+Streams chunks around the camera for this frame.  This is called by the
+M5StageManager after the stage's Update, so a camera the stage moved is used
+in the same frame.
+*/
+/******************************************************************************/
+void M5StreamManager::Update(void)
+{
+	if (!s_isOpen || s_pauseCount != 0)
+		return;
+
+	StreamClock::time_point start = StreamClock::now();
+
+	/*The camera can be rotated, so use the box around every corner*/
+	M5Vec2 corners[4];
+	M5Gfx::GetWorldTopLeft(corners[0]);
+	M5Gfx::GetWorldTopRight(corners[1]);
+	M5Gfx::GetWorldBotLeft(corners[2]);
+	M5Gfx::GetWorldBotRight(corners[3]);
+	M5Vec2 minCorner = corners[0];
+	M5Vec2 maxCorner = corners[0];
+	for (int i = 1; i < 4; ++i)
+	{
+		minCorner.x = std::min(minCorner.x, corners[i].x);
+		minCorner.y = std::min(minCorner.y, corners[i].y);
+		maxCorner.x = std::max(maxCorner.x, corners[i].x);
+		maxCorner.y = std::max(maxCorner.y, corners[i].y);
+	}
+	s_view.minX = ToChunk(minCorner.x, s_chunkSize);
+	s_view.minY = ToChunk(minCorner.y, s_chunkSize);
+	s_view.maxX = ToChunk(maxCorner.x, s_chunkSize);
+	s_view.maxY = ToChunk(maxCorner.y, s_chunkSize);
+	s_viewCenter.x = (minCorner.x + maxCorner.x) * .5f;
+	s_viewCenter.y = (minCorner.y + maxCorner.y) * .5f;
+
+	s_stats.activated = 0;
+	ReceiveLoads();
+	DeactivateChunks();
+	RequestLoads();
+	ActivateChunks();
+
+	s_stats.updateTime = std::chrono::duration<float>(StreamClock::now() - start).count();
+}
+/******************************************************************************/
+/*!
+Closes the chunk file.  This is called by M5App::Shutdown so the loading
+thread stops before the log.
+*/
+/******************************************************************************/
+void M5StreamManager::Shutdown(void)
+{
+	Close();
+	s_pauseCount = 0;
+}
+/******************************************************************************/
+/*!
+Stops streaming while the stage that opened the chunk file is paused, so
+chunks don't make objects in the stage on top of it.
+*/
+/******************************************************************************/
+void M5StreamManager::Pause(void)
+{
+	++s_pauseCount;
+}
+/******************************************************************************/
+/*!
+Starts streaming again when the paused stage is resumed.
+*/
+/******************************************************************************/
+void M5StreamManager::Resume(void)
+{
+	M5DEBUG_ASSERT(s_pauseCount > 0, "Resuming the M5StreamManager without a Pause");
+	--s_pauseCount;
+}
+/******************************************************************************/
+/*!
+Takes the chunks the loading thread has finished reading.
+*/
+/******************************************************************************/
+void M5StreamManager::ReceiveLoads(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(s_jobLock);
+		s_received.swap(s_done);
+	}
+
+	for (size_t i = 0; i < s_received.size(); ++i)
+	{
+		M5Chunk& chunk = s_chunks[s_received[i].chunk];
+		chunk.placements.swap(s_received[i].placements);
+		chunk.state = CS_LOADED;
+		--s_stats.pendingLoads;
+		++s_stats.loadedChunks;
+	}
+	s_received.clear();
+}
+/******************************************************************************/
+/*!
+Destroys the objects of active chunks that are too far from the screen, and
+hands the placements of loaded chunks that are too far to the loading thread
+to free.  Every object is destroyed with one pass over the object manager.
+*/
+/******************************************************************************/
+void M5StreamManager::DeactivateChunks(void)
+{
+	s_destroyIDs.clear();
+
+	size_t i = 0;
+	while (i < s_resident.size())
+	{
+		M5Chunk& chunk = s_chunks[s_resident[i]];
+		if (chunk.state == CS_ACTIVE && !IsWithin(chunk.index, s_activeMargin + 1))
+		{
+			s_destroyIDs.insert(s_destroyIDs.end(), chunk.objectIDs.begin(), chunk.objectIDs.end());
+			ForgetObjects(chunk);
+		}
+
+		if (chunk.state == CS_LOADED && !IsWithin(chunk.index, s_loadedMargin + 1))
+		{
+			s_requests.push_back(M5StreamJob());
+			s_requests.back().chunk = -1;
+			s_requests.back().placements.swap(chunk.placements);
+			chunk.state = CS_UNLOADED;
+			--s_stats.loadedChunks;
+
+			s_resident[i] = s_resident.back();
+			s_resident.pop_back();
+			continue;
+		}
+		++i;
+	}
+
+	if (!s_destroyIDs.empty())
+	{
+		std::sort(s_destroyIDs.begin(), s_destroyIDs.end());
+		M5ObjectManager::DestroyObjects(s_destroyIDs);
+	}
+}
+/******************************************************************************/
+/*!
+Asks the loading thread for every unloaded chunk near the screen, and hands it
+everything else that was queued this frame.
+*/
+/******************************************************************************/
+void M5StreamManager::RequestLoads(void)
+{
+	M5ChunkRect rect;
+	rect.minX = s_view.minX - s_loadedMargin;
+	rect.minY = s_view.minY - s_loadedMargin;
+	rect.maxX = s_view.maxX + s_loadedMargin;
+	rect.maxY = s_view.maxY + s_loadedMargin;
+
+	/*A camera that is far away sees more cells than there are chunks*/
+	long long cells = static_cast<long long>(rect.maxX - rect.minX + 1) * (rect.maxY - rect.minY + 1);
+	bool checkAll = cells > static_cast<long long>(s_chunks.size());
+
+	for (int y = rect.minY; y <= rect.maxY && !checkAll; ++y)
+	{
+		for (int x = rect.minX; x <= rect.maxX; ++x)
+		{
+			std::unordered_map<long long, int>::const_iterator found = s_chunkMap.find(ChunkKey(x, y));
+			if (found == s_chunkMap.end() || s_chunks[found->second].state != CS_UNLOADED)
+				continue;
+
+			M5Chunk& chunk = s_chunks[found->second];
+			s_requests.push_back(M5StreamJob());
+			s_requests.back().chunk = found->second;
+			s_requests.back().offset = chunk.index.offset;
+			s_requests.back().count = chunk.index.count;
+			chunk.state = CS_LOADING;
+			s_resident.push_back(found->second);
+			++s_stats.pendingLoads;
+		}
+	}
+
+	for (size_t i = 0; i < s_chunks.size() && checkAll; ++i)
+	{
+		M5Chunk& chunk = s_chunks[i];
+		if (chunk.state != CS_UNLOADED || !IsWithin(chunk.index, s_loadedMargin))
+			continue;
+
+		s_requests.push_back(M5StreamJob());
+		s_requests.back().chunk = static_cast<int>(i);
+		s_requests.back().offset = chunk.index.offset;
+		s_requests.back().count = chunk.index.count;
+		chunk.state = CS_LOADING;
+		s_resident.push_back(static_cast<int>(i));
+		++s_stats.pendingLoads;
+	}
+
+	if (s_requests.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(s_jobLock);
+		for (size_t i = 0; i < s_requests.size(); ++i)
+			s_jobs.push_back(std::move(s_requests[i]));
+	}
+	s_requests.clear();
+	s_jobSignal.notify_one();
+}
+/******************************************************************************/
+/*!
+Makes objects for loaded chunks near the screen, nearest chunks first, until
+the activation budget runs out.
+*/
+/******************************************************************************/
+void M5StreamManager::ActivateChunks(void)
+{
+	s_activating.clear();
+	for (size_t i = 0; i < s_resident.size(); ++i)
+	{
+		const M5Chunk& chunk = s_chunks[s_resident[i]];
+		if ((chunk.state == CS_LOADED || (chunk.state == CS_ACTIVE && chunk.objectIDs.size() < chunk.placements.size())) &&
+			IsWithin(chunk.index, s_activeMargin))
+			s_activating.push_back(s_resident[i]);
+	}
+	std::sort(s_activating.begin(), s_activating.end(), IsNearer);
+
+	StreamClock::time_point start = StreamClock::now();
+	for (size_t i = 0; i < s_activating.size(); ++i)
+	{
+		M5Chunk& chunk = s_chunks[s_activating[i]];
+		if (chunk.state == CS_LOADED)
+		{
+			chunk.state = CS_ACTIVE;
+			chunk.objectIDs.reserve(chunk.placements.size());
+			++s_stats.activeChunks;
+		}
+
+		while (chunk.objectIDs.size() < chunk.placements.size())
+		{
+			if (s_stats.activated >= s_activateCountBudget ||
+				std::chrono::duration<float>(StreamClock::now() - start).count() >= s_activateTimeBudget)
+				return;
+
+			const M5Placement& placement = chunk.placements[chunk.objectIDs.size()];
+			M5Object* pObj = M5ObjectManager::CreateObject(placement.type);
+			pObj->pos = placement.pos;
+			chunk.objectIDs.push_back(pObj->GetID());
+			++s_stats.activeObjects;
+			++s_stats.activated;
+		}
+	}
+}
+/******************************************************************************/
+/*!
+Waits until the loading thread has finished every job it was given.  The
+chunks it read are taken by the next Update.  This is for the M5Benchmark, so
+results don't depend on how fast the loading thread happened to be.
+*/
+/******************************************************************************/
+void M5StreamManager::WaitForLoads(void)
+{
+	if (!s_isOpen)
+		return;
+
+	std::unique_lock<std::mutex> lock(s_jobLock);
+	while (s_isBusy || !s_jobs.empty())
+		s_idleSignal.wait(lock);
+}
+/******************************************************************************/
+/*!
+Reads the placements of chunks and frees the placements of unloaded chunks,
+so neither stalls a frame.  The thread owns its own handle to the chunk file.
+*/
+/******************************************************************************/
+void M5StreamManager::LoadThread(void)
+{
+	std::ifstream file(s_fileName, std::ios::in | std::ios::binary);
+	std::vector<M5ChunkRecord> records;
+
+	for (;;)
+	{
+		M5StreamJob job;
+		{
+			std::unique_lock<std::mutex> lock(s_jobLock);
+			s_isBusy = false;
+			if (s_jobs.empty())
+				s_idleSignal.notify_all();
+			while (s_isRunning && s_jobs.empty())
+				s_jobSignal.wait(lock);
+			if (!s_isRunning)
+				return;
+			job = std::move(s_jobs.front());
+			s_jobs.pop_front();
+			s_isBusy = true;
+		}
+
+		/*The placements are freed when the job goes out of scope*/
+		if (job.chunk < 0)
+			continue;
+
+		records.resize(job.count);
+		if (job.count != 0)
+		{
+			file.seekg(job.offset);
+			file.read(reinterpret_cast<char*>(&records[0]), job.count * sizeof(M5ChunkRecord));
+		}
+
+		if (!file)
+		{
+			M5Log::Write(LL_WARNING, LC_STAGE, "M5StreamManager: could not read chunk %d of %s",
+				job.chunk, s_fileName.c_str());
+			file.clear();
+			records.clear();
+		}
+
+		job.placements.reserve(records.size());
+		for (size_t i = 0; i < records.size(); ++i)
+		{
+			int type = records[i].type;
+			if (type < 0 || type >= static_cast<int>(s_types.size()) || s_types[type] == AT_INVALID)
+				continue;
+
+			M5Placement placement;
+			placement.pos.x = records[i].x;
+			placement.pos.y = records[i].y;
+			placement.type = s_types[type];
+			job.placements.push_back(placement);
+		}
+
+		std::lock_guard<std::mutex> lock(s_jobLock);
+		s_done.push_back(std::move(job));
+	}
+}
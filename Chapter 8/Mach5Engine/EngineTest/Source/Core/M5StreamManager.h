@@ -0,0 +1,88 @@
+/******************************************************************************/
+/*!
+\file   M5StreamManager.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Singleton class to stream the objects of a large level in and out in chunks
+as the camera moves.
+
+*/
+/******************************************************************************/
+#ifndef M5_STREAM_MANAGER_H
+#define M5_STREAM_MANAGER_H
+
+#include "M5ArcheTypes.h"
+#include "M5Vec2.h"
+#include <string>
+#include <vector>
+
+//! One object placed in a level
+struct M5Placement
+{
+	M5Vec2       pos;  //!< Where the object starts
+	M5ArcheTypes type; //!< The ArcheType to make
+};
+
+//! What the M5StreamManager is doing
+struct M5StreamStats
+{
+	int   chunkCount;    //!< Chunks in the chunk file
+	int   loadedChunks;  //!< Chunks with their placements in memory, active or not
+	int   activeChunks;  //!< Chunks with objects in the world
+	int   pendingLoads;  //!< Chunks the loading thread is still reading
+	int   activeObjects; //!< Objects made by active chunks, including ones destroyed since
+	int   activated;     //!< Objects made during the last Update
+	float updateTime;    //!< Seconds the last Update took
+};
+
+/*! Singleton class to stream the objects of a large level.  A chunk file
+splits the placed objects of a level into square chunks.  Chunks near the
+camera are read by a loading thread, and their objects are made a few at a
+time, nearest chunks first, so no frame makes more than the activation
+budget.  Chunks that fall behind the camera have their objects destroyed and
+their placements are freed on the loading thread.  Objects are always made
+again from the chunk file, so changes to them are lost once their chunk is
+deactivated.*/
+class M5StreamManager
+{
+public:
+	friend class M5App;
+	friend class M5StageManager;
+	friend class M5Benchmark;
+
+	//Splits the objects of a stage file into a chunk file
+	static bool BuildChunkFile(const std::string& stageFile, const std::string& chunkFile, float chunkSize);
+	//Writes placements to a chunk file, split into chunks of the given size
+	static bool WriteChunkFile(const std::string& chunkFile, const std::vector<M5Placement>& placements, float chunkSize);
+	//Starts streaming the objects of a chunk file around the camera
+	static bool Open(const std::string& chunkFile);
+	//Stops streaming and frees every chunk
+	static void Close(void);
+	//Checks if a chunk file is being streamed
+	static bool IsOpen(void);
+	//Forgets the objects of every chunk so they are made again
+	static void ResetChunks(void);
+	//Sets how much time and how many objects can be made each frame
+	static void SetActivationBudget(float maxTime, int maxCount);
+	//Sets how many chunks past the edge of the screen are active and loaded
+	static void SetMargins(int activeChunks, int loadedChunks);
+	//Gets what the streamer did last frame
+	static void GetStats(M5StreamStats& stats);
+private:
+	static void Update(void);
+	static void Shutdown(void);
+	static void Pause(void);
+	static void Resume(void);
+	static void ReceiveLoads(void);
+	static void RequestLoads(void);
+	static void DeactivateChunks(void);
+	static void ActivateChunks(void);
+	static void WaitForLoads(void);
+	static void LoadThread(void);
+};//end M5StreamManager
+
+
+#endif //M5_STREAM_MANAGER_H
@@ -0,0 +1,408 @@
+/******************************************************************************/
+/*!
+\file   M5Telemetry.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Singleton class to record frame times and engine counts for the whole session,
+so long tests can report percentiles and stalls.
+
+Frames are recorded into histograms for the current interval.  Every interval
+they are added to the session histograms, and if there is an output file a CSV
+row is written and flushed, so a crashed soak test still has its trend data.
+
+*/
+/******************************************************************************/
+#include "M5Telemetry.h"
+#include "M5Histogram.h"
+#include "M5Debug.h"
+#include "M5Log.h"
+#include "M5Memory.h"
+#include "M5ObjectManager.h"
+#include "M5Phy.h"
+#include "M5Gfx.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace
+{
+typedef std::chrono::steady_clock TelemetryClock;
+
+const float DEFAULT_INTERVAL = 10.0f;    //!< Seconds between rows if StartOutput isn't called
+const float STALL_TIME = 0.1f;           //!< Frames whose work takes longer than this are stalls
+const double TO_MICROSECONDS = 1000000.0; //!< Times are recorded in microseconds
+const double TO_MILLISECONDS = 0.001;    //!< Recorded times are written in milliseconds
+
+//! Names of each M5TelemetryPhase for output
+const char* PHASE_NAMES[TP_COUNT] = { "input", "objects", "physics", "stage", "gfx" };
+//! Names of each M5TelemetryCount for output
+const char* COUNT_NAMES[TC_COUNT] = { "objects", "colliders", "drawn", "allocs" };
+
+//! Every histogram recorded each frame
+struct M5FrameHistograms
+{
+	M5Histogram frame;            //!< Frame time given to the game, including the wait for the target fps
+	M5Histogram work;             //!< Time spent in all phases, without the wait
+	M5Histogram phases[TP_COUNT]; //!< Time spent in each phase
+	M5Histogram counts[TC_COUNT]; //!< The counts at the end of each frame
+};
+
+TelemetryClock::time_point s_sessionStart;                 //!< When Init was called
+TelemetryClock::time_point s_intervalStart;                //!< When the current interval started
+TelemetryClock::time_point s_phaseStart;                   //!< When the current phase started
+double                     s_phaseTime[TP_COUNT];          //!< Seconds of each phase this frame
+M5FrameHistograms          s_interval;                     //!< Frames since the last row
+M5FrameHistograms          s_session;                      //!< Frames before the current interval
+float                      s_rowTime = DEFAULT_INTERVAL;   //!< Seconds between rows
+int                        s_frameCount;                   //!< Frames recorded
+int                        s_stallCount;                   //!< Frames whose work was longer than STALL_TIME
+long long                  s_liveBytes;                    //!< Tracked bytes allocated at the end of the last frame
+FILE*                      s_pRowFile;                     //!< CSV output, 0 for none
+std::string                s_summaryFile;                  //!< JSON output, empty for none
+
+/******************************************************************************/
+/*!
+Gets the seconds since a time point.
+
+\param [in] start
+The time to measure from.
+
+\return
+The seconds since start.
+*/
+/******************************************************************************/
+double SecondsSince(const TelemetryClock::time_point& start)
+{
+	std::chrono::duration<double> time = TelemetryClock::now() - start;
+	return time.count();
+}
+/******************************************************************************/
+/*!
+Converts seconds to the microseconds recorded in the time histograms.
+
+\param [in] seconds
+The time to convert.
+
+\return
+The time in whole microseconds.
+*/
+/******************************************************************************/
+unsigned ToMicroseconds(double seconds)
+{
+	double us = seconds * TO_MICROSECONDS + 0.5;
+	if (us <= 0)
+		return 0;
+	if (us >= 4294967295.0)
+		return 4294967295u;
+	return static_cast<unsigned>(us);
+}
+/******************************************************************************/
+/*!
+Adds the interval histograms to the session histograms and clears them.
+*/
+/******************************************************************************/
+void FoldInterval(void)
+{
+	s_session.frame.Add(s_interval.frame);
+	s_session.work.Add(s_interval.work);
+	s_interval.frame.Reset();
+	s_interval.work.Reset();
+	for (int i = 0; i < TP_COUNT; ++i)
+	{
+		s_session.phases[i].Add(s_interval.phases[i]);
+		s_interval.phases[i].Reset();
+	}
+	for (int i = 0; i < TC_COUNT; ++i)
+	{
+		s_session.counts[i].Add(s_interval.counts[i]);
+		s_interval.counts[i].Reset();
+	}
+}
+/******************************************************************************/
+/*!
+Writes one histogram of the summary as a line of JSON.
+
+\param [in] pFile
+The file to write to.
+
+\param [in] name
+The name of the histogram.
+
+\param [in] histogram
+The histogram to write.
+
+\param [in] isTime
+True if the histogram is in microseconds and should be written in milliseconds.
+
+\param [in] isLast
+True if this is the last histogram, so there is no comma.
+*/
+/******************************************************************************/
+void WriteHistogram(FILE* pFile, const char* name, const M5Histogram& histogram, bool isTime, bool isLast)
+{
+	double scale = isTime ? TO_MILLISECONDS : 1.0;
+	std::fprintf(pFile, "    { \"name\": \"%s\", \"unit\": \"%s\", \"count\": %lld, \"min\": %.3f, "
+		"\"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"p99.9\": %.3f, \"max\": %.3f }%s\n",
+		name, isTime ? "ms" : "count", histogram.GetCount(),
+		histogram.GetMin() * scale, histogram.GetMean() * scale,
+		histogram.GetPercentile(50) * scale, histogram.GetPercentile(90) * scale,
+		histogram.GetPercentile(99) * scale, histogram.GetPercentile(99.9) * scale,
+		histogram.GetMax() * scale, isLast ? "" : ",");
+}
+}//end unnamed namespace
+
+/******************************************************************************/
+/*!
+Starts writing the recorded frames to files.  A CSV row with percentiles for
+the last interval is written every interval seconds, and a JSON summary of
+the whole session is written at shutdown.
+
+\param [in] fileName
+The name of the files without an extension.  fileName.csv and fileName.json
+are written.
+
+\param [in] interval
+The seconds between CSV rows.
+*/
+/******************************************************************************/
+void M5Telemetry::StartOutput(const char* fileName, float interval)
+{
+	M5DEBUG_ASSERT(interval > 0, "The telemetry interval must be more than 0");
+	if (s_pRowFile != 0)
+		std::fclose(s_pRowFile);
+
+	std::string name(fileName);
+	s_pRowFile = std::fopen((name + ".csv").c_str(), "w");
+	M5DEBUG_ASSERT(s_pRowFile != 0, "Telemetry file could not be opened");
+	s_summaryFile = name + ".json";
+	s_rowTime = interval;
+	if (s_pRowFile == 0)
+		return;
+
+	std::fprintf(s_pRowFile, "seconds,frames,stalls,frame_p50_ms,frame_p99_ms,frame_p999_ms,frame_max_ms,"
+		"work_p50_ms,work_p99_ms,work_p999_ms,work_max_ms");
+	for (int i = 0; i < TP_COUNT; ++i)
+		std::fprintf(s_pRowFile, ",%s_p99_ms,%s_max_ms", PHASE_NAMES[i], PHASE_NAMES[i]);
+	for (int i = 0; i < TC_COUNT; ++i)
+		std::fprintf(s_pRowFile, ",%s_mean,%s_max", COUNT_NAMES[i], COUNT_NAMES[i]);
+	std::fprintf(s_pRowFile, ",live_kb\n");
+	std::fflush(s_pRowFile);
+}
+/******************************************************************************/
+/*!
+Gets the frame time that percent of the frames in the session are at or below.
+
+\param [in] percent
+The percent of frames, from 0 to 100.  For example 99 for the p99.
+
+\return
+The frame time in seconds.
+*/
+/******************************************************************************/
+float M5Telemetry::GetFramePercentile(float percent)
+{
+	/*Don't fold the interval, so the next CSV row still has all of its frames*/
+	M5Histogram frames(s_session.frame);
+	frames.Add(s_interval.frame);
+	return static_cast<float>(frames.GetPercentile(percent) / TO_MICROSECONDS);
+}
+/******************************************************************************/
+/*!
+Gets the number of frames recorded.
+
+\return
+The number of frames.
+*/
+/******************************************************************************/
+int M5Telemetry::GetFrameCount(void)
+{
+	return s_frameCount;
+}
+/******************************************************************************/
+/*!
+Gets the number of frames whose work, not counting the wait for the target
+frame rate, took longer than the stall time.
+
+\return
+The number of stalls.
+*/
+/******************************************************************************/
+int M5Telemetry::GetStallCount(void)
+{
+	return s_stallCount;
+}
+/******************************************************************************/
+/*!
+Starts the session.  This is called by M5App.
+*/
+/******************************************************************************/
+void M5Telemetry::Init(void)
+{
+	s_sessionStart = TelemetryClock::now();
+	s_intervalStart = s_sessionStart;
+	s_phaseStart = s_sessionStart;
+	s_frameCount = 0;
+	s_stallCount = 0;
+}
+/******************************************************************************/
+/*!
+Logs a summary of the session, writes the last CSV row and the JSON summary,
+and closes the output.  This is called by M5App before the log shuts down.
+*/
+/******************************************************************************/
+void M5Telemetry::Shutdown(void)
+{
+	if (s_pRowFile != 0 && s_interval.frame.GetCount() != 0)
+		WriteRow();
+	FoldInterval();
+
+	M5Log::Write(LL_INFO, LC_APP, "M5Telemetry: %d frames, p50 %.2f ms, p99 %.2f ms, p99.9 %.2f ms, max %.2f ms, %d stalls",
+		s_frameCount, s_session.frame.GetPercentile(50) * TO_MILLISECONDS,
+		s_session.frame.GetPercentile(99) * TO_MILLISECONDS, s_session.frame.GetPercentile(99.9) * TO_MILLISECONDS,
+		s_session.frame.GetMax() * TO_MILLISECONDS, s_stallCount);
+
+	if (!s_summaryFile.empty())
+		WriteSummary();
+
+	if (s_pRowFile != 0)
+		std::fclose(s_pRowFile);
+	s_pRowFile = 0;
+	s_summaryFile.clear();
+}
+/******************************************************************************/
+/*!
+Marks the start of a frame.  This is called by the M5StageManager.
+*/
+/******************************************************************************/
+void M5Telemetry::StartFrame(void)
+{
+	s_phaseStart = TelemetryClock::now();
+}
+/******************************************************************************/
+/*!
+Marks the end of a phase.  The phase started when the last phase ended, or at
+the start of the frame.  This is called by the M5StageManager.
+
+\param [in] phase
+The phase that just ended.
+*/
+/******************************************************************************/
+void M5Telemetry::EndPhase(M5TelemetryPhase phase)
+{
+	TelemetryClock::time_point now = TelemetryClock::now();
+	std::chrono::duration<double> time = now - s_phaseStart;
+	s_phaseTime[phase] = time.count();
+	s_phaseStart = now;
+}
+/******************************************************************************/
+/*!
+Records the frame into the histograms.  If the frame was a stall it is logged
+with its slowest phase.  Every interval a CSV row is written if there is an
+output file.  This is called by the M5StageManager after every phase has
+ended.
+
+\param [in] frameTime
+The frame time from the M5Timer, which includes the wait for the target fps.
+*/
+/******************************************************************************/
+void M5Telemetry::EndFrame(float frameTime)
+{
+	double work = 0;
+	int slowest = 0;
+	for (int i = 0; i < TP_COUNT; ++i)
+	{
+		work += s_phaseTime[i];
+		s_interval.phases[i].Record(ToMicroseconds(s_phaseTime[i]));
+		if (s_phaseTime[i] > s_phaseTime[slowest])
+			slowest = i;
+	}
+	s_interval.frame.Record(ToMicroseconds(frameTime));
+	s_interval.work.Record(ToMicroseconds(work));
+
+	M5GfxStats gfxStats;
+	M5Gfx::GetStats(gfxStats);
+	int allocs = 0;
+	s_liveBytes = 0;
+	for (int i = 0; i < MT_COUNT; ++i)
+	{
+		M5MemoryStats memoryStats;
+		M5Memory::GetStats(static_cast<M5MemoryTag>(i), memoryStats);
+		allocs += memoryStats.frameAllocs;
+		s_liveBytes += memoryStats.liveBytes;
+	}
+	s_interval.counts[TC_OBJECTS].Record(static_cast<unsigned>(M5ObjectManager::GetObjectCount()));
+	s_interval.counts[TC_COLLIDERS].Record(static_cast<unsigned>(M5Phy::GetColliderCount()));
+	s_interval.counts[TC_DRAWN].Record(static_cast<unsigned>(gfxStats.drawn));
+	s_interval.counts[TC_ALLOCS].Record(static_cast<unsigned>(allocs));
+
+	++s_frameCount;
+	if (work > STALL_TIME)
+	{
+		++s_stallCount;
+		M5Log::Write(LL_WARNING, LC_APP, "M5Telemetry: frame %d took %.1f ms, %.1f ms in %s",
+			s_frameCount, work * 1000.0, s_phaseTime[slowest] * 1000.0, PHASE_NAMES[slowest]);
+	}
+
+	if (SecondsSince(s_intervalStart) >= s_rowTime)
+	{
+		if (s_pRowFile != 0)
+			WriteRow();
+		FoldInterval();
+		s_intervalStart = TelemetryClock::now();
+	}
+}
+/******************************************************************************/
+/*!
+Writes a CSV row for the frames in the current interval and flushes it.
+*/
+/******************************************************************************/
+void M5Telemetry::WriteRow(void)
+{
+	const M5Histogram& frame = s_interval.frame;
+	const M5Histogram& work = s_interval.work;
+	std::fprintf(s_pRowFile, "%.1f,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f",
+		SecondsSince(s_sessionStart), s_frameCount, s_stallCount,
+		frame.GetPercentile(50) * TO_MILLISECONDS, frame.GetPercentile(99) * TO_MILLISECONDS,
+		frame.GetPercentile(99.9) * TO_MILLISECONDS, frame.GetMax() * TO_MILLISECONDS,
+		work.GetPercentile(50) * TO_MILLISECONDS, work.GetPercentile(99) * TO_MILLISECONDS,
+		work.GetPercentile(99.9) * TO_MILLISECONDS, work.GetMax() * TO_MILLISECONDS);
+	for (int i = 0; i < TP_COUNT; ++i)
+	{
+		std::fprintf(s_pRowFile, ",%.3f,%.3f", s_interval.phases[i].GetPercentile(99) * TO_MILLISECONDS,
+			s_interval.phases[i].GetMax() * TO_MILLISECONDS);
+	}
+	for (int i = 0; i < TC_COUNT; ++i)
+		std::fprintf(s_pRowFile, ",%.1f,%u", s_interval.counts[i].GetMean(), s_interval.counts[i].GetMax());
+	std::fprintf(s_pRowFile, ",%lld\n", s_liveBytes / 1024);
+	std::fflush(s_pRowFile);
+}
+/******************************************************************************/
+/*!
+Writes the session histograms as JSON, one histogram per line.
+*/
+/******************************************************************************/
+void M5Telemetry::WriteSummary(void)
+{
+	FILE* pFile = std::fopen(s_summaryFile.c_str(), "w");
+	M5DEBUG_ASSERT(pFile != 0, "Telemetry summary file could not be opened");
+	if (pFile == 0)
+		return;
+
+	std::fprintf(pFile, "{\n  \"seconds\": %.1f,\n  \"frames\": %d,\n  \"stalls\": %d,\n  \"histograms\": [\n",
+		SecondsSince(s_sessionStart), s_frameCount, s_stallCount);
+	WriteHistogram(pFile, "frame", s_session.frame, true, false);
+	WriteHistogram(pFile, "work", s_session.work, true, false);
+	for (int i = 0; i < TP_COUNT; ++i)
+		WriteHistogram(pFile, PHASE_NAMES[i], s_session.phases[i], true, false);
+	for (int i = 0; i < TC_COUNT; ++i)
+	{
+		std::string name = std::string(COUNT_NAMES[i]) + " count";
+		WriteHistogram(pFile, name.c_str(), s_session.counts[i], false, i + 1 == TC_COUNT);
+	}
+	std::fprintf(pFile, "  ]\n}\n");
+	std::fclose(pFile);
+}
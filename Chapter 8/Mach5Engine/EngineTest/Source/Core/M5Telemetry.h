@@ -0,0 +1,68 @@
+/******************************************************************************/
+/*!
+\file   M5Telemetry.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+Singleton class to record frame times and engine counts for the whole session,
+so long tests can report percentiles and stalls.
+
+*/
+/******************************************************************************/
+#ifndef M5_TELEMETRY_H
+#define M5_TELEMETRY_H
+
+//! The parts of a frame that are timed
+enum M5TelemetryPhase
+{
+	TP_INPUT,   //!< Input, window messages and replays
+	TP_OBJECTS, //!< M5ObjectManager::Update
+	TP_PHYSICS, //!< M5Phy::Update
+	TP_STAGE,   //!< The current stage's Update
+	TP_GFX,     //!< M5Gfx::Update
+	TP_COUNT    //!< The number of phases, not a real phase
+};
+
+//! The values recorded once per frame
+enum M5TelemetryCount
+{
+	TC_OBJECTS,   //!< Objects being updated
+	TC_COLLIDERS, //!< Colliders being tested
+	TC_DRAWN,     //!< GfxComponents drawn
+	TC_ALLOCS,    //!< Tracked allocations made during the frame
+	TC_COUNT      //!< The number of counts, not a real count
+};
+
+/*! Singleton class that records every frame into histograms.  It is always
+on, since recording a frame is only a few clock reads and bucket increments.
+Use StartOutput to also write a CSV row every few seconds and a JSON summary
+at shutdown.  It only uses the standard library, so it works the same in a
+-headless run.*/
+class M5Telemetry
+{
+public:
+	friend class M5App;
+	friend class M5StageManager;
+
+	//Writes a CSV row every interval seconds, and a JSON summary at shutdown
+	static void StartOutput(const char* fileName, float interval);
+	//Gets the frame time in seconds that percent of frames are at or below
+	static float GetFramePercentile(float percent);
+	//Gets the number of frames recorded
+	static int GetFrameCount(void);
+	//Gets the number of frames whose work took longer than the stall time
+	static int GetStallCount(void);
+private:
+	static void Init(void);
+	static void Shutdown(void);
+	static void StartFrame(void);
+	static void EndPhase(M5TelemetryPhase phase);
+	static void EndFrame(float frameTime);
+	static void WriteRow(void);
+	static void WriteSummary(void);
+};
+
+
+#endif //M5_TELEMETRY_H
@@ -0,0 +1,417 @@
+/******************************************************************************/
+/*!
+\file   M5TextBatch.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/27
+
+Class to lay out text as textured quads so a whole frame of text can be drawn
+at once.
+
+The font is stored here so text doesn't depend on the fonts of the OS.  Each
+glyph is 8x16 pixels with 16 levels of alpha.  Laying out a string is cached,
+since debug and HUD text is usually the same from frame to frame.
+
+*/
+/******************************************************************************/
+#include "M5TextBatch.h"
+#include "M5Debug.h"
+
+namespace
+{
+const int  FIRST_CHARACTER = 32;  //!< The space is the first glyph
+const int  GLYPH_COUNT = 95;      //!< Every printable ASCII character
+const char MISSING = '?';         //!< Drawn for characters not in the font
+const int  ATLAS_COLUMNS = 16;    //!< Glyphs in each row of the atlas
+const int  CELL_WIDTH = M5TextBatch::GLYPH_WIDTH + 2;   //!< Glyph plus a clear border so filtering doesn't bleed
+const int  CELL_HEIGHT = M5TextBatch::GLYPH_HEIGHT + 2; //!< Glyph plus a clear border so filtering doesn't bleed
+const int  MAX_AGE = 60;          //!< Frames a layout is kept without being used
+const int  MAX_LAYOUTS = 2048;    //!< Forget old layouts early if there are more than this
+
+static_assert(ATLAS_COLUMNS * CELL_WIDTH <= M5TextBatch::ATLAS_WIDTH, "Glyphs don't fit in the atlas");
+static_assert((GLYPH_COUNT + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS * CELL_HEIGHT <= M5TextBatch::ATLAS_HEIGHT,
+	"Glyphs don't fit in the atlas");
+
+/*! The alpha of each glyph as one hex digit per pixel, starting with the top
+row.  The glyphs were rasterized from DejaVu Sans Mono.*/
+const char* GLYPHS[GLYPH_COUNT] =
+{
+	"00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000", //space
+	"000000000000000000099000000cc000000cc000000cc000000cc00000089000000880000000000000099000000cc00000000000000000000000000000000000", //!
+	"00000000000000000093390000c44c0000c44c0000c44c0000000000000000000000000000000000000000000000000000000000000000000000000000000000", //double quote
+	"000000000000000000063080000e34d0002f08903cdfcfec14c94f4400e34d00ccfcefc349c4d7410a70f1000e34d00000000000000000000000000000000000", //#
+	"000000000000000000048000004ac72005f9a9600c8480000ab5800001bfea200004abf0000480f4072485f107dffd3000048000000480000000000000000000", //$
+	"0000000000000000024000005ead1000c2094000a71c30121bc73aa3016b84004a50cce30004a04b0004b04b00009fe300000000000000000000000000000000", //%
+	"0000000000000000008cc80006e4450008c0000002f2000006fd00003f1c904c8902f54b99005fc65f300cf008fdfad900041000000000000000000000000000", //&
+	"00000000000000000006600000088000000880000008800000000000000000000000000000000000000000000000000000000000000000000000000000000000", //quote
+	"00000000000000000000a6000002f000000a9000000f5000002f2000004f0000004f0000001f3000000d60000007b0000001f200000067000000000000000000", //(
+	"0000000000000000007a0000000f20000009a0000005f0000002f2000000f4000000f4000003f1000006d000000b8000002f1000007600000000000000000000", //)
+	"0000000000000000000330000824428002abba20006ee60009744790000440000001100000000000000000000000000000000000000000000000000000000000", //*
+	"000000000000000000000000000000000004400000088000000880006cceecc6488cc88400088000000880000002200000000000000000000000000000000000", //+
+	"00000000000000000000000000000000000000000000000000000000000000000000000000000000000cf000000ce000001f5000003a00000000000000000000", //,
+	"000000000000000000000000000000000000000000000000000000000034430000cffc0000000000000000000000000000000000000000000000000000000000", //-
+	"00000000000000000000000000000000000000000000000000000000000000000000000000000000000cc000000cc00000000000000000000000000000000000", //.
+	"0000000000000000000005a000000c7000004f100000c8000003f100000aa000002f200000aa000001f2000008c000001f400000140000000000000000000000", ///
+	"0000000000000000008cc70006f55f600d9009d00f4004f02f4884f23f4bb4f30f4004f00e7007e008d11d8001cffc1000033000000000000000000000000000", //0
+	"0000000000000000027ac00008cbf0000004f0000004f0000004f0000004f0000004f0000004f0000004f00004fffff000000000000000000000000000000000", //1
+	"000000000000000006ccc6000e746f70000009c000000ab000002f500001da00000da00000ac00000ad100000fffffc000000000000000000000000000000000", //2
+	"000000000000000006ccc60007646f80000009c000000ca0006ceb1000259e50000007e0000005f005001dc00efffc3000142000000000000000000000000000", //3
+	"000000000000000000008c000003ff00000d7f0000894f0002e14f000c604f004e447f413cccdfc300004f0000004f0000000000000000000000000000000000", //4
+	"000000000000000009cccc300cc888200c8000000ca751000cccfe2001001db0000008f0000008f005002ea00ffffb1000341000000000000000000000000000", //5
+	"0000000000000000004bcc4004f846500b8000000f4572001fadbf603fa007f00f4004f20f5004f10ac00ae001cfee3000023000000000000000000000000000", //6
+	"00000000000000000cccccc008888dc000000e6000005f100000aa000001f4000007e000000e8000004f200000ab000000000000000000000000000000000000", //7
+	"000000000000000001acca100ad44da00f8008f00c9009c003cccc3006f88f600f5005f03f4004f30f9009f004feef4000033000000000000000000000000000", //8
+	"000000000000000001acc7000cd45f601f4008d04f2004f01f5009f00ad56df0018ca5f0000007d002103f6007fff90000141000000000000000000000000000", //9
+	"0000000000000000000000000000000000000000000cc000000cc000000000000000000000000000000cc000000cc00000000000000000000000000000000000", //:
+	"0000000000000000000000000000000000000000000cc000000cc000000000000000000000000000000cf000000ce000001f5000003a00000000000000000000", //;
+	"000000000000000000000000000000000000001300004af7017ee8206fa400004cf930000029fd71000005b80000000000000000000000000000000000000000", //<
+	"0000000000000000000000000000000000000000000000008ffffff800000000488888846cccccc6000000000000000000000000000000000000000000000000", //=
+	"00000000000000000000000000000000310000007fa40000028ee71000004af600039fc417df92008b5000000000000000000000000000000000000000000000", //>
+	"0000000000000000029cc91008945f80000008c000003f700001fa00000ab000000c80000006400000096000000c800000000000000000000000000000000000", //?
+	"000000000000000000000000008eff800aa101d44e004469a60adcdcc43e008cc44c004cc43e108c970aecdc2e10330008d20000005dfea00000000000000000", //@
+	"0000000000000000000bb000002ff200007bb70000d77d0001f22f1006e00e600be88eb00fa88af05f0001f5ac0000ca00000000000000000000000000000000", //A
+	"00000000000000000cccb7000fc88dc00f8005f00f8007f00feccf500fa48da00f8001f40f8000f50f8017f20ffffd5000000000000000000000000000000000", //B
+	"0000000000000000002acc8002fa45b00ac000000f7000000f4000000f4000000f6000000da0000005f40060006fffe000004200000000000000000000000000", //C
+	"00000000000000000ccb71000fa8cf300f400bb00f4005f00f4004f30f4004f40f4004f10f4009e00f427f500fffd50000000000000000000000000000000000", //D
+	"000000000000000009ccccc00cc888800c8000000c8000000ceccc900cc888600c8000000c8000000c8000000cfffff400000000000000000000000000000000", //E
+	"000000000000000006ccccc308e8888208c0000008c0000008fccc9008d4443008c0000008c0000008c0000008c0000000000000000000000000000000000000", //F
+	"0000000000000000004bcc5005f846a00e8000003f3000004f0000004f008ff44f2000f40f6000f409e201f4009fffb100014100000000000000000000000000", //G
+	"00000000000000000c3003c00f4004f00f4004f00f4004f00fdccdf00fa88af00f4004f00f4004f00f4004f00f4004f000000000000000000000000000000000", //H
+	"000000000000000009cccc90068ee860000cc000000cc000000cc000000cc000000cc000000cc000000cc0000cffffc000000000000000000000000000000000", //I
+	"0000000000000000006ccc3000488f4000000f4000000f4000000f4000000f4000000f4000003f4036007f003efff60000240000000000000000000000000000", //J
+	"00000000000000000c3001b60f401da00f41dc000f4ad1000fdf50000fdae1000f41e9000f404f400f4009e10f4001f900000000000000000000000000000000", //K
+	"00000000000000000690000008c0000008c0000008c0000008c0000008c0000008c0000008c0000008c0000008fffff800000000000000000000000000000000", //L
+	"00000000000000006c5005c68fb00bf88ce11ec88c9679c88c3bd3c88c0ee0c88c0550c88c0000c88c0000c88c0000c800000000000000000000000000000000", //M
+	"00000000000000000c8003c00ff104f00fe704f00f8e04f00f4d54f00f46b4f00f41f6f00f40acf00f403ff00f400cf000000000000000000000000000000000", //N
+	"0000000000000000008cc80008f55f800f7007f02f4004f24f4004f44f4004f44f4004f40f5005f00bc00ca001dffd1000033000000000000000000000000000", //O
+	"000000000000000009ccc8100cc88de10c8001f50c8000f70c8008f20cffff600c8000000c8000000c8000000c80000000000000000000000000000000000000", //P
+	"0000000000000000008cc80008f55f800f7007f02f4004f24f4004f44f4004f44f4004f40f5005f00ac00ca001dffd1000037f30000006400000000000000000", //Q
+	"00000000000000000ccca5000fa89f800f4009e00f4008f00f745f800ffff9000f403f400f400ac00f4002f40f4000ac00000000000000000000000000000000", //R
+	"0000000000000000018ccb400cd547600f4000000f70000009fc82000049df70000007f0000004f0081009f00dfffe3000043000000000000000000000000000", //S
+	"00000000000000009cccccc9688ee886000cc000000cc000000cc000000cc000000cc000000cc000000cc000000cc00000000000000000000000000000000000", //T
+	"00000000000000000c3003c00f4004f00f4004f00f4004f00f4004f00f4004f00f4004f00f4004f00da00ad003effe3000033000000000000000000000000000", //U
+	"0000000000000000690000965f1001f50f5005f00b9009b006d00d6002f22f2000d66d00009aa900003ee300000ff00000000000000000000000000000000000", //V
+	"0000000000000000c300003cd700007db800008b8b0dc0b86c0ff0c64f4cc4e41f7887f10fc44cf00cf00fc00ad00da000000000000000000000000000000000", //W
+	"00000000000000003c2000b60cb007e102f41f40008dab00000ef100001ff30000bb8c0005f21f601e8006f19d0000d900000000000000000000000000000000", //X
+	"00000000000000007a0000a72f4004f208e00e8001e66e00005ff500000dd000000cc000000cc000000cc000000cc00000000000000000000000000000000000", //Y
+	"000000000000000009ccccc606888af500000cb000007f100002f500000cb000005f100001f500000bb000000ffffff800000000000000000000000000000000", //Z
+	"0000000000000000000fd900000f4000000f4000000f4000000f4000000f4000000f4000000f4000000f4000000f4000000f7300000cc9000000000000000000", //[
+	"00000000000000002c1000000c80000005e0000000e60000006e0000000e60000007c0000001f40000008c0000001f3000000aa0000001400000000000000000", //backslash
+	"0000000000000000009df0000004f0000004f0000004f0000004f0000004f0000004f0000004f0000004f0000004f0000037f000009cc0000000000000000000", //]
+	"000000000000000000099000009dd90006d11d603f2002f300000000000000000000000000000000000000000000000000000000000000000000000000000000", //^
+	"00000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000008888888844444444", //_
+	"0000000001b30000003e100000067000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000", //`
+	"000000000000000000000000000000000048720008d9af50010008c000688ac00cd747c02f1007c01f401ec008fcf7c000140000000000000000000000000000", //a
+	"00000000000000000c8000000c8000000c8483000cec9f600cd006f00c8001f30c8000f40c9002f20ce108e00ccedf3000014000000000000000000000000000", //b
+	"000000000000000000000000000000000003862000ae9af006f100200ba000000c8000000ab0000004f40050006fdee000004200000000000000000000000000", //c
+	"0000000000000000000008c0000008c0003848c006f9cfc00f600cc03f2008c04f0008c02f3008c00d801ec003fdedc000041000000000000000000000000000", //d
+	"000000000000000000000000000000000016830003fb9f600e8004f02f6444f44fccccc31f2000000ca0006001cfcfd000024100000000000000000000000000", //e
+	"00000000000000000005fff0000c9000034da44009cfecc0000c8000000c8000000c8000000c8000000c8000000c800000000000000000000000000000000000", //f
+	"000000000000000000000000000000000038423006facec00f600cc03f1008c04f0008c01f3009c00cb02fc002cfebc0000008b005515e5004ccc50000000000", //g
+	"00000000000000000c8000000c8000000c8384000cdcaf600cc009c00c8008c00c8008c00c8008c00c8008c00c8008c000000000000000000000000000000000", //h
+	"00000000000000000008c000000460000144300003cec0000008c0000008c0000008c0000008c0000008c0000cfffff000000000000000000000000000000000", //i
+	"00000000000000000000f000000080000144400003ccf0000000f0000000f0000000f0000000f0000000f0000000f0000002f000034ae00009cb300000000000", //j
+	"000000000000000008c0000008c0000008c0014108c01da008c1d80008dda00008f8f40008c07f1008c00cb008c001f700000000000000000000000000000000", //k
+	"00000000044410000ccf4000000f4000000f4000000f4000000f4000000f4000000f4000000f4000000e70000004efc000000000000000000000000000000000", //l
+	"00000000000000000000000000000000135617404f9fd9f24d09a0c44c0880c44c0880c44c0880c44c0880c44c0880c400000000000000000000000000000000", //m
+	"00000000000000000000000000000000032384000cdcaf600cc009c00c8008c00c8008c00c8008c00c8008c00c8008c000000000000000000000000000000000", //n
+	"000000000000000000000000000000000027720005faaf400d8008d00f4004f00f4004f00f4004f00bb00bb003eeee3000033000000000000000000000000000", //o
+	"00000000000000000000000000000000032483000cfc9f600cc006e00c8002f20c8000f40c8003f10ce108d00cdedf300c8140000c8000000960000000000000", //p
+	"000000000000000000000000000000000027413004faccc00d800cc00f4007c00f4004c00f4008c00cb01dc003eeeac0000424c0000004c00000039000000000", //q
+	"000000000000000000000000000000000032276100caecc800cf300100ca000000c8000000c8000000c8000000c8000000000000000000000000000000000000", //r
+	"000000000000000000000000000000000027840004fa8d4008b0000007f63000007cfe3000001bb003100ba007fded2000042000000000000000000000000000", //s
+	"000000000000000000140000004f0000147f44303cdfcc90004f0000004f0000004f0000004f0000002f30000009ffc000000000000000000000000000000000", //t
+	"00000000000000000000000000000000032002300c8008c00c8008c00c8008c00c8008c00c8008c00ac01dc003feebc000040000000000000000000000000000", //u
+	"00000000000000000000000000000000140000411f2002f10b8008b006e00e6001f33f1000a99a00005ee500000ff00000000000000000000000000000000000", //v
+	"0000000000000000000000000000000041000014d500005d990220996c0bb0c62f0dd0f20e8998e00af55fa007f00f7000000000000000000000000000000000", //w
+	"00000000000000000000000000000000141001410ba00ab001e66e10003ff300001ee10000abba0006f11f603f4004f300000000000000000000000000000000", //x
+	"00000000000000000000000000000000140000321f3001f30aa007d004f10d6000e63f10007c9a00001ff400000ae000000c8000037f200009c5000000000000", //y
+	"000000000000000000000000000000000244443006cccfc000003f300001e600000ca000009d000006f100000cffffc000000000000000000000000000000000", //z
+	"00000000000000000002ee600008d0000008c0000008c000000aa000049e4000049f3000000aa0000008c0000008c0000008c0000002fd600000032000000000", //{
+	"00000000000220000008800000088000000880000008800000088000000880000008800000088000000880000008800000088000000880000008800000022000", //|
+	"000000000000000006ee2000000d8000000c8000000c8000000a90000004e9400003f940000aa000000c8000000c8000000c800006df20000230000000000000", //}
+	"000000000000000000000000000000000000000000000000000000003efe94875403aca100000000000000000000000000000000000000000000000000000000"  //~
+};
+
+/******************************************************************************/
+/*!
+Helper function to turn a hex digit into an alpha value.
+
+\param [in] digit
+A hex digit from 0 to f.
+
+\return
+The alpha from 0 to 255.
+*/
+/******************************************************************************/
+unsigned char HexToAlpha(char digit)
+{
+	int value = (digit >= 'a') ? digit - 'a' + 10 : digit - '0';
+	return static_cast<unsigned char>(value * 17);
+}
+/******************************************************************************/
+/*!
+Helper function to get the atlas cell of a glyph.
+
+\param [in] glyph
+The index of the glyph.
+
+\param [out] x
+The left pixel of the glyph in the atlas.
+
+\param [out] y
+The bottom pixel of the glyph in the atlas.
+*/
+/******************************************************************************/
+void GetGlyphCorner(int glyph, int& x, int& y)
+{
+	x = (glyph % ATLAS_COLUMNS) * CELL_WIDTH + 1;
+	y = (glyph / ATLAS_COLUMNS) * CELL_HEIGHT + 1;
+}
+/******************************************************************************/
+/*!
+Helper function to add one corner of a quad.
+
+\param [in, out] verts
+The list to add to.
+
+\param [in] x
+The x position.
+
+\param [in] y
+The y position.
+
+\param [in] u
+The u texture coord.
+
+\param [in] v
+The v texture coord.
+*/
+/******************************************************************************/
+void AddVertex(M5TextVertices& verts, float x, float y, float u, float v)
+{
+	M5TextVertex vert;
+	vert.x = x;
+	vert.y = y;
+	vert.u = u;
+	vert.v = v;
+	vert.color[0] = vert.color[1] = vert.color[2] = vert.color[3] = 255;
+	verts.push_back(vert);
+}
+}//end unnamed namespace
+
+
+/******************************************************************************/
+/*!
+Constructor for M5TextBatch.
+*/
+/******************************************************************************/
+M5TextBatch::M5TextBatch(void) :
+	m_frame(0)
+{
+}
+/******************************************************************************/
+/*!
+Makes the glyph atlas.  The glyphs are white, so the color of the text comes
+from the vertices.
+
+\param [out] pixels
+The atlas as ATLAS_WIDTH by ATLAS_HEIGHT RGBA pixels, starting with the bottom
+row the way OpenGL expects.
+*/
+/******************************************************************************/
+void M5TextBatch::GetAtlas(std::vector<unsigned char>& pixels) const
+{
+	pixels.assign(ATLAS_WIDTH * ATLAS_HEIGHT * 4, 0);
+	for (int glyph = 0; glyph < GLYPH_COUNT; ++glyph)
+	{
+		int cornerX, cornerY;
+		GetGlyphCorner(glyph, cornerX, cornerY);
+		const char* pAlpha = GLYPHS[glyph];
+
+		for (int row = 0; row < GLYPH_HEIGHT; ++row)
+		{
+			/*The glyph data starts at the top, the atlas starts at the bottom*/
+			int y = cornerY + GLYPH_HEIGHT - 1 - row;
+			for (int col = 0; col < GLYPH_WIDTH; ++col)
+			{
+				unsigned char* pPixel = &pixels[(y * ATLAS_WIDTH + cornerX + col) * 4];
+				pPixel[0] = pPixel[1] = pPixel[2] = 255;
+				pPixel[3] = HexToAlpha(*pAlpha++);
+			}
+		}
+	}
+}
+/******************************************************************************/
+/*!
+Adds the quads for some text to this frame's batch.  A new line moves down one
+glyph height.
+
+\param [in] text
+The text to write.
+
+\param [in] x
+The left of the first character.
+
+\param [in] y
+The bottom of the first line.
+
+\param [in] scale
+The size of a glyph pixel.
+
+\param [in] color
+The color of the text as ABGR, where the most significant byte is alpha.
+*/
+/******************************************************************************/
+void M5TextBatch::Write(const char* text, float x, float y, float scale, unsigned color)
+{
+	M5DEBUG_ASSERT(text != 0, "Text is NULL");
+
+	const M5TextVertices& layout = GetLayout(text);
+	unsigned char red   = static_cast<unsigned char>(color);
+	unsigned char green = static_cast<unsigned char>(color >> 8);
+	unsigned char blue  = static_cast<unsigned char>(color >> 16);
+	unsigned char alpha = static_cast<unsigned char>(color >> 24);
+
+	size_t start = m_batch.size();
+	m_batch.insert(m_batch.end(), layout.begin(), layout.end());
+
+	size_t size = m_batch.size();
+	for (size_t i = start; i < size; ++i)
+	{
+		M5TextVertex& vert = m_batch[i];
+		vert.x = vert.x * scale + x;
+		vert.y = vert.y * scale + y;
+		vert.color[0] = red;
+		vert.color[1] = green;
+		vert.color[2] = blue;
+		vert.color[3] = alpha;
+	}
+}
+/******************************************************************************/
+/*!
+Gets the vertices of all text written since the last EndFrame.
+
+\return
+Triangles to draw with the glyph atlas.
+*/
+/******************************************************************************/
+const M5TextVertices& M5TextBatch::GetVertices(void) const
+{
+	return m_batch;
+}
+/******************************************************************************/
+/*!
+Gets the number of text layouts that are saved.
+
+\return
+The size of the layout cache.
+*/
+/******************************************************************************/
+int M5TextBatch::GetCacheSize(void) const
+{
+	return static_cast<int>(m_cache.size());
+}
+/******************************************************************************/
+/*!
+Clears the batch so the next frame can be written.  Layouts that haven't been
+used for a while are forgotten.
+*/
+/******************************************************************************/
+void M5TextBatch::EndFrame(void)
+{
+	m_batch.clear();
+	++m_frame;
+
+	if (m_frame % MAX_AGE != 0 && m_cache.size() <= MAX_LAYOUTS)
+		return;
+
+	LayoutCache::iterator itor = m_cache.begin();
+	while (itor != m_cache.end())
+	{
+		if (m_frame - itor->second.frame > MAX_AGE || m_cache.size() > MAX_LAYOUTS)
+			itor = m_cache.erase(itor);
+		else
+			++itor;
+	}
+}
+/******************************************************************************/
+/*!
+Gets the saved layout of some text, making it if needed.
+
+\param [in] text
+The text to get the layout of.
+
+\return
+Quads at scale 1 with the bottom of the first line at 0.
+*/
+/******************************************************************************/
+const M5TextVertices& M5TextBatch::GetLayout(const char* text)
+{
+	m_key = text;
+	LayoutCache::iterator found = m_cache.find(m_key);
+	if (found == m_cache.end())
+	{
+		found = m_cache.insert(std::make_pair(m_key, M5TextLayout())).first;
+		MakeLayout(text, found->second.verts);
+	}
+
+	found->second.frame = m_frame;
+	return found->second.verts;
+}
+/******************************************************************************/
+/*!
+Makes two triangles for each character.  Spaces only move the next character.
+
+\param [in] text
+The text to lay out.
+
+\param [out] verts
+The triangles at scale 1 with the bottom of the first line at 0.
+*/
+/******************************************************************************/
+void M5TextBatch::MakeLayout(const char* text, M5TextVertices& verts) const
+{
+	const float U_SCALE = 1.0f / ATLAS_WIDTH;
+	const float V_SCALE = 1.0f / ATLAS_HEIGHT;
+
+	float left = 0;
+	float bottom = 0;
+	verts.clear();
+
+	for (; *text; ++text)
+	{
+		int character = static_cast<unsigned char>(*text);
+		if (character == '\n')
+		{
+			left = 0;
+			bottom -= GLYPH_HEIGHT;
+			continue;
+		}
+
+		if (character < FIRST_CHARACTER || character >= FIRST_CHARACTER + GLYPH_COUNT)
+			character = MISSING;
+
+		if (character != ' ')
+		{
+			int cornerX, cornerY;
+			GetGlyphCorner(character - FIRST_CHARACTER, cornerX, cornerY);
+			float right = left + GLYPH_WIDTH;
+			float top = bottom + GLYPH_HEIGHT;
+			float u0 = cornerX * U_SCALE;
+			float v0 = cornerY * V_SCALE;
+			float u1 = (cornerX + GLYPH_WIDTH) * U_SCALE;
+			float v1 = (cornerY + GLYPH_HEIGHT) * V_SCALE;
+
+			AddVertex(verts, right, top, u1, v1);
+			AddVertex(verts, left, top, u0, v1);
+			AddVertex(verts, left, bottom, u0, v0);
+			AddVertex(verts, left, bottom, u0, v0);
+			AddVertex(verts, right, bottom, u1, v0);
+			AddVertex(verts, right, top, u1, v1);
+		}
+
+		left += GLYPH_WIDTH;
+	}
+}
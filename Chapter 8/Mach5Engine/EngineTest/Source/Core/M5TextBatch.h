@@ -0,0 +1,78 @@
+/******************************************************************************/
+/*!
+\file   M5TextBatch.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/27
+
+Class to lay out text as textured quads so a whole frame of text can be drawn
+at once.
+
+*/
+/******************************************************************************/
+#ifndef M5_TEXT_BATCH_H
+#define M5_TEXT_BATCH_H
+
+#include "M5Memory.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//! One corner of a text quad
+struct M5TextVertex
+{
+	float         x;        //!< The x position
+	float         y;        //!< The y position
+	float         u;        //!< The u texture coord in the glyph atlas
+	float         v;        //!< The v texture coord in the glyph atlas
+	unsigned char color[4]; //!< Red, green, blue and alpha
+};
+
+//! Typedef for a list of text vertices
+typedef std::vector<M5TextVertex, M5Allocator<M5TextVertex, MT_GFX> > M5TextVertices;
+
+//! Lays out text as textured quads so a whole frame of text can be drawn at once.
+class M5TextBatch
+{
+public:
+	static const int GLYPH_WIDTH = 8;      //!< Width of every glyph in pixels
+	static const int GLYPH_HEIGHT = 16;    //!< Height of every glyph, including the part below the baseline
+	static const int ATLAS_WIDTH = 256;    //!< Width of the glyph atlas in pixels
+	static const int ATLAS_HEIGHT = 128;   //!< Height of the glyph atlas in pixels
+	static const int VERTS_PER_GLYPH = 6;  //!< Two triangles for each glyph
+
+	M5TextBatch(void);
+	//Makes the glyph atlas as RGBA pixels, starting with the bottom row
+	void GetAtlas(std::vector<unsigned char>& pixels) const;
+	//Adds the quads for some text to this frame's batch
+	void Write(const char* text, float x, float y, float scale, unsigned color);
+	//Gets the vertices of all text written this frame
+	const M5TextVertices& GetVertices(void) const;
+	//Gets the number of text layouts that are saved
+	int GetCacheSize(void) const;
+	//Clears the batch and forgets layouts that haven't been used in a while
+	void EndFrame(void);
+private:
+	//! A saved layout and the last frame it was used
+	struct M5TextLayout
+	{
+		M5TextVertices verts; //!< Quads at scale 1 with the first line at 0,0
+		int            frame; //!< The last frame this was used
+	};
+
+	//! Typedef for saved layouts by their text
+	typedef std::unordered_map<std::string, M5TextLayout> LayoutCache;
+
+	const M5TextVertices& GetLayout(const char* text);
+	void  MakeLayout(const char* text, M5TextVertices& verts) const;
+
+	M5TextVertices m_batch; //!< Every vertex written this frame
+	LayoutCache    m_cache; //!< Layouts of recently written text
+	std::string    m_key;   //!< Reused so looking up a layout doesn't allocate
+	int            m_frame; //!< Counts calls to EndFrame
+};
+
+
+#endif //M5_TEXT_BATCH_H
@@ -0,0 +1,414 @@
+/******************************************************************************/
+/*!
+\file   M5Vec2Batch.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/28
+
+Functions that do the same M5Vec2 math on many vectors at once.
+
+When SSE2 is available four vectors are done at a time, and a plain loop does
+whatever is left over.  Only operations that SSE does with the same rounding as
+normal float math are used, so the results match the M5Vec2 functions.
+
+*/
+/******************************************************************************/
+#include "M5Vec2Batch.h"
+#include "M5Vec2.h"
+#include "M5Math.h"
+#include "M5Debug.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+/*! Defined if the SSE2 version of each function is compiled*/
+#define M5_VEC2_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+#ifdef M5_VEC2_BATCH_SSE2
+/******************************************************************************/
+/*!
+Helper function to pick between two sets of four floats.
+
+\param [in] mask
+All bits set where the second value should be used.
+
+\param [in] first
+The values to use where the mask is clear.
+
+\param [in] second
+The values to use where the mask is set.
+
+\return
+The picked values.
+*/
+/******************************************************************************/
+__m128 Select(__m128 mask, __m128 first, __m128 second)
+{
+  return _mm_or_ps(_mm_and_ps(mask, second), _mm_andnot_ps(mask, first));
+}
+#endif
+}//end unnamed namespace
+
+/******************************************************************************/
+/*!
+Makes room for size vectors.  The memory is only allocated when the buffer
+grows.
+
+\param size
+The number of vectors.
+
+\return
+A span of the vectors.  It is only valid until the next Resize.
+*/
+/******************************************************************************/
+M5Vec2Span M5Vec2Buffer::Resize(size_t size)
+{
+  x.resize(size);
+  y.resize(size);
+
+  M5Vec2Span span;
+  span.x = size ? &x[0] : 0;
+  span.y = size ? &y[0] : 0;
+  span.size = size;
+  return span;
+}
+
+namespace M5Vec2Batch
+{
+/******************************************************************************/
+/*!
+Adds two spans of vectors.
+
+\param result
+The span to store the results.
+
+\param vec1
+The first vectors to add.
+
+\param vec2
+The second vectors to add.
+*/
+/******************************************************************************/
+void Add(const M5Vec2Span& result, const M5Vec2Span& vec1, const M5Vec2Span& vec2)
+{
+  M5DEBUG_ASSERT(result.size == vec1.size && result.size == vec2.size, "Spans are different sizes");
+  size_t i = 0;
+#ifdef M5_VEC2_BATCH_SSE2
+  for (; i + 4 <= result.size; i += 4)
+  {
+    _mm_storeu_ps(result.x + i, _mm_add_ps(_mm_loadu_ps(vec1.x + i), _mm_loadu_ps(vec2.x + i)));
+    _mm_storeu_ps(result.y + i, _mm_add_ps(_mm_loadu_ps(vec1.y + i), _mm_loadu_ps(vec2.y + i)));
+  }
+#endif
+  for (; i < result.size; ++i)
+  {
+    result.x[i] = vec1.x[i] + vec2.x[i];
+    result.y[i] = vec1.y[i] + vec2.y[i];
+  }
+}
+/******************************************************************************/
+/*!
+Scales a span of vectors.
+
+\param result
+The span to store the results.
+
+\param toScale
+The vectors to scale.
+
+\param scale
+The amount to scale by.
+*/
+/******************************************************************************/
+void Scale(const M5Vec2Span& result, const M5Vec2Span& toScale, float scale)
+{
+  M5DEBUG_ASSERT(result.size == toScale.size, "Spans are different sizes");
+  size_t i = 0;
+#ifdef M5_VEC2_BATCH_SSE2
+  __m128 scale4 = _mm_set1_ps(scale);
+  for (; i + 4 <= result.size; i += 4)
+  {
+    _mm_storeu_ps(result.x + i, _mm_mul_ps(_mm_loadu_ps(toScale.x + i), scale4));
+    _mm_storeu_ps(result.y + i, _mm_mul_ps(_mm_loadu_ps(toScale.y + i), scale4));
+  }
+#endif
+  for (; i < result.size; ++i)
+  {
+    result.x[i] = toScale.x[i] * scale;
+    result.y[i] = toScale.y[i] * scale;
+  }
+}
+/******************************************************************************/
+/*!
+Adds a scaled span of vectors to another span.  This is the same as a Scale
+followed by an Add, but only goes through the data once.
+
+\param result
+The span to store the results.
+
+\param vec1
+The vectors to add to.
+
+\param vec2
+The vectors to scale and add.
+
+\param scale
+The amount to scale vec2 by.
+*/
+/******************************************************************************/
+void AddScaled(const M5Vec2Span& result, const M5Vec2Span& vec1, const M5Vec2Span& vec2, float scale)
+{
+  M5DEBUG_ASSERT(result.size == vec1.size && result.size == vec2.size, "Spans are different sizes");
+  size_t i = 0;
+#ifdef M5_VEC2_BATCH_SSE2
+  __m128 scale4 = _mm_set1_ps(scale);
+  for (; i + 4 <= result.size; i += 4)
+  {
+    __m128 x = _mm_mul_ps(_mm_loadu_ps(vec2.x + i), scale4);
+    __m128 y = _mm_mul_ps(_mm_loadu_ps(vec2.y + i), scale4);
+    _mm_storeu_ps(result.x + i, _mm_add_ps(_mm_loadu_ps(vec1.x + i), x));
+    _mm_storeu_ps(result.y + i, _mm_add_ps(_mm_loadu_ps(vec1.y + i), y));
+  }
+#endif
+  for (; i < result.size; ++i)
+  {
+    result.x[i] = vec1.x[i] + vec2.x[i] * scale;
+    result.y[i] = vec1.y[i] + vec2.y[i] * scale;
+  }
+}
+/******************************************************************************/
+/*!
+Normalizes a span of vectors.
+
+\attention
+Like M5Vec2::Normalize, none of the vectors can be the zero vector.
+
+\param result
+The span to store the results.
+
+\param toNormalize
+The vectors to normalize.
+*/
+/******************************************************************************/
+void Normalize(const M5Vec2Span& result, const M5Vec2Span& toNormalize)
+{
+  M5DEBUG_ASSERT(result.size == toNormalize.size, "Spans are different sizes");
+  size_t i = 0;
+#ifdef M5_VEC2_BATCH_SSE2
+  for (; i + 4 <= result.size; i += 4)
+  {
+    __m128 x = _mm_loadu_ps(toNormalize.x + i);
+    __m128 y = _mm_loadu_ps(toNormalize.y + i);
+    __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+    _mm_storeu_ps(result.x + i, _mm_div_ps(x, length));
+    _mm_storeu_ps(result.y + i, _mm_div_ps(y, length));
+  }
+#endif
+  for (; i < result.size; ++i)
+  {
+    float x = toNormalize.x[i];
+    float y = toNormalize.y[i];
+    float length = std::sqrt(x * x + y * y);
+    M5DEBUG_ASSERT(!M5Math::IsFloatEqual(length, 0.f), "Normalizing the zero vector");
+    result.x[i] = x / length;
+    result.y[i] = y / length;
+  }
+}
+/******************************************************************************/
+/*!
+Gets the length of each vector in a span.
+
+\param result
+An array of vec.size floats to store the lengths.
+
+\param vec
+The vectors to get the length of.
+*/
+/******************************************************************************/
+void Length(float* result, const M5Vec2Span& vec)
+{
+  size_t i = 0;
+#ifdef M5_VEC2_BATCH_SSE2
+  for (; i + 4 <= vec.size; i += 4)
+  {
+    __m128 x = _mm_loadu_ps(vec.x + i);
+    __m128 y = _mm_loadu_ps(vec.y + i);
+    _mm_storeu_ps(result + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+  }
+#endif
+  for (; i < vec.size; ++i)
+    result[i] = std::sqrt(vec.x[i] * vec.x[i] + vec.y[i] * vec.y[i]);
+}
+/******************************************************************************/
+/*!
+Treats each vector as a point and gets its distance to another point.
+
+\param result
+An array of vec.size floats to store the distances.
+
+\param vec
+The points to get the distance from.
+
+\param point
+The point to get the distance to.
+*/
+/******************************************************************************/
+void Distance(float* result, const M5Vec2Span& vec, const M5Vec2& point)
+{
+  size_t i = 0;
+#ifdef M5_VEC2_BATCH_SSE2
+  __m128 pointX = _mm_set1_ps(point.x);
+  __m128 pointY = _mm_set1_ps(point.y);
+  for (; i + 4 <= vec.size; i += 4)
+  {
+    __m128 x = _mm_sub_ps(_mm_loadu_ps(vec.x + i), pointX);
+    __m128 y = _mm_sub_ps(_mm_loadu_ps(vec.y + i), pointY);
+    _mm_storeu_ps(result + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+  }
+#endif
+  for (; i < vec.size; ++i)
+  {
+    float x = vec.x[i] - point.x;
+    float y = vec.y[i] - point.y;
+    result[i] = std::sqrt(x * x + y * y);
+  }
+}
+/******************************************************************************/
+/*!
+Clamps each vector inside a box, the same as calling M5Math::Clamp on x and y.
+
+\param result
+The span to store the results.
+
+\param toClamp
+The vectors to clamp.
+
+\param low
+The bottom left of the box.
+
+\param high
+The top right of the box.
+*/
+/******************************************************************************/
+void Clamp(const M5Vec2Span& result, const M5Vec2Span& toClamp, const M5Vec2& low, const M5Vec2& high)
+{
+  M5DEBUG_ASSERT(result.size == toClamp.size, "Spans are different sizes");
+  size_t i = 0;
+#ifdef M5_VEC2_BATCH_SSE2
+  __m128 lowX = _mm_set1_ps(low.x);
+  __m128 lowY = _mm_set1_ps(low.y);
+  __m128 highX = _mm_set1_ps(high.x);
+  __m128 highY = _mm_set1_ps(high.y);
+  for (; i + 4 <= result.size; i += 4)
+  {
+    __m128 x = _mm_loadu_ps(toClamp.x + i);
+    __m128 y = _mm_loadu_ps(toClamp.y + i);
+    x = Select(_mm_cmplt_ps(x, lowX), Select(_mm_cmpgt_ps(x, highX), x, highX), lowX);
+    y = Select(_mm_cmplt_ps(y, lowY), Select(_mm_cmpgt_ps(y, highY), y, highY), lowY);
+    _mm_storeu_ps(result.x + i, x);
+    _mm_storeu_ps(result.y + i, y);
+  }
+#endif
+  for (; i < result.size; ++i)
+  {
+    result.x[i] = M5Math::Clamp(toClamp.x[i], low.x, high.x);
+    result.y[i] = M5Math::Clamp(toClamp.y[i], low.y, high.y);
+  }
+}
+/******************************************************************************/
+/*!
+Wraps each vector that leaves a box to the other side, the same as calling
+M5Math::Wrap on x and y.
+
+\param result
+The span to store the results.
+
+\param toWrap
+The vectors to wrap.
+
+\param low
+The bottom left of the box.
+
+\param high
+The top right of the box.
+*/
+/******************************************************************************/
+void Wrap(const M5Vec2Span& result, const M5Vec2Span& toWrap, const M5Vec2& low, const M5Vec2& high)
+{
+  M5DEBUG_ASSERT(result.size == toWrap.size, "Spans are different sizes");
+  size_t i = 0;
+#ifdef M5_VEC2_BATCH_SSE2
+  __m128 lowX = _mm_set1_ps(low.x);
+  __m128 lowY = _mm_set1_ps(low.y);
+  __m128 highX = _mm_set1_ps(high.x);
+  __m128 highY = _mm_set1_ps(high.y);
+  for (; i + 4 <= result.size; i += 4)
+  {
+    __m128 x = _mm_loadu_ps(toWrap.x + i);
+    __m128 y = _mm_loadu_ps(toWrap.y + i);
+    x = Select(_mm_cmplt_ps(x, lowX), Select(_mm_cmpgt_ps(x, highX), x, lowX), highX);
+    y = Select(_mm_cmplt_ps(y, lowY), Select(_mm_cmpgt_ps(y, highY), y, lowY), highY);
+    _mm_storeu_ps(result.x + i, x);
+    _mm_storeu_ps(result.y + i, y);
+  }
+#endif
+  for (; i < result.size; ++i)
+  {
+    result.x[i] = M5Math::Wrap(toWrap.x[i], low.x, high.x);
+    result.y[i] = M5Math::Wrap(toWrap.y[i], low.y, high.y);
+  }
+}
+/******************************************************************************/
+/*!
+Gets a velocity from each position towards a target, the way
+ChasePlayerComponent does.
+
+\attention
+None of the positions can be at the target.
+
+\param result
+The span to store the velocities.
+
+\param pos
+The positions to move from.
+
+\param target
+The position to move towards.
+
+\param speed
+An array of pos.size speeds, one for each velocity.
+*/
+/******************************************************************************/
+void Seek(const M5Vec2Span& result, const M5Vec2Span& pos, const M5Vec2& target, const float* speed)
+{
+  M5DEBUG_ASSERT(result.size == pos.size, "Spans are different sizes");
+  size_t i = 0;
+#ifdef M5_VEC2_BATCH_SSE2
+  __m128 targetX = _mm_set1_ps(target.x);
+  __m128 targetY = _mm_set1_ps(target.y);
+  for (; i + 4 <= result.size; i += 4)
+  {
+    __m128 x = _mm_sub_ps(targetX, _mm_loadu_ps(pos.x + i));
+    __m128 y = _mm_sub_ps(targetY, _mm_loadu_ps(pos.y + i));
+    __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+    __m128 speed4 = _mm_loadu_ps(speed + i);
+    _mm_storeu_ps(result.x + i, _mm_mul_ps(_mm_div_ps(x, length), speed4));
+    _mm_storeu_ps(result.y + i, _mm_mul_ps(_mm_div_ps(y, length), speed4));
+  }
+#endif
+  for (; i < result.size; ++i)
+  {
+    float x = target.x - pos.x[i];
+    float y = target.y - pos.y[i];
+    float length = std::sqrt(x * x + y * y);
+    M5DEBUG_ASSERT(!M5Math::IsFloatEqual(length, 0.f), "Seeking from the target");
+    result.x[i] = (x / length) * speed[i];
+    result.y[i] = (y / length) * speed[i];
+  }
+}
+}//end namespace M5Vec2Batch
@@ -0,0 +1,68 @@
+/******************************************************************************/
+/*!
+\file   M5Vec2Batch.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/28
+
+Functions that do the same M5Vec2 math on many vectors at once.
+
+*/
+/******************************************************************************/
+#ifndef M5_VEC2_BATCH_H
+#define M5_VEC2_BATCH_H
+
+#include <cstddef>
+#include <vector>
+
+//Forward declarations
+struct M5Vec2;
+
+/*! Many 2D vectors stored as separate arrays of x and y, so each function can
+work on four vectors at a time.  The span does not own the arrays.*/
+struct M5Vec2Span
+{
+  float* x;    //!< The x coordinates
+  float* y;    //!< The y coordinates
+  size_t size; //!< The number of vectors
+};
+
+/*! Arrays to back an M5Vec2Span.  Keep one around between frames so the memory
+is reused.*/
+struct M5Vec2Buffer
+{
+  //Makes room for size vectors and returns a span of them
+  M5Vec2Span Resize(size_t size);
+
+  std::vector<float> x; //!< The x coordinates
+  std::vector<float> y; //!< The y coordinates
+};
+
+/*! Functions that work on every vector in a span.  The result can be the same
+span as an input.  The results match the M5Vec2 and M5Math functions with the
+same names.*/
+namespace M5Vec2Batch
+{
+/*result = vec1 + vec2*/
+void Add(const M5Vec2Span& result, const M5Vec2Span& vec1, const M5Vec2Span& vec2);
+/*result = toScale * scale*/
+void Scale(const M5Vec2Span& result, const M5Vec2Span& toScale, float scale);
+/*result = vec1 + vec2 * scale, for moving positions by velocities*/
+void AddScaled(const M5Vec2Span& result, const M5Vec2Span& vec1, const M5Vec2Span& vec2, float scale);
+/*result = toNormalize / length*/
+void Normalize(const M5Vec2Span& result, const M5Vec2Span& toNormalize);
+/*Gets the length of each vector*/
+void Length(float* result, const M5Vec2Span& vec);
+/*Gets the distance from each vector to a point*/
+void Distance(float* result, const M5Vec2Span& vec, const M5Vec2& point);
+/*Clamps each vector inside a box*/
+void Clamp(const M5Vec2Span& result, const M5Vec2Span& toClamp, const M5Vec2& low, const M5Vec2& high);
+/*Wraps each vector that leaves a box to the other side*/
+void Wrap(const M5Vec2Span& result, const M5Vec2Span& toWrap, const M5Vec2& low, const M5Vec2& high);
+/*Gets a velocity from each position towards a target*/
+void Seek(const M5Vec2Span& result, const M5Vec2Span& pos, const M5Vec2& target, const float* speed);
+}//end namespace M5Vec2Batch
+
+
+#endif //M5_VEC2_BATCH_H
@@ -64,7 +64,7 @@ Virtual constructor for this component
 /******************************************************************************/
 OutsideViewKillComponent* OutsideViewKillComponent::Clone(void) const
 {
-	OutsideViewKillComponent* pNew = new OutsideViewKillComponent;
+	OutsideViewKillComponent* pNew = new (CT_OutsideViewKillComponent) OutsideViewKillComponent;
 	pNew->m_pObj = m_pObj;
 	return pNew;
 }
\ No newline at end of file
@@ -16,6 +16,7 @@ TODO: Remove Object from rotated viewport
 #define OUTSIDE_VIEWPORT_KILL_COMPONENT_H
 
 #include "M5Component.h"
+#include "M5ComponentBuilder.h"
 
 //!< Removes The parent Game Object if it is outside the view port
 class OutsideViewKillComponent : public M5Component
@@ -29,5 +30,12 @@ private:
 
 };
 
+//! Objects leaving the screen can live a little longer without being seen
+template <>
+struct M5UpdateRate<OutsideViewKillComponent>
+{
+	static constexpr float value = 10.0f; //!< Check the view ten times a second
+};
+
 #endif // !OUTSIDE_VIEWPORT_KILL_COMPONENT_H
 
@@ -11,9 +11,11 @@ Repositions the object every frame so it stays reletive to the window
 /******************************************************************************/
 #include "RepositionComponent.h"
 #include "M5App.h"
+#include "M5Gfx.h"
 #include "M5Math.h"
 #include "M5Object.h"
 #include "M5IniFile.h"
+#include "M5Snapshot.h"
 
 /******************************************************************************/
 /*!
@@ -41,8 +43,12 @@ works if the viewport isn't rotated.
 void RepositionComponent::Update(float /*dt*/)
 {
 	M5Vec2 windowSize = M5App::GetResolution();
-	m_pObj->pos.x = windowSize.x * m_xScale;
-	m_pObj->pos.y = windowSize.y * m_yScale;
+	M5Vec2 pos(windowSize.x * m_xScale, windowSize.y * m_yScale);
+	if (pos.x != m_pObj->pos.x || pos.y != m_pObj->pos.y)
+	{
+		m_pObj->pos = pos;
+		M5Gfx::MarkMoved(m_pObj);
+	}
 }
 /******************************************************************************/
 /*!
@@ -51,7 +57,7 @@ Virtual constructor for this component
 /******************************************************************************/
 RepositionComponent* RepositionComponent::Clone(void) const
 {
-	RepositionComponent* pNew = new RepositionComponent;
+	RepositionComponent* pNew = new (CT_RepositionComponent) RepositionComponent;
 	pNew->m_pObj = m_pObj;
 	pNew->m_xScale = m_xScale;
 	pNew->m_yScale = m_yScale;
@@ -62,4 +68,30 @@ void RepositionComponent::FromFile(M5IniFile& iniFile)
 	iniFile.SetToSection("RepositionComponent");
 	iniFile.GetValue("xScale", m_xScale);
 	iniFile.GetValue("yScale", m_yScale);
-}
\ No newline at end of file
+}
+/******************************************************************************/
+/*!
+Saves the data of this component into a snapshot.
+
+\param [in] snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+void RepositionComponent::Save(M5Snapshot& snapshot) const
+{
+	snapshot.Write(m_xScale);
+	snapshot.Write(m_yScale);
+}
+/******************************************************************************/
+/*!
+Restores the data of this component from a snapshot.
+
+\param [in] snapshot
+The snapshot to read from.
+*/
+/******************************************************************************/
+void RepositionComponent::Load(M5Snapshot& snapshot)
+{
+	snapshot.Read(m_xScale);
+	snapshot.Read(m_yScale);
+}
@@ -27,6 +27,8 @@ public:
 	virtual void Update(float dt);
 	virtual RepositionComponent* Clone(void) const;
 	virtual void FromFile(M5IniFile&);
+	virtual void Save(M5Snapshot& snapshot) const;
+	virtual void Load(M5Snapshot& snapshot);
 private:
 	float m_xScale;
 	float m_yScale;
@@ -61,6 +61,19 @@ void UIButtonComponent::Update(float)
 }
 /******************************************************************************/
 /*!
+Checks once a frame if buttons need to update.  They only do anything on a
+click, so they aren't updated on other frames.
+
+\return
+True if the left mouse button was clicked this frame.
+*/
+/******************************************************************************/
+bool UIButtonComponent::HasEvent(void)
+{
+	return M5Input::IsTriggered(M5_MOUSE_LEFT);
+}
+/******************************************************************************/
+/*!
 Reads the command for the button from an inifile
 
 \param iniFile
@@ -82,7 +95,7 @@ virtual contructor for the UIButtonComponent
 /******************************************************************************/
 UIButtonComponent* UIButtonComponent::Clone(void) const
 {
-	UIButtonComponent* pClone = new UIButtonComponent();
+	UIButtonComponent* pClone = new (CT_UIButtonComponent) UIButtonComponent();
 	pClone->m_pObj = m_pObj;
 	if(m_pOnClick != nullptr)
 	  pClone->m_pOnClick = m_pOnClick->Clone();
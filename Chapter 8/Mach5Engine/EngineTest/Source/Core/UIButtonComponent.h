@@ -13,6 +13,7 @@ Component to test if a HUD button is clicked
 #define BUTTON_COMPONENT_H
 
 #include "M5Component.h"
+#include "M5ComponentBuilder.h"
 #include "M5Vec2.h"
 
 //forward declare
@@ -29,9 +30,17 @@ public:
 	virtual void     FromFile(M5IniFile&);
 	virtual UIButtonComponent* Clone(void) const;
 	void SetOnClick(M5Command* pCommand);
+	static bool HasEvent(void);
 private:
 	M5Command* m_pOnClick;
 };
 
+//! Buttons only need to check the mouse on frames it was clicked
+template <>
+struct M5UpdateRate<UIButtonComponent>
+{
+	static constexpr float value = UPDATE_ON_EVENT; //!< UIButtonComponent::HasEvent is checked once a frame
+};
+
 
 #endif //UIBUTTON_COMPONENT_H
\ No newline at end of file
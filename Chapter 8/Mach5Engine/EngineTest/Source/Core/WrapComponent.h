@@ -13,6 +13,8 @@ Component to wrap an object in the screen
 #define WRAP_COMPONENT_H
 
 #include "M5Component.h"
+#include "M5ComponentBuilder.h"
+#include <vector>
 
 //!< Component to wrap an object in the screen
 class WrapComponent : public M5Component
@@ -21,10 +23,18 @@ public:
 	WrapComponent(void);
 	~WrapComponent(void);
 	virtual void Update(float dt);
+	static void UpdateBatch(std::vector<M5Component*>& comps, size_t start, float dt);
 	virtual WrapComponent* Clone(void) const;
 private:
 
 };
 
+//! Wraps every object at once with the M5Vec2Batch functions
+template <>
+struct M5HasBatchUpdate<WrapComponent>
+{
+	static const bool value = true; //!< WrapComponent::UpdateBatch is used
+};
+
 #endif // !WRAP_COMPONENT_H
 
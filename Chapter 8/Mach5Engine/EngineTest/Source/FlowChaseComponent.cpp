@@ -0,0 +1,167 @@
+/******************************************************************************/
+/*!
+\file   FlowChaseComponent.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+AI to chase the Player around obstacles using the shared M5Nav flow field
+*/
+/******************************************************************************/
+#include "FlowChaseComponent.h"
+
+#include "Core/M5ObjectManager.h"
+#include "Core/M5IniFile.h"
+#include "Core/M5Object.h"
+#include "Core/M5Snapshot.h"
+#include "Core/M5Vec2Batch.h"
+#include "Core/M5Nav.h"
+#include "Core/M5Math.h"
+#include <vector>
+
+namespace
+{
+std::vector<M5Object*> s_players; //!< Reused so the players can be found without allocating
+std::vector<M5Vec2>    s_goals;   //!< Reused so the goals can be set without allocating
+M5Vec2Buffer           s_pos;     //!< Reused so UpdateBatch doesn't allocate each frame
+M5Vec2Buffer           s_dir;     //!< Reused so UpdateBatch doesn't allocate each frame
+int                    s_goalFrame = -1; //!< The M5ObjectManager frame the goals were last set on
+
+/******************************************************************************/
+/*!
+Makes every player a goal of the flow field.  Finding the players means
+looking at every object, so this is only done by the first chaser each frame.
+The field is only rebuilt if a player has moved to a different cell.
+*/
+/******************************************************************************/
+void SetPlayerGoals(void)
+{
+	int frame = M5ObjectManager::GetFrameCount();
+	if (frame == s_goalFrame)
+		return;
+	s_goalFrame = frame;
+
+	s_players.clear();
+	M5ObjectManager::GetAllObjectsByType(AT_Player, s_players);
+	s_goals.resize(s_players.size());
+	for (size_t i = 0; i < s_players.size(); ++i)
+		s_goals[i] = s_players[i]->pos;
+
+	if (!s_goals.empty())
+		M5Nav::SetGoals(&s_goals[0], s_goals.size());
+}
+}
+
+/******************************************************************************/
+/*!
+Sets component type and starting values for the chaser
+*/
+/******************************************************************************/
+FlowChaseComponent::FlowChaseComponent(void):
+	M5Component(CT_FlowChaseComponent),
+	m_speed(1)
+{
+
+}
+/******************************************************************************/
+/*!
+Moves this object along the flow field towards the nearest player.
+*/
+/******************************************************************************/
+void FlowChaseComponent::Update(float)
+{
+	SetPlayerGoals();
+	M5Vec2 dir;
+	M5Nav::GetDirection(dir, m_pObj->pos);
+	if (dir.x != 0 || dir.y != 0)
+		m_pObj->rotation = M5Math::Atan2(dir.y, dir.x);
+	m_pObj->vel = dir * m_speed;
+}
+/******************************************************************************/
+/*!
+Moves every chaser along the flow field at once.  The goals are only set one
+time, and the field is only checked for a rebuild one time.
+
+\param [in] comps
+The list of components, all of them from start on must be
+FlowChaseComponents.
+
+\param [in] start
+The index of the first FlowChaseComponent.
+*/
+/******************************************************************************/
+void FlowChaseComponent::UpdateBatch(std::vector<M5Component*>& comps, size_t start, float)
+{
+	SetPlayerGoals();
+
+	size_t size = comps.size() - start;
+	M5Vec2Span pos = s_pos.Resize(size);
+	M5Vec2Span dir = s_dir.Resize(size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		M5Object* pObj = static_cast<FlowChaseComponent*>(comps[start + i])->m_pObj;
+		pos.x[i] = pObj->pos.x;
+		pos.y[i] = pObj->pos.y;
+	}
+
+	M5Nav::GetDirections(dir, pos);
+
+	for (size_t i = 0; i < size; ++i)
+	{
+		FlowChaseComponent* pChase = static_cast<FlowChaseComponent*>(comps[start + i]);
+		M5Object* pObj = pChase->m_pObj;
+		if (dir.x[i] != 0 || dir.y[i] != 0)
+			pObj->rotation = M5Math::Atan2(dir.y[i], dir.x[i]);
+		pObj->vel.x = dir.x[i] * pChase->m_speed;
+		pObj->vel.y = dir.y[i] * pChase->m_speed;
+	}
+}
+/******************************************************************************/
+/*!
+Makes a copy of this component
+*/
+/******************************************************************************/
+FlowChaseComponent* FlowChaseComponent::Clone(void) const
+{
+	FlowChaseComponent* pNew = new (CT_FlowChaseComponent) FlowChaseComponent;
+	pNew->m_speed = m_speed;
+	return pNew;
+}
+/******************************************************************************/
+/*!
+Reads the speed of the chaser.
+
+\param [in] iniFile
+The ini file to read from.
+*/
+/******************************************************************************/
+void FlowChaseComponent::FromFile(M5IniFile& iniFile)
+{
+	iniFile.SetToSection("FlowChaseComponent");
+	iniFile.GetValue("speed", m_speed);
+}
+/******************************************************************************/
+/*!
+Saves the data of this component into a snapshot.
+
+\param [in] snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+void FlowChaseComponent::Save(M5Snapshot& snapshot) const
+{
+	snapshot.Write(m_speed);
+}
+/******************************************************************************/
+/*!
+Restores the data of this component from a snapshot.
+
+\param [in] snapshot
+The snapshot to read from.
+*/
+/******************************************************************************/
+void FlowChaseComponent::Load(M5Snapshot& snapshot)
+{
+	snapshot.Read(m_speed);
+}
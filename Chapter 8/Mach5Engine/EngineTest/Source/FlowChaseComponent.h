@@ -0,0 +1,49 @@
+/******************************************************************************/
+/*!
+\file   FlowChaseComponent.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/09/30
+
+AI to chase the Player around obstacles using the shared M5Nav flow field
+*/
+/******************************************************************************/
+#ifndef FLOW_CHASE_COMPONENT_H
+#define FLOW_CHASE_COMPONENT_H
+
+#include "Core/M5Component.h"
+#include "Core/M5ComponentBuilder.h"
+#include <vector>
+
+//!< AI to chase the Player around obstacles using the shared M5Nav flow field
+class FlowChaseComponent : public M5Component
+{
+public:
+	FlowChaseComponent(void);
+	virtual void Update(float dt);
+	static void UpdateBatch(std::vector<M5Component*>& comps, size_t start, float dt);
+	virtual void FromFile(M5IniFile& iniFile);
+	virtual FlowChaseComponent* Clone(void) const;
+	virtual void Save(M5Snapshot& snapshot) const;
+	virtual void Load(M5Snapshot& snapshot);
+private:
+	float m_speed;
+
+};
+
+//! Every chaser samples the flow field at once
+template <>
+struct M5HasBatchUpdate<FlowChaseComponent>
+{
+	static const bool value = true; //!< FlowChaseComponent::UpdateBatch is used
+};
+
+//! The flow field changes slowly, so chasers don't need to steer every frame
+template <>
+struct M5UpdateRate<FlowChaseComponent>
+{
+	static constexpr float value = 10.0f; //!< Steer ten times a second
+};
+
+#endif //FLOW_CHASE_COMPONENT_H
@@ -11,17 +11,19 @@ good place to load game data and initialize object you need for your game.
 */
 /******************************************************************************/
 #include "GamePlayStage.h"
-#include "Core\M5GameData.h"
-#include "Core\M5Input.h"
-#include "Core\M5StageManager.h"
-#include "Core\M5Object.h"
-#include "Core\M5ObjectManager.h"
-#include "Core\M5IniFile.h"
-#include "Core\M5Phy.h"
+#include "Core/M5GameData.h"
+#include "Core/M5Input.h"
+#include "Core/M5StageManager.h"
+#include "Core/M5Object.h"
+#include "Core/M5ObjectManager.h"
+#include "Core/M5IniFile.h"
+#include "Core/M5Phy.h"
+#include "Core/M5Gfx.h"
+#include "Core/M5StreamManager.h"
 #include "ShrinkComponent.h"
 #include "SpaceShooterHelp.h"
 
-#include "Core\M5Random.h"
+#include "Core/M5Random.h"
 
 #include <sstream>
 #include <iomanip>
@@ -29,6 +31,18 @@ good place to load game data and initialize object you need for your game.
 float maxTime = 1;
 float timer = 0;
 
+namespace
+{
+//Builds the stage file name for a level
+std::string LevelFile(int level)
+{
+	std::stringstream file;
+	file << "Stages/Level";
+	file << std::setw(2) << std::setfill('0') << level << ".ini";
+	return file.str();
+}
+}
+
 GamePlayStage::GamePlayStage(void)
 {
 }
@@ -37,17 +51,17 @@ GamePlayStage::~GamePlayStage(void)
 }
 void GamePlayStage::Init(void)
 {
-	//Construct file to read
-	std::stringstream file;
-	file << "Stages\\Level";
-	file << std::setw(2) << std::setfill('0') << 
-		M5StageManager::GetGameData().level << ".ini";
+	M5GameData& gameData = M5StageManager::GetGameData();
 
 	//Open IniFIle
 	M5IniFile iniFile;
-	iniFile.ReadFile(file.str());
+	M5StageManager::LoadStageFile(LevelFile(gameData.level), iniFile);
 	LoadObjects(iniFile);
-	
+	M5ObjectManager::Snapshot(m_levelStart);
+
+	//Start reading the next level while this one is played
+	if (gameData.level < gameData.maxLevels)
+		M5StageManager::PrefetchStage(LevelFile(gameData.level + 1));
 
 	timer = 0;
 
@@ -66,7 +80,7 @@ void GamePlayStage::Update(float dt)
 		M5StageManager::Quit();
 	else if (M5Input::IsTriggered(M5_Z))//Dynamically Shrink
 	{
-		pPlayer->AddComponent(new ShrinkComponent);
+		pPlayer->AddComponent(new (CT_ShrinkComponent) ShrinkComponent);
 	}
 	else if (M5Input::IsTriggered(M5_N))
 	{
@@ -75,7 +89,12 @@ void GamePlayStage::Update(float dt)
 	}
 	else if (M5Input::IsTriggered(M5_R))
 	{
-		M5StageManager::Restart();
+		//Put the level back without running Init again
+		M5ObjectManager::Restore(m_levelStart);
+		//Streamed objects were made after the snapshot, so make them again
+		M5StreamManager::ResetChunks();
+		timer = 0;
+		return;
 	}
 
 	timer += dt;
@@ -110,6 +129,8 @@ void GamePlayStage::Update(float dt)
 			M5Vec2::Sub(dir, pSecond->pos, pFirst->pos);
 			pFirst->pos  -= dir * dt;
 			pSecond->pos  += dir *  dt;
+			M5Gfx::MarkMoved(pFirst);
+			M5Gfx::MarkMoved(pSecond);
 		}
 		else
 		{
@@ -121,5 +142,6 @@ void GamePlayStage::Update(float dt)
 }
 void GamePlayStage::Shutdown(void)
 {
+	M5StreamManager::Close();
 	M5ObjectManager::DestroyAllObjects();
 }
@@ -12,7 +12,8 @@ This is the stage for game play in AstroShot
 #ifndef GAMEPLAY_STAGE_H
 #define GAMEPLAY_STAGE_H
 
-#include "Core\M5Stage.h"
+#include "Core/M5Stage.h"
+#include "Core/M5Snapshot.h"
 
 class GamePlayStage : public M5Stage
 {
@@ -23,6 +24,7 @@ public:
 	virtual void Update(float dt);
 	virtual void Shutdown(void);
 private:
+	M5Snapshot m_levelStart; //!< The level right after Init, used to restart
 };
 
 
@@ -11,8 +11,10 @@ Grows the object to a give size the removes it self.
 */
 /******************************************************************************/
 #include "GrowToSizeComponent.h"
-#include "Core\M5Object.h"
-#include "Core\M5IniFile.h"
+#include "Core/M5Object.h"
+#include "Core/M5Gfx.h"
+#include "Core/M5IniFile.h"
+#include "Core/M5Snapshot.h"
 
 GrowToSizeComponent::GrowToSizeComponent(void):
 	M5Component(CT_GrowToSizeComponent),
@@ -31,6 +33,9 @@ void GrowToSizeComponent::Update(float dt)
 	if (lessThanY)
 		m_pObj->scale.y += m_rate.y * dt;
 
+	if (lessThanX || lessThanY)
+		M5Gfx::MarkMoved(m_pObj);
+
 	if (!lessThanX && !lessThanY)
 		isDead = true;
 }
@@ -45,11 +50,21 @@ void GrowToSizeComponent::FromFile(M5IniFile& iniFile)
 }
 GrowToSizeComponent* GrowToSizeComponent::Clone(void) const
 {
-	GrowToSizeComponent* pClone = new GrowToSizeComponent();
+	GrowToSizeComponent* pClone = new (CT_GrowToSizeComponent) GrowToSizeComponent();
 	pClone->m_rate = m_rate;
 	pClone->m_maxSize = m_maxSize;
 	pClone->m_pObj = m_pObj;
 
 	return pClone;
 
-}
\ No newline at end of file
+}
+void GrowToSizeComponent::Save(M5Snapshot& snapshot) const
+{
+	snapshot.Write(m_rate);
+	snapshot.Write(m_maxSize);
+}
+void GrowToSizeComponent::Load(M5Snapshot& snapshot)
+{
+	snapshot.Read(m_rate);
+	snapshot.Read(m_maxSize);
+}
@@ -13,8 +13,8 @@ Grows the object to a give size the removes it self.
 #ifndef GROW_TO_SIZE_COMPONENT_H
 #define GROW_TO_SIZE_COMPONENT_H
 
-#include "Core\M5Component.h"
-#include "Core\M5Vec2.h"
+#include "Core/M5Component.h"
+#include "Core/M5Vec2.h"
 
 class GrowToSizeComponent : public M5Component
 {
@@ -23,6 +23,8 @@ public:
 	virtual void Update(float dt);
 	virtual void FromFile(M5IniFile& iniFile);
 	virtual GrowToSizeComponent* Clone(void) const;
+	virtual void Save(M5Snapshot& snapshot) const;
+	virtual void Load(M5Snapshot& snapshot);
 
 private:
 	M5Vec2 m_rate;
@@ -21,16 +21,24 @@ This is file contains the main function to make a basic window.
 #include <windows.h> /*WinMain*/ 
 
 /*Include the engine functions*/
-#include "Core\M5App.h"
-#include "Core\M5StageManager.h"
-#include "Core\M5Stage.h"
-#include "Core\M5GameData.h"
+#include "Core/M5App.h"
+#include "Core/M5StageManager.h"
+#include "Core/M5Stage.h"
+#include "Core/M5GameData.h"
 #include "RegisterStages.h"
 #include "RegisterComponents.h"
-#include "Core\M5IniFile.h"
-
-#include "Core\M5Debug.h"
+#include "Core/M5IniFile.h"
+#include "Core/M5Replay.h"
+#include "Core/M5ObjectManager.h"
+#include "Core/M5Benchmark.h"
+#include "Core/M5Telemetry.h"
+#include "Core/M5Replication.h"
+#include "Core/M5StreamManager.h"
+
+#include "Core/M5Debug.h"
 #include <string>
+#include <sstream>
+#include <ctime>
 
 /******************************************************************************/
 /*!
@@ -45,8 +53,22 @@ An identifier for the process.  This is used for various windows things.
 This is not used anymore, we can ignore it.
 
 \param comamndLine
-A string that is comes from the typed command line.  In games we usually don't
-care.
+A string that is comes from the typed command line.  Use -record file to save
+all input of the session, or -replay file to play a saved session back.  Use
+-systems to update components one type at a time.  Use -noprefetch to read
+each stage file when its stage starts.  Use -benchmark file to time
+the engine instead of playing, with -baseline file and -threshold percent to
+compare against an earlier run.  Use -headless to skip drawing, so no GPU is
+needed.  Use -telemetry file to write frame time percentiles to file.csv every
+few seconds and a summary to file.json at the end, with -interval seconds to
+change how often.  Use -duration seconds to quit after running that long, so
+a windowless soak test can end.  Use -software to draw on the CPU instead of with OpenGL.
+Use -golden file to check that the first level still draws the same, with
+-frames count to change how many frames are updated first.  The first run
+saves file as the golden image.  Use -server port to send the game to
+replication clients, with -sendrate count to change how many snapshots are
+sent each second.  Use -chunk stageFile chunkFile size to split the objects of
+a stage file into a chunk file for streaming, then quit.
 
 \param show 
 A variable stating if the window is visible, we always want it visible.
@@ -58,7 +80,7 @@ An Error code.  Just return 0;
 #pragma warning(suppress: 28251)
 int WINAPI WinMain(HINSTANCE instance,
                    HINSTANCE /*prev*/, 
-                   LPSTR /*commandLine*/, 
+                   LPSTR commandLine, 
                    int /*show*/)
 {
   /*This should appear at the top of winmain to have windows find memory leaks*/
@@ -76,6 +98,7 @@ int WINAPI WinMain(HINSTANCE instance,
   /*Set up my InitStruct*/
   iniFile.GetValue("width", initData.width);
   iniFile.GetValue("height", initData.height);
+  iniFile.GetValue("loadThreads", initData.loadThreads);
   iniFile.GetValue("framesPerSecond", initData.fps);
   iniFile.GetValue("fullScreen", initData.fullScreen);
   iniFile.GetValue("title", title);
@@ -93,10 +116,107 @@ int WINAPI WinMain(HINSTANCE instance,
   initData.title        = title.c_str();
   initData.instance     = instance;
   initData.pGData       = &gameData;
+  initData.headless     = false;
+  initData.software     = false;
+
+  /*Graphics starts with the window, so this can't wait for the other options*/
+  std::stringstream initArgs(commandLine);
+  std::string option;
+  while (initArgs >> option)
+  {
+    if (option == "-headless")
+      initData.headless = true;
+    /*Golden images are only saved by the software backend*/
+    else if (option == "-software" || option == "-golden")
+      initData.software = true;
+  }
 
   /*Pass InitStruct to Function.  This function must be called first!!!*/
   M5App::Init(initData);
+
+  /*Check if this session should be recorded or replayed*/
+  std::stringstream args(commandLine);
+  std::string replayFile;
+  std::string benchmarkFile;
+  std::string baselineFile;
+  std::string telemetryFile;
+  std::string goldenFile;
+  float threshold = 10.0f;
+  float interval = 10.0f;
+  float duration = 0;
+  int frames = 60;
+  int serverPort = -1;
+  float sendRate = 20.0f;
+  std::string chunkStage;
+  std::string chunkFile;
+  float chunkSize = 0;
+  while (args >> option)
+  {
+    if (option == "-record" && args >> replayFile)
+      M5Replay::StartRecording(replayFile.c_str(), static_cast<unsigned>(std::time(0)));
+    else if (option == "-replay" && args >> replayFile)
+      M5Replay::StartReplay(replayFile.c_str());
+    else if (option == "-systems")
+      M5ObjectManager::SetSystemUpdate(true);
+    else if (option == "-noprefetch")
+      M5StageManager::SetPrefetch(false);
+    else if (option == "-benchmark")
+      args >> benchmarkFile;
+    else if (option == "-baseline")
+      args >> baselineFile;
+    else if (option == "-threshold")
+      args >> threshold;
+    else if (option == "-telemetry")
+      args >> telemetryFile;
+    else if (option == "-interval")
+      args >> interval;
+    else if (option == "-duration" && args >> duration)
+      M5StageManager::QuitAfter(duration);
+    else if (option == "-golden")
+      args >> goldenFile;
+    else if (option == "-frames")
+      args >> frames;
+    else if (option == "-server")
+      args >> serverPort;
+    else if (option == "-sendrate")
+      args >> sendRate;
+    else if (option == "-chunk")
+      args >> chunkStage >> chunkFile >> chunkSize;
+  }
+
+  if (!telemetryFile.empty())
+    M5Telemetry::StartOutput(telemetryFile.c_str(), interval);
+
+  /*Split a big level for streaming and quit without starting the game*/
+  if (!chunkFile.empty() && chunkSize > 0)
+  {
+    bool isWritten = M5StreamManager::BuildChunkFile(chunkStage, chunkFile, chunkSize);
+    M5App::Shutdown();
+    return isWritten ? 0 : 1;
+  }
+
+  /*Time the engine and quit without starting the game*/
+  if (!benchmarkFile.empty())
+  {
+    int regressions = M5Benchmark::Run(benchmarkFile.c_str(),
+      baselineFile.empty() ? 0 : baselineFile.c_str(), threshold);
+    M5App::Shutdown();
+    return regressions;
+  }
+
+  /*Check the first level against the golden image and quit*/
+  if (!goldenFile.empty())
+  {
+    M5StageManager::GetGameData().level = 1;
+    int different = M5StageManager::TestStage(ST_GamePlayStage, frames, goldenFile.c_str());
+    M5App::Shutdown();
+    return different;
+  }
   
+  /*Send the game to anyone that connects*/
+  if (serverPort >= 0)
+    M5Replication::StartServer(static_cast<unsigned short>(serverPort), sendRate);
+
   /*Make sure to add what stage we will start in*/
   M5StageManager::SetStartStage(StringToStage(startStage));
   /*Start running the game*/
@@ -12,8 +12,19 @@ Component to spawn objects from outward from the center
 #ifndef MENU_SPAWNER_COMPONENT_H
 #define MENU_SPAWNER_COMPONENT_H
 
-#include "Core\M5Component.h"
-#include "Core\M5ArcheTypes.h"
+#include "Core/M5Component.h"
+#include "Core/M5ComponentBuilder.h"
+#include "Core/M5ArcheTypes.h"
+#include "Core/M5ArcheData.h"
+
+//! Settings shared by every MenuSpawnerComponent cloned from the same ArcheType
+struct MenuSpawnerData
+{
+	M5ArcheTypes type = AT_INVALID; //!< The ArcheType to spawn
+	float        velMin = 1;        //!< Slowest speed of a spawned object
+	float        velMax = 1;        //!< Fastest speed of a spawned object
+	float        maxTime = 1;       //!< Seconds between spawns
+};
 
 class MenuSpawnerComponent : public M5Component
 {
@@ -23,14 +34,20 @@ public:
 	virtual void Update(float dt);
 	virtual void FromFile(M5IniFile& iniFIle);
 	virtual MenuSpawnerComponent* Clone(void) const;
+	virtual void Save(M5Snapshot& snapshot) const;
+	virtual void Load(M5Snapshot& snapshot);
 private:
-	M5ArcheTypes m_type;
-	float m_velMin;
-	float m_velMax;
+	M5ArcheData<MenuSpawnerData> m_data; //!< Settings shared with the rest of the ArcheType
 	float m_timer;
-	float m_maxTime;
 
 };
 
+//! The timer is given all of the time since the last turn, so spawns are at most a turn late
+template <>
+struct M5UpdateRate<MenuSpawnerComponent>
+{
+	static constexpr float value = 10.0f; //!< Check the timer ten times a second
+};
+
 
 #endif //MENU_SPAWNER_COMPONENT_H
\ No newline at end of file
@@ -10,11 +10,11 @@ The MainMenu in AstroShot
 */
 /******************************************************************************/
 #include "MenuStage.h"
-#include "Core\M5ObjectManager.h"
-#include "Core\M5App.h"
-#include "Core\M5IniFile.h"
-#include "Core\M5StageManager.h"
-#include "Core\M5GameData.h"
+#include "Core/M5ObjectManager.h"
+#include "Core/M5App.h"
+#include "Core/M5IniFile.h"
+#include "Core/M5StageManager.h"
+#include "Core/M5GameData.h"
 #include "SpaceShooterHelp.h"
 #include <string>
 
@@ -26,11 +26,11 @@ MenuStage::~MenuStage(void)
 }
 void MenuStage::Init(void)
 {
-	std::string loadDir = "Stages\\";
+	std::string loadDir = "Stages/";
 	//Create ini reader and starting vars
 	M5IniFile iniFile;
 	//Load file
-	iniFile.ReadFile(loadDir + M5StageManager::GetGameData().menuFile);
+	M5StageManager::LoadStageFile(loadDir + M5StageManager::GetGameData().menuFile, iniFile);
 	//Read Objects From IniFile
 	LoadObjects(iniFile);
 }
@@ -12,7 +12,7 @@ The MenuStage in AstroShot
 #ifndef MENU_STAGE_H
 #define MENU_STAGE_H
 
-#include "Core\M5Stage.h"
+#include "Core/M5Stage.h"
 
 class MenuStage : public M5Stage
 {
@@ -11,11 +11,12 @@ player shoots
 */
 /******************************************************************************/
 #include "PlayerInputComponent.h"
-#include "Core\M5IniFile.h"
-#include "Core\M5Input.h"
-#include "Core\M5Vec2.h"
-#include "Core\M5Object.h"
-#include "Core\M5ObjectManager.h"
+#include "Core/M5IniFile.h"
+#include "Core/M5Input.h"
+#include "Core/M5Vec2.h"
+#include "Core/M5Object.h"
+#include "Core/M5ObjectManager.h"
+#include "Core/M5Snapshot.h"
 #include <cmath>
 
 /******************************************************************************/
@@ -25,10 +26,7 @@ Sets component type and starting values for player
 /******************************************************************************/
 PlayerInputComponent::PlayerInputComponent(void) :
 	M5Component(CT_PlayerInputComponent),
-	m_forwardSpeed(0),
-	m_speedDamp(0),
-	m_rotationSpeed(0),
-	m_rotationalDamp(0)
+	m_data()
 {
 }
 /******************************************************************************/
@@ -46,16 +44,18 @@ Updates the player based on input
 /******************************************************************************/
 void PlayerInputComponent::Update(float dt)
 {
+	const PlayerInputData& data = m_data.Get();
+
 	//first check for rotation
 	if (M5Input::IsPressed(M5_A)) 
 	{
-		m_pObj->rotationVel += m_rotationSpeed * dt;
-		m_pObj->rotationVel *= m_rotationalDamp;
+		m_pObj->rotationVel += data.rotationSpeed * dt;
+		m_pObj->rotationVel *= data.rotationalDamp;
 	}
 	else if (M5Input::IsPressed(M5_D))
 	{
-		m_pObj->rotationVel -= m_rotationSpeed * dt; 
-		m_pObj->rotationVel *= m_rotationalDamp;
+		m_pObj->rotationVel -= data.rotationSpeed * dt; 
+		m_pObj->rotationVel *= data.rotationalDamp;
 	}
 	else
 		m_pObj->rotationVel = 0;
@@ -65,9 +65,9 @@ void PlayerInputComponent::Update(float dt)
 	{
 		//Get vector from rotation
 		M5Vec2 dir(std::cos(m_pObj->rotation), std::sin(m_pObj->rotation));
-		M5Vec2::Scale(dir, dir, m_forwardSpeed * dt);
+		M5Vec2::Scale(dir, dir, data.forwardSpeed * dt);
 		m_pObj->vel += dir;
-		M5Vec2::Scale(m_pObj->vel, m_pObj->vel, m_speedDamp);
+		M5Vec2::Scale(m_pObj->vel, m_pObj->vel, data.speedDamp);
 	}
 
 	//then check for bullets 
@@ -83,7 +83,7 @@ void PlayerInputComponent::Update(float dt)
 		bullet1->pos = m_pObj->pos + perp * .5f * m_pObj->scale.y;
 		bullet2->pos = m_pObj->pos - perp * .5f * m_pObj->scale.y;
 
-		M5Vec2::Scale(bulletDir, bulletDir, m_bulletSpeed * dt);
+		M5Vec2::Scale(bulletDir, bulletDir, data.bulletSpeed * dt);
 
 		bullet1->vel = m_pObj->vel + bulletDir;
 		bullet2->vel = m_pObj->vel + bulletDir;
@@ -97,12 +97,8 @@ Virtual constructor for PlayerInputComponent
 /******************************************************************************/
 PlayerInputComponent* PlayerInputComponent::Clone(void) const
 {
-	PlayerInputComponent* pNew = new PlayerInputComponent;
-	pNew->m_forwardSpeed   = m_forwardSpeed;
-	pNew->m_bulletSpeed    = m_bulletSpeed;
-	pNew->m_rotationSpeed  = m_rotationSpeed;
-	pNew->m_speedDamp      = m_speedDamp;
-	pNew->m_rotationalDamp = m_rotationalDamp;
+	PlayerInputComponent* pNew = new (CT_PlayerInputComponent) PlayerInputComponent;
+	pNew->m_data = m_data;
 	return pNew;
 }
 /******************************************************************************/
@@ -115,10 +111,35 @@ The preloaded iniFile to read.
 /******************************************************************************/
 void PlayerInputComponent::FromFile(M5IniFile& iniFile)
 {
+	PlayerInputData& data = m_data.Edit();
 	iniFile.SetToSection("PlayerInputComponent");
-	iniFile.GetValue("forwardSpeed", m_forwardSpeed);
-	iniFile.GetValue("bulletSpeed", m_bulletSpeed);
-	iniFile.GetValue("rotationSpeed", m_rotationSpeed);
-	iniFile.GetValue("speedDamp", m_speedDamp);
-	iniFile.GetValue("rotationalDamp", m_rotationalDamp);
-}
\ No newline at end of file
+	iniFile.GetValue("forwardSpeed", data.forwardSpeed);
+	iniFile.GetValue("bulletSpeed", data.bulletSpeed);
+	iniFile.GetValue("rotationSpeed", data.rotationSpeed);
+	iniFile.GetValue("speedDamp", data.speedDamp);
+	iniFile.GetValue("rotationalDamp", data.rotationalDamp);
+}
+/******************************************************************************/
+/*!
+Saves the data of this component into a snapshot.
+
+\param [in] snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+void PlayerInputComponent::Save(M5Snapshot& snapshot) const
+{
+	m_data.Save(snapshot);
+}
+/******************************************************************************/
+/*!
+Restores the data of this component from a snapshot.
+
+\param [in] snapshot
+The snapshot to read from.
+*/
+/******************************************************************************/
+void PlayerInputComponent::Load(M5Snapshot& snapshot)
+{
+	m_data.Load(snapshot);
+}
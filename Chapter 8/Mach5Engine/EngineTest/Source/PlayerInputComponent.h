@@ -13,6 +13,17 @@ Player input for AstroShot
 #define PLAYER_INPUT_COMPONENT
 
 #include "Core/M5Component.h"
+#include "Core/M5ArcheData.h"
+
+//! Settings shared by every PlayerInputComponent cloned from the same ArcheType
+struct PlayerInputData
+{
+	float forwardSpeed = 0;   //!< Acceleration when moving forward
+	float speedDamp = 0;      //!< Velocity is scaled by this while moving
+	float bulletSpeed = 0;    //!< Speed of each bullet
+	float rotationSpeed = 0;  //!< Rotational acceleration
+	float rotationalDamp = 0; //!< Rotational velocity is scaled by this while turning
+};
 
 //!< Player input component for AstroShot
 class PlayerInputComponent : public M5Component
@@ -23,12 +34,10 @@ public:
 	virtual void Update(float dt);
 	virtual PlayerInputComponent* Clone(void) const;
 	virtual void FromFile(M5IniFile& iniFile);
+	virtual void Save(M5Snapshot& snapshot) const;
+	virtual void Load(M5Snapshot& snapshot);
 private:
-	float m_forwardSpeed;
-	float m_speedDamp;
-	float m_bulletSpeed;
-	float m_rotationSpeed;
-	float m_rotationalDamp;
+	M5ArcheData<PlayerInputData> m_data; //!< Settings shared with the rest of the ArcheType
 
 };
 
@@ -10,12 +10,13 @@ Finite Statemachine base class component
 */
 /******************************************************************************/
 #include "RandomGoComponent.h"
-#include "Core\M5Gfx.h"
-#include "Core\M5Random.h"
-#include "Core\M5Object.h"
-#include "Core\M5Intersect.h"
-#include "Core\M5IniFile.h"
-#include "Core\M5Math.h"
+#include "Core/M5Gfx.h"
+#include "Core/M5Random.h"
+#include "Core/M5Object.h"
+#include "Core/M5Intersect.h"
+#include "Core/M5IniFile.h"
+#include "Core/M5Math.h"
+#include "Core/M5Snapshot.h"
 #include <cmath>
 
 RandomGoComponent::FindState::FindState(RandomGoComponent* parent):
@@ -48,7 +49,7 @@ RandomGoComponent::RotateState::RotateState(RandomGoComponent* parent) :
 void RandomGoComponent::RotateState::Enter(float )
 {
 	M5Vec2::Sub(m_dir, m_parent->m_target, m_parent->m_pObj->pos);
-	m_targetRot = std::atan2f(m_dir.y, m_dir.x);
+	m_targetRot = std::atan2(m_dir.y, m_dir.x);
 	m_targetRot = M5Math::Wrap(m_targetRot, 0.f, M5Math::TWO_PI);
 	m_parent->m_pObj->rotationVel = m_parent->m_rotateSpeed;
 }
@@ -105,8 +106,54 @@ void RandomGoComponent::FromFile(M5IniFile& iniFile)
 }
 RandomGoComponent* RandomGoComponent::Clone(void) const
 {
-	RandomGoComponent* pNew = new RandomGoComponent;
+	RandomGoComponent* pNew = new (CT_RandomGoComponent) RandomGoComponent;
 	pNew->m_speed = m_speed;
 	pNew->m_rotateSpeed = m_rotateSpeed;
 	return pNew;
-}
\ No newline at end of file
+}
+void RandomGoComponent::Save(M5Snapshot& snapshot) const
+{
+	snapshot.Write(m_speed);
+	snapshot.Write(m_rotateSpeed);
+	snapshot.Write(m_target);
+	snapshot.Write(m_rotateState.m_targetRot);
+	snapshot.Write(m_rotateState.m_dir);
+
+	//States are members, so save which one instead of the pointer
+	snapshot.Write(StateToIndex(GetCurrState()));
+	snapshot.Write(StateToIndex(GetNextState()));
+}
+void RandomGoComponent::Load(M5Snapshot& snapshot)
+{
+	snapshot.Read(m_speed);
+	snapshot.Read(m_rotateSpeed);
+	snapshot.Read(m_target);
+	snapshot.Read(m_rotateState.m_targetRot);
+	snapshot.Read(m_rotateState.m_dir);
+
+	int curr;
+	int next;
+	snapshot.Read(curr);
+	snapshot.Read(next);
+	SetStates(IndexToState(curr), IndexToState(next));
+}
+int RandomGoComponent::StateToIndex(const M5State* pState) const
+{
+	if (pState == &m_findState)
+		return 1;
+	if (pState == &m_rotateState)
+		return 2;
+	if (pState == &m_goState)
+		return 3;
+	return 0;
+}
+M5State* RandomGoComponent::IndexToState(int index)
+{
+	switch (index)
+	{
+	case 1: return &m_findState;
+	case 2: return &m_rotateState;
+	case 3: return &m_goState;
+	default: return 0;
+	}
+}
@@ -12,9 +12,10 @@ Component to find, rotate to and move toward a random location
 #ifndef RANDOM_LOCATION_COMPONENT_H
 #define RANDOM_LOCATION_COMPONENT_H
 
-#include "Core\M5Component.h"
-#include "Core\M5StateMachine.h"
-#include "Core\M5Vec2.h"
+#include "Core/M5Component.h"
+#include "Core/M5ComponentBuilder.h"
+#include "Core/M5StateMachine.h"
+#include "Core/M5Vec2.h"
 
 //Forward declation
 
@@ -25,6 +26,8 @@ public:
 	RandomGoComponent(void);
 	virtual void FromFile(M5IniFile&);
 	virtual RandomGoComponent* Clone(void) const;
+	virtual void Save(M5Snapshot& snapshot) const;
+	virtual void Load(M5Snapshot& snapshot);
 private:
 	class FindState : public M5State
 	{
@@ -44,6 +47,7 @@ private:
 		void Update(float dt);
 		void Exit(float dt);
 	private:
+		friend RandomGoComponent;
 		float m_targetRot;
 		M5Vec2 m_dir;
 		RandomGoComponent* m_parent;
@@ -63,6 +67,9 @@ private:
 	friend GoState;
 	friend RotateState;
 
+	int      StateToIndex(const M5State* pState) const;
+	M5State* IndexToState(int index);
+
 	float       m_speed;
 	float       m_rotateSpeed;
 	M5Vec2      m_target;
@@ -71,5 +78,12 @@ private:
 	GoState     m_goState;
 };
 
+//! The object keeps moving between turns, so only the state changes are late
+template <>
+struct M5UpdateRate<RandomGoComponent>
+{
+	static constexpr float value = 10.0f; //!< Check the target ten times a second
+};
+
 
 #endif // !RANDOM_GO_COMPONENT_H
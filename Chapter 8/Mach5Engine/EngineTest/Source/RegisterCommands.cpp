@@ -7,26 +7,33 @@
  
 This file gets auto generated based on the names of the Commands in the 
 Include folder and current project.  PreBuild.bat looks for files named *Command.h 
-and registers those with the ObjectManager. 
+and makes a table of their builders for the ObjectManager. 
 */ 
 /******************************************************************************/ 
-#include "Core\M5ObjectManager.h" 
-#include "Core\M5CommandTypes.h" 
-#include "Core\M5TBuilder.h" 
-#include "Core\ChangeResolutionCommand.h" 
-#include "Core\ChangeStageCommand.h" 
-#include "Core\M5Command.h" 
-#include "Core\PauseStageCommand.h" 
-#include "Core\QuitCommand.h" 
-#include "Core\ResumeStageCommand.h" 
-#include "Core\SetFullscreenCommand.h" 
+#include "RegisterCommands.h" 
+#include "Core/M5CommandTypes.h" 
+#include "Core/ChangeResolutionCommand.h" 
+#include "Core/ChangeStageCommand.h" 
+#include "Core/M5Command.h" 
+#include "Core/PauseStageCommand.h" 
+#include "Core/QuitCommand.h" 
+#include "Core/ResumeStageCommand.h" 
+#include "Core/SetFullscreenCommand.h" 
  
  
-void RegisterCommands(void) {  
- M5ObjectManager::AddCommand(CMD_ChangeResolutionCommand, new ChangeResolutionCommand() ); 
- M5ObjectManager::AddCommand(CMD_ChangeStageCommand, new ChangeStageCommand() ); 
- M5ObjectManager::AddCommand(CMD_PauseStageCommand, new PauseStageCommand() ); 
- M5ObjectManager::AddCommand(CMD_QuitCommand, new QuitCommand() ); 
- M5ObjectManager::AddCommand(CMD_ResumeStageCommand, new ResumeStageCommand() ); 
- M5ObjectManager::AddCommand(CMD_SetFullscreenCommand, new SetFullscreenCommand() ); 
+namespace { 
+//! AutoGenerated builders in the same order as M5CommandTypes 
+constexpr M5CommandBuilder s_builders[] = { 
+ M5BuildCommand< ChangeResolutionCommand >, 
+ M5BuildCommand< ChangeStageCommand >, 
+ M5BuildCommand< PauseStageCommand >, 
+ M5BuildCommand< QuitCommand >, 
+ M5BuildCommand< ResumeStageCommand >, 
+ M5BuildCommand< SetFullscreenCommand >, 
+}; 
+static_assert(sizeof(s_builders) / sizeof(s_builders[0]) == CMD_INVALID, "Run PreBuild.bat, the builders don't match M5CommandTypes"); 
+} 
+ 
+const M5CommandBuilder* GetCommandBuilders(void) { 
+ return s_builders; 
 } 
@@ -7,11 +7,12 @@
  
 This file gets auto generated based on the names of the Commands in the 
 Include folder and current project.  PreBuild.bat looks for files named *Command.h 
-and registers those with the ObjectManager. 
+and makes a table of their builders for the ObjectManager. 
 */ 
 /******************************************************************************/ 
 #ifndef REGISTER_COMMANDS_H 
 #define REGISTER_COMMANDS_H 
  
-void RegisterCommands(void); 
+#include "Core/M5Command.h" 
+const M5CommandBuilder* GetCommandBuilders(void); 
 #endif //REGISTER_COMMANDS_H 
@@ -7,20 +7,21 @@
  
 This file gets auto generated based on the names of the Components in the 
 Include folder and current project.  UserPreBuild.bat looks for files named *Component.h 
-and registers those with the ObjectManager. 
+and makes a table of their builders for the ObjectManager. 
 */ 
 /******************************************************************************/ 
-#include "Core\M5ObjectManager.h" 
-#include "Core\M5ComponentTypes.h" 
-#include "Core\M5ComponentBuilder.h" 
-#include "Core\ClampComponent.h" 
-#include "Core\ColliderComponent.h" 
-#include "Core\GfxComponent.h" 
-#include "Core\OutsideViewKillComponent.h" 
-#include "Core\RepositionComponent.h" 
-#include "Core\UIButtonComponent.h" 
-#include "Core\WrapComponent.h" 
+#include "RegisterComponents.h" 
+#include "Core/M5ComponentTypes.h" 
+#include "Core/M5ComponentBuilder.h" 
+#include "Core/ClampComponent.h" 
+#include "Core/ColliderComponent.h" 
+#include "Core/GfxComponent.h" 
+#include "Core/OutsideViewKillComponent.h" 
+#include "Core/RepositionComponent.h" 
+#include "Core/UIButtonComponent.h" 
+#include "Core/WrapComponent.h" 
 #include "ChasePlayerComponent.h" 
+#include "FlowChaseComponent.h" 
 #include "GrowToSizeComponent.h" 
 #include "MenuSpawnerComponent.h" 
 #include "PlayerInputComponent.h" 
@@ -28,18 +29,27 @@ and registers those with the ObjectManager.
 #include "ShrinkComponent.h" 
  
  
-void RegisterComponents(void) {  
- M5ObjectManager::AddComponent(CT_ClampComponent, new M5ComponentTBuilder< ClampComponent >() ); 
- M5ObjectManager::AddComponent(CT_ColliderComponent, new M5ComponentTBuilder< ColliderComponent >() ); 
- M5ObjectManager::AddComponent(CT_GfxComponent, new M5ComponentTBuilder< GfxComponent >() ); 
- M5ObjectManager::AddComponent(CT_OutsideViewKillComponent, new M5ComponentTBuilder< OutsideViewKillComponent >() ); 
- M5ObjectManager::AddComponent(CT_RepositionComponent, new M5ComponentTBuilder< RepositionComponent >() ); 
- M5ObjectManager::AddComponent(CT_UIButtonComponent, new M5ComponentTBuilder< UIButtonComponent >() ); 
- M5ObjectManager::AddComponent(CT_WrapComponent, new M5ComponentTBuilder< WrapComponent >() ); 
- M5ObjectManager::AddComponent(CT_ChasePlayerComponent, new M5ComponentTBuilder< ChasePlayerComponent >() ); 
- M5ObjectManager::AddComponent(CT_GrowToSizeComponent, new M5ComponentTBuilder< GrowToSizeComponent >() ); 
- M5ObjectManager::AddComponent(CT_MenuSpawnerComponent, new M5ComponentTBuilder< MenuSpawnerComponent >() ); 
- M5ObjectManager::AddComponent(CT_PlayerInputComponent, new M5ComponentTBuilder< PlayerInputComponent >() ); 
- M5ObjectManager::AddComponent(CT_RandomGoComponent, new M5ComponentTBuilder< RandomGoComponent >() ); 
- M5ObjectManager::AddComponent(CT_ShrinkComponent, new M5ComponentTBuilder< ShrinkComponent >() ); 
+namespace { 
+//! AutoGenerated builders in the same order as M5ComponentTypes 
+constexpr M5ComponentBuilder s_builders[] = { 
+ M5MakeComponentBuilder< ClampComponent >(), 
+ M5MakeComponentBuilder< ColliderComponent >(), 
+ M5MakeComponentBuilder< GfxComponent >(), 
+ M5MakeComponentBuilder< OutsideViewKillComponent >(), 
+ M5MakeComponentBuilder< RepositionComponent >(), 
+ M5MakeComponentBuilder< UIButtonComponent >(), 
+ M5MakeComponentBuilder< WrapComponent >(), 
+ M5MakeComponentBuilder< ChasePlayerComponent >(), 
+ M5MakeComponentBuilder< FlowChaseComponent >(), 
+ M5MakeComponentBuilder< GrowToSizeComponent >(), 
+ M5MakeComponentBuilder< MenuSpawnerComponent >(), 
+ M5MakeComponentBuilder< PlayerInputComponent >(), 
+ M5MakeComponentBuilder< RandomGoComponent >(), 
+ M5MakeComponentBuilder< ShrinkComponent >(), 
+}; 
+static_assert(sizeof(s_builders) / sizeof(s_builders[0]) == CT_INVALID, "Run PreBuild.bat, the builders don't match M5ComponentTypes"); 
+} 
+ 
+const M5ComponentBuilder* GetComponentBuilders(void) { 
+ return s_builders; 
 } 
@@ -7,11 +7,12 @@
  
 This file gets auto generated based on the names of the Components in the 
 Include folder and current project.  PreBuild.bat looks for files named *Component.h 
-and registers those with the ObjectManager. 
+and makes a table of their builders for the ObjectManager. 
 */ 
 /******************************************************************************/ 
 #ifndef REGISTER_COMPONENTS_H 
 #define REGISTER_COMPONENTS_H 
  
-void RegisterComponents(void); 
+struct M5ComponentBuilder; 
+const M5ComponentBuilder* GetComponentBuilders(void); 
 #endif //REGISTER_COMPONENTS_H 
@@ -11,9 +11,9 @@ and registers those stages with the StageManager.
 */ 
 /******************************************************************************/ 
 #include "RegisterStages.h" 
-#include "Core\M5StageManager.h" 
-#include "Core\M5StageTypes.h" 
-#include "Core\M5StageBuilder.h" 
+#include "Core/M5StageManager.h" 
+#include "Core/M5StageTypes.h" 
+#include "Core/M5StageBuilder.h" 
 #include "GamePlayStage.h" 
 #include "MenuStage.h" 
 #include "SplashStage.h" 
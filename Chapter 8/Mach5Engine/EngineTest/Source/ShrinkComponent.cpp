@@ -11,8 +11,10 @@ Shrink Debuff Component
 /******************************************************************************/
 #include "ShrinkComponent.h"
 
-#include "Core\M5Object.h"
-#include "Core\M5Math.h"
+#include "Core/M5Object.h"
+#include "Core/M5Gfx.h"
+#include "Core/M5Math.h"
+#include "Core/M5Snapshot.h"
 
 
 /******************************************************************************/
@@ -57,6 +59,7 @@ void ShrinkComponent::Update(float dt)
 		{
 			m_oldScale = m_pObj->scale;
 			m_pObj->scale.Set(2, 2);
+			M5Gfx::MarkMoved(m_pObj);
 			m_hasStarted = true;
 		}
 	}
@@ -66,6 +69,7 @@ void ShrinkComponent::Update(float dt)
 	if (m_timer > m_maxTime)
 	{
 		m_pObj->scale = m_oldScale;
+		M5Gfx::MarkMoved(m_pObj);
 		isDead = true;
 	}
 }
@@ -76,6 +80,36 @@ Virtual constructor for PlayerInputComponent
 /******************************************************************************/
 ShrinkComponent* ShrinkComponent::Clone(void) const
 {
-	ShrinkComponent* pNew = new ShrinkComponent();
+	ShrinkComponent* pNew = new (CT_ShrinkComponent) ShrinkComponent();
 	return pNew;
-}
\ No newline at end of file
+}
+/******************************************************************************/
+/*!
+Saves the data of this component into a snapshot.
+
+\param [in] snapshot
+The snapshot to write to.
+*/
+/******************************************************************************/
+void ShrinkComponent::Save(M5Snapshot& snapshot) const
+{
+	snapshot.Write(m_oldScale);
+	snapshot.Write(m_hasStarted);
+	snapshot.Write(m_timer);
+	snapshot.Write(m_maxTime);
+}
+/******************************************************************************/
+/*!
+Restores the data of this component from a snapshot.
+
+\param [in] snapshot
+The snapshot to read from.
+*/
+/******************************************************************************/
+void ShrinkComponent::Load(M5Snapshot& snapshot)
+{
+	snapshot.Read(m_oldScale);
+	snapshot.Read(m_hasStarted);
+	snapshot.Read(m_timer);
+	snapshot.Read(m_maxTime);
+}
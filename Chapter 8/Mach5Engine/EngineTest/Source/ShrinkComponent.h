@@ -23,6 +23,8 @@ public:
 	~ShrinkComponent(void);
 	virtual void Update(float dt);
 	virtual ShrinkComponent* Clone(void) const;
+	virtual void Save(M5Snapshot& snapshot) const;
+	virtual void Load(M5Snapshot& snapshot);
 private:
 	M5Vec2 m_oldScale;
 	bool m_hasStarted;
@@ -12,16 +12,19 @@ a lot of stages so It is better to create this function.
 /******************************************************************************/
 #include "SpaceShooterHelp.h"
 
-#include "Core\M5ObjectManager.h"
-#include "Core\M5IniFile.h"
-#include "Core\M5ArcheTypes.h"
-#include "Core\M5Object.h"
+#include "Core/M5ObjectManager.h"
+#include "Core/M5IniFile.h"
+#include "Core/M5ArcheTypes.h"
+#include "Core/M5Object.h"
+#include "Core/M5StreamManager.h"
 #include <sstream>
 #include <iomanip>
 
 /******************************************************************************/
 /*!
-Loads stage objects from a pre opened ini file.
+Loads stage objects from a pre opened ini file.  If the stage has a chunkFile,
+the objects in it are streamed in around the camera instead of being loaded
+now.
 
 \param [in] iniFile
 A pre-opened Stage iniFile to load object from
@@ -30,6 +33,14 @@ A pre-opened Stage iniFile to load object from
 /******************************************************************************/
 void LoadObjects(M5IniFile& iniFile)
 {
+	//Big levels keep most of their objects in a chunk file
+	if (iniFile.HasKey("chunkFile"))
+	{
+		std::string chunkFile;
+		iniFile.GetValue("chunkFile", chunkFile);
+		M5StreamManager::Open(chunkFile);
+	}
+
 	//Get my list of ArcheTypes from the file
 	std::string archeTypesList;
 	iniFile.GetValue("ArcheTypes", archeTypesList);
@@ -12,15 +12,16 @@ good place to load game data and initialize object you need for your game.
 /******************************************************************************/
 #include "SplashStage.h"
 
-#include "Core\M5App.h"
-#include "Core\M5Debug.h"
-#include "Core\M5StageManager.h"
-#include "Core\M5ObjectManager.h"
-#include "Core\M5Object.h"
-#include "Core\M5Random.h"
-#include "Core\M5IniFile.h"
-#include "Core\M5GameData.h"
-#include "Core\M5StageTypes.h"
+#include "Core/M5App.h"
+#include "Core/M5Debug.h"
+#include "Core/M5StageManager.h"
+#include "Core/M5ObjectManager.h"
+#include "Core/M5Object.h"
+#include "Core/M5Random.h"
+#include "Core/M5Replay.h"
+#include "Core/M5IniFile.h"
+#include "Core/M5GameData.h"
+#include "Core/M5StageTypes.h"
 #include "SpaceShooterHelp.h"
 #include <ctime>
 #include <string>
@@ -37,7 +38,9 @@ SplashStage::SplashStage(void)
 {
   /*Create a debug console*/
   M5DEBUG_CREATE_CONSOLE();
-  M5Random::Seed(static_cast<unsigned>(std::time(0)));
+  /*A recorded or replayed session has already been seeded*/
+  if (!M5Replay::IsRecording() && !M5Replay::IsReplaying())
+    M5Random::Seed(static_cast<unsigned>(std::time(0)));
 }
 /******************************************************************************/
 /*!
@@ -71,7 +74,7 @@ void SplashStage::Init(void)
 
   //Create ini reader and starting vars
   M5IniFile iniFile;
-  std::string loadDir = "Stages\\";
+  std::string loadDir = "Stages/";
   std::string nextStage;
   //Load file
   iniFile.ReadFile(loadDir + M5StageManager::GetGameData().menuFile);
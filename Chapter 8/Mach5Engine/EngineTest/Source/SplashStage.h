@@ -13,8 +13,8 @@ place to load data and/or resources that you will need for all of your stages.
 #ifndef SPLASHSTAGE_H
 #define SPLASHSTAGE_H
 
-#include "Core\M5Stage.h"
-#include "Core\M5StageTypes.h"
+#include "Core/M5Stage.h"
+#include "Core/M5StageTypes.h"
 #include <string>
 
 class SplashStage : public M5Stage
@@ -0,0 +1,127 @@
+/******************************************************************************/
+/*!
+\file   FastMathTest.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/04
+
+Checks that the M5FastMath functions stay inside the max errors that
+M5FastMath.h promises.
+
+*/
+/******************************************************************************/
+#include "M5Test.h"
+
+#include "Core/M5FastMath.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+const float SIN_ERROR = 2e-7f;   //!< Max error of Sin, Cos and SinCos from M5FastMath.h
+const float ATAN2_ERROR = 1e-5f; //!< Max error of Atan2 from M5FastMath.h
+const int   SWEEP_STEPS = 1 << 20; //!< Angles checked in each sweep
+
+/******************************************************************************/
+/*!
+Checks SinCos, Sin and Cos against the double precision functions for angles
+from -MAX_ANGLE to MAX_ANGLE, and that the array version matches.
+*/
+/******************************************************************************/
+void TestSinCos(void)
+{
+	std::vector<float> angles(SWEEP_STEPS + 1);
+	for (int i = 0; i <= SWEEP_STEPS; ++i)
+		angles[i] = -M5FastMath::MAX_ANGLE + 2 * M5FastMath::MAX_ANGLE * i / SWEEP_STEPS;
+	//Small angles and the places the polynomials meet
+	for (int i = -64; i <= 64; ++i)
+		angles.push_back(i * 0.125f);
+
+	std::vector<float> sins(angles.size()), coss(angles.size());
+	M5FastMath::SinCos(&sins[0], &coss[0], &angles[0], angles.size());
+
+	double maxError = 0;
+	bool arrayMatches = true;
+	for (size_t i = 0; i < angles.size(); ++i)
+	{
+		float sin, cos;
+		M5FastMath::SinCos(angles[i], sin, cos);
+		maxError = std::fmax(maxError, std::fabs(sin - std::sin(static_cast<double>(angles[i]))));
+		maxError = std::fmax(maxError, std::fabs(cos - std::cos(static_cast<double>(angles[i]))));
+
+		arrayMatches = arrayMatches && sins[i] == sin && coss[i] == cos;
+		arrayMatches = arrayMatches && M5FastMath::Sin(angles[i]) == sin && M5FastMath::Cos(angles[i]) == cos;
+	}
+
+	std::printf("SinCos max error %g\n", maxError);
+	M5TEST_CHECK(maxError <= SIN_ERROR);
+	M5TEST_CHECK(arrayMatches);
+}
+/******************************************************************************/
+/*!
+Checks Atan2 against the double precision function all the way around the
+circle at several lengths, including the axes, and that the array version
+matches.
+*/
+/******************************************************************************/
+void TestAtan2(void)
+{
+	const double PI = 3.14159265358979323846;
+	const float LENGTHS[] = { 1e-3f, 1.0f, 250.0f, 1e6f };
+
+	std::vector<float> ys, xs;
+	for (size_t l = 0; l < sizeof(LENGTHS) / sizeof(LENGTHS[0]); ++l)
+	{
+		for (int i = 0; i < SWEEP_STEPS / 4; ++i)
+		{
+			double angle = -PI + 2 * PI * i / (SWEEP_STEPS / 4);
+			ys.push_back(static_cast<float>(LENGTHS[l] * std::sin(angle)));
+			xs.push_back(static_cast<float>(LENGTHS[l] * std::cos(angle)));
+		}
+
+		const float AXES[4][2] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+		for (int i = 0; i < 4; ++i)
+		{
+			ys.push_back(AXES[i][0] * LENGTHS[l]);
+			xs.push_back(AXES[i][1] * LENGTHS[l]);
+		}
+	}
+
+	std::vector<float> results(ys.size());
+	M5FastMath::Atan2(&results[0], &ys[0], &xs[0], ys.size());
+
+	double maxError = 0;
+	bool arrayMatches = true;
+	for (size_t i = 0; i < ys.size(); ++i)
+	{
+		float result = M5FastMath::Atan2(ys[i], xs[i]);
+		double expected = std::atan2(static_cast<double>(ys[i]), static_cast<double>(xs[i]));
+		//-pi and pi are the same angle
+		double error = std::fabs(result - expected);
+		maxError = std::fmax(maxError, std::fmin(error, std::fabs(error - 2 * PI)));
+		arrayMatches = arrayMatches && results[i] == result;
+	}
+
+	std::printf("Atan2 max error %g\n", maxError);
+	M5TEST_CHECK(maxError <= ATAN2_ERROR);
+	M5TEST_CHECK(arrayMatches);
+}
+}//end unnamed namespace
+
+/******************************************************************************/
+/*!
+Runs the M5FastMath checks.
+
+\return
+The number of failed checks.
+*/
+/******************************************************************************/
+int main(void)
+{
+	TestSinCos();
+	TestAtan2();
+	return M5Test::Failures();
+}
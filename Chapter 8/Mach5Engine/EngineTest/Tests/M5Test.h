@@ -0,0 +1,44 @@
+/******************************************************************************/
+/*!
+\file   M5Test.h
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/04
+
+A check macro for the engine tests.  Each test is its own program that returns
+the number of failed checks, so ctest can run it.
+
+*/
+/******************************************************************************/
+#ifndef M5_TEST_H
+#define M5_TEST_H
+
+#include <cstdio>
+
+/*! Counts failed checks for the test program.*/
+namespace M5Test
+{
+/*! Gets the number of checks that have failed so far.*/
+inline int& Failures(void)
+{
+	static int failures = 0;
+	return failures;
+}
+/*! Prints a check that failed and counts it.*/
+inline void Check(bool passed, const char* expression, const char* file, int line)
+{
+	if (passed)
+		return;
+
+	std::fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expression);
+	++Failures();
+}
+}//end namespace M5Test
+
+/*! Checks that an expression is true, and keeps going if it isn't so every
+failure is printed.*/
+#define M5TEST_CHECK(expression) M5Test::Check((expression), #expression, __FILE__, __LINE__)
+
+
+#endif //M5_TEST_H
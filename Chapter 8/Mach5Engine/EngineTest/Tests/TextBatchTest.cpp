@@ -0,0 +1,173 @@
+/******************************************************************************/
+/*!
+\file   TextBatchTest.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/04
+
+Checks the quads M5TextBatch lays out, and that the headless render backends
+see every quad of a frame.
+
+*/
+/******************************************************************************/
+#include "M5Test.h"
+
+#include "Core/M5TextBatch.h"
+#include "Core/M5RenderList.h"
+#include "Core/M5NullRenderBackend.h"
+#include "Core/M5SoftRenderBackend.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+const int   WIDTH = 64;           //!< Width of the test frames
+const int   HEIGHT = 64;          //!< Height of the test frames
+const float QUAD_SIZE = 10;       //!< Width and height of the test quad in pixels
+const char* IMAGE = "TextBatchTest.tga"; //!< The empty frame, to count the pixels the quad changed
+
+/******************************************************************************/
+/*!
+Makes an empty frame with a black background and no camera.
+
+\param [out] frame
+The frame to set up.
+*/
+/******************************************************************************/
+void MakeFrame(M5RenderFrame& frame)
+{
+	std::memset(frame.persp, 0, sizeof(frame.persp));
+	std::memset(frame.camera, 0, sizeof(frame.camera));
+	for (int i = 0; i < 4; ++i)
+	{
+		frame.persp[i * 5] = 1;
+		frame.camera[i * 5] = 1;
+	}
+
+	frame.viewport[0] = 0;
+	frame.viewport[1] = 0;
+	frame.viewport[2] = WIDTH;
+	frame.viewport[3] = HEIGHT;
+	frame.width = WIDTH;
+	frame.height = HEIGHT;
+	frame.background[0] = frame.background[1] = frame.background[2] = 0;
+}
+/******************************************************************************/
+/*!
+Adds one white untextured HUD quad, QUAD_SIZE pixels across, with its corner
+on a pixel edge so it covers exactly QUAD_SIZE * QUAD_SIZE pixels.
+
+\param [out] frame
+The frame to add the quad to.
+*/
+/******************************************************************************/
+void AddQuad(M5RenderFrame& frame)
+{
+	M5RenderItem item;
+	item.world.MakeTransform(QUAD_SIZE, QUAD_SIZE, 0, 20 + QUAD_SIZE / 2, 30 + QUAD_SIZE / 2, 0);
+	item.texCoords.MakeIdentity();
+	item.textureID = 0;
+	item.color[0] = item.color[1] = item.color[2] = item.color[3] = 255;
+	frame.hud.push_back(item);
+}
+/******************************************************************************/
+/*!
+Checks that text is two triangles per visible glyph, placed one glyph width
+apart, and that writing the same text again reuses its layout.
+*/
+/******************************************************************************/
+void TestLayout(void)
+{
+	M5TextBatch text;
+	text.Write("Hi !", 100, 200, 2, 0xFF00FF00);
+
+	//The space has no quad
+	const M5TextVertices& verts = text.GetVertices();
+	M5TEST_CHECK(verts.size() == 3 * M5TextBatch::VERTS_PER_GLYPH);
+
+	for (size_t i = 0; i < verts.size(); ++i)
+	{
+		int glyph = static_cast<int>(i / M5TextBatch::VERTS_PER_GLYPH);
+		int column = glyph == 2 ? 3 : glyph;
+		float left = 100.0f + column * M5TextBatch::GLYPH_WIDTH * 2;
+		M5TEST_CHECK(verts[i].x == left || verts[i].x == left + M5TextBatch::GLYPH_WIDTH * 2);
+		M5TEST_CHECK(verts[i].y == 200 || verts[i].y == 200 + M5TextBatch::GLYPH_HEIGHT * 2);
+		M5TEST_CHECK(verts[i].u >= 0 && verts[i].u <= 1 && verts[i].v >= 0 && verts[i].v <= 1);
+		M5TEST_CHECK(verts[i].color[1] == 0xFF && verts[i].color[0] == 0 && verts[i].color[3] == 0xFF);
+	}
+
+	text.Write("Hi !", 0, 0, 1, 0xFFFFFFFF);
+	M5TEST_CHECK(verts.size() == 6 * M5TextBatch::VERTS_PER_GLYPH);
+	M5TEST_CHECK(text.GetCacheSize() == 1);
+
+	text.EndFrame();
+	M5TEST_CHECK(text.GetVertices().empty());
+}
+/******************************************************************************/
+/*!
+Checks that the null backend reads every quad and text vertex of a frame.
+*/
+/******************************************************************************/
+void TestNullBackend(void)
+{
+	M5TextBatch text;
+	text.Write("M5", 0, 0, 1, 0xFFFFFFFF);
+
+	M5RenderFrame frame;
+	MakeFrame(frame);
+	AddQuad(frame);
+	frame.text = text.GetVertices();
+
+	M5NullRenderBackend backend;
+	backend.StartThread();
+	backend.Execute(frame);
+	backend.EndThread();
+
+	M5TEST_CHECK(backend.GetFrameCount() == 1);
+	M5TEST_CHECK(backend.GetItemCount() == 1 + 2 * M5TextBatch::VERTS_PER_GLYPH);
+}
+/******************************************************************************/
+/*!
+Draws one HUD quad with the software backend and checks that it changed
+exactly the pixels it covers.
+*/
+/******************************************************************************/
+void TestSoftBackend(void)
+{
+	M5SoftRenderBackend backend;
+	backend.Init(0);
+	backend.StartThread();
+
+	M5RenderFrame frame;
+	MakeFrame(frame);
+	backend.Execute(frame);
+	M5TEST_CHECK(backend.WriteImage(IMAGE));
+
+	AddQuad(frame);
+	backend.Execute(frame);
+	int quadPixels = static_cast<int>(QUAD_SIZE * QUAD_SIZE);
+	M5TEST_CHECK(backend.CompareImage(IMAGE, 0) == quadPixels);
+
+	backend.EndThread();
+	backend.Shutdown();
+	std::remove(IMAGE);
+}
+}//end unnamed namespace
+
+/******************************************************************************/
+/*!
+Runs the text and render backend checks.
+
+\return
+The number of failed checks.
+*/
+/******************************************************************************/
+int main(void)
+{
+	TestLayout();
+	TestNullBackend();
+	TestSoftBackend();
+	return M5Test::Failures();
+}
@@ -0,0 +1,131 @@
+/******************************************************************************/
+/*!
+\file   Vec2BatchTest.cpp
+\author Matt Casanova
+\par    email: lazersquad\@gmail.com
+\par    Mach5 Game Engine
+\date   2016/10/04
+
+Checks that the M5Vec2Batch functions give the same answers as doing the
+M5Vec2 math one vector at a time.
+
+*/
+/******************************************************************************/
+#include "M5Test.h"
+
+#include "Core/M5Vec2Batch.h"
+#include "Core/M5Vec2.h"
+
+#include <vector>
+
+namespace
+{
+const size_t MAX_SIZE = 37;  //!< Largest span to check, so sizes cover the SSE2 loop and the leftovers
+const float  SCALE = 0.016f; //!< The dt a frame would scale by
+
+/******************************************************************************/
+/*!
+Fills a buffer with vectors that aren't round numbers, so rounding shows up.
+
+\param [out] buffer
+The buffer to fill.
+
+\param [in] size
+The number of vectors.
+
+\param [in] seed
+Makes each buffer different.
+
+\return
+A span of the vectors.
+*/
+/******************************************************************************/
+M5Vec2Span Fill(M5Vec2Buffer& buffer, size_t size, float seed)
+{
+	M5Vec2Span span = buffer.Resize(size);
+	for (size_t i = 0; i < size; ++i)
+	{
+		span.x[i] = seed * 1.37f + i * 0.731f - 11.3f;
+		span.y[i] = seed * -2.11f + i * 1.913f + 3.7f;
+	}
+	return span;
+}
+/******************************************************************************/
+/*!
+Checks that AddScaled matches pos + vel * scale for every size up to
+MAX_SIZE, both into a new span and in place.
+*/
+/******************************************************************************/
+void TestAddScaled(void)
+{
+	M5Vec2Buffer posBuffer, velBuffer, resultBuffer;
+	for (size_t size = 0; size <= MAX_SIZE; ++size)
+	{
+		M5Vec2Span pos = Fill(posBuffer, size, 1);
+		M5Vec2Span vel = Fill(velBuffer, size, 2);
+		M5Vec2Span result = resultBuffer.Resize(size);
+
+		std::vector<M5Vec2> expected(size);
+		for (size_t i = 0; i < size; ++i)
+			expected[i] = M5Vec2(pos.x[i], pos.y[i]) + M5Vec2(vel.x[i], vel.y[i]) * SCALE;
+
+		M5Vec2Batch::AddScaled(result, pos, vel, SCALE);
+		for (size_t i = 0; i < size; ++i)
+		{
+			M5TEST_CHECK(result.x[i] == expected[i].x);
+			M5TEST_CHECK(result.y[i] == expected[i].y);
+		}
+
+		M5Vec2Batch::AddScaled(pos, pos, vel, SCALE);
+		for (size_t i = 0; i < size; ++i)
+		{
+			M5TEST_CHECK(pos.x[i] == expected[i].x);
+			M5TEST_CHECK(pos.y[i] == expected[i].y);
+		}
+	}
+}
+/******************************************************************************/
+/*!
+Checks that Add and Scale match the M5Vec2 functions for every size up to
+MAX_SIZE.
+*/
+/******************************************************************************/
+void TestAddScale(void)
+{
+	M5Vec2Buffer vec1Buffer, vec2Buffer, sumBuffer, scaledBuffer;
+	for (size_t size = 0; size <= MAX_SIZE; ++size)
+	{
+		M5Vec2Span vec1 = Fill(vec1Buffer, size, 3);
+		M5Vec2Span vec2 = Fill(vec2Buffer, size, 4);
+		M5Vec2Span sum = sumBuffer.Resize(size);
+		M5Vec2Span scaled = scaledBuffer.Resize(size);
+
+		M5Vec2Batch::Add(sum, vec1, vec2);
+		M5Vec2Batch::Scale(scaled, vec1, SCALE);
+		for (size_t i = 0; i < size; ++i)
+		{
+			M5Vec2 expected;
+			M5Vec2::Add(expected, M5Vec2(vec1.x[i], vec1.y[i]), M5Vec2(vec2.x[i], vec2.y[i]));
+			M5TEST_CHECK(sum.x[i] == expected.x && sum.y[i] == expected.y);
+
+			M5Vec2::Scale(expected, M5Vec2(vec1.x[i], vec1.y[i]), SCALE);
+			M5TEST_CHECK(scaled.x[i] == expected.x && scaled.y[i] == expected.y);
+		}
+	}
+}
+}//end unnamed namespace
+
+/******************************************************************************/
+/*!
+Runs the M5Vec2Batch checks.
+
+\return
+The number of failed checks.
+*/
+/******************************************************************************/
+int main(void)
+{
+	TestAddScaled();
+	TestAddScale();
+	return M5Test::Failures();
+}